@@ -64,15 +64,26 @@ public:
     void AttachSocketListener( UdpSocket *socket, PacketListener *listener );
     void DetachSocketListener( UdpSocket *socket, PacketListener *listener );
 
+    // thread safe versions for a multiplexer that may be running on another thread: the
+    // Run() thread is woken through the asynchronous break mechanism (without breaking) and
+    // makes the change itself between packets. they return once it is made, so after a
+    // detach the socket and listener are no longer used. don't call them from a listener.
+    void AttachSocketListenerLive( UdpSocket *socket, PacketListener *listener );
+    void DetachSocketListenerLive( UdpSocket *socket, PacketListener *listener );
+
     void AttachPeriodicTimerListener( int periodMilliseconds, TimerListener *listener );
 	void AttachPeriodicTimerListener(
             int initialDelayMilliseconds, int periodMilliseconds, TimerListener *listener );
     void DetachPeriodicTimerListener( TimerListener *listener );  
 
-    void Run();      // loop and block processing messages indefinitely
+    // loop and block processing messages indefinitely. Run() does not clear a pending
+    // break, so a break requested before the loop starts is not lost; call ClearBreak()
+    // before starting it (before spawning the thread that runs it).
+    void Run();
 	void RunUntilSigInt();
     void Break();    // call this from a listener to exit once the listener returns
     void AsynchronousBreak(); // call this from another thread or signal handler to exit the Run() state
+    void ClearBreak(); // forget an earlier break (only while Run() is not running)
 };
 
 
@@ -117,7 +128,14 @@ public:
 	// for calls to Send()
 	void Connect( const IpEndpointName& remoteEndpoint );	
 	void Send( const char *data, std::size_t size );
+	// Send several datagrams to the connected endpoint (one sendmmsg() call
+	// per batch on Linux, one send() each elsewhere).
+	void SendMultiple( const char * const *data, const std::size_t *sizes, std::size_t count );
     void SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size );
+	// Send each datagram to each of the endpoints (one sendmmsg() call per
+	// batch on Linux, one sendto() each elsewhere). Don't use on a connected socket.
+	void SendMultipleTo( const IpEndpointName *remoteEndpoints, std::size_t numEndpoints,
+			const char * const *data, const std::size_t *sizes, std::size_t count );
 
 
 	// Bind a local endpoint to receive incoming data. Endpoint
@@ -166,7 +184,7 @@ public:
         { mux_.DetachSocketListener( this, listener_ ); }
 
     // see SocketReceiveMultiplexer above for the behaviour of these methods...
-    void Run() { mux_.Run(); }
+    void Run() { mux_.ClearBreak(); mux_.Run(); }
 	void RunUntilSigInt() { mux_.RunUntilSigInt(); }
     void Break() { mux_.Break(); }
     void AsynchronousBreak() { mux_.AsynchronousBreak(); }
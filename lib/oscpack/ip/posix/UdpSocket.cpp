@@ -45,6 +45,9 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <netinet/in.h> // for sockaddr_in
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 #include <signal.h>
 #include <math.h>
@@ -56,11 +59,18 @@
 #include <cstring> // for memset
 #include <stdexcept>
 #include <vector>
+#include <mutex>
+#include <condition_variable>
 
 #include "../PacketListener.h"
 #include "../TimerListener.h"
 
 
+#if defined(__linux__)
+// max datagrams per recvmmsg()/sendmmsg() call
+#define OSCPACK_MMSG_BATCH_SIZE 16
+#endif
+
 #if defined(__APPLE__) && !defined(_SOCKLEN_T)
 // pre system 10.3 didn't have socklen_t
 typedef ssize_t socklen_t;
@@ -100,6 +110,11 @@ static IpEndpointName IpEndpointNameFromSockaddr( const struct sockaddr_in& sock
 class UdpSocket::Implementation{
 	bool isBound_;
 	bool isConnected_;
+#if defined(__linux__)
+	// cleared if the kernel doesn't have recvmmsg()/sendmmsg() (ENOSYS)
+	bool useRecvmmsg_;
+	bool useSendmmsg_;
+#endif
 
 	int socket_;
 	struct sockaddr_in connectedAddr_;
@@ -110,6 +125,10 @@ public:
 	Implementation()
 		: isBound_( false )
 		, isConnected_( false )
+#if defined(__linux__)
+		, useRecvmmsg_( true )
+		, useSendmmsg_( true )
+#endif
 		, socket_( -1 )
 	{
 		if( (socket_ = socket( AF_INET, SOCK_DGRAM, 0 )) == -1 ){
@@ -206,6 +225,41 @@ public:
         send( socket_, data, size, 0 );
 	}
 
+	void SendMultiple( const char * const *data, const std::size_t *sizes, std::size_t count )
+	{
+		assert( isConnected_ );
+
+		std::size_t i = 0;
+#if defined(__linux__)
+		if( useSendmmsg_ ){
+			struct mmsghdr msgs[ OSCPACK_MMSG_BATCH_SIZE ];
+			struct iovec iovs[ OSCPACK_MMSG_BATCH_SIZE ];
+			while( i < count ){
+				unsigned int n = (unsigned int)std::min( count - i, (std::size_t)OSCPACK_MMSG_BATCH_SIZE );
+				std::memset( msgs, 0, sizeof(msgs[0]) * n );
+				for( unsigned int k = 0; k < n; ++k ){
+					iovs[k].iov_base = (void*)data[i + k];
+					iovs[k].iov_len = sizes[i + k];
+					msgs[k].msg_hdr.msg_iov = &iovs[k];
+					msgs[k].msg_hdr.msg_iovlen = 1;
+				}
+				int sent = sendmmsg( socket_, msgs, n, 0 );
+				if( sent < 0 ){
+					if( errno == ENOSYS ){
+						useSendmmsg_ = false; // fall back to send() below
+						break;
+					}
+					// like Send(), errors are ignored: drop the datagram that failed and go on
+					sent = 1;
+				}
+				i += (std::size_t)sent;
+			}
+		}
+#endif
+		for( ; i < count; ++i )
+			send( socket_, data[i], sizes[i], 0 );
+	}
+
     void SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 	{
 		sendToAddr_.sin_addr.s_addr = htonl( remoteEndpoint.address );
@@ -214,6 +268,46 @@ public:
         sendto( socket_, data, size, 0, (sockaddr*)&sendToAddr_, sizeof(sendToAddr_) );
 	}
 
+	void SendMultipleTo( const IpEndpointName *remoteEndpoints, std::size_t numEndpoints,
+			const char * const *data, const std::size_t *sizes, std::size_t count )
+	{
+		std::size_t total = numEndpoints * count;
+		std::size_t i = 0; // index into (packet, endpoint) pairs
+#if defined(__linux__)
+		if( useSendmmsg_ ){
+			struct mmsghdr msgs[ OSCPACK_MMSG_BATCH_SIZE ];
+			struct iovec iovs[ OSCPACK_MMSG_BATCH_SIZE ];
+			struct sockaddr_in addrs[ OSCPACK_MMSG_BATCH_SIZE ];
+			while( i < total ){
+				unsigned int n = (unsigned int)std::min( total - i, (std::size_t)OSCPACK_MMSG_BATCH_SIZE );
+				std::memset( msgs, 0, sizeof(msgs[0]) * n );
+				for( unsigned int k = 0; k < n; ++k ){
+					std::size_t packet = (i + k) / numEndpoints;
+					SockaddrFromIpEndpointName( addrs[k], remoteEndpoints[ (i + k) % numEndpoints ] );
+					iovs[k].iov_base = (void*)data[packet];
+					iovs[k].iov_len = sizes[packet];
+					msgs[k].msg_hdr.msg_name = &addrs[k];
+					msgs[k].msg_hdr.msg_namelen = sizeof(addrs[k]);
+					msgs[k].msg_hdr.msg_iov = &iovs[k];
+					msgs[k].msg_hdr.msg_iovlen = 1;
+				}
+				int sent = sendmmsg( socket_, msgs, n, 0 );
+				if( sent < 0 ){
+					if( errno == ENOSYS ){
+						useSendmmsg_ = false; // fall back to sendto() below
+						break;
+					}
+					// like SendTo(), errors are ignored: drop the datagram that failed and go on
+					sent = 1;
+				}
+				i += (std::size_t)sent;
+			}
+		}
+#endif
+		for( ; i < total; ++i )
+			SendTo( remoteEndpoints[ i % numEndpoints ], data[ i / numEndpoints ], sizes[ i / numEndpoints ] );
+	}
+
 	void Bind( const IpEndpointName& localEndpoint )
 	{
 		struct sockaddr_in bindSockAddr;
@@ -246,6 +340,47 @@ public:
 		return (std::size_t)result;
 	}
 
+#if defined(__linux__)
+	// Receive up to count datagrams without blocking. Datagram k goes to data + k*size.
+	// Returns the number received (0 if none waiting) or -1 if recvmmsg() isn't available.
+	int ReceiveMultiple( IpEndpointName *remoteEndpoints, char *data, std::size_t size, std::size_t *sizes, int count )
+	{
+		assert( isBound_ );
+
+		if( !useRecvmmsg_ )
+			return -1;
+		if( count > OSCPACK_MMSG_BATCH_SIZE )
+			count = OSCPACK_MMSG_BATCH_SIZE;
+
+		struct mmsghdr msgs[ OSCPACK_MMSG_BATCH_SIZE ];
+		struct iovec iovs[ OSCPACK_MMSG_BATCH_SIZE ];
+		struct sockaddr_in fromAddrs[ OSCPACK_MMSG_BATCH_SIZE ];
+		std::memset( msgs, 0, sizeof(msgs[0]) * count );
+		for( int k = 0; k < count; ++k ){
+			iovs[k].iov_base = data + k * size;
+			iovs[k].iov_len = size;
+			msgs[k].msg_hdr.msg_iov = &iovs[k];
+			msgs[k].msg_hdr.msg_iovlen = 1;
+			msgs[k].msg_hdr.msg_name = &fromAddrs[k];
+			msgs[k].msg_hdr.msg_namelen = sizeof(fromAddrs[k]);
+		}
+		int result = recvmmsg( socket_, msgs, (unsigned int)count, MSG_DONTWAIT, 0 );
+		if( result < 0 ){
+			if( errno == ENOSYS ){
+				useRecvmmsg_ = false;
+				return -1;
+			}
+			return 0;
+		}
+		for( int k = 0; k < result; ++k ){
+			sizes[k] = msgs[k].msg_len;
+			remoteEndpoints[k].address = ntohl( fromAddrs[k].sin_addr.s_addr );
+			remoteEndpoints[k].port = ntohs( fromAddrs[k].sin_port );
+		}
+		return result;
+	}
+#endif
+
 	int Socket() { return socket_; }
 };
 
@@ -284,11 +419,24 @@ void UdpSocket::Send( const char *data, std::size_t size )
 	impl_->Send( data, size );
 }
 
+void UdpSocket::SendMultiple( const char * const *data, const std::size_t *sizes, std::size_t count )
+{
+	impl_->SendMultiple( data, sizes, count );
+}
+
 void UdpSocket::SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 {
 	impl_->SendTo( remoteEndpoint, data, size );
 }
 
+void UdpSocket::SendMultipleTo( const IpEndpointName *remoteEndpoints, std::size_t numEndpoints,
+		const char * const *data, const std::size_t *sizes, std::size_t count )
+{
+	if( numEndpoints < 1 )
+		return;
+	impl_->SendMultipleTo( remoteEndpoints, numEndpoints, data, sizes, count );
+}
+
 void UdpSocket::Bind( const IpEndpointName& localEndpoint )
 {
 	impl_->Bind( localEndpoint );
@@ -340,6 +488,19 @@ class SocketReceiveMultiplexer::Implementation{
 	volatile bool break_;
 	int breakPipe_[2]; // [0] is the reader descriptor and [1] the writer
 
+	// live attach/detach: changes queued for the Run() thread, which makes them between packets
+	struct SocketListenerChange{
+		bool attach;
+		UdpSocket *socket;
+		PacketListener *listener;
+	};
+	std::mutex changesMutex_;
+	std::condition_variable changesMade_;
+	std::vector< SocketListenerChange > changes_;
+	unsigned long changesQueued_; // number of changes ever queued
+	unsigned long changesDone_; // number of those made
+	bool running_; // if Run() is running (changes must go through it)
+
 	double GetCurrentTimeMs() const
 	{
 		struct timeval t;
@@ -351,6 +512,10 @@ class SocketReceiveMultiplexer::Implementation{
 
 public:
     Implementation()
+		: break_( false )
+		, changesQueued_( 0 )
+		, changesDone_( 0 )
+		, running_( false )
 	{
 		if( pipe(breakPipe_) != 0 )
 			throw std::runtime_error( "creation of asynchronous break pipes failed\n" );
@@ -378,6 +543,28 @@ public:
 		socketListeners_.erase( i );
 	}
 
+    // attach/detach while Run() may be running on another thread: the change is queued, Run() is
+    // woken through the break pipe and makes it (and changes its epoll/select set) between packets.
+    // returns once the change is made, so after a detach the socket and listener are no longer used.
+    void ChangeSocketListenerLive( bool attach, UdpSocket *socket, PacketListener *listener )
+	{
+		std::unique_lock<std::mutex> lock( changesMutex_ );
+		if( !running_ ){
+			if( attach )
+				AttachSocketListener( socket, listener );
+			else
+				DetachSocketListener( socket, listener );
+			return;
+		}
+		SocketListenerChange change = { attach, socket, listener };
+		changes_.push_back( change );
+		unsigned long ticket = ++changesQueued_;
+		// wake Run() (break_ is not set, so it carries on)
+		write( breakPipe_[1], "+", 1 );
+		while( changesDone_ < ticket )
+			changesMade_.wait( lock );
+	}
+
     void AttachPeriodicTimerListener( int periodMilliseconds, TimerListener *listener )
 	{
 		timerListeners_.push_back( AttachedTimerListener( periodMilliseconds, periodMilliseconds, listener ) );
@@ -402,9 +589,197 @@ public:
 		timerListeners_.erase( i );
 	}
 
+    // make the queued live changes (Run() thread, between packets). epollFd is the epoll set to
+    // update (-1 for none). returns true if the sockets changed.
+    bool MakeChanges( int epollFd )
+	{
+		std::lock_guard<std::mutex> lock( changesMutex_ );
+		bool changed = !changes_.empty();
+		for( std::size_t i = 0; i < changes_.size(); ++i ){
+			SocketListenerChange& change = changes_[i];
+#if defined(__linux__)
+			if( epollFd >= 0 ){
+				struct epoll_event ev;
+				std::memset( &ev, 0, sizeof(ev) );
+				ev.events = EPOLLIN;
+				ev.data.fd = change.socket->impl_->Socket();
+				epoll_ctl( epollFd, ( change.attach ) ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, ev.data.fd, &ev );
+			}
+#else
+			(void)epollFd;
+#endif
+			if( change.attach )
+				AttachSocketListener( change.socket, change.listener );
+			else
+				DetachSocketListener( change.socket, change.listener );
+		}
+		changes_.clear();
+		changesDone_ = changesQueued_;
+		changesMade_.notify_all();
+		return changed;
+	}
+
+    // Run() is starting: changes go through the loop from now on.
+    void BeginRun()
+	{
+		std::lock_guard<std::mutex> lock( changesMutex_ );
+		running_ = true;
+	}
+
+    // Run() is done: make what is still queued directly.
+    void EndRun()
+	{
+		MakeChanges( -1 );
+		std::lock_guard<std::mutex> lock( changesMutex_ );
+		running_ = false;
+	}
+
+#if defined(__linux__)
+    // epoll version of Run(). One wakeup per ready socket instead of rebuilding and
+    // scanning an fd_set, so a single thread can service many sockets cheaply.
+    void RunEpoll()
+	{
+        char *data = 0;
+        int epollFd = -1;
+
+        try{
+            epollFd = epoll_create1( EPOLL_CLOEXEC );
+            if( epollFd < 0 )
+                throw std::runtime_error("epoll_create1 failed\n");
+
+            // events are tagged with their descriptor (sockets may come and go, see MakeChanges())
+            struct epoll_event ev;
+            std::memset( &ev, 0, sizeof(ev) );
+            ev.events = EPOLLIN;
+            ev.data.fd = breakPipe_[0];
+            if( epoll_ctl( epollFd, EPOLL_CTL_ADD, breakPipe_[0], &ev ) != 0 )
+                throw std::runtime_error("epoll_ctl failed\n");
+            for( std::size_t i = 0; i < socketListeners_.size(); ++i ){
+                ev.events = EPOLLIN;
+                ev.data.fd = socketListeners_[i].second->impl_->Socket();
+                if( epoll_ctl( epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev ) != 0 )
+                    throw std::runtime_error("epoll_ctl failed\n");
+            }
+
+            // configure the timer queue
+            double currentTimeMs = GetCurrentTimeMs();
+
+            // expiry time ms, listener
+            std::vector< std::pair< double, AttachedTimerListener > > timerQueue_;
+            for( std::vector< AttachedTimerListener >::iterator i = timerListeners_.begin();
+                    i != timerListeners_.end(); ++i )
+                timerQueue_.push_back( std::make_pair( currentTimeMs + i->initialDelayMs, *i ) );
+            std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
+
+            const int MAX_BUFFER_SIZE = 4098;
+            const int MAX_EVENTS = 32;
+            // room for a whole recvmmsg() batch (slot 0 is also used by the plain recvfrom() fallback)
+            data = new char[ MAX_BUFFER_SIZE * OSCPACK_MMSG_BATCH_SIZE ];
+            IpEndpointName remoteEndpoints[ OSCPACK_MMSG_BATCH_SIZE ];
+            std::size_t sizes[ OSCPACK_MMSG_BATCH_SIZE ];
+            struct epoll_event events[ MAX_EVENTS ];
+
+            while( !break_ ){
+                int timeoutMs = -1;
+                if( !timerQueue_.empty() ){
+                    double t = timerQueue_.front().first - GetCurrentTimeMs();
+                    timeoutMs = ( t < 0 ) ? 0 : (int)ceil( t );
+                }
+
+                int n = epoll_wait( epollFd, events, MAX_EVENTS, timeoutMs );
+                if( n < 0 ){
+                    if( break_ ){
+                        break;
+                    }else if( errno == EINTR ){
+                        continue;
+                    }else{
+                        throw std::runtime_error("epoll_wait failed\n");
+                    }
+                }
+
+                bool wakeup = false;
+                for( int e = 0; e < n && !break_; ++e ){
+                    if( events[e].data.fd == breakPipe_[0] ){
+                        // clear pending data from the asynchronous break pipe
+                        char c;
+                        read( breakPipe_[0], &c, 1 );
+                        wakeup = true;
+                        continue;
+                    }
+                    std::size_t s = 0;
+                    while( s < socketListeners_.size() && socketListeners_[s].second->impl_->Socket() != events[e].data.fd )
+                        ++s;
+                    if( s == socketListeners_.size() )
+                        continue;
+                    std::pair< PacketListener*, UdpSocket* >& sl = socketListeners_[s];
+                    // drain up to a batch of datagrams with one call
+                    int numReceived = sl.second->impl_->ReceiveMultiple( remoteEndpoints, data, MAX_BUFFER_SIZE, sizes, OSCPACK_MMSG_BATCH_SIZE );
+                    if( numReceived < 0 ){
+                        // no recvmmsg(), one at a time
+                        sizes[0] = sl.second->ReceiveFrom( remoteEndpoints[0], data, MAX_BUFFER_SIZE );
+                        numReceived = ( sizes[0] > 0 ) ? 1 : 0;
+                    }
+                    for( int k = 0; k < numReceived && !break_; ++k ){
+                        if( sizes[k] > 0 )
+                            sl.first->ProcessPacket( data + k * MAX_BUFFER_SIZE, (int)sizes[k], remoteEndpoints[k] );
+                    }
+                }
+
+                if( break_ )
+                    break;
+
+                // attach/detach after the batch (its events refer to the sockets as they were)
+                if( wakeup )
+                    MakeChanges( epollFd );
+
+                // execute any expired timers
+                currentTimeMs = GetCurrentTimeMs();
+                bool resort = false;
+                for( std::vector< std::pair< double, AttachedTimerListener > >::iterator i = timerQueue_.begin();
+                        i != timerQueue_.end() && i->first <= currentTimeMs; ++i ){
+
+                    i->second.listener->TimerExpired();
+                    if( break_ )
+                        break;
+
+                    i->first += i->second.periodMs;
+                    resort = true;
+                }
+                if( resort )
+                    std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
+            }
+
+            delete [] data;
+            close( epollFd );
+        }catch(...){
+            if( data )
+                delete [] data;
+            if( epollFd >= 0 )
+                close( epollFd );
+            throw;
+        }
+	}
+#endif
+
     void Run()
 	{
-		break_ = false;
+        BeginRun();
+        try{
+#if defined(__linux__)
+            RunEpoll();
+#else
+            RunSelect();
+#endif
+        }catch(...){
+            EndRun();
+            throw;
+        }
+        EndRun();
+	}
+
+    // select() version of Run() (no epoll)
+    void RunSelect()
+	{
         char *data = 0;
         
         try{
@@ -476,10 +851,12 @@ public:
                     }
                 }
 
+                bool wakeup = false;
                 if( FD_ISSET( breakPipe_[0], &tempfds ) ){
                     // clear pending data from the asynchronous break pipe
                     char c;
                     read( breakPipe_[0], &c, 1 );
+                    wakeup = true;
                 }
                 
                 if( break_ )
@@ -499,6 +876,19 @@ public:
                     }
                 }
 
+                // attach/detach after the sockets were read (tempfds refers to them as they were)
+                if( wakeup && MakeChanges( -1 ) ){
+                    FD_ZERO( &masterfds );
+                    FD_SET( breakPipe_[0], &masterfds );
+                    fdmax = breakPipe_[0];
+                    for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
+                            i != socketListeners_.end(); ++i ){
+                        if( fdmax < i->second->impl_->Socket() )
+                            fdmax = i->second->impl_->Socket();
+                        FD_SET( i->second->impl_->Socket(), &masterfds );
+                    }
+                }
+
                 // execute any expired timers
                 currentTimeMs = GetCurrentTimeMs();
                 bool resort = false;
@@ -529,6 +919,11 @@ public:
 		break_ = true;
 	}
 
+    void ClearBreak()
+	{
+		break_ = false;
+	}
+
     void AsynchronousBreak()
 	{
 		break_ = true;
@@ -560,6 +955,16 @@ void SocketReceiveMultiplexer::DetachSocketListener( UdpSocket *socket, PacketLi
 	impl_->DetachSocketListener( socket, listener );
 }
 
+void SocketReceiveMultiplexer::AttachSocketListenerLive( UdpSocket *socket, PacketListener *listener )
+{
+	impl_->ChangeSocketListenerLive( true, socket, listener );
+}
+
+void SocketReceiveMultiplexer::DetachSocketListenerLive( UdpSocket *socket, PacketListener *listener )
+{
+	impl_->ChangeSocketListenerLive( false, socket, listener );
+}
+
 void SocketReceiveMultiplexer::AttachPeriodicTimerListener( int periodMilliseconds, TimerListener *listener )
 {
 	impl_->AttachPeriodicTimerListener( periodMilliseconds, listener );
@@ -585,6 +990,7 @@ void SocketReceiveMultiplexer::RunUntilSigInt()
 	assert( multiplexerInstanceToAbortWithSigInt_ == 0 ); /* at present we support only one multiplexer instance running until sig int */
 	multiplexerInstanceToAbortWithSigInt_ = this;
 	signal( SIGINT, InterruptSignalHandler );
+	impl_->ClearBreak();
 	impl_->Run();
 	signal( SIGINT, SIG_DFL );
 	multiplexerInstanceToAbortWithSigInt_ = 0;
@@ -595,6 +1001,11 @@ void SocketReceiveMultiplexer::Break()
 	impl_->Break();
 }
 
+void SocketReceiveMultiplexer::ClearBreak()
+{
+	impl_->ClearBreak();
+}
+
 void SocketReceiveMultiplexer::AsynchronousBreak()
 {
 	impl_->AsynchronousBreak();
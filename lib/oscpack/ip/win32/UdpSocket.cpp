@@ -48,6 +48,8 @@
 #include <cstring> // for memset
 #include <stdexcept>
 #include <vector>
+#include <mutex>
+#include <condition_variable>
 
 #include "../UdpSocket.h" // usually I'd include the module header first
                           // but this is causing conflicts with BCB4 due to
@@ -277,11 +279,25 @@ void UdpSocket::Send( const char *data, std::size_t size )
 	impl_->Send( data, size );
 }
 
+void UdpSocket::SendMultiple( const char * const *data, const std::size_t *sizes, std::size_t count )
+{
+	for( std::size_t i = 0; i < count; ++i )
+		impl_->Send( data[i], sizes[i] );
+}
+
 void UdpSocket::SendTo( const IpEndpointName& remoteEndpoint, const char *data, std::size_t size )
 {
 	impl_->SendTo( remoteEndpoint, data, size );
 }
 
+void UdpSocket::SendMultipleTo( const IpEndpointName *remoteEndpoints, std::size_t numEndpoints,
+		const char * const *data, const std::size_t *sizes, std::size_t count )
+{
+	for( std::size_t i = 0; i < count; ++i )
+		for( std::size_t j = 0; j < numEndpoints; ++j )
+			impl_->SendTo( remoteEndpoints[j], data[i], sizes[i] );
+}
+
 void UdpSocket::Bind( const IpEndpointName& localEndpoint )
 {
 	impl_->Bind( localEndpoint );
@@ -337,6 +353,19 @@ class SocketReceiveMultiplexer::Implementation{
 	volatile bool break_;
 	HANDLE breakEvent_;
 
+	// live attach/detach: changes queued for the Run() thread, which makes them between packets
+	struct SocketListenerChange{
+		bool attach;
+		UdpSocket *socket;
+		PacketListener *listener;
+	};
+	std::mutex changesMutex_;
+	std::condition_variable changesMade_;
+	std::vector< SocketListenerChange > changes_;
+	unsigned long changesQueued_; // number of changes ever queued
+	unsigned long changesDone_; // number of those made
+	bool running_; // if Run() is running (changes must go through it)
+
 	double GetCurrentTimeMs() const
 	{
 #ifndef WINCE
@@ -348,6 +377,10 @@ class SocketReceiveMultiplexer::Implementation{
 
 public:
     Implementation()
+		: break_( false )
+		, changesQueued_( 0 )
+		, changesDone_( 0 )
+		, running_( false )
 	{
 		breakEvent_ = CreateEvent( NULL, FALSE, FALSE, NULL );
 	}
@@ -373,6 +406,28 @@ public:
 		socketListeners_.erase( i );
 	}
 
+    // attach/detach while Run() may be running on another thread: the change is queued, Run() is
+    // woken through the break event and makes it (and changes its socket events) between packets.
+    // returns once the change is made, so after a detach the socket and listener are no longer used.
+    void ChangeSocketListenerLive( bool attach, UdpSocket *socket, PacketListener *listener )
+	{
+		std::unique_lock<std::mutex> lock( changesMutex_ );
+		if( !running_ ){
+			if( attach )
+				AttachSocketListener( socket, listener );
+			else
+				DetachSocketListener( socket, listener );
+			return;
+		}
+		SocketListenerChange change = { attach, socket, listener };
+		changes_.push_back( change );
+		unsigned long ticket = ++changesQueued_;
+		// wake Run() (break_ is not set, so it carries on)
+		SetEvent( breakEvent_ );
+		while( changesDone_ < ticket )
+			changesMade_.wait( lock );
+	}
+
     void AttachPeriodicTimerListener( int periodMilliseconds, TimerListener *listener )
 	{
 		timerListeners_.push_back( AttachedTimerListener( periodMilliseconds, periodMilliseconds, listener ) );
@@ -397,15 +452,12 @@ public:
 		timerListeners_.erase( i );
 	}
 
-    void Run()
+    // prepare the window events which we use to wake up on incoming data
+    // we use this instead of select() primarily to support the AsyncBreak() 
+    // mechanism.
+    void CreateSocketEvents( std::vector<HANDLE>& events )
 	{
-		break_ = false;
-
-		// prepare the window events which we use to wake up on incoming data
-		// we use this instead of select() primarily to support the AsyncBreak() 
-		// mechanism.
-
-		std::vector<HANDLE> events( socketListeners_.size() + 1, 0 );
+		events.assign( socketListeners_.size() + 1, 0 );
 		int j=0;
 		for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
 				i != socketListeners_.end(); ++i, ++j ){
@@ -415,8 +467,54 @@ public:
 			events[j] = event;
 		}
 
-
 		events[ socketListeners_.size() ] = breakEvent_; // last event in the collection is the break event
+	}
+
+    void FreeSocketEvents( std::vector<HANDLE>& events )
+	{
+		int j = 0;
+		for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
+				i != socketListeners_.end(); ++i, ++j ){
+
+			WSAEventSelect( i->second->impl_->Socket(), events[j], 0 ); // remove association between socket and event
+			CloseHandle( events[j] );
+			unsigned long enableNonblocking = 0;
+			ioctlsocket( i->second->impl_->Socket(), FIONBIO, &enableNonblocking );  // make the socket blocking again
+		}
+		events.clear();
+	}
+
+    // make the queued live changes (Run() thread, between packets). events is the current set
+    // of socket events (rebuilt if the sockets change, NULL if there is none).
+    void MakeChanges( std::vector<HANDLE>* events )
+	{
+		std::lock_guard<std::mutex> lock( changesMutex_ );
+		if( !changes_.empty() ){
+			if( events )
+				FreeSocketEvents( *events );
+			for( std::size_t i = 0; i < changes_.size(); ++i ){
+				if( changes_[i].attach )
+					AttachSocketListener( changes_[i].socket, changes_[i].listener );
+				else
+					DetachSocketListener( changes_[i].socket, changes_[i].listener );
+			}
+			changes_.clear();
+			if( events )
+				CreateSocketEvents( *events );
+		}
+		changesDone_ = changesQueued_;
+		changesMade_.notify_all();
+	}
+
+    void Run()
+	{
+		{
+			std::lock_guard<std::mutex> lock( changesMutex_ );
+			running_ = true;
+		}
+
+		std::vector<HANDLE> events;
+		CreateSocketEvents( events );
 
 		
 		// configure the timer queue
@@ -458,6 +556,11 @@ public:
 							break;
 					}
 				}
+				if( break_ )
+					break;
+				// the break event also wakes us for live attach/detach
+				if( waitResult - WAIT_OBJECT_0 == (DWORD)socketListeners_.size() )
+					MakeChanges( &events );
 			}
 
 			// execute any expired timers
@@ -480,15 +583,12 @@ public:
 		delete [] data;
 
 		// free events
-		j = 0;
-		for( std::vector< std::pair< PacketListener*, UdpSocket* > >::iterator i = socketListeners_.begin();
-				i != socketListeners_.end(); ++i, ++j ){
+		FreeSocketEvents( events );
 
-			WSAEventSelect( i->second->impl_->Socket(), events[j], 0 ); // remove association between socket and event
-			CloseHandle( events[j] );
-			unsigned long enableNonblocking = 0;
-			ioctlsocket( i->second->impl_->Socket(), FIONBIO, &enableNonblocking );  // make the socket blocking again
-		}
+		// Run() is done: make what is still queued directly
+		MakeChanges( NULL );
+		std::lock_guard<std::mutex> lock( changesMutex_ );
+		running_ = false;
 	}
 
     void Break()
@@ -496,6 +596,11 @@ public:
 		break_ = true;
 	}
 
+    void ClearBreak()
+	{
+		break_ = false;
+	}
+
     void AsynchronousBreak()
 	{
 		break_ = true;
@@ -525,6 +630,16 @@ void SocketReceiveMultiplexer::DetachSocketListener( UdpSocket *socket, PacketLi
 	impl_->DetachSocketListener( socket, listener );
 }
 
+void SocketReceiveMultiplexer::AttachSocketListenerLive( UdpSocket *socket, PacketListener *listener )
+{
+	impl_->ChangeSocketListenerLive( true, socket, listener );
+}
+
+void SocketReceiveMultiplexer::DetachSocketListenerLive( UdpSocket *socket, PacketListener *listener )
+{
+	impl_->ChangeSocketListenerLive( false, socket, listener );
+}
+
 void SocketReceiveMultiplexer::AttachPeriodicTimerListener( int periodMilliseconds, TimerListener *listener )
 {
 	impl_->AttachPeriodicTimerListener( periodMilliseconds, listener );
@@ -552,6 +667,7 @@ void SocketReceiveMultiplexer::RunUntilSigInt()
 #ifndef WINCE
     signal( SIGINT, InterruptSignalHandler );
 #endif
+	impl_->ClearBreak();
 	impl_->Run();
 #ifndef WINCE
 	signal( SIGINT, SIG_DFL );
@@ -569,3 +685,8 @@ void SocketReceiveMultiplexer::AsynchronousBreak()
 	impl_->AsynchronousBreak();
 }
 
+void SocketReceiveMultiplexer::ClearBreak()
+{
+	impl_->ClearBreak();
+}
+
@@ -0,0 +1,193 @@
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// assetcache_bench
+// Times the font & svg requests made while building trigSeq64 widgets, with the
+// old per-widget loads (assetPlugin() path + SVG::load()/Font::load()) against the
+// TSAssets cache.
+// The asset ids and paths are src/TSAssetPaths. Rack isn't available here, so the
+// requests a trigSeq64 widget makes (panel, TS_PadBtn, TS_Port, TS_LightString,
+// display / label / OSC config fonts) are listed in buildTrigSeq64() and the
+// loaders mimic Rack v0.6's: a map by file name to weak_ptr, loading the file on
+// a miss. A "load" here only reads the file (no nanosvg / font parsing), so the
+// miss costs are a lower bound on the real ones.
+// Build: g++ -O2 -std=c++11 other/bench/assetcache_bench.cpp src/TSAssetPaths.cpp -o assetcache_bench
+// Usage: assetcache_bench [pluginDir] [numWidgets (50)] [numAddRemove (1000)]  (run from the repo root, or pass it)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+
+#include "../../src/TSAssetPaths.hpp"
+
+// Stand-in for a loaded Font / SVG (just the file contents).
+struct Asset
+{
+	std::vector<char> data;
+	Asset(const std::string& path)
+	{
+		FILE* f = fopen(path.c_str(), "rb");
+		if (!f)
+		{
+			fprintf(stderr, "Can't open %s (pass the repo root as pluginDir).\n", path.c_str());
+			exit(2);
+		}
+		fseek(f, 0, SEEK_END);
+		data.resize(ftell(f));
+		fseek(f, 0, SEEK_SET);
+		if (fread(data.data(), 1, data.size(), f) != data.size())
+			data.clear();
+		fclose(f);
+	}
+};
+typedef std::shared_ptr<Asset> AssetPtr;
+
+static std::string pluginPath = ".";
+static int numLoads = 0;
+
+// Old: Rack v0.6 assetPlugin() + SVG::load() / Font::load() (one cache per type, by file name).
+struct OldLoader
+{
+	std::map<std::string, std::weak_ptr<Asset>> svgCache;
+	std::map<std::string, std::weak_ptr<Asset>> fontCache;
+	static std::string assetPlugin(const char* filename)
+	{
+		return pluginPath + "/" + filename;
+	}
+	static AssetPtr load(std::map<std::string, std::weak_ptr<Asset>>& cache, const std::string& filename)
+	{
+		AssetPtr sp = cache[filename].lock();
+		if (!sp)
+		{
+			cache[filename] = sp = std::make_shared<Asset>(filename);
+			numLoads++;
+		}
+		return sp;
+	}
+	AssetPtr svg(TSSvgAsset id) { return load(svgCache, assetPlugin(TSSvgAssetPaths[id])); }
+	AssetPtr font(TSFontAsset id) { return load(fontCache, assetPlugin(TSFontAssetPaths[id])); }
+};
+// New: TSAssets (kept for the life of the plugin).
+struct NewLoader
+{
+	AssetPtr _fonts[TS_NUM_FONT_ASSETS];
+	AssetPtr _svgs[TS_NUM_SVG_ASSETS];
+	const AssetPtr& svg(TSSvgAsset id)
+	{
+		if (!_svgs[id])
+		{
+			_svgs[id] = std::make_shared<Asset>(pluginPath + "/" + TSSvgAssetPaths[id]);
+			numLoads++;
+		}
+		return _svgs[id];
+	}
+	const AssetPtr& font(TSFontAsset id)
+	{
+		if (!_fonts[id])
+		{
+			_fonts[id] = std::make_shared<Asset>(pluginPath + "/" + TSFontAssetPaths[id]);
+			numLoads++;
+		}
+		return _fonts[id];
+	}
+};
+
+// The asset requests of one trigSeq64 widget (the widgets keep the handles).
+template <class L>
+static void buildTrigSeq64(L* loader, std::vector<AssetPtr>* widget)
+{
+	widget->push_back(loader->svg(TS_SVG_PANEL_TRIGSEQ));
+	for (int i = 0; i < 3; i++)
+	{
+		// Run, reset, paste (TS_PadBtn, 2 frames) and their TS_LightString
+		widget->push_back(loader->svg(TS_SVG_PAD_BTN_0));
+		widget->push_back(loader->svg(TS_SVG_PAD_BTN_1));
+		widget->push_back(loader->font(TS_FONT_LABEL));
+	}
+	for (int i = 0; i < 5 + 16; i++)
+		widget->push_back(loader->svg(TS_SVG_PORT)); // Inputs and channel outputs (TS_Port)
+	for (int p = 0; p < 4; p++)
+		widget->push_back(loader->font(TS_FONT_LABEL)); // Page TS_LightString
+	widget->push_back(loader->font(TS_FONT_DIGITAL)); // TSSeqDisplay
+	widget->push_back(loader->font(TS_FONT_LABEL));
+	widget->push_back(loader->font(TS_FONT_LABEL)); // TSSeqLabelArea
+	widget->push_back(loader->font(TS_FONT_LABEL)); // TSOSCConfigWidget
+	return;
+}
+
+// Open a patch with numWidgets trigSeq64s (all kept). Returns us and the number of file loads.
+template <class L>
+static double openPatch(int numWidgets, int* loads)
+{
+	L loader;
+	std::vector<std::vector<AssetPtr>> widgets(numWidgets);
+	numLoads = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < numWidgets; i++)
+		buildTrigSeq64(&loader, &widgets[i]);
+	auto t1 = std::chrono::steady_clock::now();
+	*loads = numLoads;
+	return std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+// Add a trigSeq64 and delete it again, numTimes times (nothing else holds the assets).
+template <class L>
+static double addRemove(int numTimes, int* loads)
+{
+	L loader;
+	numLoads = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < numTimes; i++)
+	{
+		std::vector<AssetPtr> widget;
+		buildTrigSeq64(&loader, &widget);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	*loads = numLoads;
+	return std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		pluginPath = argv[1];
+	int numWidgets = (argc > 2) ? atoi(argv[2]) : 50;
+	int numAddRemove = (argc > 3) ? atoi(argv[3]) : 1000;
+	if (numWidgets < 1)
+		numWidgets = 1;
+	if (numAddRemove < 1)
+		numAddRemove = 1;
+	int loadsOld, loadsNew;
+	// Warm the file system cache so both see the same disk state.
+	openPatch<NewLoader>(1, &loadsNew);
+
+	double tOld = openPatch<OldLoader>(numWidgets, &loadsOld);
+	double tNew = openPatch<NewLoader>(numWidgets, &loadsNew);
+	printf("Open a patch with %d trigSeq64:\n", numWidgets);
+	printf("  old %9.1f us (%d file loads)  TSAssets %9.1f us (%d file loads)\n", tOld, loadsOld, tNew, loadsNew);
+	// Again with the loads out of it (everything already cached): just the per-request cost.
+	{
+		OldLoader oldLoader;
+		NewLoader newLoader;
+		std::vector<AssetPtr> keep;
+		buildTrigSeq64(&oldLoader, &keep);
+		buildTrigSeq64(&newLoader, &keep);
+		std::vector<std::vector<AssetPtr>> widgets(numWidgets * 2);
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < numWidgets; i++)
+			buildTrigSeq64(&oldLoader, &widgets[i]);
+		auto t1 = std::chrono::steady_clock::now();
+		for (int i = 0; i < numWidgets; i++)
+			buildTrigSeq64(&newLoader, &widgets[numWidgets + i]);
+		auto t2 = std::chrono::steady_clock::now();
+		printf("  cached requests only: old %.2f us/widget  TSAssets %.2f us/widget (%d requests/widget)\n",
+			std::chrono::duration<double, std::micro>(t1 - t0).count() / numWidgets,
+			std::chrono::duration<double, std::micro>(t2 - t1).count() / numWidgets, (int)widgets[0].size());
+	}
+	tOld = addRemove<OldLoader>(numAddRemove, &loadsOld);
+	tNew = addRemove<NewLoader>(numAddRemove, &loadsNew);
+	printf("Add and delete a trigSeq64 %d times:\n", numAddRemove);
+	printf("  old %9.1f us (%d file loads)  TSAssets %9.1f us (%d file loads)\n", tOld, loadsOld, tNew, loadsNew);
+	return 0;
+}
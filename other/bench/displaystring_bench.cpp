@@ -0,0 +1,154 @@
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// displaystring_bench
+// Checks the voltSeq display strings (PATT lookup table, VOLT FormatFixed(),
+// NOTE label table) against the sprintf() output they replaced, and times both.
+// The formatting is src/TSDisplayFormat (what ValueSequencerMode and
+// NoteValueSequencerMode use); the voltage to display value translation is
+// ValueSequencerMode's. Mode ranges and formats are the ones from Module_voltSeq.hpp.
+// Build: g++ -O2 -std=c++11 other/bench/displaystring_bench.cpp src/TSDisplayFormat.cpp -o displaystring_bench
+// Usage: displaystring_bench [numValues]  (exit code 1 on any mismatch)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "../../src/TSDisplayFormat.hpp"
+
+#define TROWA_SEQ_NUM_PATTERNS		64 // Number of patterns for sequencers.
+inline float rescalef(float x, float xMin, float xMax, float yMin, float yMax) { return yMin + (x - xMin) / (xMax - xMin) * (yMax - yMin); }
+
+// A ValueSequencerMode's display value translation around a TSDisplayFormat.
+struct DisplayMode
+{
+	float voltageMin = -10;
+	float voltageMax = 10;
+	float minDisplayValue;
+	float maxDisplayValue;
+	bool needsTranslationDisplay;
+	float roundNearestDisplay = 0;
+	const char* displayFormatString;
+	TSDisplayFormat displayFormat;
+
+	DisplayMode(float minDisplayValue, float maxDisplayValue, const char* formatStr)
+	{
+		this->minDisplayValue = minDisplayValue;
+		this->maxDisplayValue = maxDisplayValue;
+		this->displayFormatString = formatStr;
+		needsTranslationDisplay = minDisplayValue != voltageMin || maxDisplayValue != voltageMax;
+		displayFormat.init(displayFormatString, minDisplayValue, maxDisplayValue);
+	}
+	float displayValue(float val)
+	{
+		float dVal = val;
+		if (needsTranslationDisplay)
+			dVal = rescalef(val, voltageMin, voltageMax, minDisplayValue, maxDisplayValue);
+		if (roundNearestDisplay > 0)
+			dVal = static_cast<int>(dVal  / roundNearestDisplay) * roundNearestDisplay;
+		return dVal;
+	}
+	void GetDisplayString(float val, char* buffer)
+	{
+		displayFormat.format(displayValue(val), buffer);
+	}
+	// Before: always sprintf().
+	void GetDisplayStringOld(float val, char* buffer)
+	{
+		sprintf(buffer, displayFormatString, displayValue(val));
+	}
+};
+// NoteValueSequencerMode's labels.
+struct NoteDisplayMode
+{
+	TSNoteLabels noteLabels;
+	void GetDisplayString(float val, char* buffer)
+	{
+		noteLabels.format(val, buffer);
+	}
+	// Before: always sprintf().
+	void GetDisplayStringOld(float val, char* buffer)
+	{
+		sprintf(buffer, "%s%d", TROWA_NOTES[TSNoteLabels::noteIx(val)], VoltsToOctave(val));
+	}
+};
+
+
+template <class T>
+static int check(const char* name, T* mode, const std::vector<float>& vals)
+{
+	char a[TROWA_DISP_MSG_SIZE], b[TROWA_DISP_MSG_SIZE];
+	int mismatches = 0;
+	for (size_t i = 0; i < vals.size(); i++)
+	{
+		mode->GetDisplayStringOld(vals[i], a);
+		mode->GetDisplayString(vals[i], b);
+		if (strcmp(a, b))
+		{
+			if (mismatches < 10)
+				printf("%s mismatch at %.9g: sprintf \"%s\" new \"%s\"\n", name, vals[i], a, b);
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+template <class T>
+static void timeIt(const char* name, T* mode, const std::vector<float>& vals, unsigned* checksum)
+{
+	char buffer[TROWA_DISP_MSG_SIZE];
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < vals.size(); i++)
+	{
+		mode->GetDisplayStringOld(vals[i], buffer);
+		*checksum += buffer[0];
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < vals.size(); i++)
+	{
+		mode->GetDisplayString(vals[i], buffer);
+		*checksum += buffer[0];
+	}
+	auto t2 = std::chrono::steady_clock::now();
+	double tOld = std::chrono::duration<double, std::nano>(t1 - t0).count() / vals.size();
+	double tNew = std::chrono::duration<double, std::nano>(t2 - t1).count() / vals.size();
+	printf("%s  sprintf %6.1f ns  new %6.1f ns  (%.1fx)\n", name, tOld, tNew, tOld / tNew);
+}
+
+int main(int argc, char* argv[])
+{
+	int numValues = (argc > 1) ? atoi(argv[1]) : 2000000;
+	if (numValues < 1)
+		numValues = 1;
+	DisplayMode volt(-10, 10, "%04.2f");
+	DisplayMode patt(1, TROWA_SEQ_NUM_PATTERNS, "%02.0f");
+	NoteDisplayMode note;
+
+	// Random knob values plus the edges, -0 and the display ties (x.xx5 for VOLT, x.5 for PATT).
+	std::mt19937 rng(12345);
+	std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+	std::vector<float> vals;
+	for (int i = 0; i < numValues; i++)
+		vals.push_back(dist(rng));
+	std::vector<float> edges = { -10.0f, 10.0f, 0.0f, -0.0f, -0.001f, 0.001f };
+	for (int i = -2000; i <= 2000; i++)
+		edges.push_back((i + 0.5f) / 200.0f);
+	for (int i = 1; i < TROWA_SEQ_NUM_PATTERNS; i++)
+		edges.push_back(rescalef(i + 0.5f, 1, TROWA_SEQ_NUM_PATTERNS, -10, 10));
+	std::vector<float> checkVals = vals;
+	checkVals.insert(checkVals.end(), edges.begin(), edges.end());
+
+	int mismatches = check("VOLT", &volt, checkVals) + check("PATT", &patt, checkVals) + check("NOTE", &note, checkVals);
+
+	unsigned checksum = 0;
+	printf("%d values per mode, per call:\n", numValues);
+	timeIt("VOLT", &volt, vals, &checksum);
+	timeIt("PATT", &patt, vals, &checksum);
+	timeIt("NOTE", &note, vals, &checksum);
+	printf("Checked %d values per mode, mismatches: %d (checksum %u)\n", (int)checkVals.size(), mismatches, checksum);
+	return (mismatches) ? 1 : 0;
+}
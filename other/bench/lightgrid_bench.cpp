@@ -0,0 +1,303 @@
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// lightgrid_bench
+// Draw time of the step lights of 20 trigSeq64s (1280 pads) with lights fading
+// like the sequencer does (fire timestamp + exponential decay):
+//   perLight    : every light draws itself (TS_LightSquare::draw()).
+//   exactAlpha  : TS_LightSquareGrid grouped by rgb + exact alpha (every fading pad is its own group).
+//   alphaLevels : TS_LightSquareGrid grouped by rgb + TS_LIGHTGRID_ALPHA_LEVELS alpha levels (what we ship).
+// Standalone (no plugin code, the drawing is copied), needs an OpenGL 2 context.
+// Build against Rack's deps, e.g. from the Rack folder:
+//   g++ -O2 -std=c++11 -Idep/include -Idep/nanovg/src plugins/trowaSoft-VCV/other/bench/lightgrid_bench.cpp -Ldep/lib -lglfw -lGLEW -lGL -o lightgrid_bench
+// Usage: lightgrid_bench [frames]
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "nanovg.h"
+#define NANOVG_GL2_IMPLEMENTATION
+#include "nanovg_gl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <chrono>
+
+#define NUM_SEQUENCERS		20
+#define NUM_ROWS			8
+#define NUM_COLS			8
+#define PAD_SIZE			24.0f
+#define PAD_SPACING			29.0f
+#define CORNER_RADIUS		3.0f
+#define SPRITE_OVERSAMPLE	2
+#define ALPHA_LEVELS		16
+// Light decay (TSSequencerModuleBase: lights fall to ~0 in about 0.2 s, 60 fps here).
+#define DECAY_PER_FRAME		0.35f
+// A step fires every this many frames (about 150 BPM 16ths).
+#define FRAMES_PER_STEP		6
+
+struct Light {
+	float x, y;
+	float r, g, b, a;
+};
+struct Sequencer {
+	float x, y;
+	float r, g, b;
+	// Frame each step last fired at (-1 never).
+	int fired[NUM_ROWS * NUM_COLS];
+	// Steps that are on (drawn at a steady 0.25 like an active step that isn't playing).
+	bool on[NUM_ROWS * NUM_COLS];
+	int phase;
+};
+
+static float clampf(float x, float a, float b) { return (x < a) ? a : (x > b) ? b : x; }
+
+// Same as TS_LightGrid::colorKey(). mode 0: rgb only, 1: exact alpha (7 bits, before), 2: alpha levels.
+static uint32_t colorKey(const Light& l, int mode)
+{
+	uint32_t key = ((uint32_t)(clampf(l.r, 0, 1) * 255 + 0.5f) << 24)
+		| ((uint32_t)(clampf(l.g, 0, 1) * 255 + 0.5f) << 16)
+		| ((uint32_t)(clampf(l.b, 0, 1) * 255 + 0.5f) << 8);
+	if (mode == 1)
+		key |= ((uint32_t)(clampf(l.a, 0, 1) * 127 + 0.5f) << 1);
+	else if (mode == 2)
+		key |= ((uint32_t)(int)(clampf(l.a, 0, 1) * (ALPHA_LEVELS - 1) + 0.5f) << 1);
+	return key | 1;
+}
+static float drawAlpha(float a, int mode)
+{
+	return (mode == 2) ? (int)(clampf(a, 0, 1) * (ALPHA_LEVELS - 1) + 0.5f) / (float)(ALPHA_LEVELS - 1) : a;
+}
+
+// Advance the sequencers and fill in the light colors.
+static void updateLights(std::vector<Sequencer>& seqs, std::vector<Light>& lights, int frame)
+{
+	int n = NUM_ROWS * NUM_COLS;
+	for (int s = 0; s < (int)seqs.size(); s++)
+	{
+		Sequencer& seq = seqs[s];
+		if ((frame + seq.phase) % FRAMES_PER_STEP == 0)
+		{
+			int step = ((frame + seq.phase) / FRAMES_PER_STEP) % n;
+			if (seq.on[step])
+				seq.fired[step] = frame;
+		}
+		for (int i = 0; i < n; i++)
+		{
+			Light& l = lights[s * n + i];
+			float a = (seq.on[i]) ? 0.25f : 0.0f;
+			if (seq.fired[i] >= 0)
+				a += 0.75f * expf(-(frame - seq.fired[i]) * DECAY_PER_FRAME);
+			l.r = seq.r; l.g = seq.g; l.b = seq.b;
+			l.a = (a < 0.002f) ? 0 : a;
+		}
+	}
+	return;
+}
+
+// Signed distance to a rounded rect (the sprite bake in TS_LightSquareGrid::getSprite()).
+static float sdRoundRect(float x, float y, float ex, float ey, float rad)
+{
+	float dx = fabsf(x) - (ex - rad);
+	float dy = fabsf(y) - (ey - rad);
+	float ox = (dx > 0) ? dx : 0;
+	float oy = (dy > 0) ? dy : 0;
+	float in = (dx > dy) ? dx : dy;
+	return ((in < 0) ? in : 0) + sqrtf(ox*ox + oy*oy) - rad;
+}
+static int getSprite(NVGcontext* vg, std::map<uint32_t, int>& sprites, const Light& l)
+{
+	uint32_t key = colorKey(l, 0);
+	std::map<uint32_t, int>::iterator it = sprites.find(key);
+	if (it != sprites.end())
+		return it->second;
+	int w = (int)ceilf(PAD_SPACING * SPRITE_OVERSAMPLE);
+	float oradius = PAD_SIZE / 2.0f * 1.1f;
+	std::vector<uint8_t> pixels(w * w * 4);
+	for (int py = 0; py < w; py++)
+	{
+		for (int px = 0; px < w; px++)
+		{
+			float x = (px + 0.5f) / SPRITE_OVERSAMPLE - PAD_SPACING / 2.0f;
+			float y = (py + 0.5f) / SPRITE_OVERSAMPLE - PAD_SPACING / 2.0f;
+			float sd = sdRoundRect(x, y, oradius, oradius, CORNER_RADIUS);
+			float d = clampf((sd + 1.0f) / 2.0f, 0, 1);
+			float a = 0.25f * (1.0f - d) * clampf(0.5f - sd * SPRITE_OVERSAMPLE, 0, 1);
+			uint8_t* p = &(pixels[(py * w + px) * 4]);
+			p[0] = (uint8_t)(l.r * 255); p[1] = (uint8_t)(l.g * 255); p[2] = (uint8_t)(l.b * 255);
+			p[3] = (uint8_t)(a * 255 + 0.5f);
+		}
+	}
+	int handle = nvgCreateImageRGBA(vg, w, w, NVG_IMAGE_REPEATX | NVG_IMAGE_REPEATY, pixels.data());
+	sprites[key] = handle;
+	return handle;
+}
+
+// TS_LightSquare::draw() for every light. Returns the number of fills + strokes.
+static int drawPerLight(NVGcontext* vg, const std::vector<Light>& lights)
+{
+	NVGcolor bg = nvgRGBA(0, 0, 0, 128);
+	NVGcolor border = nvgRGBA(0, 0, 0, 64);
+	float radius = PAD_SIZE / 2.0f;
+	float oradius = radius * 1.1f;
+	int calls = 0;
+	for (int i = 0; i < (int)lights.size(); i++)
+	{
+		const Light& l = lights[i];
+		nvgSave(vg);
+		nvgTranslate(vg, l.x, l.y);
+		nvgBeginPath(vg);
+		nvgRoundedRect(vg, 0, 0, PAD_SIZE, PAD_SIZE, CORNER_RADIUS);
+		nvgFillColor(vg, bg);
+		nvgFill(vg);
+		nvgStrokeWidth(vg, 1.0f);
+		nvgStrokeColor(vg, border);
+		nvgStroke(vg);
+		calls += 2;
+		if (l.a > 0)
+		{
+			nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
+			nvgFillColor(vg, nvgRGBAf(l.r, l.g, l.b, l.a));
+			nvgFill(vg);
+			nvgBeginPath(vg);
+			nvgRoundedRect(vg, radius - oradius, radius - oradius, 2 * oradius, 2 * oradius, CORNER_RADIUS);
+			NVGpaint paint = nvgBoxGradient(vg, radius - oradius, radius - oradius, 2 * oradius, 2 * oradius, CORNER_RADIUS, 2,
+				nvgRGBAf(l.r, l.g, l.b, l.a * 0.25f), nvgRGBAf(l.r, l.g, l.b, 0));
+			nvgFillPaint(vg, paint);
+			nvgFill(vg);
+			calls += 2;
+		}
+		nvgRestore(vg);
+	}
+	return calls;
+}
+
+// TS_LightSquareGrid::draw() (backgrounds are a cached layer there, so one fill here). Returns the number of fills + strokes.
+static int drawGrid(NVGcontext* vg, const std::vector<Light>& lights, int mode, std::map<uint32_t, int>& sprites)
+{
+	int n = (int)lights.size();
+	int calls = 0;
+	// Cached background (an image fill in the plugin)
+	nvgBeginPath(vg);
+	nvgRect(vg, 0, 0, 1, 1);
+	nvgFillColor(vg, nvgRGBA(0, 0, 0, 128));
+	nvgFill(vg);
+	calls++;
+	// Group
+	std::vector<uint32_t> keys(n);
+	for (int i = 0; i < n; i++)
+		keys[i] = (drawAlpha(lights[i].a, mode) > 0) ? colorKey(lights[i], mode) : 0;
+	std::vector<uint8_t> done(n);
+	for (int i = 0; i < n; i++)
+		done[i] = (keys[i] == 0);
+	std::vector<int> order;
+	float margin = (PAD_SPACING - PAD_SIZE) / 2.0f;
+	nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
+	for (int i = 0; i < n; i++)
+	{
+		if (done[i])
+			continue;
+		order.clear();
+		for (int j = i; j < n; j++)
+		{
+			if (!done[j] && keys[j] == keys[i])
+			{
+				done[j] = 1;
+				order.push_back(j);
+			}
+		}
+		const Light& l = lights[i];
+		float a = drawAlpha(l.a, mode);
+		nvgBeginPath(vg);
+		for (int j = 0; j < (int)order.size(); j++)
+			nvgRoundedRect(vg, lights[order[j]].x, lights[order[j]].y, PAD_SIZE, PAD_SIZE, CORNER_RADIUS);
+		nvgFillColor(vg, nvgRGBAf(l.r, l.g, l.b, a));
+		nvgFill(vg);
+		nvgBeginPath(vg);
+		for (int j = 0; j < (int)order.size(); j++)
+			nvgRect(vg, lights[order[j]].x - margin, lights[order[j]].y - margin, PAD_SPACING, PAD_SPACING);
+		NVGpaint paint = nvgImagePattern(vg, lights[0].x - margin, lights[0].y - margin, PAD_SPACING, PAD_SPACING, 0,
+			getSprite(vg, sprites, l), a);
+		nvgFillPaint(vg, paint);
+		nvgFill(vg);
+		calls += 2;
+	}
+	nvgGlobalCompositeOperation(vg, NVG_SOURCE_OVER);
+	return calls;
+}
+
+int main(int argc, char** argv)
+{
+	int frames = (argc > 1) ? atoi(argv[1]) : 600;
+	if (!glfwInit())
+	{
+		fprintf(stderr, "glfwInit() failed.\n");
+		return 1;
+	}
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	int width = 1400, height = 1200;
+	GLFWwindow* window = glfwCreateWindow(width, height, "lightgrid_bench", NULL, NULL);
+	if (!window)
+	{
+		fprintf(stderr, "No OpenGL window.\n");
+		glfwTerminate();
+		return 1;
+	}
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+	glewExperimental = GL_TRUE;
+	glewInit();
+	NVGcontext* vg = nvgCreateGL2(NVG_ANTIALIAS);
+
+	// 20 trigSeq64s in 4 rows of 5, one channel color each.
+	const float colors[8][3] = { {1,0,0}, {0,1,0}, {0,0.6f,1}, {1,1,0}, {1,0,1}, {0,1,1}, {1,0.5f,0}, {1,1,1} };
+	std::vector<Sequencer> seqs(NUM_SEQUENCERS);
+	std::vector<Light> lights(NUM_SEQUENCERS * NUM_ROWS * NUM_COLS);
+	srand(1);
+	for (int s = 0; s < NUM_SEQUENCERS; s++)
+	{
+		Sequencer& seq = seqs[s];
+		seq.x = (s % 5) * (NUM_COLS * PAD_SPACING + 40);
+		seq.y = (s / 5) * (NUM_ROWS * PAD_SPACING + 40);
+		seq.r = colors[s % 8][0]; seq.g = colors[s % 8][1]; seq.b = colors[s % 8][2];
+		seq.phase = rand() % FRAMES_PER_STEP;
+		for (int i = 0; i < NUM_ROWS * NUM_COLS; i++)
+		{
+			seq.fired[i] = -1;
+			seq.on[i] = (rand() % 3) == 0;
+			Light& l = lights[s * NUM_ROWS * NUM_COLS + i];
+			l.x = seq.x + (i % NUM_COLS) * PAD_SPACING;
+			l.y = seq.y + (i / NUM_COLS) * PAD_SPACING;
+		}
+	}
+
+	const char* names[] = { "perLight", "exactAlpha", "alphaLevels" };
+	std::map<uint32_t, int> sprites;
+	printf("%d sequencers, %d lights, %d frames\n", NUM_SEQUENCERS, (int)lights.size(), frames);
+	for (int mode = -1; mode <= 2; mode++)
+	{
+		if (mode == 0)
+			continue;
+		std::vector<Sequencer> s = seqs;
+		long calls = 0;
+		double ms = 0;
+		for (int f = 0; f < frames; f++)
+		{
+			updateLights(s, lights, f);
+			std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+			glViewport(0, 0, width, height);
+			glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+			nvgBeginFrame(vg, width, height, 1.0f);
+			calls += (mode < 0) ? drawPerLight(vg, lights) : drawGrid(vg, lights, mode, sprites);
+			nvgEndFrame(vg);
+			glFinish();
+			ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+		}
+		printf("%-12s %8.3f ms/frame %8.1f fills+strokes/frame\n", names[(mode < 0) ? 0 : mode], ms / frames, calls / (double)frames);
+	}
+	nvgDeleteGL2(vg);
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return 0;
+}
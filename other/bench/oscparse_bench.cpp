@@ -0,0 +1,240 @@
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// oscparse_bench
+// Receive path parse cost: oscpack's ReceivedPacket/ReceivedMessage (throws
+// osc::Exception on anything malformed) vs TSOSCMessage/TSOSCBundleReader
+// (validated in one pass, status codes). Each is run over a corpus of good
+// packets and a corpus of bad ones (truncated, bad sizes, bad addresses/type
+// tags, bad bundle element sizes, NaN/inf/out of range numbers).
+// "ok" counts differ on the bad corpus: oscpack doesn't check for the leading
+// '/', and TSOSCMessage::getInt() clamps inf/out of range numbers instead of failing.
+// Valid packets cost about the same with both (TSOSCMessage validates up front, then
+// lays the arguments out unchecked); the gap is on bad packets, where oscpack throws.
+// Build from the plugin folder:
+//   g++ -O2 -std=c++11 -Ilib/oscpack other/bench/oscparse_bench.cpp src/TSOSCCommon.cpp lib/oscpack/osc/OscReceivedElements.cpp lib/oscpack/osc/OscOutboundPacketStream.cpp lib/oscpack/osc/OscTypes.cpp -o oscparse_bench
+// Usage: oscparse_bench [iterations]  (per run; the best of NUM_RUNS runs is reported)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "osc/OscReceivedElements.h"
+#include "osc/OscOutboundPacketStream.h"
+#include "../../src/TSOSCCommon.hpp"
+
+#define BUFFER_SIZE		1024
+
+typedef std::vector<char> Packet;
+
+// Sum of everything read (so nothing is optimized away).
+static long sink = 0;
+
+//--------------------------------------------------------
+// oscpack: read ints as ints, floats as floats (like the old listener), anything else throws.
+//--------------------------------------------------------
+static void readOscpack(const osc::ReceivedPacket& p)
+{
+	if (p.IsBundle())
+	{
+		osc::ReceivedBundle b(p);
+		for (osc::ReceivedBundle::const_iterator it = b.ElementsBegin(); it != b.ElementsEnd(); ++it)
+			readOscpack(osc::ReceivedPacket(it->Contents(), it->Size()));
+	}
+	else
+	{
+		osc::ReceivedMessage m(p);
+		sink += strlen(m.AddressPattern());
+		for (osc::ReceivedMessage::const_iterator arg = m.ArgumentsBegin(); arg != m.ArgumentsEnd(); ++arg)
+		{
+			if (arg->IsString())
+				sink += arg->AsString()[0];
+			else if (arg->IsInt32())
+				sink += arg->AsInt32();
+			else
+			{
+				float f = arg->AsFloat();
+				if (f != f || fabsf(f) > 2147483520.0f)
+					throw osc::Exception("bad number");
+				sink += (int)f;
+			}
+		}
+	}
+	return;
+}
+static bool parseOscpack(const Packet& packet)
+{
+	try
+	{
+		readOscpack(osc::ReceivedPacket(packet.data(), (osc::osc_bundle_element_size_t)packet.size()));
+		return true;
+	}
+	catch (const osc::Exception&)
+	{
+		return false;
+	}
+}
+
+//--------------------------------------------------------
+// TSOSCMessage: same reads, nothing throws.
+//--------------------------------------------------------
+static bool readTS(const char* data, int size, int depth)
+{
+	if (TSOSCIsBundle(data, size))
+	{
+		if (depth >= TSOSC_MAX_BUNDLE_DEPTH)
+			return false;
+		TSOSCBundleReader reader;
+		if (reader.init(data, size) != TSOSC_PARSE_OK)
+			return false;
+		const char* element = NULL;
+		int elementSize = 0;
+		bool ok = true;
+		while (ok && reader.next(&element, &elementSize))
+			ok = readTS(element, elementSize, depth + 1);
+		return ok && reader.status == TSOSC_PARSE_OK;
+	}
+	TSOSCMessage m;
+	if (m.parse(data, size) != TSOSC_PARSE_OK)
+		return false;
+	sink += m.addressLength;
+	for (int i = 0; i < m.numArgs; i++)
+	{
+		const char* s = NULL;
+		int v = 0;
+		if (m.getString(i, &s) == TSOSC_PARSE_OK)
+			sink += s[0];
+		else if (m.getInt(i, &v) == TSOSC_PARSE_OK)
+			sink += v;
+		else
+			return false;
+	}
+	return true;
+}
+static bool parseTS(const Packet& packet)
+{
+	return readTS(packet.data(), (int)packet.size(), 0);
+}
+
+//--------------------------------------------------------
+// Corpora
+//--------------------------------------------------------
+static Packet toPacket(const osc::OutboundPacketStream& s)
+{
+	return Packet(s.Data(), s.Data() + s.Size());
+}
+static void makeCorpora(std::vector<Packet>& good, std::vector<Packet>& bad)
+{
+	char buffer[BUFFER_SIZE];
+	{
+		osc::OutboundPacketStream s(buffer, BUFFER_SIZE);
+		s << osc::BeginMessage("/tsseq/play") << 1 << osc::EndMessage;
+		good.push_back(toPacket(s));
+	}
+	{
+		osc::OutboundPacketStream s(buffer, BUFFER_SIZE);
+		s << osc::BeginMessage("/tsseq/step/val/12/3") << 1 << 0.75f << osc::EndMessage;
+		good.push_back(toPacket(s));
+	}
+	{
+		osc::OutboundPacketStream s(buffer, BUFFER_SIZE);
+		s << osc::BeginMessage("/tsseq/bpm") << 120.0f << osc::EndMessage;
+		good.push_back(toPacket(s));
+	}
+	{
+		osc::OutboundPacketStream s(buffer, BUFFER_SIZE);
+		s << osc::BeginMessage("/tsseq/pat") << "next" << 4 << osc::EndMessage;
+		good.push_back(toPacket(s));
+	}
+	{
+		osc::OutboundPacketStream s(buffer, BUFFER_SIZE);
+		s << osc::BeginBundleImmediate;
+		for (int i = 0; i < 8; i++)
+			s << osc::BeginMessage("/tsseq/step/val") << i << (float)i / 8 << osc::EndMessage;
+		s << osc::EndBundle;
+		good.push_back(toPacket(s));
+	}
+
+	// Bad: truncated (last argument cut off)
+	Packet p = good[1];
+	p.resize(p.size() - 4);
+	bad.push_back(p);
+	// Bad: size not a multiple of 4
+	p = good[0];
+	p.push_back(0);
+	bad.push_back(p);
+	// Bad: no leading '/'
+	p = good[0];
+	p[0] = 'x';
+	bad.push_back(p);
+	// Bad: address not terminated
+	p = good[2];
+	for (int i = 0; i < (int)p.size(); i++)
+		p[i] = (p[i] == 0) ? 'a' : p[i];
+	bad.push_back(p);
+	// Bad: unknown type tag
+	p = good[0];
+	for (int i = 1; i + 1 < (int)p.size(); i++)
+	{
+		if (p[i] == ',' && p[i + 1] == 'i')
+		{
+			p[i + 1] = 'z';
+			break;
+		}
+	}
+	bad.push_back(p);
+	// Bad: bundle element size runs past the end
+	p = good[4];
+	p[16] = 0x7f;
+	bad.push_back(p);
+	// Bad numbers: NaN, inf, out of the int range
+	const float numbers[] = { NAN, INFINITY, -INFINITY, 1e20f };
+	for (int i = 0; i < 4; i++)
+	{
+		osc::OutboundPacketStream s(buffer, BUFFER_SIZE);
+		s << osc::BeginMessage("/tsseq/step/val/1/1") << numbers[i] << osc::EndMessage;
+		bad.push_back(toPacket(s));
+	}
+	return;
+}
+
+// Number of timed runs (the best one is reported, so other load on the machine doesn't count).
+#define NUM_RUNS		7
+
+//--------------------------------------------------------
+// Time parsing the corpus n times, NUM_RUNS times.
+//--------------------------------------------------------
+static void run(const char* name, const std::vector<Packet>& corpus, bool (*parse)(const Packet&), int n)
+{
+	int ok = 0;
+	double best = 0;
+	for (int r = 0; r < NUM_RUNS; r++)
+	{
+		ok = 0;
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		for (int it = 0; it < n; it++)
+		{
+			for (int i = 0; i < (int)corpus.size(); i++)
+				ok += parse(corpus[i]) ? 1 : 0;
+		}
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+		if (r == 0 || ns < best)
+			best = ns;
+	}
+	printf("%-20s %8.1f ns/packet  %d/%d ok\n", name, best / ((double)n * corpus.size()), ok / n, (int)corpus.size());
+	return;
+}
+
+int main(int argc, char** argv)
+{
+	int n = (argc > 1) ? atoi(argv[1]) : 50000;
+	std::vector<Packet> good, bad;
+	makeCorpora(good, bad);
+	run("oscpack good", good, parseOscpack, n);
+	run("TSOSCMessage good", good, parseTS, n);
+	run("oscpack bad", bad, parseOscpack, n);
+	run("TSOSCMessage bad", bad, parseTS, n);
+	printf("(%ld)\n", sink);
+	return 0;
+}
@@ -0,0 +1,161 @@
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// scopetransform_bench
+// Times the multiScope point transform: the old per-point loop (modulo index,
+// double rotation, a location code per point) against the block transform +
+// bulk location codes, and checks that both give the same points. Runs a sweep
+// of buffer sizes (512, the multiScope BUFFER_SIZE, up to 64k points) with the
+// same number of points per size.
+// The kernels are src/TSScopeTransform (what TSScopeBase / multiScope use).
+// Build (Rack plugin flags): g++ -O3 -march=nocona -funsafe-math-optimizations -std=c++11 other/bench/scopetransform_bench.cpp src/TSScopeTransform.cpp -o scopetransform_bench
+// Usage: scopetransform_bench [numFrames at 512 points]  (exit code 1 on any mismatch)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+
+#include "../../src/TSScopeTransform.hpp"
+
+#define MIN_BUFFER_SIZE		512
+#define MAX_BUFFER_SIZE		(64*1024)
+
+// Old per-point transform (Module_multiScope.cpp before the block transform, without the clipping).
+// Flip was done afterwards with nvgScale(), so it is not applied here.
+static void oldTransform(const float* valX, const float* valY, int n, int startIx,
+	float gainX, float gainY, float offsetX, float offsetY, float width, float height,
+	float c, float s, float minX, float maxX, float minY, float maxY,
+	float* outX, float* outY, uint8_t* codes)
+{
+	float ox = width / 2.0; // Center of box
+	float oy = height / 2.0;
+	for (int i = 0; i < n; i++)
+	{
+		int j = (i + startIx) % n;
+		float x, y;
+		if (valY) {
+			x = ((valX[j] + offsetX) * gainX) / 2.0 + 0.5;
+			y = ((valY[j] + offsetY) * gainY) / 2.0 + 0.5;
+		}
+		else {
+			x = (float)i / (n - 1);
+			y = ((valX[j] + offsetX) * gainX) / 2.0 + 0.5;
+		}
+		float px = width * x;
+		float py = height * (1.0 - y);
+		double dx = px - ox;
+		double dy = py - oy;
+		px = ox + dx * c - dy * s;
+		py = oy + dx * s + dy * c;
+		outX[i] = px;
+		outY[i] = py;
+		codes[i] = TSScopePointLocationCode(px, py, minX, maxX, minY, maxY);
+	}
+	return;
+}
+
+// New path: two block calls around the ring buffer wrap, then the bulk codes (as in Module_multiScope.cpp).
+static void newTransform(const float* valX, const float* valY, int n, int startIx,
+	float gainX, float gainY, float offsetX, float offsetY, float width, float height,
+	float c, float s, float minX, float maxX, float minY, float maxY,
+	float* outX, float* outY, uint8_t* codes)
+{
+	int n1 = n - startIx;
+	TSScopeTransformBlock(valX + startIx, (valY) ? valY + startIx : NULL, n1, /*drawIxStart*/ 0, n,
+		gainX, gainY, offsetX, offsetY, width, height, c, s, false, false, outX, outY);
+	if (startIx > 0)
+	{
+		TSScopeTransformBlock(valX, (valY) ? valY : NULL, startIx, /*drawIxStart*/ n1, n,
+			gainX, gainY, offsetX, offsetY, width, height, c, s, false, false, outX + n1, outY + n1);
+	}
+	TSScopeLocationCodeBlock(outX, outY, n, minX, maxX, minY, maxY, codes);
+	return;
+}
+
+typedef void (*TransformFn)(const float*, const float*, int, int, float, float, float, float, float, float,
+	float, float, float, float, float, float, float*, float*, uint8_t*);
+
+static std::vector<float> valX(MAX_BUFFER_SIZE);
+static std::vector<float> valY(MAX_BUFFER_SIZE);
+static std::vector<float> outX(MAX_BUFFER_SIZE);
+static std::vector<float> outY(MAX_BUFFER_SIZE);
+static std::vector<uint8_t> codes(MAX_BUFFER_SIZE);
+
+// Run numFrames frames of n points, returns ns per point. Accumulates a checksum so nothing is optimized away.
+static double timeIt(TransformFn fn, int n, bool lissajous, int numFrames, double* checksum)
+{
+	const float w = 400, h = 380;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int f = 0; f < numFrames; f++)
+	{
+		float rot = 0.001f * f;
+		fn(valX.data(), (lissajous) ? valY.data() : NULL, n, (lissajous) ? f % n : 0, 0.2f, 0.2f, 0.0f, 0.0f, w, h,
+			cosf(rot), sinf(rot), 0, w, 0, h, outX.data(), outY.data(), codes.data());
+		*checksum += outX[f % n] + codes[(f * 7) % n];
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)numFrames * n);
+}
+
+// Check the two give the same points (within float vs double rounding) and codes (away from the edges).
+static int check(int n)
+{
+	int mismatches = 0;
+	std::vector<float> oX(n), oY(n);
+	std::vector<uint8_t> oC(n);
+	for (int l = 0; l < 2; l++)
+	{
+		for (int startIx = 0; startIx < n; startIx += n / 13 + 1)
+		{
+			float c = cosf(0.3f), s = sinf(0.3f);
+			oldTransform(valX.data(), (l) ? valY.data() : NULL, n, startIx, 0.2f, 0.2f, 0.5f, -0.5f, 400, 380, c, s, 0, 400, 0, 380, oX.data(), oY.data(), oC.data());
+			newTransform(valX.data(), (l) ? valY.data() : NULL, n, startIx, 0.2f, 0.2f, 0.5f, -0.5f, 400, 380, c, s, 0, 400, 0, 380, outX.data(), outY.data(), codes.data());
+			for (int i = 0; i < n; i++)
+			{
+				bool nearEdge = fabsf(oX[i]) < 0.01f || fabsf(oX[i] - 400) < 0.01f || fabsf(oY[i]) < 0.01f || fabsf(oY[i] - 380) < 0.01f;
+				if (fabsf(oX[i] - outX[i]) > 0.01f || fabsf(oY[i] - outY[i]) > 0.01f || (!nearEdge && oC[i] != codes[i]))
+				{
+					if (mismatches < 10)
+						printf("Mismatch (n %d, lissajous %d, startIx %d, i %d): old (%f, %f, %d) new (%f, %f, %d)\n",
+							n, l, startIx, i, oX[i], oY[i], oC[i], outX[i], outY[i], codes[i]);
+					mismatches++;
+				}
+			}
+		}
+	}
+	return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	int numFrames = (argc > 1) ? atoi(argv[1]) : 200000;
+	if (numFrames < 1)
+		numFrames = 1;
+	// Signal that spills out of the box on both axes so all the codes get used.
+	for (int i = 0; i < MAX_BUFFER_SIZE; i++)
+	{
+		valX[i] = 7.0f * sinf(i * 0.05f);
+		valY[i] = 6.0f * cosf(i * 0.031f);
+	}
+
+	int mismatches = 0;
+	double checksum = 0;
+	printf("%d points per size (%d frames at %d points), ns per point:\n", numFrames * MIN_BUFFER_SIZE, numFrames, MIN_BUFFER_SIZE);
+	printf("%8s  %-10s %8s %8s\n", "points", "", "old", "block");
+	for (int n = MIN_BUFFER_SIZE; n <= MAX_BUFFER_SIZE; n *= 2)
+	{
+		mismatches += check(n);
+		int frames = (int)((long long)numFrames * MIN_BUFFER_SIZE / n);
+		if (frames < 1)
+			frames = 1;
+		for (int l = 0; l < 2; l++)
+		{
+			double tOld = timeIt(oldTransform, n, l, frames, &checksum);
+			double tNew = timeIt(newTransform, n, l, frames, &checksum);
+			printf("%8d  %-10s %8.3f %8.3f  (%.1fx)\n", n, (l) ? "x vs y:" : "vs time:", tOld, tNew, tOld / tNew);
+		}
+	}
+	printf("Mismatches: %d (checksum %g)\n", mismatches, checksum);
+	return (mismatches) ? 1 : 0;
+}
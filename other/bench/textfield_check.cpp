@@ -0,0 +1,108 @@
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// textfield_check
+// Checks the TSTextField character class filtering & validation against the
+// std::regex versions it replaced (same results), and times both.
+// The table and validators are src/TSCharClass (what TSTextField uses); the
+// regexes are the old TROWA_REGEX_*.
+// Build: g++ -O2 -std=c++11 other/bench/textfield_check.cpp src/TSCharClass.cpp -o textfield_check
+// Usage: textfield_check [numStrings]  (exit code 1 on any mismatch)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <regex>
+#include <chrono>
+
+#include "../../src/TSCharClass.hpp"
+
+// Old regexes (TSTextField.hpp before the character table)
+#define TROWA_REGEX_NUMERIC_STR_ONLY		"^[0-9]*$"
+#define TROWA_REGEX_NUMERIC_CHAR_NOT		"[^0-9]"
+#define TROWA_REGEX_IP_ADDRESS			 "^(?:(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\.){3}(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)$" 
+#define TROWA_REGEX_IP_CHAR_NOT		"[^0-9\\.]"
+
+// Random string: any byte, or mostly digits and dots, or IP shaped.
+static std::string randomString()
+{
+	std::string s;
+	int kind = rand() % 3;
+	if (kind == 2)
+	{
+		int parts = 3 + rand() % 3;
+		for (int p = 0; p < parts; p++)
+		{
+			if (p > 0)
+				s.push_back((rand() % 20) ? '.' : "x. "[rand() % 3]);
+			int digits = rand() % 5;
+			for (int d = 0; d < digits; d++)
+				s.push_back('0' + rand() % 10);
+		}
+		return s;
+	}
+	int len = rand() % 24;
+	for (int i = 0; i < len; i++)
+	{
+		if (kind == 0)
+			s.push_back((char)(1 + rand() % 255)); // Any byte but '\0' (text fields never hold one)
+		else
+			s.push_back("0123456789..a -"[rand() % 15]);
+	}
+	return s;
+}
+
+int main(int argc, char** argv)
+{
+	int n = (argc > 1) ? atoi(argv[1]) : 300000;
+	const size_t maxLength = 50;
+	srand(48);
+	std::vector<std::string> strings(n);
+	for (int i = 0; i < n; i++)
+		strings[i] = randomString();
+
+	std::regex digitsStr(TROWA_REGEX_NUMERIC_STR_ONLY);
+	std::regex digitsNot(TROWA_REGEX_NUMERIC_CHAR_NOT);
+	std::regex ipStr(TROWA_REGEX_IP_ADDRESS);
+	std::regex ipNot(TROWA_REGEX_IP_CHAR_NOT);
+
+	// Regex (old)
+	std::vector<std::string> rxDigits(n), rxIp(n);
+	std::vector<char> rxDigitsValid(n), rxIpValid(n);
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < n; i++)
+	{
+		rxDigits[i] = std::regex_replace(strings[i], digitsNot, "").substr(0, maxLength);
+		rxIp[i] = std::regex_replace(strings[i], ipNot, "").substr(0, maxLength);
+		rxDigitsValid[i] = std::regex_match(strings[i], digitsStr);
+		rxIpValid[i] = std::regex_match(strings[i], ipStr);
+	}
+	double rxMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+	// Table (new)
+	std::vector<std::string> tDigits(n), tIp(n);
+	std::vector<char> tDigitsValid(n), tIpValid(n);
+	t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < n; i++)
+	{
+		tDigits[i] = TSCharClass::cleanseString(strings[i], TROWA_CHARCLASS_DIGIT, maxLength);
+		tIp[i] = TSCharClass::cleanseString(strings[i], TROWA_CHARCLASS_IP, maxLength);
+		tDigitsValid[i] = TSCharClass::isValidDigits(strings[i]);
+		tIpValid[i] = TSCharClass::isValidIpAddress(strings[i]);
+	}
+	double tMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+	int mismatches = 0;
+	int numValidIp = 0;
+	for (int i = 0; i < n; i++)
+	{
+		numValidIp += tIpValid[i];
+		if (rxDigits[i] != tDigits[i] || rxIp[i] != tIp[i] || rxDigitsValid[i] != tDigitsValid[i] || rxIpValid[i] != tIpValid[i])
+		{
+			if (mismatches++ < 10)
+				printf("Mismatch: \"%s\"\n", strings[i].c_str());
+		}
+	}
+	printf("%d strings (%d valid IPs): %d mismatches. regex %.1f ms, table %.1f ms.\n", n, numValidIp, mismatches, rxMs, tMs);
+	return (mismatches > 0) ? 1 : 0;
+}
@@ -13,19 +13,34 @@
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // multiScope()
 // Multi scope.
+// @numWaveforms : (IN) Number of waveforms / shapes (1 to TROWA_SCOPE_MAX_NUM_WAVEFORMS).
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-multiScope::multiScope() : Module(multiScope::NUM_PARAMS, multiScope::NUM_INPUTS, multiScope::NUM_OUTPUTS, multiScope::NUM_LEDS)
+multiScope::multiScope(int numWaveforms) : Module(TSScopeBlockId(numWaveforms, multiScope::NUM_WAVEFORM_PARAMS, multiScope::NUM_PARAMS, 0),
+	TSScopeBlockId(numWaveforms, multiScope::NUM_INPUTS, multiScope::NUM_INPUTS, 0),
+	multiScope::NUM_OUTPUTS,
+	TSScopeBlockId(numWaveforms, multiScope::NUM_WAVEFORM_LEDS, multiScope::NUM_LEDS, 0))
 {
 	initialized = false;
 	firstLoad = true;
 	plotBackgroundColor = COLOR_BLACK;
+	this->numWaveforms = numWaveforms;
 	float initColorKnobs[4] = { -10, -3.33, 3, 7.2 };
 
-	for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+	for (int wIx = 0; wIx < TROWA_SCOPE_MAX_NUM_WAVEFORMS; wIx++)
 	{
-		waveForms[wIx] = new TSWaveform();
-		waveForms[wIx]->setHueFromKnob(initColorKnobs[wIx]);
-		waveForms[wIx]->setFillHueFromKnob(initColorKnobs[wIx]);
+		if (wIx < numWaveforms)
+		{
+			waveForms[wIx] = new TSWaveform();
+			// First ones are the usual colors, any more are spread out (golden ratio) so neighbors differ.
+			float knobVal = (wIx < 4) ? initColorKnobs[wIx] 
+				: rescalef(fmodf(wIx * 0.618034f, 1.0f), 0, 1.0, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX);
+			waveForms[wIx]->setHueFromKnob(knobVal);
+			waveForms[wIx]->setFillHueFromKnob(knobVal);
+		}
+		else
+		{
+			waveForms[wIx] = NULL;
+		}
 	}
 	return;
 } // end multiScope()
@@ -35,9 +50,10 @@ multiScope::multiScope() : Module(multiScope::NUM_PARAMS, multiScope::NUM_INPUTS
 multiScope::~multiScope()
 {
 	// Clean our stuff
-	for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+	for (int wIx = 0; wIx < numWaveforms; wIx++)
 	{
 		delete waveForms[wIx];
+		waveForms[wIx] = NULL;
 	}
 	return;
 } // end multiScope()
@@ -48,9 +64,24 @@ multiScope::~multiScope()
 void multiScope::step() {
 	if (!initialized)
 		return;
+	// Knobs, buttons, colors, etc. don't need to be read every sample.
+	if (--controlCounter < 0 || firstLoad)
+	{
+		controlCounter = TROWA_SCOPE_CONTROL_RATE_DIVIDER - 1;
+		processControls();
+	}
+	captureFrames();
+	firstLoad = false;
+	return;
+} // end step()
 
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// processControls(void)
+// Read the knobs, buttons and CVs for all waveforms.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void multiScope::processControls() {
 #if ENABLE_BG_COLOR_PICKER
-	if (plotBackgroundDisplayOnTrigger.process(params[multiScope::BGCOLOR_DISPLAY_PARAM].value))
+	if (plotBackgroundDisplayOnTrigger.process(params[paramId(multiScope::BGCOLOR_DISPLAY_PARAM)].value))
 	{
 		showColorPicker = !showColorPicker;
 		if (showColorPicker)
@@ -59,400 +90,386 @@ void multiScope::step() {
 			editColorPointer = &(this->plotBackgroundColor);
 		}
 	}
-	lights[multiScope::BGCOLOR_DISPLAY_LED].value = showColorPicker;
+	lights[lightId(multiScope::BGCOLOR_DISPLAY_LED)].value = showColorPicker;
 #endif
+	sampleRate = engineGetSampleRate();
 
-	//TSWaveform* waveForm = NULL;
-	for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+	TSWaveform* waveForm = NULL;
+	for (int wIx = 0; wIx < numWaveforms; wIx++)
 	{			
-		//waveForm = waveForms[wIx]; // tmp pointer
+		waveForm = waveForms[wIx]; // tmp pointer
 
 		// Effect:
-		waveForms[wIx]->gEffectIx = clampi(roundf(params[multiScope::EFFECT_PARAM+wIx].value), 0, TROWA_SCOPE_NUM_EFFECTS - 1);
+		waveForm->gEffectIx = clampi(roundf(params[paramId(multiScope::EFFECT_PARAM, wIx)].value), 0, TROWA_SCOPE_NUM_EFFECTS - 1);
 
 		// Lissajous:
-		if (waveForms[wIx]->lissajousTrigger.process(params[multiScope::LISSAJOUS_PARAM + wIx].value))
+		if (waveForm->lissajousTrigger.process(params[paramId(multiScope::LISSAJOUS_PARAM, wIx)].value))
 		{
-			waveForms[wIx]->lissajous = !waveForms[wIx]->lissajous;
+			waveForm->lissajous = !waveForm->lissajous;
 		}
-		lights[multiScope::LISSAJOUS_LED + wIx].value = waveForms[wIx]->lissajous;
+		lights[lightId(multiScope::LISSAJOUS_LED, wIx)].value = waveForm->lissajous;
 
 		// Compute Color:
 		float hue = 0;
-		if(inputs[multiScope::COLOR_INPUT+wIx].active){
-			hue = clampf(rescalef(inputs[multiScope::COLOR_INPUT+wIx].value, TROWA_SCOPE_HUE_INPUT_MIN_V, TROWA_SCOPE_HUE_INPUT_MAX_V, 0.0, 1.0), 0.0, 1.0);
+		if(inputs[inputId(multiScope::COLOR_INPUT, wIx)].active){
+			hue = clampf(rescalef(inputs[inputId(multiScope::COLOR_INPUT, wIx)].value, TROWA_SCOPE_HUE_INPUT_MIN_V, TROWA_SCOPE_HUE_INPUT_MAX_V, 0.0, 1.0), 0.0, 1.0);
 		} else {
-			hue = rescalef(params[multiScope::COLOR_PARAM+wIx].value, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, 0.0, 1.0);					
+			hue = rescalef(params[paramId(multiScope::COLOR_PARAM, wIx)].value, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, 0.0, 1.0);					
 		}
-		waveForms[wIx]->colorChanged = hue != waveForms[wIx]->waveHue || firstLoad; 
-		if (waveForms[wIx]->colorChanged)
+		waveForm->colorChanged = hue != waveForm->waveHue || firstLoad; 
+		if (waveForm->colorChanged)
 		{
-			waveForms[wIx]->waveHue = hue;
+			waveForm->waveHue = hue;
 			if (hue > 0.99)
 			{
 				// Inject white
-				waveForms[wIx]->waveColor = COLOR_WHITE;
+				waveForm->waveColor = COLOR_WHITE;
 			}
 			else
 			{
-				waveForms[wIx]->waveColor = HueToColor(waveForms[wIx]->waveHue); // Base Color (opacity full)
+				waveForm->waveColor = HueToColor(waveForm->waveHue); // Base Color (opacity full)
 			}
 #if TROWA_SCOPE_USE_COLOR_LIGHTS
 			// Change the light color:
-			waveForms[wIx]->waveLight->setColor(waveForms[wIx]->waveColor);
+			waveForm->waveLight->setColor(waveForm->waveColor);
 #endif
 		} // end if color changed		
 		// Opacity:
-		if (inputs[multiScope::OPACITY_INPUT + wIx].active)
+		if (inputs[inputId(multiScope::OPACITY_INPUT, wIx)].active)
 		{
-			waveForms[wIx]->waveOpacity = clampf(rescalef(inputs[multiScope::OPACITY_INPUT + wIx].value, TROWA_SCOPE_OPACITY_INPUT_MIN, TROWA_SCOPE_OPACITY_INPUT_MAX, TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY),
+			waveForm->waveOpacity = clampf(rescalef(inputs[inputId(multiScope::OPACITY_INPUT, wIx)].value, TROWA_SCOPE_OPACITY_INPUT_MIN, TROWA_SCOPE_OPACITY_INPUT_MAX, TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY),
 									 TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY);
 		}
 		else
 		{
-			waveForms[wIx]->waveOpacity = params[multiScope::OPACITY_PARAM + wIx].value;
+			waveForm->waveOpacity = params[paramId(multiScope::OPACITY_PARAM, wIx)].value;
 		}
 		// Line Thickness
-		if (inputs[multiScope::THICKNESS_INPUT + wIx].active)
+		if (inputs[inputId(multiScope::THICKNESS_INPUT, wIx)].active)
 		{
-			waveForms[wIx]->lineThickness = clampf(rescalef(inputs[multiScope::THICKNESS_INPUT + wIx].value, TROWA_SCOPE_THICKNESS_INPUT_MIN, TROWA_SCOPE_THICKNESS_INPUT_MAX, TROWA_SCOPE_THICKNESS_MIN, TROWA_SCOPE_THICKNESS_MAX),
+			waveForm->lineThickness = clampf(rescalef(inputs[inputId(multiScope::THICKNESS_INPUT, wIx)].value, TROWA_SCOPE_THICKNESS_INPUT_MIN, TROWA_SCOPE_THICKNESS_INPUT_MAX, TROWA_SCOPE_THICKNESS_MIN, TROWA_SCOPE_THICKNESS_MAX),
 				TROWA_SCOPE_THICKNESS_MIN, TROWA_SCOPE_THICKNESS_MAX);
 		}
 		else
 		{
-			waveForms[wIx]->lineThickness = params[multiScope::THICKNESS_PARAM + wIx].value;
+			waveForm->lineThickness = params[paramId(multiScope::THICKNESS_PARAM, wIx)].value;
 		}
 
 		// Compute Fill :::::::::::::::::::::::::::::::::::::::::
-		if (waveForms[wIx]->fillOnTrigger.process(params[multiScope::FILL_ON_PARAM + wIx].value))
+		if (waveForm->fillOnTrigger.process(params[paramId(multiScope::FILL_ON_PARAM, wIx)].value))
 		{
-			waveForms[wIx]->doFill = !waveForms[wIx]->doFill;
-			debug("Waveform %d: Fill On Clicked : %d (ParamId: %d).", wIx, waveForms[wIx]->doFill, multiScope::FILL_ON_PARAM + wIx);
+			waveForm->doFill = !waveForm->doFill;
+			debug("Waveform %d: Fill On Clicked : %d (ParamId: %d).", wIx, waveForm->doFill, paramId(multiScope::FILL_ON_PARAM, wIx));
 		}
-		lights[multiScope::FILL_ON_LED + wIx].value = waveForms[wIx]->doFill;
+		lights[lightId(multiScope::FILL_ON_LED, wIx)].value = waveForm->doFill;
 		hue = 0;
-		if (inputs[multiScope::FILL_COLOR_INPUT + wIx].active) {
-			hue = clampf(rescalef(inputs[multiScope::FILL_COLOR_INPUT + wIx].value, TROWA_SCOPE_HUE_INPUT_MIN_V, TROWA_SCOPE_HUE_INPUT_MAX_V, 0.0, 1.0), 0.0, 1.0);
+		if (inputs[inputId(multiScope::FILL_COLOR_INPUT, wIx)].active) {
+			hue = clampf(rescalef(inputs[inputId(multiScope::FILL_COLOR_INPUT, wIx)].value, TROWA_SCOPE_HUE_INPUT_MIN_V, TROWA_SCOPE_HUE_INPUT_MAX_V, 0.0, 1.0), 0.0, 1.0);
 		}
 		else {
-			hue = rescalef(params[multiScope::FILL_COLOR_PARAM + wIx].value, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, 0.0, 1.0);
+			hue = rescalef(params[paramId(multiScope::FILL_COLOR_PARAM, wIx)].value, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, 0.0, 1.0);
 		}
-		if (hue != waveForms[wIx]->fillHue || firstLoad)
+		if (hue != waveForm->fillHue || firstLoad)
 		{
-			waveForms[wIx]->fillHue = hue;
+			waveForm->fillHue = hue;
 			if (hue > 0.99)
 			{
 				// Inject White
-				waveForms[wIx]->fillColor = COLOR_WHITE;
+				waveForm->fillColor = COLOR_WHITE;
 			}
 			else
 			{
-				waveForms[wIx]->fillColor = HueToColor(waveForms[wIx]->fillHue); // Base Color (opacity full)
+				waveForm->fillColor = HueToColor(waveForm->fillHue); // Base Color (opacity full)
 			}
 		} // end if color changed		
 		// Opacity:
-		if (inputs[multiScope::FILL_OPACITY_INPUT + wIx].active)
+		if (inputs[inputId(multiScope::FILL_OPACITY_INPUT, wIx)].active)
 		{
-			waveForms[wIx]->fillOpacity = clampf(rescalef(inputs[multiScope::FILL_OPACITY_INPUT + wIx].value, TROWA_SCOPE_OPACITY_INPUT_MIN, TROWA_SCOPE_OPACITY_INPUT_MAX, TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY),
+			waveForm->fillOpacity = clampf(rescalef(inputs[inputId(multiScope::FILL_OPACITY_INPUT, wIx)].value, TROWA_SCOPE_OPACITY_INPUT_MIN, TROWA_SCOPE_OPACITY_INPUT_MAX, TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY),
 				TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY);
 		}
 		else
 		{
-			waveForms[wIx]->fillOpacity = params[multiScope::FILL_OPACITY_PARAM + wIx].value;
+			waveForm->fillOpacity = params[paramId(multiScope::FILL_OPACITY_PARAM, wIx)].value;
 		}
 
 
 		// Compute rotation:
-		waveForms[wIx]->rotKnobValue = params[multiScope::ROTATION_PARAM+wIx].value;
-		if (waveForms[wIx]->rotModeTrigger.process(params[multiScope::ROTATION_MODE_PARAM+wIx].value))
+		waveForm->rotKnobValue = params[paramId(multiScope::ROTATION_PARAM, wIx)].value;
+		if (waveForm->rotModeTrigger.process(params[paramId(multiScope::ROTATION_MODE_PARAM, wIx)].value))
 		{
-			waveForms[wIx]->rotMode = !waveForms[wIx]->rotMode;
-			debug("Waveform %d: Rotation Mode On Clicked : %d.", wIx, waveForms[wIx]->rotMode);
+			waveForm->rotMode = !waveForm->rotMode;
+			debug("Waveform %d: Rotation Mode On Clicked : %d.", wIx, waveForm->rotMode);
 		}
-		lights[multiScope::ROT_LED+wIx].value = waveForms[wIx]->rotMode;		
+		lights[lightId(multiScope::ROT_LED, wIx)].value = waveForm->rotMode;		
 		float rot = 0;
 		float rotRate = 0;
-		if (waveForms[wIx]->rotMode)
+		float rotVal = params[paramId(multiScope::ROTATION_PARAM, wIx)].value + inputs[inputId(multiScope::ROTATION_INPUT, wIx)].value;
+		if (waveForm->rotMode)
 		{
 			// Absolute position:
-			rot = rescalef(params[multiScope::ROTATION_PARAM+wIx].value + inputs[multiScope::ROTATION_INPUT+wIx].value, 0, 10, 0, NVG_PI);
+			rot = rescalef(rotVal, 0, 10, 0, NVG_PI);
 		}
 		else
 		{
 			// Differential rotation
-			rotRate = rescalef(params[multiScope::ROTATION_PARAM+wIx].value + inputs[multiScope::ROTATION_INPUT+wIx].value, 0, 10, 0, 0.5);
+			rotRate = rescalef(rotVal, 0, 10, 0, 0.5);
 		}
-		waveForms[wIx]->rotAbsValue = rot;
-		waveForms[wIx]->rotDiffValue = rotRate;
+		waveForm->rotAbsValue = rot;
+		waveForm->rotDiffValue = rotRate;
 		
-		// Compute time:
-		float deltaTime = powf(2.0, params[TIME_PARAM+wIx].value + inputs[TIME_INPUT+wIx].value);
-		int frameCount = (int)ceilf(deltaTime * engineGetSampleRate());
+		// Compute time (only call pow when the knob/CV actually moved):
+		float timeVal = params[paramId(multiScope::TIME_PARAM, wIx)].value + inputs[inputId(multiScope::TIME_INPUT, wIx)].value;
+		if (timeVal != waveForm->lastTimeValue || waveForm->lastSampleRate != sampleRate || firstLoad)
+		{
+			waveForm->lastTimeValue = timeVal;
+			waveForm->lastSampleRate = sampleRate;
+			float deltaTime = powf(2.0, timeVal);
+			waveForm->frameCount = (int)ceilf(deltaTime * sampleRate);
+		}
+		// Pen input (read per sample in captureFrames)
+		waveForm->penInputActive = inputs[inputId(multiScope::PEN_ON_INPUT, wIx)].active;
+#if TROWA_SCOPE_USE_Z_DIMENSION
+		// Z input (lissajous is drawn in 3D if plugged in)
+		waveForm->inputsActive[2] = inputs[inputId(multiScope::Z_INPUT, wIx)].active;
+#endif
+	} // end loop through waveforms
+	return;
+} // end processControls()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// captureFrames(void)
+// Add the current sample to all waveforms buffers (if it is time).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void multiScope::captureFrames() {
+	const float holdTime = 0.1;
+	const float holdFrames = sampleRate * holdTime;
+	Input* xInputs = &(inputs[inputId(multiScope::X_INPUT, 0)]);
+	Input* yInputs = &(inputs[inputId(multiScope::Y_INPUT, 0)]);
+	Input* penInputs = &(inputs[inputId(multiScope::PEN_ON_INPUT, 0)]);
+#if TROWA_SCOPE_USE_Z_DIMENSION
+	Input* zInputs = &(inputs[inputId(multiScope::Z_INPUT, 0)]);
+#endif
+	for (int wIx = 0; wIx < numWaveforms; wIx++)
+	{
+		TSWaveform* waveForm = waveForms[wIx];
 		// Add frame to buffer
-		if (waveForms[wIx]->bufferIndex < BUFFER_SIZE) {
-			if (++(waveForms[wIx]->frameIndex) > frameCount) {
-				waveForms[wIx]->frameIndex = 0;
-				waveForms[wIx]->bufferX[waveForms[wIx]->bufferIndex] = inputs[X_INPUT+wIx].value;
-				waveForms[wIx]->bufferY[waveForms[wIx]->bufferIndex] = inputs[Y_INPUT+wIx].value;
-				waveForms[wIx]->bufferPenOn[waveForms[wIx]->bufferIndex] = (!inputs[PEN_ON_INPUT + wIx].active || inputs[PEN_ON_INPUT + wIx].value > 0.1); // Allow some noise?
-				waveForms[wIx]->bufferIndex++;
+		if (waveForm->bufferIndex < BUFFER_SIZE) {
+			if (++(waveForm->frameIndex) > waveForm->frameCount) {
+				waveForm->frameIndex = 0;
+#if TROWA_SCOPE_USE_Z_DIMENSION
+				waveForm->addFrame(xInputs[wIx].value, yInputs[wIx].value, zInputs[wIx].value,
+					(!waveForm->penInputActive || penInputs[wIx].value > 0.1)); // Allow some noise?
+#else
+				waveForm->addFrame(xInputs[wIx].value, yInputs[wIx].value, 
+					(!waveForm->penInputActive || penInputs[wIx].value > 0.1)); // Allow some noise?
+#endif
 			}
 		}
 		else {
-			if (waveForms[wIx]->lissajous)
+			if (waveForm->lissajous)
 			{
 				// Reset
-				waveForms[wIx]->bufferIndex = 0;
-				waveForms[wIx]->frameIndex = 0;
+				waveForm->bufferIndex = 0;
+				waveForm->frameIndex = 0;
 			}
 			else
 			{
 				// Just show stuff (no trigger inputs)
-				waveForms[wIx]->frameIndex++;
-				float holdTime = 0.1;
-				if (waveForms[wIx]->frameIndex >= engineGetSampleRate() * holdTime) {
-					waveForms[wIx]->bufferIndex = 0; 
-					waveForms[wIx]->frameIndex = 0;
+				waveForm->frameIndex++;
+				if (waveForm->frameIndex >= holdFrames) {
+					waveForm->bufferIndex = 0; 
+					waveForm->frameIndex = 0;
 				}
 			}
 		}
 	} // end loop through waveforms
-	firstLoad = false;
 	return;
-} // end step()
+} // end captureFrames()
 
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-// drawWaveform()
-// @vg : (IN) NVGcontext
-// @valX: (IN) Pointer to x values.
-// @valY: (IN) Pointer to y values.
-// @rotRate: (IN) Rotation rate in radians
-// @lineThickness: (IN) Line thickness
-// @compositeOp: (IN) Some global effect if any
-// @flipX: (IN) Flip along x (at x=0)
-// @flipY: (IN) Flip along y
+// AddPathPoint()
+// @path : (IN/OUT) The path cache.
+// @p : (IN) The point.
+// @moveTo : (IN) True to start a new sub-path (nvgMoveTo), false for nvgLineTo.
+// @band : (IN) Depth band of the segment ending here (3D only).
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-void multiScopeDisplay::drawWaveform(NVGcontext *vg, float *valX, float *valY, bool* penOn,
-	float rotRate, float lineThickness, NVGcolor lineColor,
-	bool doFill, NVGcolor fillColor,
-	NVGcompositeOperation compositeOp, bool flipX, bool flipY)
+inline void AddPathPoint(TSScopePathCache* path, Vec p, bool moveTo, uint8_t band = 0)
 {
-	if (!valX)
-		return;
-	nvgSave(vg);
-	Rect b = Rect(Vec(0, 0), box.size);
-	nvgScissor(vg, b.pos.x, b.pos.y, b.size.x, b.size.y);
-	//nvgTranslate(vg, box.size.x / 2.0, box.size.y / 2.0);
-	//nvgRotate(vg, rot += rotRate);
-	rot += rotRate;
-	if (flipX || flipY)
+	if (path->numPoints < TROWA_SCOPE_MAX_PATH_POINTS)
 	{
-		// Sets the transform to scale matrix.
-		// void nvgTransformScale(float* dst, float sx, float sy);
-		nvgScale(vg, ((flipX) ? -1 : 1), (flipY) ? -1 : 1); // flip
+		path->points[path->numPoints] = p;
+		path->moveTo[path->numPoints] = moveTo;
+		path->band[path->numPoints] = band;
+		path->numPoints++;
 	}
+	return;
+}
 
-	// Draw maximum display left to right
-	nvgBeginPath(vg);
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// updatePath()
+// @path : (IN/OUT) The path cache to check/rebuild.
+// @waveForm: (IN) The waveform (pen on, generation, buffer index, thickness).
+// @valX: (IN) Pointer to raw x buffer (or the plotted buffer if valY is NULL).
+// @valY: (IN) Pointer to raw y buffer (or NULL to plot valX vs time).
+// @valZ: (IN) Pointer to raw z buffer (or NULL for 2D). Requires valY and proj.
+// @gainX/gainY/gainZ: (IN) Gain (already divided by 10).
+// @offsetX/offsetY: (IN) Offsets.
+// @rotation: (IN) Rotation [radians] (3D: the yaw already in proj).
+// @proj: (IN) The 3D projection (if valZ).
+// @doTrim: (IN) If we need to clip to our box.
+// @flipX: (IN) Mirror along x (about the center).
+// @flipY: (IN) Mirror along y (about the center).
+// Rebuilds the transformed/clipped vertices only if the buffer or transform changed.
+// @returns: True if rebuilt, false if the cache was used.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool multiScopeDisplay::updatePath(TSScopePathCache* path, TSWaveform* waveForm, float* valX, float* valY, float* valZ,
+	float gainX, float gainY, float gainZ, float offsetX, float offsetY, float rotation, const TSScopeProjection* proj,
+	bool doTrim, bool flipX, bool flipY)
+{
+	bool is3D = valZ != NULL && valY != NULL && proj != NULL;
+	if (!is3D)
+	{
+		valZ = NULL;
+		gainZ = 0;
+	}
+	float lineThickness = waveForm->lineThickness;
+	if (path->valid && path->generation == waveForm->bufferGeneration
+		&& path->srcX == valX && path->srcY == valY && path->srcZ == valZ
+		&& path->gainX == gainX && path->gainY == gainY && path->gainZ == gainZ
+		&& path->offsetX == offsetX && path->offsetY == offsetY
+		&& path->rot == rotation && path->lineThickness == lineThickness
+		&& path->doTrim == doTrim && path->flipX == flipX && path->flipY == flipY
+		&& path->size.x == box.size.x && path->size.y == box.size.y)
+	{
+		// Nothing changed, keep what we have.
+		// (In lissajous the buffer index moves on even with identical data, but we keep the old start
+		// since the slots themselves haven't changed).
+		return false;
+	}
+	path->valid = true;
+	path->generation = waveForm->bufferGeneration;
+	path->srcX = valX;
+	path->srcY = valY;
+	path->srcZ = valZ;
+	path->gainX = gainX;
+	path->gainY = gainY;
+	path->gainZ = gainZ;
+	path->offsetX = offsetX;
+	path->offsetY = offsetY;
+	path->rot = rotation;
+	path->lineThickness = lineThickness;
+	path->doTrim = doTrim;
+	path->flipX = flipX;
+	path->flipY = flipY;
+	path->size = box.size;
+	// Lock display to buffer if buffer update deltaTime <= 2^-11
+	int startIx = (waveForm->lissajous) ? waveForm->bufferIndex % BUFFER_SIZE : 0;
+	path->startIx = startIx;
+	path->numPoints = 0;
+	bool* penOn = waveForm->bufferPenOn;
+
+	Rect b = Rect(Vec(0, 0), box.size);
 	float xOffset = 0;// -box.size.x / 2.0;
 	float yOffset = 0;// -box.size.y / 2.0;
 	float minX = b.pos.x + xOffset + lineThickness / 2.0;
 	float maxX = minX + b.size.x - lineThickness;
 	float minY = b.pos.y + yOffset + lineThickness / 2.0;
 	float maxY = minY + box.size.y - lineThickness;
-	bool doTrim = false;
-	switch (compositeOp)
+	float s = sin(rotation);
+	float c = cos(rotation);
+
+	// 1. Transform the whole buffer (in draw order). The ring is split into the two contiguous runs so the
+	// block transform doesn't have to do any index wrapping.
+	int n1 = BUFFER_SIZE - startIx;
+	if (is3D)
+	{
+		// 3D: The projection already holds the rotation (yaw).
+		TSScopeTransformBlock3D(valX + startIx, valY + startIx, valZ + startIx, n1,
+			gainX, gainY, gainZ, offsetX, offsetY, /*offsetZ*/ 0, b.size.x, b.size.y, proj, flipX, flipY,
+			path->vx, path->vy, path->vz);
+		if (startIx > 0)
+		{
+			TSScopeTransformBlock3D(valX, valY, valZ, startIx,
+				gainX, gainY, gainZ, offsetX, offsetY, /*offsetZ*/ 0, b.size.x, b.size.y, proj, flipX, flipY,
+				path->vx + n1, path->vy + n1, path->vz + n1);
+		}
+	}
+	else
 	{
-	case NVG_DESTINATION_OVER:
-	case NVG_SOURCE_IN:
-	case NVG_SOURCE_OUT:
-	case NVG_DESTINATION_IN:
-	case NVG_DESTINATION_ATOP:
-	case NVG_COPY:
-		doTrim = true;
-		break;
-	case NVG_SOURCE_OVER:
-	case NVG_ATOP:
-	case NVG_DESTINATION_OUT:
-	case NVG_LIGHTER:
-	case NVG_XOR:
-	default:
-		break;
+		TSScopeTransformBlock(valX + startIx, (valY) ? valY + startIx : NULL, n1, /*drawIxStart*/ 0, BUFFER_SIZE,
+			gainX, gainY, offsetX, offsetY, b.size.x, b.size.y, c, s, flipX, flipY, path->vx, path->vy);
+		if (startIx > 0)
+		{
+			TSScopeTransformBlock(valX, valY, startIx, /*drawIxStart*/ n1, BUFFER_SIZE,
+				gainX, gainY, offsetX, offsetY, b.size.x, b.size.y, c, s, flipX, flipY, path->vx + n1, path->vy + n1);
+		}
+	}
+	// 2. Location codes for everything at once.
+	if (doTrim)
+	{
+		TSScopeLocationCodeBlock(path->vx, path->vy, BUFFER_SIZE, minX, maxX, minY, maxY, path->codes);
 	}
-	float ox = b.pos.x + b.size.x / 2.0; // Center of box
-	float oy = b.pos.y + b.size.y / 2.0;
-	float s = sin(rot);
-	float c = cos(rot);
 
+	// 3. Walk the points. Only segments that cross the bounds go to the scalar clipper.
 	bool lastPointStarted = false; // If the last point was actually plotted
-								   //bool lastPointInBounds = false; // If the last point was in bounds
-	Vec lastPoint;
-	Vec lastPointRaw;
-	uint8_t lastLocCodeRaw = POINT_POS_INSIDE;
 	bool lastPointExists = false; // If the last point was actually calculated (i.e. false if pen is off)
-	uint8_t lastLocCode = POINT_POS_INSIDE;
+	uint8_t lastLocCode = POINT_POS_INSIDE; // Location of the last point after any clipping
 	for (int i = 0; i < BUFFER_SIZE; i++) {
-		if (penOn[i])
+		if (penOn[(i + startIx) % BUFFER_SIZE])
 		{
-			float x, y;
-			if (valY) {
-				x = valX[i] / 2.0 + 0.5;
-				y = valY[i] / 2.0 + 0.5;
-			}
-			else {
-				x = (float)i / (BUFFER_SIZE - 1);
-				y = valX[i] / 2.0 + 0.5;
-			}
-
-
-			Vec p;
-			//p.x = b.pos.x + xOffset + b.size.x * x;
-			//p.y = b.pos.y + yOffset + b.size.y * (1.0 - y);
-			p.x = b.size.x * x;
-			p.y = b.size.y * (1.0 - y);
-			// Rotate ourselves so we can cull easily.
-			double dx = p.x - ox;
-			double dy = p.y - oy;
-			p.x =  ox + dx * c - dy * s;
-			p.y =  oy + dx * s + dy * c;
-
+			Vec p = Vec(path->vx[i], path->vy[i]);
+			// Depth band of the segment ending here (average depth of its end points)
+			uint8_t band = (is3D) ? TSScopeDepthBand((lastPointExists) ? (path->vz[i - 1] + path->vz[i]) * 0.5f : path->vz[i]) : 0;
 			bool plotPoint = true;
 			if (doTrim)
 			{
-				Vec origPoint = p;
-				// Do some cropping/clipping if needed
-				uint8_t locCode = GetPointLocationCode(p, minX, maxX, minY, maxY);
-				uint8_t origLocCode = locCode;
-				//bool inBounds = !locCode;
-				bool doSearch = false;
-				if (locCode)
+				uint8_t locCode = path->codes[i];
+				uint8_t lastLocCodeRaw = (lastPointExists) ? path->codes[i - 1] : POINT_POS_INSIDE;
+				if (lastPointExists && !LINE_IS_IN_BOUNDS(locCode, lastLocCodeRaw))
 				{
-					// Outside of bounds
-					if (lastPointExists && !LINE_OUT_OF_BOUNDS(locCode, lastLocCodeRaw)) // If there was a point last time and both prev and this one don't make a line totally outside of bounds.
+					if (LINE_OUT_OF_BOUNDS(locCode, lastLocCodeRaw))
 					{
-						// Check the last point calculated (it may be out of bounds too)
-						doSearch = true;
-					}
-					else
-					{
-						// Just save this for next time. Do not plot
+						// Line is completely outside of bounds. Do not plot
 						plotPoint = false;
 					}
-				} // end if this point is out of bounds
-				else if (lastPointExists && lastLocCodeRaw)
-				{
-					// Last point wasn't valid although this one is, so we will have to inject both points.
-					doSearch = true;
-				}
-				if (doSearch)
-				{
-					Vec p1 = lastPointRaw;
-					Vec p2 = p;
-					uint8_t outcode0 = lastLocCodeRaw;
-					uint8_t outcode1 = locCode;
-					while (doSearch)
-					{
-						if (LINE_IS_IN_BOUNDS(outcode0, outcode1))
-						{ // Bitwise OR is 0. Trivially accept and get out of loop
-							plotPoint = true;
-							doSearch = false;
-						}
-						else if (LINE_OUT_OF_BOUNDS(outcode0, outcode1))
-						{ // Bitwise AND is not 0. (implies both end points are in the same region outside the window). Reject and get out of loop
-							doSearch = false;
-							plotPoint = false;
-						}
-						else {
-							// failed both tests, so calculate the line segment to clip
-							// from an outside point to an intersection with clip edge
-							double x, y;
-
-							// At least one endpoint is outside the clip rectangle; pick it.
-							uint8_t outcodeOut = outcode0 ? outcode0 : outcode1;
-
-							// Now find the intersection point;
-							// use formulas:
-							//   slope = (y1 - y0) / (x1 - x0)
-							//   x = x0 + (1 / slope) * (ym - y0), where ym is ymin or ymax
-							//   y = y0 + slope * (xm - x0), where xm is xmin or xmax
-							if (outcodeOut & POINT_POS_TOP) {           // point is above the clip rectangle
-								x = p1.x + (p2.x - p1.x) * (maxY - p1.y) / (p2.y - p1.y);
-								y = maxY;
-							}
-							else if (outcodeOut & POINT_POS_BOTTOM) { // point is below the clip rectangle
-								x = p1.x + (p2.x - p1.x) * (minY - p1.y) / (p2.y - p1.y);
-								y = minY;
-							}
-							else if (outcodeOut & POINT_POS_RIGHT) {  // point is to the right of clip rectangle
-								y = p1.y + (p2.y - p1.y) * (maxX - p1.x) / (p2.x - p1.x);
-								x = maxX;
-							}
-							else if (outcodeOut & POINT_POS_LEFT) {   // point is to the left of clip rectangle
-								y = p1.y + (p2.y - p1.y) * (minX - p1.x) / (p2.x - p1.x);
-								x = minX;
-							}
-
-							// Now we move outside point to intersection point to clip
-							// and get ready for next pass.
-							if (outcodeOut == outcode0) {
-								p1.x = x;
-								p1.y = y;
-								outcode0 = GetPointLocationCode(p1, minX, maxX, minY, maxY);
-							}
-							else {
-								p2.x = x;
-								p2.y = y;
-								outcode1 = GetPointLocationCode(p2, minX, maxX, minY, maxY);
-							}
-						} // end else (check bounds)
-					} // end while
-
-
-					// See if we should plot the last point (now that it's fixed)
-					if (lastLocCode && !outcode0)
+					else
 					{
-						// Last point was out of bounds, but is now not out of bounds
-						if (!lastPointStarted)
-						{
-							nvgMoveTo(vg, p1.x, p1.y);
-						}
-						else
+						// Crossing segment, clip it
+						Vec p1 = Vec(path->vx[i - 1], path->vy[i - 1]);
+						Vec p2 = p;
+						plotPoint = ClipLineSegment(&p1, &p2, minX, maxX, minY, maxY);
+						if (plotPoint)
 						{
-							nvgLineTo(vg, p1.x, p1.y);
+							// See if we should plot the last point (now that it's fixed)
+							if (lastLocCode)
+							{
+								// Last point was out of bounds, but is now not out of bounds
+								AddPathPoint(path, p1, !lastPointStarted, band);
+								lastPointStarted = true;
+							}
+							p = p2;
+							locCode = POINT_POS_INSIDE;
 						}
-						lastPointStarted = true;
-					} // end if plot prev point
-
-					locCode = outcode1;
-					p = p2;
-					if (locCode)
-					{
-						// Still not in bounds
-						plotPoint = false;
 					}
 				}
+				else if (locCode)
+				{
+					// No line to clip and this point is out of bounds. Just save this for next time.
+					plotPoint = false;
+				}
 				lastLocCode = locCode;
-				lastPointRaw = origPoint;
-				lastLocCodeRaw = origLocCode;
 			} // end if do trimming
 			if (plotPoint)
 			{
-				if (!lastPointStarted)
-				{
-					nvgMoveTo(vg, p.x, p.y);
-				}
-				else
-				{
-					nvgLineTo(vg, p.x, p.y);
-				}
+				AddPathPoint(path, p, !lastPointStarted, band);
 				lastPointStarted = true;
 			}
 			else
 			{
 				lastPointStarted = false;
 			}
-			lastPoint = p;
 			lastPointExists = true;
 		} // end if penOn
 		else
@@ -462,20 +479,172 @@ void multiScopeDisplay::drawWaveform(NVGcontext *vg, float *valX, float *valY, b
 			lastPointExists = false;
 		} // end else (pen off)
 	} // end loop through buffer
-    
-	nvgLineCap(vg, NVG_ROUND);
-	nvgMiterLimit(vg, 2.0);
+	return true;
+} // end updatePath()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// drawWaveform()
+// @vg : (IN) NVGcontext (scissor should already be set).
+// @path: (IN) The (transformed) path to draw.
+// @lineThickness: (IN) Line thickness
+// @compositeOp: (IN) Some global effect if any
+// 3D paths are stroked once per depth band (farther bands more transparent) since
+// NanoVG can't vary opacity along one stroke.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void multiScopeDisplay::drawWaveform(NVGcontext *vg, TSScopePathCache* path,
+	float lineThickness, NVGcolor lineColor,
+	bool doFill, NVGcolor fillColor,
+	NVGcompositeOperation compositeOp)
+{
+	if (!path || path->numPoints < 1)
+		return;
+
+	// Replay our cached vertices
+	nvgBeginPath(vg);
+	for (int i = 0; i < path->numPoints; i++)
+	{
+		if (path->moveTo[i])
+			nvgMoveTo(vg, path->points[i].x, path->points[i].y);
+		else
+			nvgLineTo(vg, path->points[i].x, path->points[i].y);
+	}
 	nvgGlobalCompositeOperation(vg, compositeOp);
 	if (doFill)
 	{
 		nvgFillColor(vg, fillColor);
 		nvgFill(vg);
 	}
-	nvgStrokeColor(vg, lineColor);
 	nvgStrokeWidth(vg, lineThickness);
-	nvgStroke(vg);
+	if (path->srcZ == NULL)
+	{
+		nvgStrokeColor(vg, lineColor);
+		nvgStroke(vg);
+	}
+	else
+	{
+		// Depth cue: one path + one stroke per band. Consecutive segments in the same band
+		// are joined into one polyline (only start a new sub-path when the run breaks).
+		for (int band = 0; band < TROWA_SCOPE_3D_NUM_DEPTH_BANDS; band++)
+		{
+			nvgBeginPath(vg);
+			bool any = false;
+			bool inRun = false; // If the last segment was in this band (so point i-1 is our pen position)
+			for (int i = 1; i < path->numPoints; i++)
+			{
+				if (!path->moveTo[i] && path->band[i] == band)
+				{
+					if (!inRun)
+						nvgMoveTo(vg, path->points[i - 1].x, path->points[i - 1].y);
+					nvgLineTo(vg, path->points[i].x, path->points[i].y);
+					inRun = true;
+					any = true;
+				}
+				else
+				{
+					inRun = false;
+				}
+			}
+			if (any)
+			{
+				NVGcolor bandColor = lineColor;
+				bandColor.a *= TSScopeDepthBandAlpha(band);
+				nvgStrokeColor(vg, bandColor);
+				nvgStroke(vg);
+			}
+		} // end loop through bands
+	}
+	nvgGlobalCompositeOperation(vg, NVG_SOURCE_OVER); // Restore to normal
+	return;
+} // end drawWaveform()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// draw()
+// Draw all the waveforms under one scissor.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void multiScopeDisplay::draw(NVGcontext *vg) 
+{
+	if (!module->initialized || pathCache == NULL)
+		return;
+	int n = (module->numWaveforms < numWaveforms) ? module->numWaveforms : numWaveforms;
+
+	nvgSave(vg);
+	Rect b = Rect(Vec(0, 0), box.size);
+	nvgScissor(vg, b.pos.x, b.pos.y, b.size.x, b.size.y);
+	nvgLineCap(vg, NVG_ROUND);
+	nvgMiterLimit(vg, 2.0);
+	for (int wIx = 0; wIx < n; wIx++)
+	{
+		TSWaveform* waveForm = module->waveForms[wIx];
+		bool xActive = module->inputs[module->inputId(multiScope::X_INPUT, wIx)].active;
+		bool yActive = module->inputs[module->inputId(multiScope::Y_INPUT, wIx)].active;
+		if (!xActive && !yActive)
+			continue; // Nothing to draw
+
+		float gainX = ((int)(module->params[module->paramId(multiScope::X_SCALE_PARAM, wIx)].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
+		float gainY = ((int)(module->params[module->paramId(multiScope::Y_SCALE_PARAM, wIx)].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
+		float offsetX = ((int)(module->params[module->paramId(multiScope::X_POS_PARAM, wIx)].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
+		float offsetY = ((int)(module->params[module->paramId(multiScope::Y_POS_PARAM, wIx)].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
+		float multX = gainX / 10.0;
+		float multY = gainY / 10.0;
+
+		// 1. Line Color:
+		NVGcolor waveColor = waveForm->waveColor;
+		waveColor.a = waveForm->waveOpacity;
+		if (waveForm->negativeImage)
+			waveColor = ColorInvertToNegative(waveColor);
+		// 2. Fill color:
+		NVGcolor fillColor = waveForm->fillColor;
+		fillColor.a = waveForm->fillOpacity;
+		// 3. Rotation
+		float rotRate = 0;
+		if (waveForm->rotMode)
+		{
+			// Absolute position:
+			rot[wIx] = waveForm->rotAbsValue;
+		}
+		else
+		{
+			// Differential rotation
+			rotRate = waveForm->rotDiffValue;
+		}
+		NVGcompositeOperation compositeOp = SCOPE_GLOBAL_EFFECTS[waveForm->gEffectIx]->compositeOperation;
+		bool doTrim = TSScopeCompositeOpNeedsTrim(compositeOp);
+		TSScopePathCache* paths = &(pathCache[2 * wIx]);
+		if (waveForm->lissajous) {
+			// X x Y
+			rot[wIx] += rotRate;
+			float* valZ = NULL;
+			float multZ = 0;
+			TSScopeProjection* proj = NULL;
+#if TROWA_SCOPE_USE_Z_DIMENSION
+			if (waveForm->inputsActive[2])
+			{
+				// X x Y x Z: Rotation is the yaw. Z uses the X gain.
+				projection[wIx].update(rot[wIx], TROWA_SCOPE_3D_PITCH);
+				proj = &(projection[wIx]);
+				valZ = waveForm->bufferZ;
+				multZ = multX * waveForm->aspectRatioXZ;
+			}
+#endif
+			updatePath(&(paths[0]), waveForm, waveForm->bufferX, waveForm->bufferY, valZ, multX, multY, multZ, offsetX, offsetY, rot[wIx], proj, doTrim, false, false);
+			drawWaveform(vg, &(paths[0]), waveForm->lineThickness, waveColor, waveForm->doFill, fillColor, compositeOp);
+		}
+		else {
+			// Y
+			if (yActive) {
+				rot[wIx] += rotRate;
+				updatePath(&(paths[0]), waveForm, waveForm->bufferY, NULL, NULL, multY, 0, 0, offsetY, 0, rot[wIx], NULL, doTrim, false, false);
+				drawWaveform(vg, &(paths[0]), waveForm->lineThickness, waveColor, waveForm->doFill, fillColor, compositeOp);
+			}
+			// X
+			if (xActive) {
+				rot[wIx] += rotRate;
+				updatePath(&(paths[1]), waveForm, waveForm->bufferX, NULL, NULL, multX, 0, 0, offsetX, 0, rot[wIx], NULL, doTrim, false, false);
+				drawWaveform(vg, &(paths[1]), waveForm->lineThickness, waveColor, waveForm->doFill, fillColor, compositeOp);
+			}
+		}
+	} // end loop through waveforms
 	nvgResetScissor(vg);
 	nvgRestore(vg);
-	nvgGlobalCompositeOperation(vg, NVG_SOURCE_OVER); // Restore to normal
 	return;
-} // end drawWaveform()	  
+} // end draw()
@@ -14,7 +14,18 @@
 // Now it seems the scope just crashes Rack on OSX no matter what.
 #define ENABLE_BG_COLOR_PICKER			(!(__APPLE__))
 
+// Default number of waveforms / shapes
 #define TROWA_SCOPE_NUM_WAVEFORMS	3
+// Number of waveforms / shapes for the large scope
+#define TROWA_SCOPE_NUM_WAVEFORMS_LARGE		8
+// Max number of waveforms / shapes that one scope can have
+#define TROWA_SCOPE_MAX_NUM_WAVEFORMS		16
+// Number of waveform control groups stacked in one column (more waveforms add more columns)
+#define TROWA_SCOPE_WAVEFORMS_PER_COLUMN	3
+// Width of the input / control area for one column of waveforms
+#define	TROWA_SCOPE_INPUT_AREA_WIDTH		365  // 295 265
+// Only read the controls (knobs, buttons, color/rotation/time CVs) every this many samples. Capture is still every sample.
+#define TROWA_SCOPE_CONTROL_RATE_DIVIDER	32
 
 // Laying out controls
 #define TROWA_SCOPE_CONTROL_START_X			47  // 47
@@ -24,6 +35,9 @@
 #define TROWA_SCOPE_CONTROL_SHAPE_SPACING		16 // 8
 
 
+// Max vertices in a cached path (clipping can inject an extra point per segment).
+#define TROWA_SCOPE_MAX_PATH_POINTS			(2*BUFFER_SIZE)
+
 // Labels for each waveform / shape
 #define TROWA_SCOPE_SHAPE_FORMAT_STRING		"Shp %d"
 
@@ -33,59 +47,79 @@
 // Scope module that draws multiple waveforms.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 //===============================================================================
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeBlockId()
+// Per-waveform ids are laid out in blocks of numWaveforms (X + wIx), any single
+// ids come after all the blocks.
+// @numWaveforms : (IN) Number of waveforms.
+// @numBlocks : (IN) Number of per-waveform ids (the single ids start here).
+// @id : (IN) The id (block or single).
+// @wIx : (IN) The waveform index (ignored for single ids).
+// @returns : The actual index into params/inputs/lights.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+inline int TSScopeBlockId(int numWaveforms, int numBlocks, int id, int wIx)
+{
+	return (id < numBlocks) ? id * numWaveforms + wIx : numBlocks * numWaveforms + (id - numBlocks);
+}
+
 struct multiScope : Module {
-	// Should probably make this linearly growing in case of course, we add more freaken waveforms...
-	// TODO: Refactor to make variable num waveforms.
+	// Per-waveform ids are blocks of numWaveforms. Use paramId(), inputId(), lightId() to get the actual index.
+	// (With 3 waveforms this is the same layout as always so old patches still load).
 	enum ParamIds {
 		COLOR_PARAM,
-		EXTERNAL_PARAM = COLOR_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		ROTATION_PARAM = EXTERNAL_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		ROTATION_MODE_PARAM = ROTATION_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		TIME_PARAM = ROTATION_MODE_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		TRIG_PARAM = TIME_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		X_POS_PARAM = TRIG_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		X_SCALE_PARAM = X_POS_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		Y_POS_PARAM = X_SCALE_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		Y_SCALE_PARAM = Y_POS_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		LINK_XY_SCALE_PARAM = Y_SCALE_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,	   // Force Scale X = Scale Y.
-		OPACITY_PARAM = LINK_XY_SCALE_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,	   // Alpha channel
-		LISSAJOUS_PARAM = OPACITY_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,		  
-		THICKNESS_PARAM = LISSAJOUS_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		FILL_ON_PARAM = THICKNESS_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		FILL_COLOR_PARAM = FILL_ON_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		FILL_OPACITY_PARAM = FILL_COLOR_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
-		EFFECT_PARAM = FILL_OPACITY_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
+		EXTERNAL_PARAM,
+		ROTATION_PARAM,
+		ROTATION_MODE_PARAM,
+		TIME_PARAM,
+		TRIG_PARAM,
+		X_POS_PARAM,
+		X_SCALE_PARAM,
+		Y_POS_PARAM,
+		Y_SCALE_PARAM,
+		LINK_XY_SCALE_PARAM,	   // Force Scale X = Scale Y.
+		OPACITY_PARAM,	   // Alpha channel
+		LISSAJOUS_PARAM,		  
+		THICKNESS_PARAM,
+		FILL_ON_PARAM,
+		FILL_COLOR_PARAM,
+		FILL_OPACITY_PARAM,
+		EFFECT_PARAM,
+		NUM_WAVEFORM_PARAMS, // Number of per-waveform params
 		// Single Inputs:
 		// Info display
-		INFO_DISPLAY_TOGGLE_PARAM = EFFECT_PARAM + TROWA_SCOPE_NUM_WAVEFORMS,
+		INFO_DISPLAY_TOGGLE_PARAM = NUM_WAVEFORM_PARAMS,
 		// BG Color Display
-		BGCOLOR_DISPLAY_PARAM = INFO_DISPLAY_TOGGLE_PARAM + 1,
-		NUM_PARAMS = BGCOLOR_DISPLAY_PARAM + 1
+		BGCOLOR_DISPLAY_PARAM,
+		NUM_PARAMS
 	};
 	enum InputIds {
 		COLOR_INPUT,
-		ROTATION_INPUT = COLOR_INPUT+TROWA_SCOPE_NUM_WAVEFORMS,
-		TIME_INPUT = ROTATION_INPUT+TROWA_SCOPE_NUM_WAVEFORMS,
-		X_INPUT = TIME_INPUT+TROWA_SCOPE_NUM_WAVEFORMS,
-		Y_INPUT = X_INPUT+TROWA_SCOPE_NUM_WAVEFORMS,
-		OPACITY_INPUT = Y_INPUT + TROWA_SCOPE_NUM_WAVEFORMS, // Opacity/Alpha channel
-		PEN_ON_INPUT = OPACITY_INPUT + TROWA_SCOPE_NUM_WAVEFORMS, // Turn on/off drawing lines in between points.
-		THICKNESS_INPUT = PEN_ON_INPUT + TROWA_SCOPE_NUM_WAVEFORMS,
-		FILL_COLOR_INPUT = THICKNESS_INPUT + TROWA_SCOPE_NUM_WAVEFORMS,
-		FILL_OPACITY_INPUT = FILL_COLOR_INPUT + TROWA_SCOPE_NUM_WAVEFORMS,
-		NUM_INPUTS = FILL_OPACITY_INPUT + TROWA_SCOPE_NUM_WAVEFORMS
+		ROTATION_INPUT,
+		TIME_INPUT,
+		X_INPUT,
+		Y_INPUT,
+		OPACITY_INPUT, // Opacity/Alpha channel
+		PEN_ON_INPUT, // Turn on/off drawing lines in between points.
+		THICKNESS_INPUT,
+		FILL_COLOR_INPUT,
+		FILL_OPACITY_INPUT,
+#if TROWA_SCOPE_USE_Z_DIMENSION
+		Z_INPUT, // Z (depth). Lissajous waveforms with Z are drawn in 3D.
+#endif
+		NUM_INPUTS
 	};
 
 	enum LightIds {
 		COLOR_LED,
-		ROT_LED = COLOR_LED+TROWA_SCOPE_NUM_WAVEFORMS,
-		LINK_XY_SCALE_LED = ROT_LED + TROWA_SCOPE_NUM_WAVEFORMS,
-		LISSAJOUS_LED = LINK_XY_SCALE_LED + TROWA_SCOPE_NUM_WAVEFORMS,
-		HIGHLIGHT_LED = LISSAJOUS_LED + TROWA_SCOPE_NUM_WAVEFORMS,
-		FILL_ON_LED = HIGHLIGHT_LED + TROWA_SCOPE_NUM_WAVEFORMS,
-		INFO_DISPLAY_TOGGLE_LED = FILL_ON_LED + TROWA_SCOPE_NUM_WAVEFORMS,
-		BGCOLOR_DISPLAY_LED = INFO_DISPLAY_TOGGLE_LED + 1,
-		NUM_LEDS = BGCOLOR_DISPLAY_LED + 1
+		ROT_LED,
+		LINK_XY_SCALE_LED,
+		LISSAJOUS_LED,
+		HIGHLIGHT_LED,
+		FILL_ON_LED,
+		NUM_WAVEFORM_LEDS, // Number of per-waveform lights
+		INFO_DISPLAY_TOGGLE_LED = NUM_WAVEFORM_LEDS,
+		BGCOLOR_DISPLAY_LED,
+		NUM_LEDS
 	};
 
 	enum OutputIds {
@@ -104,15 +138,39 @@ struct multiScope : Module {
 	// Current Color Picker Color (ptr to which color we are editing)
 	NVGcolor* editColorPointer;
 
-	// Information about what we are plotting. In future may become dynamically allocated.
-	TSWaveform* waveForms[TROWA_SCOPE_NUM_WAVEFORMS];
-
+	// Number of waveforms / shapes.
+	int numWaveforms = TROWA_SCOPE_NUM_WAVEFORMS;
+	// Information about what we are plotting (only the first numWaveforms are used).
+	TSWaveform* waveForms[TROWA_SCOPE_MAX_NUM_WAVEFORMS];
+	// Samples until we read the controls again.
+	int controlCounter = 0;
+	// Sample rate (read at control rate).
+	float sampleRate = 44100;
 
-
-	multiScope();
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// multiScope()
+	// @numWaveforms : (IN) Number of waveforms / shapes (1 to TROWA_SCOPE_MAX_NUM_WAVEFORMS).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	multiScope(int numWaveforms = TROWA_SCOPE_NUM_WAVEFORMS);
 	~multiScope();
 	void step() override;
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// processControls()
+	// Read the knobs, buttons and CVs for all waveforms (control rate).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void processControls();
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// captureFrames()
+	// Add the current sample to the buffers of all waveforms (audio rate).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void captureFrames();
+	// Get the param index for the given waveform.
+	inline int paramId(int id, int wIx = 0) { return TSScopeBlockId(numWaveforms, NUM_WAVEFORM_PARAMS, id, wIx); }
+	// Get the input index for the given waveform.
+	inline int inputId(int id, int wIx = 0) { return TSScopeBlockId(numWaveforms, NUM_INPUTS, id, wIx); }
+	// Get the light index for the given waveform.
+	inline int lightId(int id, int wIx = 0) { return TSScopeBlockId(numWaveforms, NUM_WAVEFORM_LEDS, id, wIx); }
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// toJson(void)
 	// Save to json.
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-	
@@ -129,7 +187,7 @@ struct multiScope : Module {
 		json_t* waveColorJ = json_array();
 		json_t* waveFillColorJ = json_array();
 		json_t* waveDoFillJ = json_array();
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+		for (int wIx = 0; wIx < numWaveforms; wIx++)
 		{
 			json_t* itemJ = json_real(waveForms[wIx]->waveHue);
 			json_array_append_new(huesJ, itemJ);
@@ -204,7 +262,7 @@ struct multiScope : Module {
 		json_t* waveFillColorJ = json_object_get(rootJ, "waveFillColor");
 		json_t* waveDoFillJ = json_object_get(rootJ, "waveDoFill");
 
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+		for (int wIx = 0; wIx < numWaveforms; wIx++)
 		{
 			json_t* itemJ = json_array_get(huesJ, wIx);
 			if (itemJ)
@@ -276,7 +334,7 @@ struct multiScope : Module {
 	}
 
 	void reset()  override {
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+		for (int wIx = 0; wIx < numWaveforms; wIx++)
 		{
 			waveForms[wIx]->doFill = false;
 			waveForms[wIx]->linkXYScales = false; // Added
@@ -291,7 +349,7 @@ struct multiScope : Module {
 // TSScopeDisplay
 // A top digital display for trowaSoft scope.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-struct TSScopeDisplay : TransparentWidget {
+struct TSScopeDisplay : TransparentWidget, TS_StaticLayerSource {
 	multiScope *module;
 	std::shared_ptr<Font> font;
 	std::shared_ptr<Font> labelFont;
@@ -299,24 +357,24 @@ struct TSScopeDisplay : TransparentWidget {
 	char messageStr[TROWA_DISP_MSG_SIZE];
 	bool visible = true;
 	int originalWidth = 240;
+	// Cached background and column labels.
+	TS_StaticLayer* staticLayer;
 
 	TSScopeDisplay() {
 		visible = true;
-		font = Font::load(assetPlugin(plugin, TROWA_DIGITAL_FONT));
-		labelFont = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_DIGITAL);
+		labelFont = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 12;
 		for (int i = 0; i < TROWA_DISP_MSG_SIZE; i++)
 			messageStr[i] = '\0';
+		staticLayer = new TS_StaticLayer(this);
+		addChild(staticLayer);
 	}
-
-	void draw(NVGcontext *vg) override {
-		if (!visible)
-			return; // Don't draw anything if we are not visible.
-
-		nvgSave(vg);
-		Rect b = Rect(Vec(0, 0), box.size);
-		nvgScissor(vg, b.pos.x, b.pos.y, b.size.x, b.size.y);
-
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// drawStaticLayer()
+	// Background and column labels (only redrawn when our size changes).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void drawStaticLayer(NVGcontext *vg) override {
 		// Default Font:
 		nvgFontSize(vg, fontSize);
 		nvgTextLetterSpacing(vg, 1);
@@ -338,36 +396,19 @@ struct TSScopeDisplay : TransparentWidget {
 
 		////////////// Labels /////////////////
 		const int yStart = 10;
-		int xStart = 10;
 		const int dxRotation = 3; // 10
 		const int dxEffect = 12;
 		int y = yStart;
-		int x = xStart;
+		int x = 0;
 		int dx = 59; //41 // 37; // 35
-		int dy = 16; //14
 
-		//nvgFontSize(vg, fontSize); // Small font
 		nvgFontFaceId(vg, labelFont->handle);
-		nvgFillColor(vg, textColor);
-		// Row Labels 
-		nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
-		y = yStart + 5;
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
-		{
-			NVGcolor currColor = module->waveForms[wIx]->waveColor;
-			nvgFillColor(vg, currColor);
-			sprintf(messageStr, "S%d", wIx + 1);
-			nvgText(vg, 5, y, messageStr, NULL);
-			y += dy;
-		}
-		
 		// Column Labels:		
 		nvgTextAlign(vg, NVG_ALIGN_RIGHT);
 		nvgFillColor(vg, textColor);
 
 		// Column 1 (Labels)
-		y = yStart;
-		xStart = 35; // 40
+		int xStart = 35; // 40
 		x = xStart + dx / 2.0;
 		nvgText(vg, x, y, "X Offset", NULL);
 
@@ -388,34 +429,84 @@ struct TSScopeDisplay : TransparentWidget {
 		x += (dx + dxEffect)/2.0;
 		nvgTextAlign(vg, NVG_ALIGN_CENTER);
 		nvgText(vg, x, y, "Effect", NULL);
+		return;
+	} // end drawStaticLayer()
+
+	// Invalidate the static layer before it steps (FramebufferWidget re-renders in step(), not draw()).
+	void step() override {
+		staticLayer->setSize(box.size);
+		TransparentWidget::step();
+		return;
+	}
+
+	void draw(NVGcontext *vg) override {
+		if (!visible)
+			return; // Don't draw anything if we are not visible.
+
+		nvgSave(vg);
+		Rect b = Rect(Vec(0, 0), box.size);
+		nvgScissor(vg, b.pos.x, b.pos.y, b.size.x, b.size.y);
+
+		// Static layer (cached)
+		Widget::draw(vg);
+
+		// Default Font:
+		nvgFontSize(vg, fontSize);
+		nvgTextLetterSpacing(vg, 1);
+		NVGcolor textColor = nvgRGB(0xee, 0xee, 0xee);
+
+		const int yStart = 10;
+		int xStart = 10;
+		const int dxRotation = 3; // 10
+		const int dxEffect = 12;
+		int y = yStart;
+		int x = xStart;
+		int dx = 59; //41 // 37; // 35
+		int dy = 16; //14
 
+		//nvgFontSize(vg, fontSize); // Small font
+		nvgFontFaceId(vg, labelFont->handle);
+		nvgFillColor(vg, textColor);
+		// Row Labels (waveform colors may change at any time)
+		nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+		y = yStart + 5;
+		for (int wIx = 0; wIx < module->numWaveforms; wIx++)
+		{
+			NVGcolor currColor = module->waveForms[wIx]->waveColor;
+			nvgFillColor(vg, currColor);
+			sprintf(messageStr, "S%d", wIx + 1);
+			nvgText(vg, 5, y, messageStr, NULL);
+			y += dy;
+		}
+		nvgFillColor(vg, textColor);
+		xStart = 35; // 40
 		// Values:
 		y = yStart + 5;
 		NVGcolor absRotColor = TROWA_SCOPE_ABS_ROT_ON_COLOR;
 		absRotColor.a = 0.50;
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+		for (int wIx = 0; wIx < module->numWaveforms; wIx++)
 		{
 			// NVGcolor currColor = module->waveForms[wIx]->waveColor;
 			nvgTextAlign(vg, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
 
 			// X Offset
 			x = xStart + dx / 2.0;
-			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[multiScope::X_POS_PARAM + wIx].value);
+			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[module->paramId(multiScope::X_POS_PARAM, wIx)].value);
 			nvgText(vg, x, y, messageStr, NULL);
 
 			// X Gain
 			x += dx;
-			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[multiScope::X_SCALE_PARAM + wIx].value);
+			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[module->paramId(multiScope::X_SCALE_PARAM, wIx)].value);
 			nvgText(vg, x, y, messageStr, NULL);
 
 			// Y Offset
 			x += dx;
-			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[multiScope::Y_POS_PARAM + wIx].value);
+			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[module->paramId(multiScope::Y_POS_PARAM, wIx)].value);
 			nvgText(vg, x, y, messageStr, NULL);
 
 			// Y Gain
 			x += dx;
-			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[multiScope::Y_SCALE_PARAM + wIx].value);
+			sprintf(messageStr, TROWA_SCOPE_ROUND_FORMAT, module->params[module->paramId(multiScope::Y_SCALE_PARAM, wIx)].value);
 			nvgText(vg, x, y, messageStr, NULL);
 
 			// Rotation
@@ -460,106 +551,131 @@ struct TSScopeDisplay : TransparentWidget {
 }; // end TSScopeDisplay
 
 
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopePathCache
+// Transformed (rotated/scaled) and clipped vertices for one drawn waveform, kept
+// between UI frames. Only rebuilt when the buffer generation or the transform
+// changes; color/opacity/effect changes just replay it.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSScopePathCache {
+	// The vertices to plot (in order).
+	Vec points[TROWA_SCOPE_MAX_PATH_POINTS];
+	// If this vertex starts a new sub-path (nvgMoveTo) instead of continuing one (nvgLineTo).
+	bool moveTo[TROWA_SCOPE_MAX_PATH_POINTS];
+	// Scratch: transformed x of every buffer point (draw order).
+	float vx[BUFFER_SIZE];
+	// Scratch: transformed y of every buffer point (draw order).
+	float vy[BUFFER_SIZE];
+	// Scratch: location codes of every buffer point (draw order).
+	uint8_t codes[BUFFER_SIZE];
+	// Scratch: depth of every buffer point (draw order, 3D only).
+	float vz[BUFFER_SIZE];
+	// Depth band of the segment ending at this vertex (3D only).
+	uint8_t band[TROWA_SCOPE_MAX_PATH_POINTS];
+	// Number of vertices in use.
+	int numPoints = 0;
+	// If this cache has been built at least once.
+	bool valid = false;
+	//--- What the cache was built from ---
+	// Source buffer.
+	float* srcX = NULL;
+	// Source Y buffer (NULL if plotting vs time).
+	float* srcY = NULL;
+	// Source Z buffer (NULL if not 3D).
+	float* srcZ = NULL;
+	// The waveform buffer generation.
+	uint32_t generation = 0;
+	// The buffer index we started drawing at (lissajous).
+	int startIx = 0;
+	float gainX = 0;
+	float gainY = 0;
+	float offsetX = 0;
+	float offsetY = 0;
+	float gainZ = 0;
+	// Rotation [radians] (yaw if 3D).
+	float rot = 0;
+	float lineThickness = 0;
+	bool doTrim = false;
+	bool flipX = false;
+	bool flipY = false;
+	// Size of the display box.
+	Vec size;
+};
+
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // multiScopeDisplay
-// Draws a waveform.
+// Draws all the waveforms (in order).
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 struct multiScopeDisplay : TransparentWidget {
 	multiScope *module;
 	int frame = 0;
-	float rot = 0;
 	std::shared_ptr<Font> font;
-	int wIx = 0; // Waveform index
+	// Number of waveforms we have set up for.
+	int numWaveforms = 0;
+	// Current rotation [radians] per waveform.
+	float rot[TROWA_SCOPE_MAX_NUM_WAVEFORMS] = {};
+	// Cached paths (2 per waveform). Lissajous uses [2*wIx] only (X x Y), otherwise [2*wIx] is Y and [2*wIx+1] is X.
+	TSScopePathCache* pathCache = NULL;
+	// 3D projection per waveform (only recalculated when the rotation changes).
+	TSScopeProjection projection[TROWA_SCOPE_MAX_NUM_WAVEFORMS];
 	
 	multiScopeDisplay() {
 		//spoutInitSpout();
 		return;
 	}
+	~multiScopeDisplay() {
+		if (pathCache)
+			delete[] pathCache;
+		pathCache = NULL;
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// setNumWaveforms()
+	// @n : (IN) Number of waveforms to draw. Allocates the path caches.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void setNumWaveforms(int n) {
+		if (pathCache)
+			delete[] pathCache;
+		numWaveforms = clampi(n, 0, TROWA_SCOPE_MAX_NUM_WAVEFORMS);
+		pathCache = (numWaveforms > 0) ? new TSScopePathCache[2 * numWaveforms] : NULL;
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// updatePath()
+	// @path : (IN/OUT) The path cache to check/rebuild.
+	// @waveForm: (IN) The waveform (pen on, generation, buffer index, thickness).
+	// @valX: (IN) Pointer to raw x buffer (or the plotted buffer if valY is NULL).
+	// @valY: (IN) Pointer to raw y buffer (or NULL to plot valX vs time).
+	// @valZ: (IN) Pointer to raw z buffer (or NULL for 2D). Requires valY and proj.
+	// @gainX/gainY/gainZ: (IN) Gain (already divided by 10).
+	// @offsetX/offsetY: (IN) Offsets.
+	// @rotation: (IN) Rotation [radians] (3D: the yaw already in proj).
+	// @proj: (IN) The 3D projection (if valZ).
+	// @doTrim: (IN) If we need to clip to our box.
+	// @flipX: (IN) Mirror along x (about the center).
+	// @flipY: (IN) Mirror along y (about the center).
+	// Rebuilds the transformed/clipped vertices only if the buffer or transform changed.
+	// @returns: True if rebuilt, false if the cache was used.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	bool updatePath(TSScopePathCache* path, TSWaveform* waveForm, float* valX, float* valY, float* valZ,
+		float gainX, float gainY, float gainZ, float offsetX, float offsetY, float rotation, const TSScopeProjection* proj,
+		bool doTrim, bool flipX, bool flipY);
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// drawWaveform()
-	// @vg : (IN) NVGcontext
-	// @valX: (IN) Pointer to x values.
-	// @valY: (IN) Pointer to y values.
-	// @rotRate: (IN) Rotation rate in radians
+	// @vg : (IN) NVGcontext (scissor should already be set).
+	// @path: (IN) The (transformed) path to draw.
 	// @lineThickness: (IN) Line thickness
 	// @compositeOp: (IN) Some global effect if any
-	// @flipX: (IN) Flip along x (at x=0)
-	// @flipY: (IN) Flip along y
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-	void drawWaveform(NVGcontext *vg, float *valX, float *valY, bool* penOn,
-		float rotRate, float lineThickness, NVGcolor lineColor,
+	void drawWaveform(NVGcontext *vg, TSScopePathCache* path,
+		float lineThickness, NVGcolor lineColor,
 		bool doFill, NVGcolor fillColor,
-		NVGcompositeOperation compositeOp, bool flipX, bool flipY);
-
-
-	void draw(NVGcontext *vg) override {
-		if (!module->initialized)
-			return;
-		float gainX = ((int)(module->params[multiScope::X_SCALE_PARAM + wIx].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
-		float gainY = ((int)(module->params[multiScope::Y_SCALE_PARAM + wIx].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
-		float offsetX = ((int)(module->params[multiScope::X_POS_PARAM + wIx].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
-		float offsetY = ((int)(module->params[multiScope::Y_POS_PARAM + wIx].value * TROWA_SCOPE_ROUND_VALUE)) / (float)(TROWA_SCOPE_ROUND_VALUE);
-
-		TSWaveform* waveForm = module->waveForms[wIx];
-		float valuesX[BUFFER_SIZE];
-		float valuesY[BUFFER_SIZE];
-		bool penOn[BUFFER_SIZE];
-		float multX = gainX / 10.0;
-		float multY = gainY / 10.0;
-		for (int i = 0; i < BUFFER_SIZE; i++) {
-			int j = i;
-			// Lock display to buffer if buffer update deltaTime <= 2^-11
-			if (waveForm->lissajous)
-				j = (i + waveForm->bufferIndex) % BUFFER_SIZE;
-			valuesX[i] = (waveForm->bufferX[j] + offsetX) * multX;
-			valuesY[i] = (waveForm->bufferY[j] + offsetY) * multY;
-			penOn[i] = waveForm->bufferPenOn[j];
-		}
-
-		// Draw waveforms
-		// 1. Line Color:
-		NVGcolor waveColor = waveForm->waveColor;
-		waveColor.a = waveForm->waveOpacity;
-		if (waveForm->negativeImage)
-			waveColor = ColorInvertToNegative(waveColor);
-		nvgStrokeColor(vg, waveColor); // Color has already been calculated by main module
-		// 2. Fill color:
-		NVGcolor fillColor = waveForm->fillColor;
-		if (waveForm->doFill)
-		{
-			fillColor.a = waveForm->fillOpacity;
-			nvgFillColor(vg, fillColor);
-		}
-		// 3. Rotation
-		float rotRate = 0;
-		if (waveForm->rotMode)
-		{
-			// Absolute position:
-			rot = waveForm->rotAbsValue;
-		}
-		else
-		{
-			// Differential rotation
-			rotRate = waveForm->rotDiffValue;
-		}
-		if (waveForm->lissajous) {
-			// X x Y
-			if (module->inputs[multiScope::X_INPUT + wIx].active || module->inputs[multiScope::Y_INPUT + wIx].active) {
-				drawWaveform(vg, valuesX, valuesY, penOn, rotRate, waveForm->lineThickness, waveColor, waveForm->doFill, fillColor, SCOPE_GLOBAL_EFFECTS[module->waveForms[wIx]->gEffectIx]->compositeOperation, false, false);
-			}
-		}
-		else {
-			// Y
-			if (module->inputs[multiScope::Y_INPUT + wIx].active) {
-				drawWaveform(vg, valuesY, NULL, penOn, rotRate, waveForm->lineThickness, waveColor, waveForm->doFill, fillColor, SCOPE_GLOBAL_EFFECTS[module->waveForms[wIx]->gEffectIx]->compositeOperation, false, false);
-			}
-			// X
-			if (module->inputs[multiScope::X_INPUT + wIx].active) {
-				drawWaveform(vg, valuesX, NULL, penOn, rotRate, waveForm->lineThickness, waveColor, waveForm->doFill, fillColor, SCOPE_GLOBAL_EFFECTS[module->waveForms[wIx]->gEffectIx]->compositeOperation, false, false);
-			}
-		}
-		return;
-	} // end draw()
+		NVGcompositeOperation compositeOp);
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// draw()
+	// Draw all the waveforms under one scissor.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void draw(NVGcontext *vg) override;
 }; // end multiScopeDisplay
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
@@ -573,7 +689,7 @@ struct TSScopeLabelArea : TransparentWidget {
 	char messageStr[TROWA_DISP_MSG_SIZE];
 
 	TSScopeLabelArea() {
-		font = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 10;
 		for (int i = 0; i < TROWA_DISP_MSG_SIZE; i++)
 			messageStr[i] = '\0';
@@ -665,12 +781,15 @@ struct TSScopeLabelArea : TransparentWidget {
 		int x, y;
 		int shapeDy = dy * 3 + knobOffset + shapeSpacingY + 3;
 
-		x = xStart;
-		y = yStart;
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+		for (int wIx = 0; wIx < module->numWaveforms; wIx++)
 		{
+			// More waveforms than fit go in another column
+			int colX = (wIx / TROWA_SCOPE_WAVEFORMS_PER_COLUMN) * TROWA_SCOPE_INPUT_AREA_WIDTH;
+			nvgSave(vg);
+			nvgTranslate(vg, colX, 0);
 			nvgFontSize(vg, fontSize);
 			x = xStart;
+			y = yStart + (wIx % TROWA_SCOPE_WAVEFORMS_PER_COLUMN) * (shapeDy - 3);
 			int waveY = y;
 			// Shape Label:		
 			nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
@@ -719,6 +838,12 @@ struct TSScopeLabelArea : TransparentWidget {
 			nvgText(vg, x1, y1, "LNK", NULL);
 
 			x1 += 2*dx;
+#if TROWA_SCOPE_USE_Z_DIMENSION
+			// Z port sits under the color knob, so the pen label goes right over its port.
+			int y2 = y1 - 6;
+			nvgText(vg, x1 - 0.5*dx, y2, "Z", NULL);
+			nvgText(vg, x1 + 0.5*dx, y2, "BLANK<=0", NULL);
+#else
 			int y2 = y1 + 9;
 			nvgText(vg, x1 - 8, y2, "BLANK", NULL);
 			y2 += fontSize * 0.8 + 0.5;
@@ -731,6 +856,7 @@ struct TSScopeLabelArea : TransparentWidget {
 			nvgStrokeWidth(vg, 1.0);
 			nvgStrokeColor(vg, textColor);
 			nvgStroke(vg);			
+#endif
 
 			nvgFontSize(vg, fontSize*0.8);
 			x1 += 1.5*dx; // Fill Color
@@ -761,8 +887,7 @@ struct TSScopeLabelArea : TransparentWidget {
 				/*radius*/ 14,
 				/*thickness*/ 4.0);
 
-
-			y += shapeDy - 3;
+			nvgRestore(vg);
 		} // end loop through shapes/waveforms
 		return;
 	} // end draw()
@@ -777,7 +902,7 @@ struct TSScopeSideBarLabelArea : TransparentWidget {
 	std::shared_ptr<Font> font;
 	int fontSize;
 	TSScopeSideBarLabelArea() {
-		font = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 10;
 	}
 	TSScopeSideBarLabelArea(Vec bsize) : TSScopeSideBarLabelArea() {
@@ -5,6 +5,7 @@
 #include "trowaSoftComponents.hpp"
 #include "trowaSoftUtilities.hpp"
 #include "TSSequencerModuleBase.hpp"
+#include "TSLightGrid.hpp"
 #include "Module_trigSeq.hpp"
 #include "TSOSCSequencerOutputMessages.hpp"
 #include "TSOSCCommon.hpp"
@@ -98,31 +99,37 @@ void trigSeq::step() {
 			oscStream << osc::BeginBundleImmediate;
 		}
 		oscMutex.unlock();
-		// Load this gate and/or pattern into our 4x4 matrix
+		// Pads show the channel color (the widget sets it)
+		setPadColor(voiceColors[currentChannelEditingIx]);
+		// Load this gate and/or pattern into our 4x4 matrix (the shown page). OSC clients get all the steps.
 		for (int s = 0; s < maxSteps; s++) 
 		{
-			r = s / this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
-			c = s % this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
-
-			padLightPtrs[r][c]->setColor(voiceColors[currentChannelEditingIx]);
-			if (triggerState[currentPatternEditingIx][currentChannelEditingIx][s])
-			{
-				gateLights[r][c] = 1.0f - stepLights[r][c];
-				gateTriggers[s].state = SchmittTrigger::HIGH;				
-			} 
-			else
+			int shownIx = getShownStepIx(s);
+			if (shownIx > -1)
 			{
-				gateLights[r][c] = 0.0f; // Turn light off	
-				gateTriggers[s].state = SchmittTrigger::LOW;
+				r = shownIx / this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
+				c = shownIx % this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
+				if (triggerState[currentPatternEditingIx][currentChannelEditingIx][s])
+				{
+					gateLights[r][c] = 1.0f - stepLights[r][c];
+					gateTriggers[shownIx].state = SchmittTrigger::HIGH;
+				}
+				else
+				{
+					gateLights[r][c] = 0.0f; // Turn light off	
+					gateTriggers[shownIx].state = SchmittTrigger::LOW;
+				}
 			}
 			oscMutex.lock();
-			if (sendOSC && oscInitialized)
+			// touchOSC grids only have the shown page
+			if (sendOSC && oscInitialized && (shownIx > -1 || this->oscCurrentClient != OSCClient::touchOSCClient))
 			{
-				if (s > 0 && s % 16 == 0) // There is a limit to client buffer size, so let's not make the bundles too large. Hopefully they can take 16-steps at a time.
+				// There is a limit to client buffer size, so let's not make the bundles too large. Hopefully they can take 16-steps at a time.
+				// (A stream transport has no such limit, send it all in one bundle).
+				if (s > 0 && s % 16 == 0 && !oscSendBatch.isStream())
 				{
 					// Send this bundle and then start a new one
-					oscStream << osc::EndBundle;
-					oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+					endOSCDelta(oscStream);
 					oscStream.Clear();
 					// Start new bundle:
 					oscStream << osc::BeginBundleImmediate;
@@ -130,13 +137,13 @@ void trigSeq::step() {
 				if (this->oscCurrentClient == OSCClient::touchOSCClient)
 				{
 					// LED Color (current step LED):
-					sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::PlayStepLed], s + 1);
+					sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::PlayStepLed], shownIx + 1);
 					sprintf(addrBuff, OSC_TOUCH_OSC_CHANGE_COLOR_FS, addrBuff);
 					oscStream << osc::BeginMessage(addrBuff)
 						<< touchOSC::ChannelColors[currentChannelEditingIx]
 						<< osc::EndMessage;
 					// Step:
-					touchOSC::stepIndex_to_mcRowCol(s, numRows, numCols, &gridRow, &gridCol);
+					touchOSC::stepIndex_to_mcRowCol(shownIx, numRows, numCols, &gridRow, &gridCol);
 					sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::EditTOSC_GridStep], gridRow, gridCol); // Grid's /<row>/<col> to accomodate touchOSC's lack of multi-parameter support.
 				}
 				else
@@ -166,8 +173,7 @@ void trigSeq::step() {
 					<< osc::EndMessage;
 			}
 			// End last bundle and send:
-			oscStream << osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			endOSCDelta(oscStream);
 		}
 		oscMutex.unlock();
 	}
@@ -183,21 +189,25 @@ void trigSeq::step() {
 		oscMutex.unlock();
 		int numChanged = 0;
 
-		// Step buttons/pads (for this one Channel/gate) - Read Inputs
-		for (int s = 0; s < maxSteps; s++) 
+		// Step buttons/pads (for this one Channel/gate) - Read Inputs. Only the shown page has pads.
+		int pageStartIx = currentPageIx * numPageSteps;
+		float* editSteps = triggerState[currentPatternEditingIx][currentChannelEditingIx] + pageStartIx;
+		int numShownSteps = (maxSteps - pageStartIx < numPageSteps) ? maxSteps - pageStartIx : numPageSteps;
+		for (int s = 0; s < numShownSteps; s++) 
 		{
 			bool sendLightVal = false;
 			if (gateTriggers[s].process(params[ParamIds::CHANNEL_PARAM + s].value)) 
 			{
-				triggerState[currentPatternEditingIx][currentChannelEditingIx][s] = !triggerState[currentPatternEditingIx][currentChannelEditingIx][s];
+				editSteps[s] = !editSteps[s];
 				sendLightVal = sendOSC; // Value has changed.
 			}
 			r = s / this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
 			c = s % this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
-			stepLights[r][c] -= stepLights[r][c] / lightLambda / engineGetSampleRate();
-			
-			gateLights[r][c] = (triggerState[currentPatternEditingIx][currentChannelEditingIx][s]) ? 1.0 - stepLights[r][c] : stepLights[r][c];
-			lights[PAD_LIGHTS + s].value = gateLights[r][c];
+			if (lightsUpdate)
+			{
+				gateLights[r][c] = (editSteps[s]) ? 1.0 - stepLights[r][c] : stepLights[r][c];
+				lights[PAD_LIGHTS + s].value = gateLights[r][c];
+			}
 
 			oscMutex.lock();
 			// This step has changed and we are doing OSC
@@ -211,13 +221,13 @@ void trigSeq::step() {
 				}
 				else
 				{
-					sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::EditStep], s + 1); // Changed to /<step> to accomodate touchOSC's lack of multi-parameter support.
+					sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::EditStep], pageStartIx + s + 1); // Changed to /<step> to accomodate touchOSC's lack of multi-parameter support.
 				}
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-				debug("Step changed %d (new val is %.2f), sending OSC %s", s, triggerState[currentPatternEditingIx][currentChannelEditingIx][s], addrBuff);
+				debug("Step changed %d (new val is %.2f), sending OSC %s", pageStartIx + s, editSteps[s], addrBuff);
 #endif
 				oscStream << osc::BeginMessage(addrBuff)
-					<< triggerState[currentPatternEditingIx][currentChannelEditingIx][s]
+					<< editSteps[s]
 					<< osc::EndMessage;
 				numChanged++;
 			} // end if send the value over OSC
@@ -226,8 +236,7 @@ void trigSeq::step() {
 		oscMutex.lock();
 		if (sendOSC && oscInitialized && numChanged > 0)
 		{			
-			oscStream << osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			endOSCDelta(oscStream);
 		}
 		oscMutex.unlock();
 	} // end else (read buttons)
@@ -247,6 +256,8 @@ void trigSeq::step() {
 	}	
 	// Now we have to keep track of this for OSC...
 	prevIndex = index;
+	// Send whatever OSC we queued up
+	flushOSC();
 	return;
 } // end step()
 
@@ -266,7 +277,7 @@ trigSeqWidget::trigSeqWidget() : TSSequencerWidgetBase()
 	{
 		SVGPanel *panel = new SVGPanel();
 		panel->box.size = box.size;
-		panel->setBackground(SVG::load(assetPlugin(plugin, "res/trigSeq.svg")));
+		panel->setBackground(TSAssets::svg(TS_SVG_PANEL_TRIGSEQ));
 		addChild(panel);
 	}
 	
@@ -277,6 +288,9 @@ trigSeqWidget::trigSeqWidget() : TSSequencerWidgetBase()
 	int x = 79;
 	int dx = 3;
 	Vec lSize = Vec(50 - 2*dx, 50 - 2*dx);
+	// All pad lights are drawn together by the grid
+	TS_LightSquareGrid* lightGrid = new TS_LightSquareGrid(/*pitch*/ Vec(59, 59));
+	lightGrid->box.size = box.size;
 	for (int r = 0; r < module->numRows; r++) //---------THE PADS
 	{
 		for (int c = 0; c < module->numCols; c++)
@@ -290,12 +304,13 @@ trigSeqWidget::trigSeqWidget() : TSSequencerWidgetBase()
 				/*module*/ module, 
 				/*lightId*/ TSSequencerModuleBase::PAD_LIGHTS + r*module->numCols + c,
 				/* size */ lSize, /* color */ module->voiceColors[module->currentChannelEditingIx]));
-			addChild( module->padLightPtrs[r][c] );
+			lightGrid->addLight( module->padLightPtrs[r][c] );
 			x+= 59;
 		}		
 		y += 59; // Next row
 		x = 79;
 	} // end loop through MxN grid	
+	addChild(lightGrid);
 	module->modeString = module->modeStrings[module->selectedOutputValueMode];
 	module->initialized = true;
 	return;
@@ -27,7 +27,7 @@ struct trigSeq : TSSequencerModuleBase
 	
 	trigSeq(int numSteps, int numRows, int numCols) : TSSequencerModuleBase(numSteps, numRows, numCols, false)
 	{
-		gateTriggers = new SchmittTrigger[numSteps]; // maxSteps
+		gateTriggers = new SchmittTrigger[numPageSteps]; // Only the shown page has pads
 		selectedOutputValueMode = VALUE_TRIGGER;
 		lastOutputValueMode = selectedOutputValueMode;
 		modeStrings[0] = "TRIG";
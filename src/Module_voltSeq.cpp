@@ -6,6 +6,7 @@
 #include "trowaSoftComponents.hpp"
 #include "trowaSoftUtilities.hpp"
 #include "TSSequencerModuleBase.hpp"
+#include "TSLightGrid.hpp"
 #include "Module_voltSeq.hpp"
 
 #define TROWA_VOLTSEQ_OSC_ROUND_VAL					 100   // Mult & Divisor for rounding.
@@ -23,16 +24,13 @@ inline float roundValForOSC(float val) {
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 void voltSeq::randomize()
 {
-	int r, c;
 	for (int s = 0; s < maxSteps; s++) 
 	{
 		// randomf() - [0.0, 1.0)
 		triggerState[currentPatternEditingIx][currentChannelEditingIx][s] = voltSeq_STEP_KNOB_MIN + randomf()*(voltSeq_STEP_KNOB_MAX - voltSeq_STEP_KNOB_MIN);		
-		r = s / this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
-		c = s % this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
 		this->params[CHANNEL_PARAM + s].value = this->triggerState[currentPatternEditingIx][currentChannelEditingIx][s];
-		knobStepMatrix[r][c]->setKnobValue(this->triggerState[currentPatternEditingIx][currentChannelEditingIx][s]);			
 	}	
+	queueWidgetChange(StepValuesChanged);
 	reloadEditMatrix = true;
 	return;
 } // end randomize()
@@ -124,17 +122,16 @@ void voltSeq::setStepValue(int step, float val, int channel, int pattern)
 		sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::EditStepString], step + 1);
 		oscStream << osc::BeginMessage( addrBuff )
 			<< valOutputBuffer // String version of the value (touchOSC needs this)
-			<< osc::EndMessage
-			<< osc::EndBundle;
-		oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			<< osc::EndMessage;
+		endOSCDelta(oscStream);
 	}
 	oscMutex.unlock();
 
 	// Set our knobs
 	if (pattern == currentPatternEditingIx && channel == currentChannelEditingIx)
 	{
-		this->knobStepMatrix[r][c]->setKnobValue(val);
 		this->params[ParamIds::CHANNEL_PARAM + step].value = val;
+		queueWidgetChange(StepValuesChanged);
 	}
 	return;
 } // end setStepValue()
@@ -180,10 +177,8 @@ void voltSeq::shiftValues(/*in*/ int patternIx, /*in*/ int channelIx, /*in*/ flo
 				triggerState[patternIx][channelIx][s] = tmp;
 				if (patternIx == currentPatternEditingIx && channelIx == currentChannelEditingIx)
 				{
-					int r = s / numCols;
-					int c = s % numCols;
 					this->params[CHANNEL_PARAM + s].value = tmp;
-					knobStepMatrix[r][c]->setKnobValue(tmp);
+					queueWidgetChange(StepValuesChanged);
 				}
 			}
 		}
@@ -200,10 +195,8 @@ void voltSeq::shiftValues(/*in*/ int patternIx, /*in*/ int channelIx, /*in*/ flo
 			triggerState[patternIx][channelIx][s] = tmp;
 			if (patternIx == currentPatternEditingIx && channelIx == currentChannelEditingIx)
 			{
-				int r = s / numCols;
-				int c = s % numCols;
 				this->params[CHANNEL_PARAM + s].value = tmp;
-				knobStepMatrix[r][c]->setKnobValue(tmp);
+				queueWidgetChange(StepValuesChanged);
 			}
 		}
 		//if (patternIx == currentPatternEditingIx && channelIx == currentChannelEditingIx)
@@ -211,6 +204,81 @@ void voltSeq::shiftValues(/*in*/ int patternIx, /*in*/ int channelIx, /*in*/ flo
 	}
 	return;
 } // end shiftValues()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// voltSeq::reset()
+// Initialize. The note scales go back to chromatic (C root).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void voltSeq::reset()
+{
+	TSSequencerModuleBase::reset();
+	scaleQuantizer.setUserScale(NULL, 0);
+	scaleQuantizer.setScale(-1, TS_SCALE_CHROMATIC, 0);
+	return;
+} // end reset()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// voltSeq::scalesToJson()
+// Save the note scales: the user scale (cents) and each channel's scale (by name) & root.
+// @returns : The json object.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+json_t* voltSeq::scalesToJson()
+{
+	json_t* scalesJ = json_object();
+	json_t* userJ = json_array();
+	for (int i = 0; i < (int)scaleQuantizer.userCents.size(); i++)
+		json_array_append_new(userJ, json_real(scaleQuantizer.userCents[i]));
+	json_object_set_new(scalesJ, "User", userJ);
+	json_t* channelsJ = json_array();
+	for (int c = 0; c < TROWA_SEQ_NUM_CHNLS; c++)
+	{
+		json_t* channelJ = json_object();
+		json_object_set_new(channelJ, "Scale", json_string(TSScales[scaleQuantizer.scaleIx[c]].name));
+		json_object_set_new(channelJ, "Root", json_integer(scaleQuantizer.root[c]));
+		json_array_append_new(channelsJ, channelJ);
+	}
+	json_object_set_new(scalesJ, "Channels", channelsJ);
+	return scalesJ;
+} // end scalesToJson()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// voltSeq::scalesFromJson()
+// Read the note scales. Missing scales (older saves) are chromatic.
+// @scalesJ : (IN) The json object (or NULL).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void voltSeq::scalesFromJson(json_t* scalesJ)
+{
+	float cents[TS_QUANTIZER_MAX_DEGREES];
+	int numDegrees = 0;
+	json_t* userJ = (scalesJ) ? json_object_get(scalesJ, "User") : NULL;
+	if (userJ)
+	{
+		for (int i = 0; i < (int)json_array_size(userJ) && numDegrees < TS_QUANTIZER_MAX_DEGREES; i++)
+		{
+			json_t* centJ = json_array_get(userJ, i);
+			if (json_is_number(centJ))
+				cents[numDegrees++] = (float)json_number_value(centJ);
+		}
+	}
+	scaleQuantizer.setUserScale(cents, numDegrees);
+	// Set each channel once (the engine may be quantizing while we load)
+	json_t* channelsJ = (scalesJ) ? json_object_get(scalesJ, "Channels") : NULL;
+	int nChannels = (channelsJ) ? (int)json_array_size(channelsJ) : 0;
+	for (int c = 0; c < TROWA_SEQ_NUM_CHNLS; c++)
+	{
+		int scaleIx = TS_SCALE_CHROMATIC;
+		int root = 0;
+		if (c < nChannels)
+		{
+			json_t* channelJ = json_array_get(channelsJ, c);
+			json_t* scaleJ = json_object_get(channelJ, "Scale");
+			json_t* rootJ = json_object_get(channelJ, "Root");
+			scaleIx = TSScaleQuantizer::findScale((scaleJ) ? json_string_value(scaleJ) : NULL);
+			if (scaleIx < 0)
+				scaleIx = TS_SCALE_CHROMATIC;
+			root = (rootJ) ? (int)json_integer_value(rootJ) : 0;
+		}
+		scaleQuantizer.setScale(c, scaleIx, root);
+	}
+	return;
+} // end scalesFromJson()
 
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
@@ -235,17 +303,19 @@ void voltSeq::step()
 	if (valueModeChanged)
 	{
 		modeString = currOutputValueMode->displayName;
-		// Change our lights 
-		for (r = 0; r < this->numRows; r++)
-		{
-			for (c = 0; c < this->numCols; c++)
-			{
-				dynamic_cast<TS_LightArc*>(padLightPtrs[r][c])->zeroAnglePoint = currOutputValueMode->zeroPointAngle_radians;
-				dynamic_cast<TS_LightArc*>(padLightPtrs[r][c])->valueMode = currOutputValueMode;
-			}
-		}
+		// Change our lights (the widget does this)
+		queueWidgetChange(ValueModeChanged);
 	}
 	lastOutputValueMode = selectedOutputValueMode;
+	// NOTE mode displays with the edit channel's scale (the outputs use each channel's own scale)
+	NoteValueSequencerMode* noteValueMode = static_cast<NoteValueSequencerMode*>(ValueModes[ValueMode::VALUE_MIDINOTE]);
+	const float* quantizeTable = scaleQuantizer.table(currentChannelEditingIx);
+	if (noteValueMode->quantizeTable != quantizeTable || scaleQuantizer.version != lastQuantizerVersion)
+	{
+		noteValueMode->quantizeTable = quantizeTable;
+		noteValueMode->outputVersion++;
+		lastQuantizerVersion = scaleQuantizer.version;
+	}
 		
 	// Only send OSC if it is enabled, initialized, and we are in EDIT mode.
 	sendOSC = useOSC && currentCtlMode == ExternalControllerMode::EditMode && oscInitialized;
@@ -267,25 +337,27 @@ void voltSeq::step()
 			oscStream << osc::BeginBundleImmediate;
 		}
 		oscMutex.unlock();
+		// Lights show the channel color and the knobs move to the params (the widget does both)
+		setPadColor(voiceColors[currentChannelEditingIx]);
+		queueWidgetChange(StepValuesChanged);
 		// Load this channel into our 4x4 matrix
 		for (int s = 0; s < maxSteps; s++) 
 		{
 			r = s / this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
 			c = s % this->numCols; // TROWA_SEQ_STEP_NUM_COLS;
-			padLightPtrs[r][c]->setColor(voiceColors[currentChannelEditingIx]);
 			gateLights[r][c] = 1.0 - stepLights[r][c];
 			this->params[CHANNEL_PARAM + s].value = this->triggerState[currentPatternEditingIx][currentChannelEditingIx][s];
-			knobStepMatrix[r][c]->setKnobValue(this->triggerState[currentPatternEditingIx][currentChannelEditingIx][s]);			
 			lights[PAD_LIGHTS + s].value = gateLights[r][c];
 			oscMutex.lock();
 			if (sendOSC && oscInitialized)
 			{
 				// Each step may have up to 4-ish messages, so send 4 or 8 steps at a time.
-				if (s > 0 && s % 8 == 0) // There is a limit to client buffer size, so let's not make the bundles too large. Hopefully they can take this many steps at a time.
+				// There is a limit to client buffer size, so let's not make the bundles too large. Hopefully they can take this many steps at a time.
+				// (A stream transport has no such limit, send it all in one bundle).
+				if (s > 0 && s % 8 == 0 && !oscSendBatch.isStream())
 				{
 					// Send this bundle and then start a new one
-					oscStream << osc::EndBundle;
-					oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+					endOSCDelta(oscStream);
 					oscStream.Clear();
 					// Start new bundle:
 					oscStream << osc::BeginBundleImmediate;
@@ -332,8 +404,7 @@ void voltSeq::step()
 			}
 
 			// End last bundle and send:
-			oscStream << osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			endOSCDelta(oscStream);
 		}
 		oscMutex.unlock();
 	} // end if reload edit matrix
@@ -359,9 +430,11 @@ void voltSeq::step()
 			sendLightVal = sendOSC && (dv > threshold || -dv > threshold); // Let's not send super tiny changes
 			r = s / this->numCols;
 			c = s % this->numCols;			
-			stepLights[r][c] -= stepLights[r][c] / lightLambda / engineGetSampleRate();
-			gateLights[r][c] = stepLights[r][c];			
-			lights[PAD_LIGHTS + s].value = gateLights[r][c];
+			if (lightsUpdate)
+			{
+				gateLights[r][c] = stepLights[r][c];
+				lights[PAD_LIGHTS + s].value = gateLights[r][c];
+			}
 
 			oscMutex.lock();
 			// This step has changed and we are doing OSC
@@ -393,21 +466,44 @@ void voltSeq::step()
 		oscMutex.lock();
 		if (sendOSC && oscInitialized && numChanged > 0)
 		{
-			oscStream << osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			endOSCDelta(oscStream);
 		}
 		oscMutex.unlock();
 	} // end else (read button matrix)
 	
 	// Set Outputs (16 triggers)	
+	float gates[TROWA_SEQ_NUM_CHNLS];
+	if (running && gOn)
+	{
+		for (int g = 0; g < TROWA_SEQ_NUM_CHNLS; g++)
+			gates[g] = triggerState[currentPatternPlayingIx][g][index];
+		if (selectedOutputValueMode == ValueMode::VALUE_MIDINOTE)
+		{
+			// Quantize each channel to its own scale
+			currOutputValueMode->GetOutputValues(gates, TROWA_SEQ_NUM_CHNLS, /*quantize*/ false);
+			scaleQuantizer.quantize(gates, TROWA_SEQ_NUM_CHNLS); //***********VOLTAGE OUTPUT
+		}
+		else
+		{
+			currOutputValueMode->GetOutputValues(gates, TROWA_SEQ_NUM_CHNLS); //***********VOLTAGE OUTPUT
+		}
+	}
+	else
+	{
+		for (int g = 0; g < TROWA_SEQ_NUM_CHNLS; g++)
+			gates[g] = 0.0f;
+	}
+	float lightScale = 1.0f / currOutputValueMode->outputVoltageMax;
 	for (int g = 0; g < TROWA_SEQ_NUM_CHNLS; g++) 
 	{		
-		float gate = (running && gOn) ? currOutputValueMode->GetOutputValue( triggerState[currentPatternPlayingIx][g][index] ) : 0.0; //***********VOLTAGE OUTPUT
+		float gate = gates[g];
 		outputs[CHANNELS_OUTPUT + g].value= gate;
 		// Output lights (around output jacks for each gate/trigger):
 		gateLightsOut[g] = (gate < 0) ? -gate : gate;
-		lights[CHANNEL_LIGHTS + g].value = gate / currOutputValueMode->outputVoltageMax;
+		lights[CHANNEL_LIGHTS + g].value = gate * lightScale;
 	}
+	// Send whatever OSC we queued up
+	flushOSC();
 	return;
 } // end step()
 
@@ -427,7 +523,7 @@ voltSeqWidget::voltSeqWidget() : TSSequencerWidgetBase()
 	{
 		SVGPanel *panel = new SVGPanel();
 		panel->box.size = box.size;
-		panel->setBackground(SVG::load(assetPlugin(plugin, "res/voltSeq.svg")));
+		panel->setBackground(TSAssets::svg(TS_SVG_PANEL_VOLTSEQ));
 		addChild(panel);
 	}
 	
@@ -442,6 +538,10 @@ voltSeqWidget::voltSeqWidget() : TSSequencerWidgetBase()
 	int v = 0;
 	ValueSequencerMode* currValueMode = module->ValueModes[module->selectedOutputValueMode];
 	module->modeString = currValueMode->displayName;
+	// All knob lights are drawn together by the grid (under the knobs)
+	TS_LightArcGrid* lightGrid = new TS_LightArcGrid(/*pitch*/ Vec(59, 59));
+	lightGrid->box.size = box.size;
+	addChild(lightGrid);
 	for (int r = 0; r < module->numRows; r++) //---------THE KNOBS
 	{
 		for (int c = 0; c < module->numCols; c++)
@@ -464,7 +564,7 @@ voltSeqWidget::voltSeqWidget() : TSSequencerWidgetBase()
 			lightPtr->valueMode = currValueMode;			
 			
 			module->padLightPtrs[r][c] = lightPtr;			
-			addChild( module->padLightPtrs[r][c] );
+			lightGrid->addLight( module->padLightPtrs[r][c] );
 			
 			addParam(knobPtr);
 			knobPtr->dirty = true;
@@ -479,6 +579,43 @@ voltSeqWidget::voltSeqWidget() : TSSequencerWidgetBase()
 	return;
 }
 
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// voltSeqWidget::applyModuleChanges()
+// Apply the changes the module queued for us. The step knobs move to their params
+// (only the ones that changed get redrawn) and the light arcs get the value mode.
+// @thisModule : (IN) Our module.
+// @changes : (IN) The TSSequencerModuleBase::WidgetChangeBits.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void voltSeqWidget::applyModuleChanges(TSSequencerModuleBase* thisModule, uint32_t changes)
+{
+	TSSequencerWidgetBase::applyModuleChanges(thisModule, changes);
+	voltSeq* seqModule = dynamic_cast<voltSeq*>(thisModule);
+	if (changes & TSSequencerModuleBase::WidgetChangeBits::StepValuesChanged)
+	{
+		for (int s = 0; s < seqModule->maxSteps; s++)
+		{
+			TS_LightedKnob* knob = seqModule->knobStepMatrix[s / seqModule->numCols][s % seqModule->numCols];
+			float val = seqModule->params[voltSeq::CHANNEL_PARAM + s].value;
+			if (knob->value != val)
+				knob->setKnobValue(val);
+		}
+	}
+	if (changes & TSSequencerModuleBase::WidgetChangeBits::ValueModeChanged)
+	{
+		ValueSequencerMode* valueMode = seqModule->ValueModes[seqModule->selectedOutputValueMode];
+		for (int r = 0; r < seqModule->numRows; r++)
+		{
+			for (int c = 0; c < seqModule->numCols; c++)
+			{
+				TS_LightArc* light = dynamic_cast<TS_LightArc*>(seqModule->padLightPtrs[r][c]);
+				light->zeroAnglePoint = valueMode->zeroPointAngle_radians;
+				light->valueMode = valueMode;
+			}
+		}
+	}
+	return;
+} // end applyModuleChanges()
+
 struct voltSeq_ShiftVoltageSubMenuItem : MenuItem {
 	voltSeq* sequencerModule;
 	float amount = 1.0;
@@ -565,9 +702,80 @@ struct voltSeq_ShiftVoltageMenuItem : MenuItem {
 	}
 };
 
+// Note scale / root for the current edit channel (or apply the edit channel's to all channels).
+struct voltSeq_ScaleSubMenuItem : MenuItem {
+	voltSeq* sequencerModule;
+	enum ScaleTarget {
+		// Set the edit channel's scale (value)
+		Scale,
+		// Set the edit channel's root (value)
+		Root,
+		// Copy the edit channel's scale & root to all channels
+		AllChannels
+	};
+	ScaleTarget Target = ScaleTarget::Scale;
+	int value = 0;
+
+	voltSeq_ScaleSubMenuItem(std::string text, ScaleTarget target, int value, voltSeq* seqModule)
+	{
+		this->text = text;
+		this->Target = target;
+		this->value = value;
+		this->sequencerModule = seqModule;
+	}
+
+	void onAction(EventAction &e) override {
+		int ch = sequencerModule->currentChannelEditingIx;
+		int scaleIx = sequencerModule->scaleQuantizer.scaleIx[ch];
+		int root = sequencerModule->scaleQuantizer.root[ch];
+		if (this->Target == ScaleTarget::Scale)
+			sequencerModule->setScale(ch, value, root);
+		else if (this->Target == ScaleTarget::Root)
+			sequencerModule->setScale(ch, scaleIx, value);
+		else
+			sequencerModule->setScale(TROWA_INDEX_UNDEFINED, scaleIx, root);
+	}
+	void step() override {
+		int ch = sequencerModule->currentChannelEditingIx;
+		if (this->Target == ScaleTarget::Scale)
+			rightText = (sequencerModule->scaleQuantizer.scaleIx[ch] == value) ? "✔" : "";
+		else if (this->Target == ScaleTarget::Root)
+			rightText = (sequencerModule->scaleQuantizer.root[ch] == value) ? "✔" : "";
+		MenuItem::step();
+	}
+};
+// First tier menu item. Create Submenu of scales or roots.
+struct voltSeq_ScaleMenuItem : MenuItem {
+	voltSeq* sequencerModule;
+	voltSeq_ScaleSubMenuItem::ScaleTarget Target = voltSeq_ScaleSubMenuItem::ScaleTarget::Scale;
+
+	voltSeq_ScaleMenuItem(std::string text, voltSeq_ScaleSubMenuItem::ScaleTarget target, voltSeq* seqModule)
+	{
+		this->text = text;
+		this->Target = target;
+		this->sequencerModule = seqModule;
+		return;
+	}
+	Menu *createChildMenu() override {
+		Menu* menu = new Menu();
+		if (Target == voltSeq_ScaleSubMenuItem::ScaleTarget::Scale)
+		{
+			for (int i = 0; i < TS_NUM_SCALES; i++)
+				menu->addChild(new voltSeq_ScaleSubMenuItem(TSScales[i].name, Target, i, sequencerModule));
+		}
+		else
+		{
+			for (int i = 0; i < TS_QUANTIZER_NUM_ROOTS; i++)
+				menu->addChild(new voltSeq_ScaleSubMenuItem(TROWA_NOTES[i], Target, i, sequencerModule));
+		}
+		menu->box.size = Vec(200, 60);
+		return menu;
+	}
+};
+
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // voltSeqWidget
-// Create context menu with the ability to shift 1 V (1 octave).
+// Create context menu with the ability to shift 1 V (1 octave) and set the note scale.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 Menu *voltSeqWidget::createContextMenu()
 {
@@ -591,5 +799,15 @@ Menu *voltSeqWidget::createContextMenu()
 	menu->addChild(new voltSeq_ShiftVoltageMenuItem("> +1 V/Octave/Patt", 1.0, sequencerModule));// menu->pushChild(menuItem);
 	//menuItem = new voltSeq_ShiftVoltageMenuItem("> -1 V/Octave/Patt", -1.0, sequencerModule);
 	menu->addChild(new voltSeq_ShiftVoltageMenuItem("> -1 V/Octave/Patt", -1.0, sequencerModule));// menu->pushChild(menuItem);
+
+	//-------- Note Scale ------- //
+	// (Edit channel, NOTE mode).
+	menu->addChild(new MenuLabel());
+	MenuLabel *scaleLabel = new MenuLabel();
+	scaleLabel->text = "Note Scale (Edit Channel)";
+	menu->addChild(scaleLabel);
+	menu->addChild(new voltSeq_ScaleMenuItem("> Scale", voltSeq_ScaleSubMenuItem::ScaleTarget::Scale, sequencerModule));
+	menu->addChild(new voltSeq_ScaleMenuItem("> Root", voltSeq_ScaleSubMenuItem::ScaleTarget::Root, sequencerModule));
+	menu->addChild(new voltSeq_ScaleSubMenuItem("Apply to All Channels", voltSeq_ScaleSubMenuItem::ScaleTarget::AllChannels, 0, sequencerModule));
 	return menu;
 }
\ No newline at end of file
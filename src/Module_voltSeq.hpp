@@ -20,11 +20,15 @@
 // [11/28/2017]: Change knobStepMatrix for allowing for > the standard # steps (16).
 struct voltSeq : TSSequencerModuleBase	
 {	
-	// References to our pad knobs. 
+	// References to our pad knobs (UI thread only, see widgetChanges).
 	// We may have > 16 steps in the future, so no more static matrix.
 	TS_LightedKnob***  knobStepMatrix;
 	// Array of values of what we last sent over OSC (for comparison).
 	float* oscLastSentVals = NULL;
+	// Note scales (per channel) for NOTE mode.
+	TSScaleQuantizer scaleQuantizer;
+	// The quantizer version the NOTE mode display was last updated for.
+	uint32_t lastQuantizerVersion = 0;
 	
 	ValueSequencerMode* ValueModes[TROWA_SEQ_NUM_MODES] = { 
 		// Voltage Mode 
@@ -96,6 +100,7 @@ struct voltSeq : TSSequencerModuleBase
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-	
 	void fromJson(json_t *rootJ) override {
 		TSSequencerModuleBase::fromJson(rootJ);
+		scalesFromJson(json_object_get(rootJ, "scales"));
 
 		//// Check for old version and try to do graceful conversion from -5 to +5V 
 		//// in Note Mode to -4 to +6V
@@ -106,6 +111,32 @@ struct voltSeq : TSSequencerModuleBase
 		return;
 	}
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// toJson(void)
+	// Save our junk (and our note scales) to json.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	json_t *toJson() override {
+		json_t* rootJ = TSSequencerModuleBase::toJson();
+		json_object_set_new(rootJ, "scales", scalesToJson());
+		return rootJ;
+	}
+	// Save the note scales (user scale and per channel scale & root).
+	json_t* scalesToJson();
+	// Read the note scales.
+	void scalesFromJson(json_t* scalesJ);
+	// Initialize (and go back to chromatic).
+	void reset() override;
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// setScale()
+	// Set the note scale & root for a channel (NOTE mode outputs are quantized to it).
+	// @channel : (IN) The channel (0 to TROWA_SEQ_NUM_CHNLS - 1, or < 0 for all).
+	// @scaleIx : (IN) The scale (TSScaleId).
+	// @root : (IN) The root (semitones above C).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void setScale(int channel, int scaleIx, int root) override {
+		scaleQuantizer.setScale(channel, scaleIx, root);
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// Set a single the step value
 	// (i.e. this command probably comes from an external source).
 	// >> Should set the control knob value too if applicable. <<
@@ -133,9 +164,7 @@ struct voltSeq : TSSequencerModuleBase
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	void onShownStepChange(int step, float val) override {
 		this->params[CHANNEL_PARAM + step].value = val;
-		int r = step / numRows;
-		int c = step % numRows;
-		knobStepMatrix[r][c]->setKnobValue(val);
+		queueWidgetChange(StepValuesChanged);
 		return;
 	}
 
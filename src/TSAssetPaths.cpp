@@ -0,0 +1,21 @@
+#include "TSAssetPaths.hpp"
+
+// Plugin relative paths (by TSFontAsset).
+const char* TSFontAssetPaths[TS_NUM_FONT_ASSETS] = {
+	TROWA_DIGITAL_FONT,
+	TROWA_LABEL_FONT
+};
+// Plugin relative paths (by TSSvgAsset).
+const char* TSSvgAssetPaths[TS_NUM_SVG_ASSETS] = {
+	"res/ComponentLibrary/TS_pad_0.svg",
+	"res/ComponentLibrary/TS_pad_btn_0.svg",
+	"res/ComponentLibrary/TS_pad_btn_1.svg",
+	"res/ComponentLibrary/TS_pad_run_0.svg",
+	"res/ComponentLibrary/TS_pad_run_1.svg",
+	"res/ComponentLibrary/TS_pad_reset_0.svg",
+	"res/ComponentLibrary/TS_pad_reset_1.svg",
+	"res/ComponentLibrary/TS_Port.svg",
+	"res/trigSeq.svg",
+	"res/voltSeq.svg",
+	"res/multiScope.svg"
+};
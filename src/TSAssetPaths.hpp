@@ -0,0 +1,35 @@
+#ifndef TSASSETPATHS_HPP
+#define TSASSETPATHS_HPP
+
+// Fonts:
+#define TROWA_DIGITAL_FONT		"res/Fonts/Digital dream Fat.ttf"
+#define TROWA_LABEL_FONT		"res/Fonts/ZeroesThree-Regular.ttf"
+
+// Plugin fonts.
+enum TSFontAsset {
+	TS_FONT_DIGITAL,	// TROWA_DIGITAL_FONT
+	TS_FONT_LABEL,		// TROWA_LABEL_FONT
+	TS_NUM_FONT_ASSETS
+};
+// Plugin SVGs.
+enum TSSvgAsset {
+	TS_SVG_PAD,
+	TS_SVG_PAD_BTN_0,
+	TS_SVG_PAD_BTN_1,
+	TS_SVG_PAD_RUN_0,
+	TS_SVG_PAD_RUN_1,
+	TS_SVG_PAD_RESET_0,
+	TS_SVG_PAD_RESET_1,
+	TS_SVG_PORT,
+	TS_SVG_PANEL_TRIGSEQ,
+	TS_SVG_PANEL_VOLTSEQ,
+	TS_SVG_PANEL_MULTISCOPE,
+	TS_NUM_SVG_ASSETS
+};
+
+// Plugin relative paths (by TSFontAsset).
+extern const char* TSFontAssetPaths[TS_NUM_FONT_ASSETS];
+// Plugin relative paths (by TSSvgAsset).
+extern const char* TSSvgAssetPaths[TS_NUM_SVG_ASSETS];
+
+#endif // !TSASSETPATHS_HPP
@@ -0,0 +1,33 @@
+#include "TSAssets.hpp"
+#include "trowaSoft.hpp"
+#include "trowaSoftUtilities.hpp"
+
+std::shared_ptr<Font> TSAssets::_fonts[TS_NUM_FONT_ASSETS];
+std::shared_ptr<SVG> TSAssets::_svgs[TS_NUM_SVG_ASSETS];
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// loadFont()
+// Load a font into the cache.
+// @id : (IN) The font.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSAssets::loadFont(TSFontAsset id)
+{
+	_fonts[id] = Font::load(assetPlugin(plugin, TSFontAssetPaths[id]));
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+	debug("TSAssets - Loaded font %s.", TSFontAssetPaths[id]);
+#endif
+	return;
+} // end loadFont()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// loadSvg()
+// Load an svg into the cache.
+// @id : (IN) The svg.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSAssets::loadSvg(TSSvgAsset id)
+{
+	_svgs[id] = SVG::load(assetPlugin(plugin, TSSvgAssetPaths[id]));
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+	debug("TSAssets - Loaded svg %s.", TSSvgAssetPaths[id]);
+#endif
+	return;
+} // end loadSvg()
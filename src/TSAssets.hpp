@@ -0,0 +1,37 @@
+#ifndef TSASSETS_HPP
+#define TSASSETS_HPP
+
+#include "rack.hpp"
+using namespace rack;
+
+#include <memory>
+#include "TSAssetPaths.hpp"
+
+//=== TSAssets ================================================
+// Plugin-wide font & svg cache shared by all module instances.
+// Each asset is loaded the first time it is asked for and then kept for the life
+// of the plugin, so later widgets just get the handle (no path building, no lookup
+// by file name, no file access). UI thread only (widgets are built there).
+//=============================================================
+struct TSAssets
+{
+	// Get a font (loads it the first time).
+	static const std::shared_ptr<Font>& font(TSFontAsset id) {
+		if (!_fonts[id])
+			loadFont(id);
+		return _fonts[id];
+	}
+	// Get an svg (loads it the first time).
+	static const std::shared_ptr<SVG>& svg(TSSvgAsset id) {
+		if (!_svgs[id])
+			loadSvg(id);
+		return _svgs[id];
+	}
+protected:
+	static std::shared_ptr<Font> _fonts[TS_NUM_FONT_ASSETS];
+	static std::shared_ptr<SVG> _svgs[TS_NUM_SVG_ASSETS];
+	static void loadFont(TSFontAsset id);
+	static void loadSvg(TSSvgAsset id);
+}; // end TSAssets
+
+#endif // !TSASSETS_HPP
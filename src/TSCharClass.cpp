@@ -0,0 +1,99 @@
+#include "TSCharClass.hpp"
+
+// Character class table. Digits are in every class, '.' is IP.
+#define TS_CC_D		(TROWA_CHARCLASS_DIGIT | TROWA_CHARCLASS_IP)
+#define TS_CC_P		(TROWA_CHARCLASS_IP)
+const uint8_t TSCharClass::CharClasses[256] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x00
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, TS_CC_P, 0, // 0x20 (.)
+	TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, TS_CC_D, 0, 0, 0, 0, 0, 0, // 0x30 digits
+	// 0x40-0xFF: none
+};
+#undef TS_CC_D
+#undef TS_CC_P
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// cleanseString()
+// @text : (IN) The text.
+// @charClass : (IN) Character class bit (TROWA_CHARCLASS_*) of allowed characters.
+// @maxLength : (IN) Max length of the result.
+// @returns: The allowed characters of the text (in order), up to maxLength of them.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+std::string TSCharClass::cleanseString(const std::string& text, uint8_t charClass, size_t maxLength)
+{
+	std::string cleansedStr;
+	cleansedStr.reserve(text.length());
+	for (size_t i = 0; i < text.length() && cleansedStr.length() < maxLength; i++)
+	{
+		if (isCharClass(text[i], charClass))
+			cleansedStr.push_back(text[i]);
+	}
+	return cleansedStr;
+} // end cleanseString()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// isValidDigits()
+// @text : (IN) The text.
+// @returns: True if the text is digits only (empty is valid).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSCharClass::isValidDigits(const std::string& text)
+{
+	for (size_t i = 0; i < text.length(); i++)
+	{
+		if (!isCharClass(text[i], TROWA_CHARCLASS_DIGIT))
+			return false;
+	}
+	return true;
+} // end isValidDigits()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// isValidIpAddress()
+// Four parts of 1-3 digits (0-255, leading zeros allowed) split by '.'.
+// @text : (IN) The text.
+// @returns: True if the text is a valid IPv4 address.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSCharClass::isValidIpAddress(const std::string& text)
+{
+	int numParts = 0;
+	int numDigits = 0;
+	int partValue = 0;
+	for (size_t i = 0; i <= text.length(); i++)
+	{
+		char c = (i < text.length()) ? text[i] : '.';
+		if (isCharClass(c, TROWA_CHARCLASS_DIGIT))
+		{
+			if (++numDigits > 3)
+				return false;
+			partValue = partValue * 10 + (c - '0');
+		}
+		else if (c == '.')
+		{
+			if (numDigits == 0 || partValue > 255 || ++numParts > 4)
+				return false;
+			numDigits = 0;
+			partValue = 0;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return numParts == 4;
+} // end isValidIpAddress()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// isValidPort()
+// @text : (IN) The text.
+// @returns: True if the text is 1-5 digits and at most 65535.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSCharClass::isValidPort(const std::string& text)
+{
+	if (text.length() < 1 || text.length() > 5)
+		return false;
+	int port = 0;
+	for (size_t i = 0; i < text.length(); i++)
+	{
+		if (!isCharClass(text[i], TROWA_CHARCLASS_DIGIT))
+			return false;
+		port = port * 10 + (text[i] - '0');
+	}
+	return port <= 0xFFFF;
+} // end isValidPort()
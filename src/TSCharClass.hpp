@@ -0,0 +1,34 @@
+#ifndef TSCHARCLASS_HPP
+#define TSCHARCLASS_HPP
+
+#include <string>
+#include <stdint.h>
+
+// Character class bits (TSCharClass character table).
+// Integer/Digits: [0-9]
+#define TROWA_CHARCLASS_DIGIT			0x01
+// IP Address: [0-9] or '.'
+#define TROWA_CHARCLASS_IP				0x02
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSCharClass
+// Character table filtering and validation for text input (TSTextField).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSCharClass {
+	// Character class bits (TROWA_CHARCLASS_*) for each (8-bit) character.
+	static const uint8_t CharClasses[256];
+	// If the character is in the class.
+	static bool isCharClass(char c, uint8_t charClass) {
+		return (CharClasses[static_cast<uint8_t>(c)] & charClass) != 0;
+	}
+	// Only the characters in the class, up to maxLength of them.
+	static std::string cleanseString(const std::string& text, uint8_t charClass, size_t maxLength);
+	// If the text is digits only (may be empty).
+	static bool isValidDigits(const std::string& text);
+	// If the text is a valid IPv4 address (dotted quad, i.e. 127.0.0.1).
+	static bool isValidIpAddress(const std::string& text);
+	// If the text is a valid port number (0-65535).
+	static bool isValidPort(const std::string& text);
+}; // end struct TSCharClass
+
+#endif // end if not defined
@@ -0,0 +1,185 @@
+#include "TSDisplayFormat.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+const char * TROWA_NOTES[TROWA_SEQ_NUM_NOTES] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// ParseFixedFormat()
+// Parse a simple fixed point format string ("%[0][width][.precision]f" and nothing else).
+// @format : (IN) The format string.
+// @width : (OUT) Minimum field width.
+// @precision : (OUT) Number of decimals.
+// @zeroPad : (OUT) Pad with zeros instead of spaces.
+// @returns : False if the format is anything else (or too wide for FormatFixed()).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool ParseFixedFormat(/*in*/ const char* format, /*out*/ int* width, /*out*/ int* precision, /*out*/ bool* zeroPad)
+{
+	const char* p = format;
+	*width = 0;
+	*precision = 6; // printf default
+	*zeroPad = false;
+	if (*p++ != '%')
+		return false;
+	if (*p == '0')
+	{
+		*zeroPad = true;
+		p++;
+	}
+	while (*p >= '0' && *p <= '9')
+		*width = *width * 10 + (*p++ - '0');
+	if (*p == '.')
+	{
+		p++;
+		*precision = 0;
+		while (*p >= '0' && *p <= '9')
+			*precision = *precision * 10 + (*p++ - '0');
+	}
+	if (*p++ != 'f')
+		return false;
+	return *p == 0 && *width <= 20 && *precision <= 6;
+} // end ParseFixedFormat()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// FormatFixed()
+// Fast fixed point formatting, same output as sprintf() with "%[0][width].[precision]f".
+// A float times 10^6 still fits in a double's mantissa, so the scaled value is exact
+// and rint() (to nearest, ties to even) rounds it the same as printf does.
+// @buffer : (OUT) The string (needs width or 24 chars, whichever is more).
+// @val : (IN) The value.
+// @width : (IN) Minimum field width.
+// @precision : (IN) Number of decimals (0-6).
+// @zeroPad : (IN) Pad with zeros instead of spaces.
+// @returns : The length or -1 if it can't format the value (caller should sprintf()).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+int FormatFixed(/*out*/ char* buffer, /*in*/ float val, /*in*/ int width, /*in*/ int precision, /*in*/ bool zeroPad)
+{
+	static const double pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+	if (precision < 0 || precision > 6 || width > 20 || !std::isfinite(val))
+		return -1;
+	double scaled = std::rint(std::fabs(static_cast<double>(val)) * pow10[precision]);
+	if (scaled >= 1e15)
+		return -1;
+	bool neg = std::signbit(val); // printf shows the sign of -0 too
+	uint64_t n = static_cast<uint64_t>(scaled);
+	// Digits (backwards), at least one before the decimal point
+	char digits[24];
+	int numDigits = 0;
+	do {
+		digits[numDigits++] = '0' + (char)(n % 10);
+		n /= 10;
+	} while (n > 0 || numDigits < precision + 1);
+	int len = numDigits + ((precision > 0) ? 1 : 0) + ((neg) ? 1 : 0);
+	int pad = (width > len) ? width - len : 0;
+	char* p = buffer;
+	if (!zeroPad)
+	{
+		for (int i = 0; i < pad; i++)
+			*p++ = ' ';
+	}
+	if (neg)
+		*p++ = '-';
+	if (zeroPad)
+	{
+		for (int i = 0; i < pad; i++)
+			*p++ = '0';
+	}
+	for (int i = numDigits - 1; i >= 0; i--)
+	{
+		*p++ = digits[i];
+		if (i == precision && precision > 0)
+			*p++ = '.';
+	}
+	*p = 0;
+	return static_cast<int>(p - buffer);
+} // end FormatFixed()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSDisplayFormat::init()
+// Parse the display format and, if it has no decimals, make all the display
+// strings now (the display range is small and finite).
+// @format : (IN) The printf format for a float (may be NULL).
+// @minDisplayValue : (IN) One end of the display range.
+// @maxDisplayValue : (IN) The other end of the display range.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSDisplayFormat::init(/*in*/ const char* format, /*in*/ float minDisplayValue, /*in*/ float maxDisplayValue)
+{
+	formatString = format;
+	displayTable.clear();
+	if (formatString == NULL || !ParseFixedFormat(formatString, &fmtWidth, &fmtPrecision, &fmtZeroPad))
+	{
+		fmtPrecision = -1;
+		return;
+	}
+	if (fmtPrecision == 0)
+	{
+		float lo = (minDisplayValue < maxDisplayValue) ? minDisplayValue : maxDisplayValue;
+		float hi = (minDisplayValue < maxDisplayValue) ? maxDisplayValue : minDisplayValue;
+		int n = (int)ceilf(hi) - (int)floorf(lo) + 1;
+		if (n > 0 && n <= TROWA_DISP_TABLE_MAX)
+		{
+			char buffer[TROWA_DISP_MSG_SIZE];
+			displayTableMin = (int)floorf(lo);
+			for (int i = 0; i < n; i++)
+			{
+				sprintf(buffer, formatString, static_cast<float>(displayTableMin + i));
+				displayTable.push_back(buffer);
+			}
+		}
+	}
+	return;
+} // end TSDisplayFormat::init()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSDisplayFormat::format()
+// Format a display value, same output as sprintf(buffer, formatString, dVal).
+// @dVal : (IN) The display value.
+// @buffer : (OUT) The string.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSDisplayFormat::format(/*in*/ float dVal, /*out*/ char* buffer) const
+{
+	if (displayTable.size() > 0)
+	{
+		// Same rounding as printf (to nearest, ties to even). -0 prints as "-0" so leave that to sprintf.
+		float r = std::nearbyint(dVal);
+		if (r >= displayTableMin && r < displayTableMin + (int)displayTable.size() && !(r == 0 && std::signbit(r)))
+		{
+			strcpy(buffer, displayTable[static_cast<int>(r) - displayTableMin].c_str());
+			return;
+		}
+	}
+	else if (fmtPrecision > 0 && FormatFixed(buffer, dVal, fmtWidth, fmtPrecision, fmtZeroPad) >= 0)
+	{
+		return;
+	}
+	sprintf(buffer, formatString, dVal);
+	return;
+} // end TSDisplayFormat::format()
+
+TSNoteLabels::TSNoteLabels()
+{
+	for (int octave = 0; octave <= TROWA_SEQ_NUM_OCTAVES; octave++)
+	{
+		for (int noteIx = 0; noteIx < TROWA_SEQ_NUM_NOTES; noteIx++)
+			snprintf(noteStrings[octave][noteIx], sizeof(noteStrings[octave][noteIx]), "%s%d", TROWA_NOTES[noteIx], octave);
+	}
+	return;
+}
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSNoteLabels::format()
+// The note label for a voltage (from the table unless the octave is out of range).
+// @val : (IN) The voltage (1 V per octave).
+// @buffer : (OUT) The string.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSNoteLabels::format(/*in*/ float val, /*out*/ char* buffer) const
+{
+	int octave = VoltsToOctave(val);
+	int ix = noteIx(val);
+	if (octave >= 0 && octave <= TROWA_SEQ_NUM_OCTAVES)
+		strcpy(buffer, noteStrings[octave][ix]);
+	else
+		sprintf(buffer, "%s%d", TROWA_NOTES[ix], octave);
+	return;
+} // end TSNoteLabels::format()
@@ -0,0 +1,87 @@
+#ifndef TSDISPLAYFORMAT_HPP
+#define TSDISPLAYFORMAT_HPP
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <cmath>
+
+#define TROWA_DISP_MSG_SIZE			30 // For local buffers of strings
+#define TROWA_DISP_TABLE_MAX		1024 // Max number of precomputed display strings for a value mode
+#define TROWA_SEQ_NUM_NOTES			12 // Num notes per octave (1 V per octave)
+#define TROWA_SEQ_ZERO_OCTAVE		4  // Octave for voltage 0 -- Was 5, now 4
+#define TROWA_SEQ_NUM_OCTAVES	   10  // Number of total octaves
+
+extern const char * TROWA_NOTES[TROWA_SEQ_NUM_NOTES]; // Our note labels.
+
+// Voltage [-5 to 5] to Octave 0 to 10
+inline int VoltsToOctave(float v)
+{
+	return (int)(v + TROWA_SEQ_ZERO_OCTAVE);
+}
+// Note index 0 to 11 (to TROWA_NOTES array).
+inline int VoltsToNoteIx(float v)
+{
+	// This doesn't work all the time.
+	//(v - floorf(v))*TROWA_SEQ_NUM_NOTES
+	// (-4.9 - -5) * 12 = 0.1*12 = int(1.2) = 1 [C#]
+	// (-0.33 - -1) * 12 = 0.67*12 = int(8.04) = 8 [G#]
+	return (int)(round((v + TROWA_SEQ_ZERO_OCTAVE)*TROWA_SEQ_NUM_NOTES)) % TROWA_SEQ_NUM_NOTES;
+}
+
+// Parse a simple fixed point format string ("%[0][width][.precision]f" and nothing else).
+// Returns false if the format is anything else.
+bool ParseFixedFormat(/*in*/ const char* format, /*out*/ int* width, /*out*/ int* precision, /*out*/ bool* zeroPad);
+// Fast fixed point formatting (same output as sprintf() with "%[0][width].[precision]f").
+// Returns the length written or -1 if it can't (caller should just sprintf()).
+int FormatFixed(/*out*/ char* buffer, /*in*/ float val, /*in*/ int width, /*in*/ int precision, /*in*/ bool zeroPad);
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSDisplayFormat
+// A printf float format for display values. Whole number formats use a table of
+// precomputed strings, simple fixed point formats use FormatFixed(), anything
+// else is sprintf()'d.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSDisplayFormat
+{
+	// The format string.
+	const char* formatString = NULL;
+	// formatString parsed for FormatFixed() (fmtPrecision < 0 if it isn't a simple fixed point format).
+	int fmtWidth = 0;
+	int fmtPrecision = -1;
+	bool fmtZeroPad = false;
+	// Precomputed display strings when the format has no decimals (display values are whole numbers).
+	std::vector<std::string> displayTable;
+	// The display value of displayTable[0].
+	int displayTableMin = 0;
+
+	// Parse the format and, if it has no decimals, make all the strings for the display range now.
+	void init(/*in*/ const char* format, /*in*/ float minDisplayValue, /*in*/ float maxDisplayValue);
+	// Format a display value (buffer should be TROWA_DISP_MSG_SIZE).
+	void format(/*in*/ float dVal, /*out*/ char* buffer) const;
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSNoteLabels
+// Precomputed note labels by octave and note index (i.e. "C#4").
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSNoteLabels
+{
+	char noteStrings[TROWA_SEQ_NUM_OCTAVES + 1][TROWA_SEQ_NUM_NOTES][6];
+
+	TSNoteLabels();
+	// Note index for the voltage, clamped to [0, TROWA_SEQ_NUM_NOTES - 1].
+	static int noteIx(/*in*/ float val)
+	{
+		int noteIx = VoltsToNoteIx(val);
+		if (noteIx > TROWA_SEQ_NUM_NOTES - 1)
+			noteIx = TROWA_SEQ_NUM_NOTES - 1;
+		else if (noteIx < 0)
+			noteIx = 0;
+		return noteIx;
+	}
+	// The label for the voltage (buffer should be TROWA_DISP_MSG_SIZE).
+	void format(/*in*/ float val, /*out*/ char* buffer) const;
+};
+
+#endif // !TSDISPLAYFORMAT_HPP
@@ -1,6 +1,8 @@
 #ifndef TSEXTERNALCONTROLMESSAGE_HPP
 #define TSEXTERNALCONTROLMESSAGE_HPP
 
+#include <stdint.h>
+
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // External (from Rack) Control message.
 // Currently this will be for OSC but may be from MIDI or anything else in the future.
@@ -126,6 +128,18 @@ struct TSExternalControlMessage {
 		// /edit/module/init
 		// Parameters: -NONE-
 		InitializeEditModule,
+		// Resync the client: full snapshot, or replay of the state changes from a sequence number
+		// /sync
+		// Parameters: (opt) int fromSeq
+		SyncState,
+		// Reply with our OSC traffic counters
+		// /stats
+		// Parameters: (opt) int reset
+		QueryStats,
+		// Set the note scale & root (voltSeq)
+		// /edit/scale
+		// Parameters: int scale, (opt) int root, (opt) int channel
+		SetEditScale,
 		// Total # message types
 		NUM_MESSAGE_TYPES
 	};
@@ -143,6 +157,10 @@ struct TSExternalControlMessage {
 	int mode;
 	// The value / mode.
 	float val;
+	// When to apply the message (OSC/NTP time tag from the bundle). 1 (or 0) = immediately.
+	uint64_t timeTag = 1;
+	// When the message was received (TSOSCStatsNowUs(), for the latency stats).
+	int64_t rxTimeUs = 0;
 };
 
 
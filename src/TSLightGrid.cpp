@@ -0,0 +1,409 @@
+#include "TSLightGrid.hpp"
+
+#include <math.h>
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TS_LightGrid()
+// @pitch : (IN) Distance between the lights (origin to origin).
+// @numPasses : (IN) Number of grouped draw passes the subclass uses.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TS_LightGrid::TS_LightGrid(Vec pitch, int numPasses)
+{
+	this->pitch = pitch;
+	_passes.resize(numPasses);
+	staticLayer = new TS_StaticLayer(this);
+	addChild(staticLayer);
+	return;
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// addLight()
+// Add a light to the grid (box.pos relative to this grid).
+// @light : (IN) The light.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightGrid::addLight(ColorValueLight* light)
+{
+	lights.push_back(light);
+	_keys.push_back(0);
+	_done.push_back(0);
+	addChild(light);
+	_groupsDirty = true;
+	staticLayer->dirty = true;
+	return;
+} // end addLight()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// step()
+// Step the lights (they update their colors & signatures), then see if any changed.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightGrid::step()
+{
+	Widget::step();
+	for (int i = 0; i < (int)lights.size() && !_groupsDirty; i++)
+	{
+		if (lights[i]->changed)
+			_groupsDirty = true;
+	}
+	return;
+} // end step()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// colorKey()
+// Get the key for a color (8 bits per channel). Bit 0 is always set so a key
+// is never 0 (0 means skip the light).
+// @color : (IN) The color.
+// @withAlpha : (IN) Include the alpha level (see alphaLevel(), not the exact alpha).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+uint32_t TS_LightGrid::colorKey(NVGcolor color, bool withAlpha)
+{
+	uint32_t key = ((uint32_t)(clampf(color.r, 0, 1) * 255 + 0.5f) << 24)
+		| ((uint32_t)(clampf(color.g, 0, 1) * 255 + 0.5f) << 16)
+		| ((uint32_t)(clampf(color.b, 0, 1) * 255 + 0.5f) << 8);
+	if (withAlpha)
+		key |= ((uint32_t)alphaLevel(color.a) << 1);
+	return key | 1;
+} // end colorKey()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// buildPass()
+// Group the lights by their current _keys (lights with a zero key are skipped).
+// Nothing to do if the keys are the same as last time.
+// @pass : (IN) The pass index.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightGrid::buildPass(int pass)
+{
+	GroupPass* p = &(_passes[pass]);
+	if (p->keys == _keys)
+		return;
+	p->keys = _keys;
+	p->order.clear();
+	p->starts.clear();
+	int n = (int)lights.size();
+	for (int i = 0; i < n; i++)
+		_done[i] = (_keys[i] == 0);
+	for (int i = 0; i < n; i++)
+	{
+		if (_done[i])
+			continue;
+		// New group, collect everything after us with the same key
+		p->starts.push_back((int)p->order.size());
+		for (int j = i; j < n; j++)
+		{
+			if (!_done[j] && _keys[j] == _keys[i])
+			{
+				_done[j] = 1;
+				p->order.push_back(j);
+			}
+		}
+	}
+	return;
+} // end buildPass()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// Signed distance from pt (relative to the center) to a rounded rect (same as nanovg's box gradient shader).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+static float sdRoundRect(float x, float y, float ex, float ey, float rad)
+{
+	float dx = fabsf(x) - (ex - rad);
+	float dy = fabsf(y) - (ey - rad);
+	float ox = (dx > 0) ? dx : 0;
+	float oy = (dy > 0) ? dy : 0;
+	float in = (dx > dy) ? dx : dy;
+	return ((in < 0) ? in : 0) + sqrtf(ox*ox + oy*oy) - rad;
+}
+
+TS_LightSquareGrid::~TS_LightSquareGrid()
+{
+	if (_spriteContext != NULL)
+	{
+		for (std::map<uint32_t, int>::iterator it = _sprites.begin(); it != _sprites.end(); it++)
+			nvgDeleteImage(_spriteContext, it->second);
+	}
+	_sprites.clear();
+	return;
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// getSprite()
+// Get (or make) the outer glow sprite for the color. One sprite is one lattice
+// tile with the glow (TS_LightSquare's box gradient) baked in around the center.
+// @vg : (IN) The context.
+// @color : (IN) The light color (alpha is applied when drawing).
+// @light : (IN) A light to get the geometry from.
+// @returns : The image handle.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+int TS_LightSquareGrid::getSprite(NVGcontext* vg, NVGcolor color, TS_LightSquare* light)
+{
+	if (_spriteContext != vg)
+	{
+		// New context, old handles are no good
+		_sprites.clear();
+		_spriteContext = vg;
+	}
+	uint32_t key = colorKey(color, false);
+	std::map<uint32_t, int>::iterator it = _sprites.find(key);
+	if (it != _sprites.end())
+		return it->second;
+
+	const float scale = TS_LIGHTGRID_SPRITE_OVERSAMPLE;
+	int w = (int)ceilf(pitch.x * scale);
+	int h = (int)ceilf(pitch.y * scale);
+	float oradius = light->box.size.x / 2.0 * 1.1;
+	float feather = 2;
+	uint8_t r = (uint8_t)(clampf(color.r, 0, 1) * 255 + 0.5f);
+	uint8_t g = (uint8_t)(clampf(color.g, 0, 1) * 255 + 0.5f);
+	uint8_t b = (uint8_t)(clampf(color.b, 0, 1) * 255 + 0.5f);
+	std::vector<uint8_t> pixels(w * h * 4);
+	for (int py = 0; py < h; py++)
+	{
+		for (int px = 0; px < w; px++)
+		{
+			float x = (px + 0.5f) / scale - pitch.x / 2.0f;
+			float y = (py + 0.5f) / scale - pitch.y / 2.0f;
+			float sd = sdRoundRect(x, y, oradius, oradius, light->cornerRadius);
+			// Gradient (inner alpha 0.25 to 0) times the coverage of the rounded rect path
+			float d = clampf((sd + feather * 0.5f) / feather, 0, 1);
+			float a = 0.25f * (1.0f - d) * clampf(0.5f - sd * scale, 0, 1);
+			uint8_t* p = &(pixels[(py * w + px) * 4]);
+			p[0] = r; p[1] = g; p[2] = b;
+			p[3] = (uint8_t)(a * 255 + 0.5f);
+		}
+	}
+	int handle = nvgCreateImageRGBA(vg, w, h, NVG_IMAGE_REPEATX | NVG_IMAGE_REPEATY, pixels.data());
+	_sprites[key] = handle;
+	return handle;
+} // end getSprite()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// drawStaticLayer()
+// Backgrounds & borders (one path). Cached, only drawn when the layer is dirty.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightSquareGrid::drawStaticLayer(NVGcontext* vg)
+{
+	int n = (int)lights.size();
+	TS_LightSquare* first = (n > 0) ? dynamic_cast<TS_LightSquare*>(lights[0]) : NULL;
+	if (first == NULL)
+		return;
+	Vec size = first->box.size;
+	// Solid
+	nvgBeginPath(vg);
+	for (int i = 0; i < n; i++)
+		nvgRoundedRect(vg, lights[i]->box.pos.x, lights[i]->box.pos.y, size.x, size.y, first->cornerRadius);
+	nvgFillColor(vg, first->bgColor);
+	nvgFill(vg);
+	// Border
+	nvgStrokeWidth(vg, 1.0);
+	NVGcolor borderColor = first->bgColor;
+	borderColor.a *= 0.5;
+	nvgStrokeColor(vg, borderColor);
+	nvgStroke(vg);
+	return;
+} // end TS_LightSquareGrid::drawStaticLayer()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// draw()
+// Cached backgrounds, then per color/alpha level group the inner fill and the
+// outer glow sprite (one path each, the sprite is rgb only and the level is the paint alpha).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightSquareGrid::draw(NVGcontext* vg)
+{
+	int n = (int)lights.size();
+	TS_LightSquare* first = (n > 0) ? dynamic_cast<TS_LightSquare*>(lights[0]) : NULL;
+	if (first == NULL)
+		return;
+	Vec size = first->box.size;
+	float cornerRadius = first->cornerRadius;
+	// Margin from the lattice tile to the light
+	Vec margin = pitch.minus(size).div(2);
+	Vec tileOrigin = first->box.pos.minus(margin);
+
+	drawBackground(vg);
+
+	if (_groupsDirty)
+	{
+		// Glows by rgb & alpha level (lights that are off, or round to off, add nothing)
+		for (int i = 0; i < n; i++)
+			_keys[i] = (alphaLevel(lights[i]->color.a) > 0) ? colorKey(lights[i]->color, true) : 0;
+		buildPass(0);
+		_groupsDirty = false;
+	}
+	GroupPass* pass = &(_passes[0]);
+	if (pass->numGroups() < 1)
+		return;
+	nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
+	for (int g = 0; g < pass->numGroups(); g++)
+	{
+		int start = pass->groupStart(g);
+		int end = pass->groupEnd(g);
+		NVGcolor color = levelColor(lights[pass->order[start]]->color);
+		// Inner glow
+		nvgBeginPath(vg);
+		for (int j = start; j < end; j++)
+		{
+			Vec pos = lights[pass->order[j]]->box.pos;
+			nvgRoundedRect(vg, pos.x, pos.y, size.x, size.y, cornerRadius);
+		}
+		nvgFillColor(vg, color);
+		nvgFill(vg);
+		// Outer glow
+		nvgBeginPath(vg);
+		for (int j = start; j < end; j++)
+		{
+			Vec pos = lights[pass->order[j]]->box.pos.minus(margin);
+			nvgRect(vg, pos.x, pos.y, pitch.x, pitch.y);
+		}
+		NVGpaint paint = nvgImagePattern(vg, tileOrigin.x, tileOrigin.y, pitch.x, pitch.y, /*angle*/ 0,
+			getSprite(vg, color, first), /*alpha*/ color.a);
+		nvgFillPaint(vg, paint);
+		nvgFill(vg);
+	}
+	nvgGlobalCompositeOperation(vg, NVG_SOURCE_OVER);
+	return;
+} // end TS_LightSquareGrid::draw()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// addArc()
+// Add the light's value arc (from its zero point to the knob angle) as a new sub-path.
+// @vg : (IN) The context.
+// @light : (IN) The light.
+// @radius : (IN) The arc radius.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightArcGrid::addArc(NVGcontext* vg, TS_LightArc* light, float radius)
+{
+	float oradius = light->box.size.x / 2.0;
+	float cx = light->box.pos.x + oradius;
+	float cy = light->box.pos.y + oradius;
+	float angle = *(light->currentAngle_radians);
+	int dir = (angle < light->zeroAnglePoint) ? NVG_CCW : NVG_CW;
+	// nvgArc only moves to its start on an empty path (else it lines from the last point), so move there first
+	nvgMoveTo(vg, cx + radius * cosf(light->zeroAnglePoint), cy + radius * sinf(light->zeroAnglePoint));
+	nvgArc(vg, cx, cy, radius, /*a0*/ light->zeroAnglePoint, /*a1*/ angle, dir);
+	return;
+} // end addArc()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// drawStaticLayer()
+// Background - Solid (one path). Cached, only drawn when the layer is dirty.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightArcGrid::drawStaticLayer(NVGcontext* vg)
+{
+	int n = (int)lights.size();
+	TS_LightArc* first = (n > 0) ? dynamic_cast<TS_LightArc*>(lights[0]) : NULL;
+	if (first == NULL)
+		return;
+	float oradius = first->box.size.x / 2.0;
+	nvgBeginPath(vg);
+	for (int i = 0; i < n; i++)
+		nvgCircle(vg, lights[i]->box.pos.x + oradius, lights[i]->box.pos.y + oradius, first->innerRadius);
+	nvgFillColor(vg, first->bgColor);
+	nvgFill(vg);
+	return;
+} // end TS_LightArcGrid::drawStaticLayer()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// draw()
+// Same layers as TS_LightArc::draw(), but each layer is one path per color group.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TS_LightArcGrid::draw(NVGcontext* vg)
+{
+	int n = (int)lights.size();
+	TS_LightArc* first = (n > 0) ? dynamic_cast<TS_LightArc*>(lights[0]) : NULL;
+	if (first == NULL)
+		return;
+	float oradius = first->box.size.x / 2.0; // 25
+	float radius = oradius - 2; // 23
+	float innerRadius = first->innerRadius;
+	for (int i = 0; i < n; i++)
+	{
+		TS_LightArc* light = static_cast<TS_LightArc*>(lights[i]);
+		light->zeroAnglePoint = light->valueMode->zeroPointAngle_radians;
+	}
+
+	drawBackground(vg);
+
+	if (_groupsDirty)
+	{
+		// 0: Border (light color, skip if off), 1: Inner glow (rgb only), 2: Value arcs (base color), 3: Outer glow (light color, skip if off)
+		for (int i = 0; i < n; i++)
+			_keys[i] = (alphaLevel(lights[i]->color.a) > 0) ? colorKey(lights[i]->color, true) : 0;
+		buildPass(0);
+		buildPass(3);
+		for (int i = 0; i < n; i++)
+			_keys[i] = colorKey(lights[i]->color, false);
+		buildPass(1);
+		for (int i = 0; i < n; i++)
+			_keys[i] = colorKey(lights[i]->baseColor, true);
+		buildPass(2);
+		_groupsDirty = false;
+	}
+
+	// Border (light color, half alpha)
+	GroupPass* pass = &(_passes[0]);
+	nvgStrokeWidth(vg, radius - innerRadius);
+	for (int g = 0; g < pass->numGroups(); g++)
+	{
+		nvgBeginPath(vg);
+		for (int j = pass->groupStart(g); j < pass->groupEnd(g); j++)
+		{
+			Vec pos = lights[pass->order[j]]->box.pos;
+			nvgCircle(vg, pos.x + oradius, pos.y + oradius, innerRadius);
+		}
+		NVGcolor borderColor = levelColor(lights[pass->order[pass->groupStart(g)]]->color);
+		borderColor.a *= 0.5;
+		nvgStrokeColor(vg, borderColor);
+		nvgStroke(vg);
+	}
+
+	nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
+	// Inner glow (TS_LightArc strokes both the inner and outer circle here, at a fixed alpha)
+	pass = &(_passes[1]);
+	nvgStrokeWidth(vg, oradius - radius);
+	for (int g = 0; g < pass->numGroups(); g++)
+	{
+		nvgBeginPath(vg);
+		for (int j = pass->groupStart(g); j < pass->groupEnd(g); j++)
+		{
+			Vec pos = lights[pass->order[j]]->box.pos;
+			nvgCircle(vg, pos.x + oradius, pos.y + oradius, innerRadius);
+			nvgCircle(vg, pos.x + oradius, pos.y + oradius, radius);
+		}
+		NVGcolor borderColor = lights[pass->order[pass->groupStart(g)]]->color;
+		borderColor.a = 0.25;
+		nvgStrokeColor(vg, borderColor);
+		nvgStroke(vg);
+	}
+
+	// Value arcs (base color)
+	pass = &(_passes[2]);
+	nvgStrokeWidth(vg, oradius - innerRadius);
+	for (int g = 0; g < pass->numGroups(); g++)
+	{
+		nvgBeginPath(vg);
+		for (int j = pass->groupStart(g); j < pass->groupEnd(g); j++)
+			addArc(vg, static_cast<TS_LightArc*>(lights[pass->order[j]]), innerRadius);
+		NVGcolor arcColor = levelColor(lights[pass->order[pass->groupStart(g)]]->baseColor);
+		arcColor.a *= 0.7;
+		nvgStrokeColor(vg, arcColor);
+		nvgStroke(vg);
+	}
+
+	// Outer glow. TS_LightArc's radial gradient starts fading at innerRadius, which is where this
+	// stroke ends, so it is a solid color (no per knob gradient needed).
+	pass = &(_passes[3]);
+	nvgStrokeWidth(vg, oradius - innerRadius + 3);
+	for (int g = 0; g < pass->numGroups(); g++)
+	{
+		nvgBeginPath(vg);
+		for (int j = pass->groupStart(g); j < pass->groupEnd(g); j++)
+			addArc(vg, static_cast<TS_LightArc*>(lights[pass->order[j]]), innerRadius - 3);
+		NVGcolor icol = levelColor(lights[pass->order[pass->groupStart(g)]]->color);
+		icol.a *= 0.8;
+		nvgStrokeColor(vg, icol);
+		nvgStroke(vg);
+	}
+	nvgGlobalCompositeOperation(vg, NVG_SOURCE_OVER);//Restore to default.
+
+	// Text (each light only formats its string when its value changes)
+	nvgFontFaceId(vg, first->font->handle);
+	nvgFontSize(vg, first->fontSize);
+	nvgTextAlign(vg, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
+	nvgFillColor(vg, COLOR_WHITE);
+	for (int i = 0; i < n; i++)
+	{
+		TS_LightArc* light = static_cast<TS_LightArc*>(lights[i]);
+		if (light->numericValue != NULL)
+			nvgText(vg, light->box.pos.x + oradius, light->box.pos.y + oradius, light->getDisplayString(), NULL);
+	}
+	return;
+} // end TS_LightArcGrid::draw()
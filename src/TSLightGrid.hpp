@@ -0,0 +1,115 @@
+#ifndef TSLIGHTGRID_HPP
+#define TSLIGHTGRID_HPP
+
+#include "rack.hpp"
+using namespace rack;
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include "trowaSoftComponents.hpp"
+
+// Glow sprite pixels per widget unit (so the glow stays smooth when zoomed in).
+#define TS_LIGHTGRID_SPRITE_OVERSAMPLE		2
+// Number of alpha levels lights are grouped (and drawn) at, so fading lights still batch.
+#define TS_LIGHTGRID_ALPHA_LEVELS			16
+
+//=== TS_LightGrid ============================================
+// Draws the sequencer step lights in a few batched passes instead of every light
+// issuing its own paths, gradients and composite switches.
+// The lights are still our children (so they step and keep their color & value
+// and the module can still setColor() them) but they don't draw themselves.
+// All lights should be the same size and sit on a lattice of 'pitch'.
+// The parts that never change (backgrounds) are cached in a TS_StaticLayer and the
+// draw groups are only rebuilt when a light's change signature changed.
+//=============================================================
+struct TS_LightGrid : TransparentWidget, TS_StaticLayerSource
+{
+	// The lights we draw (also our children).
+	std::vector<ColorValueLight*> lights;
+	// Distance between the lights (origin to origin).
+	Vec pitch;
+	// Cached backgrounds.
+	TS_StaticLayer* staticLayer;
+
+	TS_LightGrid(Vec pitch, int numPasses);
+	virtual ~TS_LightGrid() {};
+	// Add a light. Its box.pos is relative to this grid.
+	void addLight(ColorValueLight* light);
+	// Step the lights and check their signatures.
+	void step() override;
+protected:
+	// One draw pass (layer): light indices ordered by group and where each group starts.
+	struct GroupPass {
+		std::vector<int> order;
+		std::vector<int> starts;
+		// The keys the groups were built from (so we only regroup when a key changed).
+		std::vector<uint32_t> keys;
+		int numGroups() { return (int)starts.size(); }
+		int groupStart(int g) { return starts[g]; }
+		int groupEnd(int g) { return (g + 1 < (int)starts.size()) ? starts[g + 1] : (int)order.size(); }
+	};
+	// The cached groups for each pass.
+	std::vector<GroupPass> _passes;
+	// If the groups need to be rebuilt (a light changed).
+	bool _groupsDirty = true;
+	// Draw group key per light (for building a pass).
+	std::vector<uint32_t> _keys;
+	// If the light is already in a group (for building a pass).
+	std::vector<uint8_t> _done;
+	// Get the key for a color (8 bits per channel, alpha level optional).
+	static uint32_t colorKey(NVGcolor color, bool withAlpha);
+	// Get the alpha level (0 to TS_LIGHTGRID_ALPHA_LEVELS - 1) for an alpha.
+	static int alphaLevel(float alpha) {
+		return (int)(clampf(alpha, 0, 1) * (TS_LIGHTGRID_ALPHA_LEVELS - 1) + 0.5f);
+	}
+	// Get the color with its alpha snapped to its level (what a group is drawn with).
+	static NVGcolor levelColor(NVGcolor color) {
+		color.a = alphaLevel(color.a) / (float)(TS_LIGHTGRID_ALPHA_LEVELS - 1);
+		return color;
+	}
+	// Rebuild a pass from the current _keys (lights with a zero key are skipped).
+	void buildPass(int pass);
+	// Draw the cached static layer (it sits at our origin).
+	void drawBackground(NVGcontext* vg) {
+		staticLayer->setSize(box.size);
+		staticLayer->draw(vg);
+		return;
+	}
+}; // end TS_LightGrid
+
+//=== TS_LightSquareGrid ======================================
+// Batched drawing for TS_LightSquare (trigSeq/trigSeq64 pads).
+// The outer glow is one precomputed sprite per rgb, repeated across the lattice
+// so all lit pads of the same color & alpha level are one fill (the level is the
+// paint alpha, so fading pads don't each become their own group).
+//=============================================================
+struct TS_LightSquareGrid : TS_LightGrid
+{
+	TS_LightSquareGrid(Vec pitch) : TS_LightGrid(pitch, /*numPasses*/ 1) {};
+	virtual ~TS_LightSquareGrid();
+	void draw(NVGcontext* vg) override;
+	void drawStaticLayer(NVGcontext* vg) override;
+protected:
+	// Glow sprite image handles by rgb key.
+	std::map<uint32_t, int> _sprites;
+	// The context the sprites belong to.
+	NVGcontext* _spriteContext = NULL;
+	// Get (or make) the glow sprite for the color.
+	int getSprite(NVGcontext* vg, NVGcolor color, TS_LightSquare* light);
+}; // end TS_LightSquareGrid
+
+//=== TS_LightArcGrid =========================================
+// Batched drawing for TS_LightArc (voltSeq knob lights).
+//=============================================================
+struct TS_LightArcGrid : TS_LightGrid
+{
+	TS_LightArcGrid(Vec pitch) : TS_LightGrid(pitch, /*numPasses*/ 4) {};
+	void draw(NVGcontext* vg) override;
+	void drawStaticLayer(NVGcontext* vg) override;
+protected:
+	// Add the light's value arc to the current path.
+	void addArc(NVGcontext* vg, TS_LightArc* light, float radius);
+}; // end TS_LightArcGrid
+
+#endif // !TSLIGHTGRID_HPP
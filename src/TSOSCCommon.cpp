@@ -1,10 +1,15 @@
 #include "TSOSCCommon.hpp"
 #include <string>
+#include <string.h>
+#include <limits.h>
+#include <chrono>
 
 
 // The OSC client labels/strings. 
 std::string OSCClientStr[NUM_OSC_CLIENTS] = { "Generic", "touchOSC" };// , "Lemur" };
 std::string OSCClientAbbr[NUM_OSC_CLIENTS] = { "Gen", "tOSC" };// , "Lemr" };
+// The OSC transport labels.
+std::string TSOSCTransportStr[NUM_TSOSC_TRANSPORTS] = { "UDP", "TCP (SLIP)", "Unix Socket (SLIP)" };
 
 
 namespace touchOSC
@@ -50,3 +55,445 @@ namespace touchOSC
 		return;
 	}
 }
+
+//--------------------------------------------------------
+// Read a big-endian int32.
+//--------------------------------------------------------
+static inline int32_t TSOSCReadInt32(const char* p)
+{
+	const uint8_t* u = reinterpret_cast<const uint8_t*>(p);
+	return (int32_t)(((uint32_t)u[0] << 24) | ((uint32_t)u[1] << 16) | ((uint32_t)u[2] << 8) | (uint32_t)u[3]);
+}
+//--------------------------------------------------------
+// Read a big-endian uint64.
+//--------------------------------------------------------
+static inline uint64_t TSOSCReadUInt64(const char* p)
+{
+	return ((uint64_t)(uint32_t)TSOSCReadInt32(p) << 32) | (uint64_t)(uint32_t)TSOSCReadInt32(p + 4);
+}
+//--------------------------------------------------------
+// Read a big-endian float.
+//--------------------------------------------------------
+static inline float TSOSCReadFloat(const char* p)
+{
+	uint32_t u = (uint32_t)TSOSCReadInt32(p);
+	float f;
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+//--------------------------------------------------------
+// Read a big-endian double.
+//--------------------------------------------------------
+static inline double TSOSCReadDouble(const char* p)
+{
+	uint64_t u = TSOSCReadUInt64(p);
+	double d;
+	memcpy(&d, &u, sizeof(d));
+	return d;
+}
+//--------------------------------------------------------
+// Round to the nearest int, clamped to the int range (casting an out of range
+// or infinite value is undefined). d must not be NaN.
+//--------------------------------------------------------
+static inline int TSOSCRoundToInt(double d)
+{
+	if (d >= (double)INT_MAX)
+		return INT_MAX;
+	if (d <= (double)INT_MIN)
+		return INT_MIN;
+	return (int)((d < 0) ? d - 0.5 : d + 0.5);
+}
+//--------------------------------------------------------
+// Find the end of a null terminated, 4-byte padded string starting at p.
+// @length : (OUT) The string length (if not NULL).
+// @returns : Pointer to the next 4-byte boundary after the terminator, or NULL if not terminated before end.
+//--------------------------------------------------------
+static inline const char* TSOSCFindStr4End(const char* p, const char* end, /*out*/ int* length = NULL)
+{
+	const char* s = (const char*)memchr(p, '\0', end - p);
+	if (s == NULL)
+		return NULL;
+	if (length != NULL)
+		*length = (int)(s - p);
+	// Skip terminator and padding
+	const char* next = p + (((s - p) + 4) & ~3);
+	return (next <= end) ? next : NULL;
+}
+// Argument size of a type tag that has its size in the data (string, symbol, blob).
+#define TSOSC_TAG_SIZE_VARIABLE		-1
+// Argument size of an unknown type tag.
+#define TSOSC_TAG_SIZE_INVALID		-2
+//--------------------------------------------------------
+// Size of the argument data for the type tag (0, 4 or 8 bytes, or
+// TSOSC_TAG_SIZE_VARIABLE / TSOSC_TAG_SIZE_INVALID).
+//--------------------------------------------------------
+static inline int TSOSCTagSize(char tag)
+{
+	switch (tag)
+	{
+		case 'i': // int32
+		case 'f': // float
+		case 'c': // char
+		case 'r': // rgba
+		case 'm': // midi
+			return 4;
+		case 'h': // int64
+		case 'd': // double
+		case 't': // time tag
+			return 8;
+		case 's': // string
+		case 'S': // symbol
+		case 'b': // blob
+			return TSOSC_TAG_SIZE_VARIABLE;
+		case 'T': // true
+		case 'F': // false
+		case 'N': // nil
+		case 'I': // infinitum
+		case '[': // array begin
+		case ']': // array end
+			return 0;
+		default:
+			return TSOSC_TAG_SIZE_INVALID;
+	}
+}
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCMessage::parse()
+// Parse and validate the message. The type tags are checked first and the
+// fixed size arguments are checked against the size once, so a message with
+// only numbers (the usual) is laid out without any more checks. Strings and
+// blobs carry their size in the data and are checked as they are read.
+// @data : (IN) The message data (4-byte aligned size).
+// @size : (IN) The size of the data.
+// @returns : TSOSC_PARSE_OK if the message is valid.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCParseStatus TSOSCMessage::parse(const char* data, int size)
+{
+	numArgs = 0;
+	address = NULL;
+	addressLength = 0;
+	this->size = size;
+	if (data == NULL || size <= 0 || (size & 0x03) != 0)
+		return TSOSC_PARSE_BAD_SIZE;
+	const char* end = data + size;
+	if (data[0] != '/')
+		return TSOSC_PARSE_BAD_ADDRESS;
+	int length = 0;
+	const char* p = TSOSCFindStr4End(data, end, &length);
+	if (p == NULL)
+		return TSOSC_PARSE_BAD_ADDRESS;
+	address = data;
+	addressLength = length;
+	if (p == end)
+		return TSOSC_PARSE_OK; // No type tags (old style message) -> no arguments
+	if (*p != ',')
+		return TSOSC_PARSE_BAD_TYPE_TAGS;
+	const char* tags = p + 1;
+	p = TSOSCFindStr4End(p, end, &length);
+	if (p == NULL)
+		return TSOSC_PARSE_BAD_TYPE_TAGS;
+	int numTags = length - 1;
+	// Check the tags and add up the fixed sizes.
+	int fixedSize = 0;
+	bool variable = false;
+	for (int i = 0; i < numTags; i++)
+	{
+		int argSize = TSOSCTagSize(tags[i]);
+		if (argSize == TSOSC_TAG_SIZE_INVALID)
+			return TSOSC_PARSE_BAD_TYPE_TAGS;
+		else if (argSize == TSOSC_TAG_SIZE_VARIABLE)
+			variable = true;
+		else
+			fixedSize += argSize;
+	}
+	if (fixedSize > end - p)
+		return TSOSC_PARSE_BAD_ARGUMENT;
+	int n = (numTags < TSOSC_MAX_ARGS) ? numTags : TSOSC_MAX_ARGS;
+	if (!variable)
+	{
+		// All sizes are known and fit, just lay out the arguments we keep.
+		for (int i = 0; i < n; i++)
+		{
+			typeTags[i] = tags[i];
+			args[i] = p;
+			p += TSOSCTagSize(tags[i]);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < numTags; i++)
+		{
+			const char* arg = p;
+			int argSize = TSOSCTagSize(tags[i]);
+			if (argSize != TSOSC_TAG_SIZE_VARIABLE)
+			{
+				p += argSize;
+				if (p > end)
+					return TSOSC_PARSE_BAD_ARGUMENT;
+			}
+			else if (tags[i] == 'b')
+			{
+				if (end - p < 4)
+					return TSOSC_PARSE_BAD_ARGUMENT;
+				int32_t blobSize = TSOSCReadInt32(p);
+				if (blobSize < 0 || blobSize > end - p - 4)
+					return TSOSC_PARSE_BAD_ARGUMENT;
+				p += 4 + ((blobSize + 3) & ~3);
+			}
+			else
+			{
+				p = TSOSCFindStr4End(p, end);
+				if (p == NULL)
+					return TSOSC_PARSE_BAD_ARGUMENT;
+			}
+			if (i < n)
+			{
+				typeTags[i] = tags[i];
+				args[i] = arg;
+			}
+		} // end for
+	}
+	numArgs = n;
+	return TSOSC_PARSE_OK;
+} // end TSOSCMessage::parse()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCMessage::getInt()
+// Read an argument as an int. Numbers are converted (floats are rounded, anything
+// out of the int range is clamped, NaN is rejected), true/false are 1/0.
+// @ix : (IN) The argument index.
+// @val : (OUT) The value (untouched if not OK).
+// @returns : TSOSC_PARSE_OK, TSOSC_PARSE_MISSING_ARGUMENT or TSOSC_PARSE_WRONG_TYPE.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCParseStatus TSOSCMessage::getInt(int ix, int* val) const
+{
+	if (ix < 0 || ix >= numArgs)
+		return TSOSC_PARSE_MISSING_ARGUMENT;
+	switch (typeTags[ix])
+	{
+		case 'i':
+			*val = TSOSCReadInt32(args[ix]);
+			break;
+		case 'h':
+		{
+			int64_t h = (int64_t)TSOSCReadUInt64(args[ix]);
+			*val = (h > INT_MAX) ? INT_MAX : (h < INT_MIN) ? INT_MIN : (int)h;
+			break;
+		}
+		case 'f':
+		{
+			float f = TSOSCReadFloat(args[ix]);
+			if (f != f)
+				return TSOSC_PARSE_WRONG_TYPE; // NaN
+			*val = TSOSCRoundToInt(f); // Exact as a double, so no float rounding at the edges
+			break;
+		}
+		case 'd':
+		{
+			double d = TSOSCReadDouble(args[ix]);
+			if (d != d)
+				return TSOSC_PARSE_WRONG_TYPE; // NaN
+			*val = TSOSCRoundToInt(d);
+			break;
+		}
+		case 'T':
+			*val = 1;
+			break;
+		case 'F':
+			*val = 0;
+			break;
+		default:
+			return TSOSC_PARSE_WRONG_TYPE;
+	}
+	return TSOSC_PARSE_OK;
+} // end TSOSCMessage::getInt()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCMessage::getFloat()
+// Read an argument as a float. Numbers are converted, true/false are 1/0.
+// @ix : (IN) The argument index.
+// @val : (OUT) The value (untouched if not OK).
+// @returns : TSOSC_PARSE_OK, TSOSC_PARSE_MISSING_ARGUMENT or TSOSC_PARSE_WRONG_TYPE.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCParseStatus TSOSCMessage::getFloat(int ix, float* val) const
+{
+	if (ix < 0 || ix >= numArgs)
+		return TSOSC_PARSE_MISSING_ARGUMENT;
+	switch (typeTags[ix])
+	{
+		case 'f':
+			*val = TSOSCReadFloat(args[ix]);
+			break;
+		case 'i':
+			*val = (float)TSOSCReadInt32(args[ix]);
+			break;
+		case 'h':
+			*val = (float)(int64_t)TSOSCReadUInt64(args[ix]);
+			break;
+		case 'd':
+			*val = (float)TSOSCReadDouble(args[ix]);
+			break;
+		case 'T':
+			*val = 1.0f;
+			break;
+		case 'F':
+			*val = 0.0f;
+			break;
+		default:
+			return TSOSC_PARSE_WRONG_TYPE;
+	}
+	return TSOSC_PARSE_OK;
+} // end TSOSCMessage::getFloat()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCMessage::getString()
+// Read a string or symbol argument.
+// @ix : (IN) The argument index.
+// @val : (OUT) The string (points into the packet).
+// @returns : TSOSC_PARSE_OK, TSOSC_PARSE_MISSING_ARGUMENT or TSOSC_PARSE_WRONG_TYPE.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCParseStatus TSOSCMessage::getString(int ix, const char** val) const
+{
+	if (ix < 0 || ix >= numArgs)
+		return TSOSC_PARSE_MISSING_ARGUMENT;
+	if (typeTags[ix] != 's' && typeTags[ix] != 'S')
+		return TSOSC_PARSE_WRONG_TYPE;
+	*val = args[ix];
+	return TSOSC_PARSE_OK;
+} // end TSOSCMessage::getString()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCBundleReader::init()
+// Check the bundle header and read the time tag.
+// @data : (IN) The bundle data.
+// @size : (IN) The size of the data.
+// @returns : TSOSC_PARSE_OK if the header is good.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCParseStatus TSOSCBundleReader::init(const char* data, int size)
+{
+	_p = _end = NULL;
+	if (data == NULL || size < 16 || (size & 0x03) != 0)
+		status = TSOSC_PARSE_BAD_SIZE;
+	else if (!TSOSCIsBundle(data, size))
+		status = TSOSC_PARSE_BAD_BUNDLE;
+	else
+	{
+		timeTag = TSOSCReadUInt64(data + 8);
+		_p = data + 16;
+		_end = data + size;
+		status = TSOSC_PARSE_OK;
+	}
+	return status;
+} // end TSOSCBundleReader::init()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCBundleReader::next()
+// Get the next element of the bundle.
+// @element : (OUT) Start of the element (message or bundle).
+// @size : (OUT) Size of the element.
+// @returns : True if there was a (size-valid) element.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCBundleReader::next(/*out*/ const char** element, /*out*/ int* size)
+{
+	if (status != TSOSC_PARSE_OK || _p == NULL || _p >= _end)
+		return false;
+	if (_end - _p < 4)
+	{
+		status = TSOSC_PARSE_BAD_BUNDLE;
+		return false;
+	}
+	int32_t elementSize = TSOSCReadInt32(_p);
+	if (elementSize <= 0 || (elementSize & 0x03) != 0 || elementSize > _end - _p - 4)
+	{
+		status = TSOSC_PARSE_BAD_BUNDLE;
+		return false;
+	}
+	*element = _p + 4;
+	*size = elementSize;
+	_p += 4 + elementSize;
+	return true;
+} // end TSOSCBundleReader::next()
+
+//--------------------------------------------------------
+// TSOSCTimeTagNow()
+// Current time as an OSC/NTP time tag (upper 32 bits seconds since 1/1/1900, lower 32 bits fraction).
+//--------------------------------------------------------
+uint64_t TSOSCTimeTagNow()
+{
+	// Seconds between 1/1/1900 (NTP epoch) and 1/1/1970 (unix epoch)
+	const uint64_t ntpUnixOffset = 2208988800ULL;
+	int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	uint64_t secs = (uint64_t)(us / 1000000) + ntpUnixOffset;
+	uint64_t frac = ((uint64_t)(us % 1000000) << 32) / 1000000;
+	return (secs << 32) | frac;
+} // end TSOSCTimeTagNow()
+//--------------------------------------------------------
+// TSOSCParsePathInt()
+// Parse a non-negative int from a path segment (up to '/' or end of string).
+// @s : (IN) Start of the segment.
+// @val : (OUT) The value.
+// @returns : False if the segment is empty or has a non-digit (or overflows).
+//--------------------------------------------------------
+bool TSOSCParsePathInt(const char* s, /*out*/ int* val)
+{
+	if (s == NULL || *s == '\0' || *s == '/')
+		return false;
+	int v = 0;
+	for (; *s != '\0' && *s != '/'; s++)
+	{
+		if (*s < '0' || *s > '9' || v > 100000000)
+			return false;
+		v = v * 10 + (*s - '0');
+	}
+	*val = v;
+	return true;
+} // end TSOSCParsePathInt()
+//--------------------------------------------------------
+// TSOSCPathSegment()
+// Get the start of the nth (0-based) segment of a path.
+// ("/edit/step/3", 2) -> "3".
+// @path : (IN) The path (starts with '/').
+// @n : (IN) The segment index.
+// @returns : Pointer to the segment start, or NULL.
+//--------------------------------------------------------
+const char* TSOSCPathSegment(const char* path, int n)
+{
+	if (path == NULL)
+		return NULL;
+	int count = -1;
+	for (const char* s = path; *s != '\0'; s++)
+	{
+		if (*s == '/' && ++count == n)
+			return s + 1;
+	}
+	return NULL;
+} // end TSOSCPathSegment()
+
+// Zero all counters.
+void TSOSCStats::reset()
+{
+	packetsOut = 0;
+	bytesOut = 0;
+	messagesIn = 0;
+	bytesIn = 0;
+	queueHighWater = 0;
+	drops = 0;
+	parseErrors = 0;
+	unknownMessages = 0;
+	handleMaxUs = 0;
+	for (int i = 0; i < TSOSC_STATS_MAX_MSG_TYPES; i++)
+		messageTypeCounts[i] = 0;
+	for (int i = 0; i < TSOSC_STATS_LATENCY_BUCKETS; i++)
+		latency[i] = 0;
+	return;
+}
+// Count a receive to apply latency (bucket i is < 2^i us).
+void TSOSCStats::addLatency(uint32_t us)
+{
+	int bucket = 0;
+	while (bucket < TSOSC_STATS_LATENCY_BUCKETS - 1 && (us >> bucket) > 0)
+		bucket++;
+	add(latency[bucket], 1);
+	return;
+}
+// Monotonic clock in microseconds (for TSOSCStats latency).
+int64_t TSOSCStatsNowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
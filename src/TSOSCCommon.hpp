@@ -2,7 +2,21 @@
 #define TSOSCCOMMON_HPP
 
 #include <string>
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include "TSExternalControlMessage.hpp"
 
+// Max number of arguments we keep track of in a TSOSCMessage (the rest are validated but ignored).
+#define TSOSC_MAX_ARGS				8
+// Max bundle nesting we will follow.
+#define TSOSC_MAX_BUNDLE_DEPTH		4
+// Time tag for 'immediately'.
+#define TSOSC_TIMETAG_IMMEDIATE		1ULL
+// Number of buckets in the TSOSCStats latency histogram (bucket i is < 2^i us, the last one is everything longer).
+#define TSOSC_STATS_LATENCY_BUCKETS	16
+// Max number of message types counted in TSOSCStats.
+#define TSOSC_STATS_MAX_MSG_TYPES	32
 
 // What client are we talking to. touchOSC and Lemur are a little limited, so they need special treatment.
 enum OSCClient : uint8_t {
@@ -20,7 +34,166 @@ extern std::string OSCClientStr[NUM_OSC_CLIENTS];
 // OSC Client abbreviations.
 extern std::string OSCClientAbbr[NUM_OSC_CLIENTS];
 
+// How we send OSC out. Stream transports are SLIP framed (OSC 1.1) so a whole state dump can go in one write.
+enum TSOSCTransport : uint8_t {
+	// UDP datagrams (default).
+	UdpTransport,
+	// SLIP framed stream over TCP (to the OSC IP address / output port).
+	TcpSlipTransport,
+	// SLIP framed stream over a local (AF_UNIX) socket (not on Windows). Path is TSOSC_UNIX_SOCKET_PATH_FS with the output port.
+	UnixSlipTransport,
+	NUM_TSOSC_TRANSPORTS
+};
+// The transport labels.
+extern std::string TSOSCTransportStr[NUM_TSOSC_TRANSPORTS];
+// Local socket path for UnixSlipTransport (format string, takes the output port).
+#define TSOSC_UNIX_SOCKET_PATH_FS	"/tmp/trowaSoft_osc_%d.sock"
+
+
+
+// Result of parsing/reading OSC (no exceptions).
+enum TSOSCParseStatus : uint8_t {
+	// All good.
+	TSOSC_PARSE_OK,
+	// Size is 0, not a multiple of 4 or too small for what it claims to hold.
+	TSOSC_PARSE_BAD_SIZE,
+	// Address pattern doesn't start with '/' or isn't terminated.
+	TSOSC_PARSE_BAD_ADDRESS,
+	// Type tag string missing, unterminated or has an unknown tag.
+	TSOSC_PARSE_BAD_TYPE_TAGS,
+	// An argument runs past the end of the message.
+	TSOSC_PARSE_BAD_ARGUMENT,
+	// Bundle header or element sizes are bad.
+	TSOSC_PARSE_BAD_BUNDLE,
+	// [Read] Argument not there.
+	TSOSC_PARSE_MISSING_ARGUMENT,
+	// [Read] Argument can't be converted to the requested type.
+	TSOSC_PARSE_WRONG_TYPE,
+	NUM_TSOSC_PARSE_STATUS
+};
 
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCMessage
+// A received OSC message, parsed and validated in place (points into the packet
+// buffer, so only valid while that is). Never throws; everything returns a status.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSOSCMessage
+{
+	// The address pattern (null terminated).
+	const char* address = NULL;
+	// Length of the address pattern.
+	int addressLength = 0;
+	// Size of the whole message in bytes.
+	int size = 0;
+	// Number of arguments (up to TSOSC_MAX_ARGS).
+	int numArgs = 0;
+	// Type tag of each argument.
+	char typeTags[TSOSC_MAX_ARGS];
+	// Start of each argument's data.
+	const char* args[TSOSC_MAX_ARGS];
+
+	// Parse and validate the message (one pass over the type tags).
+	TSOSCParseStatus parse(const char* data, int size);
+	// Read an argument as an int (int32, int64, float, double, true/false are converted).
+	TSOSCParseStatus getInt(int ix, int* val) const;
+	// Read an argument as a float (int32, int64, float, double, true/false are converted).
+	TSOSCParseStatus getFloat(int ix, float* val) const;
+	// Read a string/symbol argument.
+	TSOSCParseStatus getString(int ix, const char** val) const;
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCBundleReader
+// Walks the elements of a bundle without exceptions.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSOSCBundleReader
+{
+	// The bundle's time tag (NTP format).
+	uint64_t timeTag = TSOSC_TIMETAG_IMMEDIATE;
+	// Status (TSOSC_PARSE_BAD_BUNDLE if an element size was bad).
+	TSOSCParseStatus status = TSOSC_PARSE_OK;
+	// Check the header. 
+	TSOSCParseStatus init(const char* data, int size);
+	// Get the next element. Returns false at the end (or on error, see status).
+	bool next(/*out*/ const char** element, /*out*/ int* size);
+private:
+	const char* _p = NULL;
+	const char* _end = NULL;
+};
+
+// If the packet is a bundle.
+inline bool TSOSCIsBundle(const char* data, int size)
+{
+	return size >= 16 && data[0] == '#' && strncmp(data, "#bundle", 8) == 0;
+}
+// Current time as an OSC (NTP, 32.32 fixed point seconds since 1900) time tag.
+uint64_t TSOSCTimeTagNow();
+// Seconds from time tag a until time tag b (negative if b is before a).
+inline double TSOSCTimeTagDiffSeconds(uint64_t a, uint64_t b)
+{
+	return (double)(int64_t)(b - a) / 4294967296.0;
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCStats
+// OSC traffic counters for one module. Lock-free (relaxed atomics), written by the receive
+// thread and the engine thread, read by the UI and /stats. Counters wrap.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSOSCStats
+{
+	// Packets (bundles) we sent.
+	std::atomic<uint32_t> packetsOut;
+	// Bytes we sent.
+	std::atomic<uint32_t> bytesOut;
+	// Messages we received (routed to us).
+	std::atomic<uint32_t> messagesIn;
+	// Bytes of the messages we received.
+	std::atomic<uint32_t> bytesIn;
+	// Most messages waiting in the module's inbox.
+	std::atomic<uint32_t> queueHighWater;
+	// Messages dropped (inbox full).
+	std::atomic<uint32_t> drops;
+	// Bad packets/messages on our receive port.
+	std::atomic<uint32_t> parseErrors;
+	// Messages for our namespace with an address we don't know.
+	std::atomic<uint32_t> unknownMessages;
+	// Longest time handling our messages in one step (us).
+	std::atomic<uint32_t> handleMaxUs;
+	// Messages received by type (TSExternalControlMessage::MessageType).
+	std::atomic<uint32_t> messageTypeCounts[TSOSC_STATS_MAX_MSG_TYPES];
+	static_assert(TSExternalControlMessage::MessageType::NUM_MESSAGE_TYPES <= TSOSC_STATS_MAX_MSG_TYPES, "TSOSCStats can't count all message types.");
+	// Receive to apply latency histogram (bucket i is < 2^i us). Scheduled (time tagged) messages are not counted.
+	std::atomic<uint32_t> latency[TSOSC_STATS_LATENCY_BUCKETS];
+
+	TSOSCStats() { reset(); }
+	// Zero all counters.
+	void reset();
+	// Add to a counter.
+	static inline void add(std::atomic<uint32_t>& counter, uint32_t n)
+	{
+		counter.fetch_add(n, std::memory_order_relaxed);
+	}
+	// Raise a max counter.
+	static inline void setMax(std::atomic<uint32_t>& counter, uint32_t val)
+	{
+		uint32_t curr = counter.load(std::memory_order_relaxed);
+		while (val > curr && !counter.compare_exchange_weak(curr, val, std::memory_order_relaxed))
+			;
+	}
+	// Count a receive to apply latency.
+	void addLatency(uint32_t us);
+	// Count a message type.
+	inline void addMessageType(int type)
+	{
+		if (type >= 0 && type < TSOSC_STATS_MAX_MSG_TYPES)
+			add(messageTypeCounts[type], 1);
+	}
+};
+// Monotonic clock in microseconds (for TSOSCStats latency).
+int64_t TSOSCStatsNowUs();
+// Parse a (non-negative) int from the path segment starting at s (ends at '/' or end of string). Never throws.
+bool TSOSCParsePathInt(const char* s, /*out*/ int* val);
+// Get the start of the nth (0-based) segment of the path (after the nth '/'). NULL if there isn't one.
+const char* TSOSCPathSegment(const char* path, int n);
 
 //-------- Helpers -------------
 namespace touchOSC
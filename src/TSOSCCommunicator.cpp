@@ -3,126 +3,996 @@
 #include <thread> // std::thread
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <map>
 #include <mutex>
+#include <algorithm>
+#if defined(_WIN32)
+#include <winsock2.h>
+#define TSOSC_INVALID_SOCKET	((intptr_t)INVALID_SOCKET)
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#define TSOSC_INVALID_SOCKET	((intptr_t)-1)
+#endif
 #include "util.hpp"
+#include "trowaSoftUtilities.hpp" // For debug
+
+#if defined(_MSC_VER)
+#include <intrin.h> // _BitScanForward64
+#endif
 
 #define MIN_PORT	1000
 #define MAX_PORT	0xFFFF
 
 // The connector
-TSOSCConnector* TSOSCConnector::_instance = NULL;
+// Port state word layout.
+#define PORT_ID_MASK		0xFFFFFFULL
+#define PORT_RX_OWNER_SHIFT	24
+#define PORT_RX_COUNT_SHIFT	48
+#define PORT_TX_OWNER(s)	((int)((s) & PORT_ID_MASK))
+#define PORT_RX_OWNER(s)	((int)(((s) >> PORT_RX_OWNER_SHIFT) & PORT_ID_MASK))
+#define PORT_RX_COUNT(s)	((int)((s) >> PORT_RX_COUNT_SHIFT))
+#define PORT_STATE(txOwner, rxOwner, rxCount)	((uint64_t)(txOwner) | ((uint64_t)(rxOwner) << PORT_RX_OWNER_SHIFT) | ((uint64_t)(rxCount) << PORT_RX_COUNT_SHIFT))
 
 TSOSCConnector::TSOSCConnector()
 {
 	_lastId = 0;
+	_rxRunning = false;
+	for (int i = 0; i < TSOSC_NUM_PORTS; i++)
+		_ports[i].store(0, std::memory_order_relaxed);
+	for (int i = 0; i < TSOSC_PORT_BITMAP_WORDS; i++)
+		_usedPorts[i].store(0, std::memory_order_relaxed);
 	return;
 }
 
 TSOSCConnector* TSOSCConnector::Connector()
 {
-	if (!_instance)
-		_instance = new TSOSCConnector();
-	return _instance;
+	// Initialization of a local static is thread safe (C++11). Never deleted (the receive thread may still be running at exit).
+	static TSOSCConnector* instance = new TSOSCConnector();
+	return instance;
 }
 // Get an id for the module instance.
 int TSOSCConnector::getId()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	return ++_lastId;
+	int id = ++_lastId;
+	if (id > TSOSC_PORT_MAX_ID)
+	{
+		// Only 24 bits in the port table. Wrap around (a module this old is long gone).
+		_lastId = 0;
+		id = ++_lastId;
+	}
+	return id;
+}
+// If the port is free for this id (for sending).
+bool TSOSCConnector::portFree(int id, uint16_t port)
+{
+	uint64_t s = _ports[port].load(std::memory_order_acquire);
+	int txOwner = PORT_TX_OWNER(s);
+	int rxCount = PORT_RX_COUNT(s);
+	if (txOwner != 0 && txOwner != id)
+		return false;
+	return rxCount == 0 || (rxCount == 1 && PORT_RX_OWNER(s) == id);
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// claimTxPort()
+// @id : (IN) The module id.
+// @port : (IN) The port.
+// @alreadyOwned : (OUT) If this id already had the port for sending.
+// Nobody else may be sending or receiving on it.
+// @returns : True if the port is now ours.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCConnector::claimTxPort(int id, uint16_t port, bool& alreadyOwned)
+{
+	alreadyOwned = false;
+	uint64_t s = _ports[port].load(std::memory_order_acquire);
+	do
+	{
+		int txOwner = PORT_TX_OWNER(s);
+		int rxCount = PORT_RX_COUNT(s);
+		if ((txOwner != 0 && txOwner != id) || !(rxCount == 0 || (rxCount == 1 && PORT_RX_OWNER(s) == id)))
+			return false;
+		if (txOwner == id)
+		{
+			alreadyOwned = true;
+			return true;
+		}
+	} while (!_ports[port].compare_exchange_weak(s, PORT_STATE(id, PORT_RX_OWNER(s), PORT_RX_COUNT(s)), std::memory_order_acq_rel));
+	syncPortBit(port);
+	return true;
+} // end claimTxPort()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// claimRxPort()
+// @id : (IN) The module id.
+// @port : (IN) The port.
+// @alreadyOwned : (OUT) If this id already had the port for receiving.
+// Others may also be receiving on it, but nobody else may be sending on it.
+// Claiming it again is a no-op if we can tell this id already has it (it is the remembered
+// receiver). Shared ports only keep a count, so callers should not claim twice (see oscPortsRegistered).
+// @returns : True if the port is now (also) ours.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCConnector::claimRxPort(int id, uint16_t port, bool& alreadyOwned)
+{
+	alreadyOwned = false;
+	uint64_t s = _ports[port].load(std::memory_order_acquire);
+	uint64_t newState = 0;
+	do
+	{
+		int txOwner = PORT_TX_OWNER(s);
+		int rxCount = PORT_RX_COUNT(s);
+		if (txOwner != 0 && txOwner != id)
+			return false;
+		if (rxCount > 0 && PORT_RX_OWNER(s) == id)
+		{
+			alreadyOwned = true;
+			return true;
+		}
+		// The first receiver is remembered so it can also send on the port later.
+		int rxOwner = (rxCount == 0) ? id : PORT_RX_OWNER(s);
+		newState = PORT_STATE(txOwner, rxOwner, rxCount + 1);
+	} while (!_ports[port].compare_exchange_weak(s, newState, std::memory_order_acq_rel));
+	syncPortBit(port);
+	return true;
+} // end claimRxPort()
+// Release the send claim of this id on the port.
+bool TSOSCConnector::releaseTxPort(int id, uint16_t port)
+{
+	uint64_t s = _ports[port].load(std::memory_order_acquire);
+	do
+	{
+		if (PORT_TX_OWNER(s) != id)
+			return false;
+	} while (!_ports[port].compare_exchange_weak(s, PORT_STATE(0, PORT_RX_OWNER(s), PORT_RX_COUNT(s)), std::memory_order_acq_rel));
+	syncPortBit(port);
+	return true;
+}
+// Release the receive claim of this id on the port.
+// Shared ports only keep a count, so the caller must really have claimed it.
+bool TSOSCConnector::releaseRxPort(int id, uint16_t port)
+{
+	uint64_t s = _ports[port].load(std::memory_order_acquire);
+	uint64_t newState = 0;
+	do
+	{
+		int rxCount = PORT_RX_COUNT(s);
+		int rxOwner = PORT_RX_OWNER(s);
+		if (rxCount < 1 || (rxCount == 1 && rxOwner != id && rxOwner != TSOSC_PORT_ID_SHARED))
+			return false;
+		if (rxCount == 1)
+			rxOwner = 0;
+		else if (rxOwner == id)
+			rxOwner = TSOSC_PORT_ID_SHARED; // The others are still here, but we don't know which one is left.
+		newState = PORT_STATE(PORT_TX_OWNER(s), rxOwner, rxCount - 1);
+	} while (!_ports[port].compare_exchange_weak(s, newState, std::memory_order_acq_rel));
+	syncPortBit(port);
+	return true;
+}
+// Update the used port bitmap from the port's state.
+// Two threads may race here; whoever writes last re-checks the state so the bit settles to match it.
+void TSOSCConnector::syncPortBit(uint16_t port)
+{
+	uint64_t bit = 1ULL << (port & 63);
+	std::atomic<uint64_t>& word = _usedPorts[port >> 6];
+	bool used;
+	do
+	{
+		used = _ports[port].load(std::memory_order_acquire) != 0;
+		if (used)
+			word.fetch_or(bit, std::memory_order_acq_rel);
+		else
+			word.fetch_and(~bit, std::memory_order_acq_rel);
+	} while ((_ports[port].load(std::memory_order_acquire) != 0) != used);
+	return;
+}
+// Count trailing zeros (word must not be 0).
+static inline int ctz64(uint64_t word)
+{
+#if defined(_MSC_VER)
+	unsigned long ix;
+	_BitScanForward64(&ix, word);
+	return (int)ix;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+// Count leading zeros (word must not be 0).
+static inline int clz64(uint64_t word)
+{
+#if defined(_MSC_VER)
+	unsigned long ix;
+	_BitScanReverse64(&ix, word);
+	return 63 - (int)ix;
+#else
+	return __builtin_clzll(word);
+#endif
+}
+// Bits for the ports with the same parity as port.
+static inline uint64_t parityMask(uint32_t port)
+{
+	return (port & 1) ? 0xAAAAAAAAAAAAAAAAULL : 0x5555555555555555ULL;
+}
+// Find the next port >= start with the same parity that is not in the bitmap (0 if none).
+uint32_t TSOSCConnector::nextFreePortUp(uint32_t start)
+{
+	uint64_t mask = parityMask(start);
+	uint32_t w = start >> 6;
+	// Free bits in the first word at or above start.
+	uint64_t free = ~_usedPorts[w].load(std::memory_order_acquire) & mask & (~0ULL << (start & 63));
+	while (!free && ++w < TSOSC_PORT_BITMAP_WORDS)
+		free = ~_usedPorts[w].load(std::memory_order_acquire) & mask;
+	return (free) ? (w << 6) + ctz64(free) : 0;
+}
+// Find the next port <= start with the same parity that is not in the bitmap (0 if none).
+uint32_t TSOSCConnector::nextFreePortDown(uint32_t start)
+{
+	uint64_t mask = parityMask(start);
+	int w = start >> 6;
+	// Free bits in the first word at or below start.
+	uint64_t free = ~_usedPorts[w].load(std::memory_order_acquire) & mask & (~0ULL >> (63 - (start & 63)));
+	while (!free && --w >= 0)
+		free = ~_usedPorts[w].load(std::memory_order_acquire) & mask;
+	return (free) ? (w << 6) + 63 - clz64(free) : 0;
 }
 // Register the usage of these ports.
+// The receive port may already be used for receiving by another module (messages are routed by namespace),
+// but not for sending.
 bool TSOSCConnector::registerPorts(int id, uint16_t txPort, uint16_t rxPort)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	int tx = -1;
-	int rx = -1;
-	if (_portMap.count(txPort) < 1 || _portMap[txPort] == id)
+	bool txHad = false;
+	bool rxHad = false;
+	if (!claimTxPort(id, txPort, txHad))
+		return false;
+	if (!claimRxPort(id, rxPort, rxHad))
 	{
-		tx = txPort;
+		// Roll back.
+		if (!txHad)
+			releaseTxPort(id, txPort);
+		return false;
 	}
-	if (_portMap.count(rxPort) < 1 || _portMap[rxPort] == id)
+	return true;
+}
+// Clear the usage of these ports.
+bool TSOSCConnector::clearPorts(int id, uint16_t txPort, uint16_t rxPort)
+{
+	int nErased = 0;
+	if (releaseTxPort(id, txPort))
+		nErased++;
+	if (releaseRxPort(id, rxPort))
+		nErased++;
+	return nErased == 2;
+}
+
+// See if the port is in use (returns the id of the module using it or 0 if it is free).
+int TSOSCConnector::portInUse(uint16_t port)
+{
+	uint64_t s = _ports[port].load(std::memory_order_acquire);
+	int id = PORT_TX_OWNER(s);
+	if (id == 0 && PORT_RX_COUNT(s) > 0)
+		id = PORT_RX_OWNER(s);
+	return id;
+}
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// getAvailablePort()
+// @id : (IN) The module id.
+// @desiredPort : (IN) The port we want.
+// Returns the desired port if it is free for this id, otherwise the nearest unused
+// port (above or below) with the same parity, found by scanning the used port bitmap.
+// @returns : The port or 0 if none is available.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+uint16_t TSOSCConnector::getAvailablePort(int id, uint16_t desiredPort)
+{
+	if (portFree(id, desiredPort))
+		return desiredPort;
+	uint32_t portA = (desiredPort + 2 <= MAX_PORT) ? nextFreePortUp(desiredPort + 2) : 0;
+	uint32_t portB = (desiredPort >= MIN_PORT + 2) ? nextFreePortDown(desiredPort - 2) : 0;
+	if (portB < MIN_PORT)
+		portB = 0;
+	uint16_t port = 0;
+	if (portA && portB)
+		port = (portA - desiredPort <= desiredPort - portB) ? portA : portB;
+	else if (portA)
+		port = portA;
+	else
+		port = portB;
+	return port;
+} // end getAvailablePort()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// addListener()
+// @id : (IN) The module id.
+// @rxPort : (IN) The port to receive on.
+// @listener : (IN) The listener (its oscNamespace is used for routing).
+// Opens the port if no one else is receiving on it yet.
+// @returns : False if the port can't be opened or the namespace is already taken on the port.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCConnector::addListener(int id, uint16_t rxPort, TSOSCSequencerListener* listener)
+{
+	std::lock_guard<std::mutex> lock(_rxMutex);
+	bool added = false;
+	std::map<uint16_t, TSOSCPortRouter*>::iterator it = _routers.find(rxPort);
+	TSOSCPortRouter* router = (it != _routers.end()) ? it->second : NULL;
+	if (router != NULL)
 	{
-		rx = rxPort;
+		for (int i = 0; i < (int)router->listeners.size(); i++)
+		{
+			if (router->listeners[i].first == listener->oscNamespace)
+			{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+				debug("TSOSCConnector::addListener(%d) - Namespace %s is already listening on port %d.", id, listener->oscNamespace.c_str(), rxPort);
+#endif
+				return false;
+			}
+		}
 	}
-	if (tx > -1 && rx > -1)
+	try
 	{
-		_portMap[txPort] = id;
-		_portMap[rxPort] = id;
-		return true;
+		if (router == NULL)
+		{
+			// New port: the receive thread picks the socket up without stopping.
+			router = new TSOSCPortRouter(rxPort);
+			router->listeners.push_back(std::pair<std::string, TSOSCSequencerListener*>(listener->oscNamespace, listener));
+			_routers[rxPort] = router;
+			_mux.AttachSocketListenerLive(router->socket, router);
+			startReceiving();
+		}
+		else
+		{
+			std::lock_guard<std::mutex> listenersLock(router->listenersMutex);
+			router->listeners.push_back(std::pair<std::string, TSOSCSequencerListener*>(listener->oscNamespace, listener));
+		}
+		added = true;
 	}
-	else
+	catch (const std::exception& ex)
 	{
-		return false; // Do nothing
+		warn("TSOSCConnector::addListener(%d) - Error opening port %d: %s.", id, rxPort, ex.what());
 	}
+	return added;
+} // end addListener()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// removeListener()
+// @id : (IN) The module id.
+// @rxPort : (IN) The port it was receiving on.
+// @listener : (IN) The listener.
+// Closes the port if this was the last listener on it.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCConnector::removeListener(int id, uint16_t rxPort, TSOSCSequencerListener* listener)
+{
+	std::lock_guard<std::mutex> lock(_rxMutex);
+	std::map<uint16_t, TSOSCPortRouter*>::iterator it = _routers.find(rxPort);
+	if (it == _routers.end())
+		return false;
+	TSOSCPortRouter* router = it->second;
+	bool removed = false;
+	bool empty = false;
+	{
+		// Once we have the lock the receive thread isn't routing to the listener (and won't again).
+		std::lock_guard<std::mutex> listenersLock(router->listenersMutex);
+		for (int i = 0; i < (int)router->listeners.size(); i++)
+		{
+			if (router->listeners[i].second == listener)
+			{
+				router->listeners.erase(router->listeners.begin() + i);
+				removed = true;
+				break;
+			}
+		}
+		empty = router->listeners.empty();
+	}
+	if (empty)
+	{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+		debug("TSOSCConnector::removeListener(%d) - Closing port %d.", id, rxPort);
+#endif
+		// Returns once the receive thread has let go of the socket.
+		_mux.DetachSocketListenerLive(router->socket, router);
+		_routers.erase(it);
+		delete router;
+	}
+	return removed;
+} // end removeListener()
+
+// Start the receive thread if it isn't running yet (caller must hold _rxMutex).
+// It then stays up (sockets come and go through the live attach/detach), the connector is never deleted.
+void TSOSCConnector::startReceiving()
+{
+	if (!_rxRunning)
+	{
+		_rxThread = std::thread(&TSOSCConnector::receive, this);
+		_rxThread.detach();
+		_rxRunning = true;
+	}
+	return;
 }
-// Clear the usage of these ports.
-bool TSOSCConnector::clearPorts(int id, uint16_t txPort, uint16_t rxPort)
+// Receive thread.
+void TSOSCConnector::receive()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	std::map<uint16_t, int>::iterator it;
-	int nErased = 0;
-	it = _portMap.find(txPort);
-	if (it != _portMap.end() && _portMap[txPort] == id)
+	try
 	{
-		_portMap.erase(it);
-		nErased++;
+		_mux.Run();
 	}
-	it = _portMap.find(rxPort);
-	if (it != _portMap.end() && _portMap[rxPort] == id)
+	catch (const std::exception& ex)
 	{
-		_portMap.erase(it);
-		nErased++;
+		warn("TSOSCConnector::receive() - Receive thread stopped: %s.", ex.what());
 	}
-	return nErased == 2;
+	return;
 }
 
-// See if the port is in use (returns the id of the module using it or 0 if it is free).
-int TSOSCConnector::portInUse(uint16_t port)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCSendBatch
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCSendBatch::TSOSCSendBatch()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	std::map<uint16_t, int>::iterator it;
-	int id = 0;
-	it = _portMap.find(port);
-	if (it != _portMap.end())
+	_buffer = (char*)malloc(TSOSC_SEND_BATCH_BUFFER_SIZE * sizeof(char));
+	_used = 0;
+	_count = 0;
+	_stream = NULL;
+	_mirrorSocket = NULL;
+	_numMirrors = 0;
+	_stats = NULL;
+	return;
+}
+TSOSCSendBatch::~TSOSCSendBatch()
+{
+	setMirrors(std::vector<TSOSCEndpoint>());
+	free(_buffer);
+	_buffer = NULL;
+	return;
+}
+// Queue a copy of the packet. Sends what is queued first if there is no room.
+void TSOSCSendBatch::add(UdpSocket* socket, const char* data, std::size_t size)
+{
+	if (size < 1)
+		return;
+	if (_stats != NULL)
 	{
-		id = _portMap[port];
+		TSOSCStats::add(_stats->packetsOut, 1);
+		TSOSCStats::add(_stats->bytesOut, (uint32_t)size);
 	}
-	return id;
+	if (_stream != NULL)
+	{
+		if (!_stream->send(data, size))
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+			debug("TSOSCSendBatch - Stream backlog full, packet dropped.");
+#endif
+		}
+		if (_mirrors.empty())
+			return; // Nothing else to do (else queue for the mirrors)
+		socket = NULL;
+	}
+	else if (socket == NULL && _mirrors.empty())
+	{
+		return;
+	}
+	if (size > TSOSC_SEND_BATCH_BUFFER_SIZE)
+	{
+		// Too big to queue, keep the order and send it now.
+		flush(socket);
+		if (socket != NULL)
+			socket->Send(data, size);
+		if (_mirrorSocket != NULL)
+			_mirrorSocket->SendMultipleTo(&_mirrors[0], _mirrors.size(), &data, &size, 1);
+		return;
+	}
+	if (_count >= TSOSC_SEND_BATCH_MAX_PACKETS || _used + size > TSOSC_SEND_BATCH_BUFFER_SIZE)
+		flush(socket);
+	memcpy(_buffer + _used, data, size);
+	_data[_count] = _buffer + _used;
+	_sizes[_count] = size;
+	_used += size;
+	_count++;
+	return;
+}
+// Send everything queued.
+void TSOSCSendBatch::flush(UdpSocket* socket)
+{
+	if (_stream != NULL)
+		_stream->flush(); // (Stream already has the packets)
+	else if (_count > 0 && socket != NULL)
+		socket->SendMultiple(_data, _sizes, _count);
+	if (_count > 0 && _mirrorSocket != NULL)
+		_mirrorSocket->SendMultipleTo(&_mirrors[0], _mirrors.size(), _data, _sizes, _count);
+	clear();
+	return;
+}
+// Set the extra (UDP) targets that get a copy of every packet (empty for none).
+void TSOSCSendBatch::setMirrors(const std::vector<TSOSCEndpoint>& mirrors)
+{
+	clear();
+	_mirrors.clear();
+	_numMirrors.store(0, std::memory_order_relaxed);
+	if (_mirrorSocket != NULL)
+	{
+		delete _mirrorSocket;
+		_mirrorSocket = NULL;
+	}
+	if (mirrors.empty())
+		return;
+	try
+	{
+		for (int i = 0; i < (int)mirrors.size(); i++)
+		{
+			IpEndpointName endpoint(mirrors[i].ipAddress.c_str(), mirrors[i].port);
+			if (endpoint.address == IpEndpointName::ANY_ADDRESS || mirrors[i].port == 0)
+				continue;
+			_mirrors.push_back(endpoint);
+		}
+		if (!_mirrors.empty())
+			_mirrorSocket = new UdpSocket(); // Unconnected (multicast groups are sent with the default TTL, so local network only)
+		_numMirrors.store((int)_mirrors.size(), std::memory_order_relaxed);
+	}
+	catch (const std::exception& ex)
+	{
+		_mirrors.clear();
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+		warn("TSOSCSendBatch::setMirrors() - Error creating mirror socket: %s.", ex.what());
+#endif
+	}
+	return;
 }
 
-// Get an available port.
-uint16_t TSOSCConnector::getAvailablePort(int id, uint16_t desiredPort)
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCStreamConnectThread
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCStreamConnectThread::TSOSCStreamConnectThread()
+{
+	_thread = std::thread(&TSOSCStreamConnectThread::run, this);
+	return;
+}
+TSOSCStreamConnectThread* TSOSCStreamConnectThread::Instance()
+{
+	// Never deleted (the thread may be in a connect at exit).
+	static TSOSCStreamConnectThread* instance = new TSOSCStreamConnectThread();
+	return instance;
+}
+// Start servicing this slot.
+void TSOSCStreamConnectThread::add(const std::shared_ptr<TSOSCStreamConnectSlot>& slot)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
-	bool portFound = false;
-	uint16_t port = desiredPort;
-	uint16_t portA, portB;
-	if (_portMap.count(port) < 1 || _portMap[port] == id)
+	_slots.push_back(slot);
+	return;
+}
+// Thread loop.
+void TSOSCStreamConnectThread::run()
+{
+	// Notify from the transmitters is not under _mutex, so a wake may be missed; the timeout picks the request up.
+	std::vector<std::shared_ptr<TSOSCStreamConnectSlot>> slots;
+	while (true)
 	{
-		portFound = true;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait_for(lock, std::chrono::milliseconds(TSOSC_STREAM_CONNECT_POLL_MS));
+			// Drop slots whose transmitter is gone.
+			for (int i = (int)_slots.size() - 1; i >= 0; i--)
+			{
+				if (_slots[i]->cancelled.load(std::memory_order_acquire))
+				{
+					if (_slots[i]->state.load(std::memory_order_acquire) == TSOSCStreamConnectSlot::Done)
+					{
+#if defined(_WIN32)
+						closesocket((SOCKET)_slots[i]->socket);
+#else
+						close((int)_slots[i]->socket);
+#endif
+					}
+					_slots.erase(_slots.begin() + i);
+				}
+			}
+			slots = _slots;
+		}
+		for (int i = 0; i < (int)slots.size(); i++)
+		{
+			TSOSCStreamConnectSlot* slot = slots[i].get();
+			if (slot->state.load(std::memory_order_acquire) != TSOSCStreamConnectSlot::Requested || slot->cancelled.load(std::memory_order_acquire))
+				continue;
+			intptr_t s = connectSocket(slot);
+			if (s != TSOSC_INVALID_SOCKET)
+			{
+				slot->socket = s;
+				slot->state.store(TSOSCStreamConnectSlot::Done, std::memory_order_release);
+			}
+			else
+			{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+				debug("TSOSCStreamConnectThread - Could not connect to %s (port %d).", slot->host.c_str(), slot->port);
+#endif
+				slot->state.store(TSOSCStreamConnectSlot::Failed, std::memory_order_release);
+			}
+		}
+		slots.clear();
 	}
+	return;
+} // end run()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// connectSocket()
+// Look up the host, create the socket and connect (waits up to TSOSC_STREAM_CONNECT_TIMEOUT_MS).
+// @slot : (IN) Transport, host and port.
+// @returns : The connected, non-blocking socket or TSOSC_INVALID_SOCKET.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+intptr_t TSOSCStreamConnectThread::connectSocket(const TSOSCStreamConnectSlot* slot)
+{
+	intptr_t s = TSOSC_INVALID_SOCKET;
+	int result = -1;
+	if (slot->transport == TSOSCTransport::TcpSlipTransport)
+	{
+		unsigned long address = GetHostByName(slot->host.c_str());
+		if (address == 0)
+			return TSOSC_INVALID_SOCKET;
+		s = (intptr_t)socket(AF_INET, SOCK_STREAM, 0);
+		if (s == TSOSC_INVALID_SOCKET)
+			return TSOSC_INVALID_SOCKET;
+		int noDelay = 1;
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(address);
+		addr.sin_port = htons(slot->port);
+#if defined(_WIN32)
+		setsockopt((SOCKET)s, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+		u_long nonBlocking = 1;
+		ioctlsocket((SOCKET)s, FIONBIO, &nonBlocking);
+		result = connect((SOCKET)s, (struct sockaddr*)&addr, sizeof(addr));
+#else
+		setsockopt((int)s, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+		fcntl((int)s, F_SETFL, fcntl((int)s, F_GETFL, 0) | O_NONBLOCK);
+		result = connect((int)s, (struct sockaddr*)&addr, sizeof(addr));
+#endif
+	}
+#if !defined(_WIN32)
+	else if (slot->transport == TSOSCTransport::UnixSlipTransport)
+	{
+		s = (intptr_t)socket(AF_UNIX, SOCK_STREAM, 0);
+		if (s == TSOSC_INVALID_SOCKET)
+			return TSOSC_INVALID_SOCKET;
+		struct sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		snprintf(addr.sun_path, sizeof(addr.sun_path), TSOSC_UNIX_SOCKET_PATH_FS, slot->port);
+		fcntl((int)s, F_SETFL, fcntl((int)s, F_GETFL, 0) | O_NONBLOCK);
+		result = connect((int)s, (struct sockaddr*)&addr, sizeof(addr));
+	}
+#endif
 	else
 	{
-		portA = port;
-		portB = port;
-		while (!portFound && (portA < MAX_PORT || portB > MIN_PORT))
+		return TSOSC_INVALID_SOCKET;
+	}
+#if defined(__APPLE__)
+	int noSigPipe = 1;
+	setsockopt((int)s, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+	bool connected = result == 0;
+	if (!connected)
+	{
+		// Wait for the non-blocking connect to finish.
+#if defined(_WIN32)
+		if (WSAGetLastError() == WSAEWOULDBLOCK)
 		{
-			if (portA < MAX_PORT)
-			{
-				portA += 2;
-				portFound = _portMap.count(portA) < 1 || _portMap[portA] == id;
-				if (portFound)
-					port = portA;
-			}
-			if (!portFound && portB > MIN_PORT)
+			fd_set writeSet, errorSet;
+			FD_ZERO(&writeSet);
+			FD_ZERO(&errorSet);
+			FD_SET((SOCKET)s, &writeSet);
+			FD_SET((SOCKET)s, &errorSet);
+			struct timeval timeout = { TSOSC_STREAM_CONNECT_TIMEOUT_MS / 1000, (TSOSC_STREAM_CONNECT_TIMEOUT_MS % 1000) * 1000 };
+			connected = select(0, NULL, &writeSet, &errorSet, &timeout) > 0
+				&& !FD_ISSET((SOCKET)s, &errorSet) && FD_ISSET((SOCKET)s, &writeSet);
+		}
+#else
+		if (errno == EINPROGRESS || errno == EAGAIN)
+		{
+			struct pollfd pfd;
+			pfd.fd = (int)s;
+			pfd.events = POLLOUT;
+			pfd.revents = 0;
+			if (poll(&pfd, 1, TSOSC_STREAM_CONNECT_TIMEOUT_MS) > 0)
 			{
-				portB -= 2;
-				portFound = _portMap.count(portB) < 1 || _portMap[portB] == id;
-				if (portFound)
-					port = portB;
+				int err = 0;
+				socklen_t len = sizeof(err);
+				connected = getsockopt((int)s, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0;
 			}
-		} // end while
+		}
+#endif
+	}
+	if (!connected)
+	{
+#if defined(_WIN32)
+		closesocket((SOCKET)s);
+#else
+		close((int)s);
+#endif
+		s = TSOSC_INVALID_SOCKET;
+	}
+	return s;
+} // end connectSocket()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCStreamTransmitter
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// SLIP special bytes (RFC 1055).
+#define SLIP_END		((char)0xC0)
+#define SLIP_ESC		((char)0xDB)
+#define SLIP_ESC_END	((char)0xDC)
+#define SLIP_ESC_ESC	((char)0xDD)
+
+TSOSCStreamTransmitter::TSOSCStreamTransmitter(TSOSCTransport transport, const char* host, uint16_t port)
+{
+	_transport = transport;
+	_host = host;
+	_port = port;
+	_socket = TSOSC_INVALID_SOCKET;
+	_state = State::Disconnected;
+	_ring = (char*)malloc(TSOSC_STREAM_MAX_PENDING * sizeof(char));
+	_ringHead = 0;
+	_ringTail = 0;
+	_ringUsed = 0;
+	_nextTry = std::chrono::steady_clock::now();
+	_connect = std::make_shared<TSOSCStreamConnectSlot>();
+	_connect->transport = transport;
+	_connect->host = host;
+	_connect->port = port;
+	_connect->state.store(TSOSCStreamConnectSlot::Idle, std::memory_order_relaxed);
+	_connect->socket = TSOSC_INVALID_SOCKET;
+	_connect->cancelled.store(false, std::memory_order_relaxed);
+	TSOSCStreamConnectThread::Instance()->add(_connect);
+	requestConnect();
+	return;
+}
+TSOSCStreamTransmitter::~TSOSCStreamTransmitter()
+{
+	// The connect thread closes any socket it made for us but we didn't take.
+	_connect->cancelled.store(true, std::memory_order_release);
+	closeSocket();
+	free(_ring);
+	_ring = NULL;
+	return;
+}
+// Close the socket.
+void TSOSCStreamTransmitter::closeSocket()
+{
+	if (_socket != TSOSC_INVALID_SOCKET)
+	{
+#if defined(_WIN32)
+		closesocket((SOCKET)_socket);
+#else
+		close((int)_socket);
+#endif
+		_socket = TSOSC_INVALID_SOCKET;
+	}
+	_state = State::Disconnected;
+	return;
+}
+// Ask the connect thread for a connection.
+void TSOSCStreamTransmitter::requestConnect()
+{
+	_state = State::Connecting;
+	_connect->state.store(TSOSCStreamConnectSlot::Requested, std::memory_order_release);
+	TSOSCStreamConnectThread::Instance()->wake();
+	return;
+}
+// Frame the packet into the ring buffer. Returns false if it doesn't fit (packet dropped).
+bool TSOSCStreamTransmitter::send(const char* data, std::size_t size)
+{
+	if (size < 1)
+		return true;
+	// Double END framing: leading END flushes any line noise (or a half written frame from a dropped connection).
+	std::size_t framedSize = size + 2;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		if (data[i] == SLIP_END || data[i] == SLIP_ESC)
+			framedSize++;
+	}
+	if (framedSize > TSOSC_STREAM_MAX_PENDING - _ringUsed)
+		return false;
+	char* ring = _ring;
+	std::size_t head = _ringHead;
+	ring[head] = SLIP_END;
+	if (++head == TSOSC_STREAM_MAX_PENDING) head = 0;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		char c = data[i];
+		if (c == SLIP_END || c == SLIP_ESC)
+		{
+			ring[head] = SLIP_ESC;
+			if (++head == TSOSC_STREAM_MAX_PENDING) head = 0;
+			c = (c == SLIP_END) ? SLIP_ESC_END : SLIP_ESC_ESC;
+		}
+		ring[head] = c;
+		if (++head == TSOSC_STREAM_MAX_PENDING) head = 0;
+	}
+	ring[head] = SLIP_END;
+	if (++head == TSOSC_STREAM_MAX_PENDING) head = 0;
+	_ringHead = head;
+	_ringUsed += framedSize;
+	return true;
+} // end send()
+// Write as much pending data as the socket will take (never blocks). Asks for a connection if needed.
+void TSOSCStreamTransmitter::flush()
+{
+	if (_state == State::Connected && _ringUsed < 1)
+		return;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now < _nextTry)
+		return;
+	if (_state != State::Connected)
+	{
+		// Connecting is done by the connect thread, just see how it went.
+		switch (_connect->state.load(std::memory_order_acquire))
+		{
+		case TSOSCStreamConnectSlot::Done:
+			_socket = _connect->socket;
+			_connect->state.store(TSOSCStreamConnectSlot::Idle, std::memory_order_relaxed);
+			_state = State::Connected;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+			debug("TSOSCStreamTransmitter - Connected to %s (port %d).", _host.c_str(), _port);
+#endif
+			break;
+		case TSOSCStreamConnectSlot::Failed:
+			_connect->state.store(TSOSCStreamConnectSlot::Idle, std::memory_order_relaxed);
+			_state = State::Disconnected;
+			_nextTry = now + std::chrono::milliseconds(TSOSC_STREAM_RECONNECT_MS);
+			return;
+		case TSOSCStreamConnectSlot::Idle:
+			requestConnect();
+			return;
+		case TSOSCStreamConnectSlot::Requested:
+		default:
+			_nextTry = now + std::chrono::milliseconds(TSOSC_STREAM_RETRY_MS);
+			return;
+		}
+	}
+	// Write (at most two chunks, the ring may wrap)
+	while (_ringUsed > 0)
+	{
+		const char* data = _ring + _ringTail;
+		std::size_t size = TSOSC_STREAM_MAX_PENDING - _ringTail;
+		if (size > _ringUsed)
+			size = _ringUsed;
+#if defined(_WIN32)
+		int n = ::send((SOCKET)_socket, data, (int)size, 0);
+		bool wouldBlock = n < 0 && WSAGetLastError() == WSAEWOULDBLOCK;
+#elif defined(MSG_NOSIGNAL)
+		ssize_t n = ::send((int)_socket, data, size, MSG_NOSIGNAL);
+		bool wouldBlock = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+#else
+		ssize_t n = ::send((int)_socket, data, size, 0);
+		bool wouldBlock = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+#endif
+		if (n > 0)
+		{
+			_ringTail += n;
+			if (_ringTail == TSOSC_STREAM_MAX_PENDING)
+				_ringTail = 0;
+			_ringUsed -= n;
+		}
+		else if (wouldBlock)
+		{
+			// Reader is behind, hold on to the rest.
+			_nextTry = now + std::chrono::milliseconds(TSOSC_STREAM_RETRY_MS);
+			break;
+		}
+		else
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+			debug("TSOSCStreamTransmitter - Connection to %s (port %d) lost.", _host.c_str(), _port);
+#endif
+			closeSocket();
+			_nextTry = now + std::chrono::milliseconds(TSOSC_STREAM_RECONNECT_MS);
+			break;
+		}
+	}
+	if (_ringUsed < 1)
+	{
+		// Start over at the front (fewer wrapped writes).
+		_ringHead = 0;
+		_ringTail = 0;
+	}
+	return;
+} // end flush()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCPortRouter
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCPortRouter::TSOSCPortRouter(uint16_t port)
+{
+	this->port = port;
+	this->socket = new UdpReceiveSocket(IpEndpointName(IpEndpointName::ANY_ADDRESS, port));
+	return;
+}
+TSOSCPortRouter::~TSOSCPortRouter()
+{
+	if (socket != NULL)
+	{
+		delete socket;
+		socket = NULL;
 	}
-	return (portFound) ? port : 0;
+	return;
+}
+// Parse the packet (message or bundle) and route the messages.
+void TSOSCPortRouter::ProcessPacket(const char* data, int size, const IpEndpointName& remoteEndpoint)
+{
+	(void)remoteEndpoint; // suppress unused parameter warning
+	std::lock_guard<std::mutex> lock(listenersMutex);
+	processElement(data, size, 0, TSOSC_TIMETAG_IMMEDIATE);
+	return;
+}
+// Parse one packet element (recurses into bundles up to TSOSC_MAX_BUNDLE_DEPTH). Bad elements are dropped.
+// Messages get the time tag of the innermost bundle (a bare message is immediate).
+void TSOSCPortRouter::processElement(const char* data, int size, int depth, uint64_t timeTag)
+{
+	if (TSOSCIsBundle(data, size))
+	{
+		TSOSCBundleReader bundle;
+		if (depth >= TSOSC_MAX_BUNDLE_DEPTH || bundle.init(data, size) != TSOSC_PARSE_OK)
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+			debug("TSOSCPortRouter(%d) - Bad bundle (depth %d).", port, depth);
+#endif
+			countParseError();
+			return;
+		}
+		const char* element = NULL;
+		int elementSize = 0;
+		while (bundle.next(&element, &elementSize))
+		{
+			processElement(element, elementSize, depth + 1, bundle.timeTag);
+		}
+		if (bundle.status != TSOSC_PARSE_OK)
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+			debug("TSOSCPortRouter(%d) - Bad bundle element size.", port);
+#endif
+			countParseError();
+		}
+	}
+	else
+	{
+		TSOSCMessage rxMsg;
+		TSOSCParseStatus status = rxMsg.parse(data, size);
+		if (status == TSOSC_PARSE_OK)
+		{
+			routeMessage(rxMsg, timeTag);
+		}
+		else
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+			debug("TSOSCPortRouter(%d) - Bad message (status %d).", port, status);
+#endif
+			countParseError();
+		}
+	}
+	return;
+}
+// Count a bad element against every listener on the port (we can't tell whose it was).
+void TSOSCPortRouter::countParseError()
+{
+	for (int i = 0; i < (int)listeners.size(); i++)
+		listeners[i].second->countParseError();
+	return;
+}
+// Route the message to the listener for its namespace (address starts with /<namespace>/).
+void TSOSCPortRouter::routeMessage(const TSOSCMessage& rxMsg, uint64_t timeTag)
+{
+	const char* addr = rxMsg.address;
+	for (int i = 0; i < (int)listeners.size(); i++)
+	{
+		const std::string& ns = listeners[i].first;
+		int len = ns.length();
+		if (len <= rxMsg.addressLength && std::strncmp(addr, ns.c_str(), len) == 0 && (addr[len] == '/' || addr[len] == '\0'))
+		{
+			listeners[i].second->processMessage(rxMsg, addr + len, timeTag);
+			return;
+		}
+	}
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+	debug("TSOSCPortRouter(%d) - No listener for %s.", port, addr);
+#endif
+	return;
 }
@@ -3,16 +3,56 @@
 
 #include <thread> // std::thread
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
 #include <string.h>
 //#include <stdio.h>
 #include <map>
+#include <vector>
+#include <chrono>
 
 #include "../lib/oscpack/osc/OscOutboundPacketStream.h"
 #include "../lib/oscpack/ip/UdpSocket.h"
 #include "../lib/oscpack/osc/OscReceivedElements.h"
 #include "../lib/oscpack/osc/OscPacketListener.h"
+#include "../lib/oscpack/ip/PacketListener.h"
+#include "../lib/oscpack/ip/NetworkingUtils.h"
 
 #include "TSOSCSequencerListener.hpp"
+#include "TSOSCCommon.hpp"
+
+// Max number of packets queued in a TSOSCSendBatch before it sends on its own.
+#define TSOSC_SEND_BATCH_MAX_PACKETS	32
+// Buffer size for the packets queued in a TSOSCSendBatch.
+#define TSOSC_SEND_BATCH_BUFFER_SIZE	(32*1024)
+// Size of the TSOSCStreamTransmitter SLIP ring buffer (bytes held while the reader is slow or not there yet). Past this, packets are dropped.
+#define TSOSC_STREAM_MAX_PENDING		(1024*1024)
+// Min time between connect attempts for a TSOSCStreamTransmitter.
+#define TSOSC_STREAM_RECONNECT_MS		1000
+// Max time the stream connect thread waits for one connect to finish.
+#define TSOSC_STREAM_CONNECT_TIMEOUT_MS	3000
+// How often the stream connect thread looks for requests if it isn't woken.
+#define TSOSC_STREAM_CONNECT_POLL_MS	100
+// Number of entries in the TSOSCConnector port table (one per UDP port).
+#define TSOSC_NUM_PORTS				0x10000
+// Number of 64-bit words in the TSOSCConnector used port bitmap.
+#define TSOSC_PORT_BITMAP_WORDS		(TSOSC_NUM_PORTS / 64)
+// Largest module id the port table can hold (ids are stored in 24 bits).
+#define TSOSC_PORT_MAX_ID			0xFFFFFE
+// Receive owner id stored when the remaining receivers of a shared port are not known exactly (someone else's).
+#define TSOSC_PORT_ID_SHARED		0xFFFFFF
+// Min time between write attempts when the stream socket is full (or still connecting).
+#define TSOSC_STREAM_RETRY_MS			5
+
+// An extra OSC output target (mirror). May be an IPv4 multicast group.
+struct TSOSCEndpoint {
+	// IP address (or multicast group).
+	std::string ipAddress;
+	// Port number.
+	uint16_t port;
+};
 
 // OSC connection information
 typedef struct TSOSCInfo {	
@@ -22,11 +62,207 @@ typedef struct TSOSCInfo {
 	uint16_t oscTxPort;
 	// OSC input port number.
 	uint16_t oscRxPort;
+	// OSC output transport.
+	TSOSCTransport oscTransport;
+	// Extra output targets (UDP) that get a copy of every packet.
+	// No UI for these, they are set by editing "osc" : { "Mirrors" : [...] } in the patch file.
+	std::vector<TSOSCEndpoint> oscMirrors;
 } TSOSCConnectionInfo;
 
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCStreamConnectSlot
+// Connect request/result shared by a TSOSCStreamTransmitter and the stream connect
+// thread. The transmitter only flips the state; the connect thread does the name
+// lookup, socket() and connect() and hands back the connected socket.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSOSCStreamConnectSlot
+{
+	enum State {
+		Idle,		// Nothing asked for.
+		Requested,	// The transmitter wants a connection.
+		Done,		// socket is connected (and non-blocking), the transmitter takes it.
+		Failed		// Could not connect (the transmitter asks again later).
+	};
+	TSOSCTransport transport;
+	std::string host;
+	uint16_t port;
+	// State (State).
+	std::atomic<int> state;
+	// The connected socket (only valid when state is Done).
+	intptr_t socket;
+	// Set when the transmitter is gone. The connect thread then drops the slot (closing any socket it made).
+	std::atomic<bool> cancelled;
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCStreamConnectThread
+// The one thread that connects stream sockets for all TSOSCStreamTransmitters, so the
+// (blocking) name lookup and connect never run on the engine thread.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+class TSOSCStreamConnectThread
+{
+public:
+	static TSOSCStreamConnectThread* Instance();
+	// Start servicing this slot.
+	void add(const std::shared_ptr<TSOSCStreamConnectSlot>& slot);
+	// Wake the thread to look at the slots now (doesn't lock).
+	void wake() { _wake.notify_one(); }
+private:
+	TSOSCStreamConnectThread();
+	// Thread loop.
+	void run();
+	// Look up, create and connect a socket for the slot (blocks up to TSOSC_STREAM_CONNECT_TIMEOUT_MS).
+	static intptr_t connectSocket(const TSOSCStreamConnectSlot* slot);
+	// Slots being serviced.
+	std::vector<std::shared_ptr<TSOSCStreamConnectSlot>> _slots;
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	std::thread _thread;
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCStreamTransmitter
+// Sends OSC packets SLIP framed (OSC 1.1) over TCP or a local (AF_UNIX) stream socket.
+// Never blocks: packets are framed into a fixed ring buffer and written as the socket
+// takes them, so a slow reader holds data back instead of it being silently dropped
+// (up to TSOSC_STREAM_MAX_PENDING, then packets are dropped). Connecting (and
+// reconnecting) is done by the TSOSCStreamConnectThread.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+class TSOSCStreamTransmitter
+{
+public:
+	// @transport : (IN) TcpSlipTransport or UnixSlipTransport.
+	// @host : (IN) Host for TCP.
+	// @port : (IN) Port for TCP (or the # in the local socket path).
+	TSOSCStreamTransmitter(TSOSCTransport transport, const char* host, uint16_t port);
+	~TSOSCStreamTransmitter();
+	// Frame the packet into the ring buffer. Returns false if it doesn't fit (packet dropped).
+	bool send(const char* data, std::size_t size);
+	// Write as much pending data as the socket will take (never blocks). Asks for a connection if needed.
+	void flush();
+	// If the socket is connected.
+	bool isConnected() const { return _state == Connected; }
+	// Bytes waiting to go out.
+	std::size_t pending() const { return _ringUsed; }
+private:
+	enum State {
+		Disconnected,
+		Connecting,
+		Connected
+	};
+	// Make sure sockets are available (Windows).
+	NetworkInitializer _networkInitializer;
+	TSOSCTransport _transport;
+	std::string _host;
+	uint16_t _port;
+	// The socket (-1 if none).
+	intptr_t _socket;
+	State _state;
+	// Connect request/result shared with the connect thread.
+	std::shared_ptr<TSOSCStreamConnectSlot> _connect;
+	// Framed data not written yet (TSOSC_STREAM_MAX_PENDING bytes, allocated once).
+	char* _ring;
+	// Where the next byte is framed into.
+	std::size_t _ringHead;
+	// Next byte to write to the socket.
+	std::size_t _ringTail;
+	// Bytes in the ring.
+	std::size_t _ringUsed;
+	// Don't try to connect/write again until this time.
+	std::chrono::steady_clock::time_point _nextTry;
+	// Ask the connect thread for a connection.
+	void requestConnect();
+	// Close the socket.
+	void closeSocket();
+};
+
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCSendBatch
+// Outgoing packets (bundles) queued up during a step and sent together with
+// UdpSocket::SendMultiple() (one sendmmsg() on Linux).
+// Packets are serialized once; mirrors get the same bytes (SendMultipleTo()).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+class TSOSCSendBatch
+{
+public:
+	TSOSCSendBatch();
+	~TSOSCSendBatch();
+	// Queue a copy of the packet. Sends what is queued first if there is no room.
+	void add(UdpSocket* socket, const char* data, std::size_t size);
+	// Send everything queued.
+	void flush(UdpSocket* socket);
+	// Drop everything queued (i.e. socket is going away).
+	void clear() { _count = 0; _used = 0; }
+	// Number of packets queued.
+	int count() const { return _count; }
+	// Send through a stream transport instead (NULL for UDP). Packets are then handed straight to the stream.
+	void setStream(TSOSCStreamTransmitter* stream) { clear(); _stream = stream; }
+	// If we are sending over a stream (no datagram size limits).
+	bool isStream() const { return _stream != NULL; }
+	// Set the extra (UDP) targets that get a copy of every packet (empty for none).
+	void setMirrors(const std::vector<TSOSCEndpoint>& mirrors);
+	// Number of mirror targets (safe to read from any thread).
+	int numMirrors() const { return _numMirrors.load(std::memory_order_relaxed); }
+	// Count what we send in these stats (NULL for none).
+	void setStats(TSOSCStats* stats) { _stats = stats; }
+private:
+	// Where to count what we send.
+	TSOSCStats* _stats;
+	// Unconnected socket for sending to the mirrors.
+	UdpSocket* _mirrorSocket;
+	// Mirror targets.
+	std::vector<IpEndpointName> _mirrors;
+	// Number of mirror targets, published for the UI (_mirrors is only touched by the thread that sends).
+	std::atomic<int> _numMirrors;
+	// Stream transport (if not UDP).
+	TSOSCStreamTransmitter* _stream;
+	// Packet data.
+	char* _buffer;
+	// Bytes of _buffer in use.
+	std::size_t _used;
+	// Start of each packet.
+	const char* _data[TSOSC_SEND_BATCH_MAX_PACKETS];
+	// Size of each packet.
+	std::size_t _sizes[TSOSC_SEND_BATCH_MAX_PACKETS];
+	// Number of packets queued.
+	int _count;
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCPortRouter
+// Owns the receive socket for one port and hands each message to the listener
+// whose namespace matches the message address (so modules can share a port).
+// Packets are parsed with TSOSCMessage/TSOSCBundleReader (no exceptions), bad ones are dropped.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+class TSOSCPortRouter : public PacketListener
+{
+public:
+	// The receive port.
+	uint16_t port;
+	// The receive socket (bound to any address on port).
+	UdpReceiveSocket* socket;
+	// Listeners on this port by namespace.
+	std::vector<std::pair<std::string, TSOSCSequencerListener*>> listeners;
+	// Guards listeners (held by the receive thread while it routes a packet).
+	std::mutex listenersMutex;
 
-// OSC Connection / track ports used to try to auto-increment and probably eventually allow multiple guys to talk on the same
-// ports just with namespace or id routing.
+	// Opens the socket (throws std::runtime_error if it can't be bound).
+	TSOSCPortRouter(uint16_t port);
+	~TSOSCPortRouter();
+	// Parse the packet (message or bundle) and route the messages.
+	virtual void ProcessPacket(const char* data, int size, const IpEndpointName& remoteEndpoint) override;
+protected:
+	// Parse one packet element (recurses into bundles up to TSOSC_MAX_BUNDLE_DEPTH).
+	void processElement(const char* data, int size, int depth, uint64_t timeTag);
+	// Route the message (with the time tag of its enclosing bundle) to the listener for its namespace.
+	void routeMessage(const TSOSCMessage& rxMsg, uint64_t timeTag);
+	// Count a bad element against every listener on the port.
+	void countParseError();
+};
+
+// OSC Connection / track ports used to try to auto-increment. Receive ports may be shared by several modules (with
+// different namespaces), all receive sockets are serviced by one thread.
 class TSOSCConnector
 {
 public:
@@ -41,6 +277,10 @@ public:
 	uint16_t getAvailablePort(int id, uint16_t desiredPort);
 	// See if the port is in use (returns the id of the module using it or 0 if it is free).
 	int portInUse(uint16_t port);
+	// Start receiving on the port for this listener (by its namespace).
+	bool addListener(int id, uint16_t rxPort, TSOSCSequencerListener* listener);
+	// Stop receiving for this listener. Once this returns the receive thread no longer references the listener.
+	bool removeListener(int id, uint16_t rxPort, TSOSCSequencerListener* listener);
 
 	// Get an id for the module instance.
 	static int GetId() { return Connector()->getId(); }
@@ -52,19 +292,54 @@ public:
 	static bool ClearPorts(int id, uint16_t txPort, uint16_t rxPort) { return Connector()->clearPorts(id, txPort, rxPort);}
 	// See if the port is in use (returns the id of the module using it or 0 if it is free).
 	static int PortInUse(uint16_t port) { return Connector()->portInUse(port); }
+	// Start receiving on the port for this listener (by its namespace).
+	static bool AddListener(int id, uint16_t rxPort, TSOSCSequencerListener* listener) { return Connector()->addListener(id, rxPort, listener); }
+	// Stop receiving for this listener.
+	static bool RemoveListener(int id, uint16_t rxPort, TSOSCSequencerListener* listener) { return Connector()->removeListener(id, rxPort, listener); }
 private:
 	TSOSCConnector();
+	// If the port is free for this id (for sending).
+	bool portFree(int id, uint16_t port);
+	// Claim the port for sending by this id (compare-and-swap). Sets alreadyOwned if this id already had it.
+	bool claimTxPort(int id, uint16_t port, bool& alreadyOwned);
+	// Claim the port for receiving by this id (compare-and-swap). Sets alreadyOwned if this id already had it.
+	bool claimRxPort(int id, uint16_t port, bool& alreadyOwned);
+	// Release the send claim of this id on the port.
+	bool releaseTxPort(int id, uint16_t port);
+	// Release the receive claim of this id on the port.
+	bool releaseRxPort(int id, uint16_t port);
+	// Update the used port bitmap from the port's state.
+	void syncPortBit(uint16_t port);
+	// Find the next port >= start with the same parity that is not in the bitmap (0 if none).
+	uint32_t nextFreePortUp(uint32_t start);
+	// Find the next port <= start with the same parity that is not in the bitmap (0 if none).
+	uint32_t nextFreePortDown(uint32_t start);
+	// Start the receive thread if it isn't running yet (caller must hold _rxMutex).
+	void startReceiving();
+	// Receive thread.
+	void receive();
 	//TSOSCConnector(TSOSCConnector const&) {};             // copy constructor is private
 	//TSOSCConnector& operator=(TSOSCConnector const&) { return this; };  // assignment operator is private
 
-	static TSOSCConnector* _instance;
 	// The last id we gave out.
-	int _lastId;
-	// The ports that are in use by which id.
-	std::map<uint16_t, int> _portMap;
+	std::atomic<int> _lastId;
+	// Port state, one word per port: [0-23] transmit owner id, [24-47] receive owner id, [48-63] number of receivers.
+	// Receive ports may be shared by modules (messages are routed by namespace), transmit ports may not.
+	std::atomic<uint64_t> _ports[TSOSC_NUM_PORTS];
+	// Bit per port, set if the port has any owner. Only a hint for getAvailablePort(), claims always go through _ports.
+	std::atomic<uint64_t> _usedPorts[TSOSC_PORT_BITMAP_WORDS];
 
-	// Port mutex.
-	std::mutex _mutex;
+	// Receive sockets //////////////////
+	// Multiplexer for all receive sockets (epoll on Linux). Sockets are attached/detached while it runs.
+	SocketReceiveMultiplexer _mux;
+	// Receive socket/router per port.
+	std::map<uint16_t, TSOSCPortRouter*> _routers;
+	// The one receive thread (started with the first socket, then kept running).
+	std::thread _rxThread;
+	// If the receive thread was started.
+	bool _rxRunning;
+	// Mutex for adding/removing receivers.
+	std::mutex _rxMutex;
 };
 
 #endif // !TSOSCCOMMUNICATOR_HPP
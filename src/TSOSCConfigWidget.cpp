@@ -50,7 +50,7 @@ TSOSCConfigWidget::TSOSCConfigWidget(Module* mod, int btnSaveId, int btnDisableI
 TSOSCConfigWidget::TSOSCConfigWidget(Module* mod, int btnSaveId, int btnDisableId, OSCClient selectedClient, std::string ipAddress, uint16_t txPort, uint16_t rxPort)
 {
 	this->module = mod;
-	font = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+	font = TSAssets::font(TS_FONT_LABEL);
 	
 
 	statusMsg2 = "";
@@ -124,20 +124,7 @@ struct TSOSCConfigWidget : OpaqueWidget
 	}
 
 	bool isValidPort(std::string port) {
-		bool isValid = false;
-		try
-		{
-			if (port.length() > 0)
-			{
-				int portNumber = std::atoi(port.c_str());
-				isValid = portNumber > -1 && portNumber <= 0xFFFF;
-			}
-		}
-		catch (const std::exception& ex)
-		{
-			isValid = false;
-		} 
-		return isValid;
+		return TSTextField::isValidPort(port);
 	}
 	// If the Tx port is valid.
 	bool isValidTxPort()
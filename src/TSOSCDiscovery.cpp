@@ -0,0 +1,243 @@
+#include "TSOSCDiscovery.hpp"
+
+#include <string.h>
+#include "../lib/oscpack/osc/OscOutboundPacketStream.h"
+#include "../lib/oscpack/ip/UdpSocket.h"
+#include "../lib/oscpack/ip/IpEndpointName.h"
+#include "util.hpp"
+#include "trowaSoftUtilities.hpp" // For debug
+
+using namespace rack;
+
+std::atomic<TSOSCDiscovery*> TSOSCDiscovery::_provider(NULL);
+std::vector<std::unique_ptr<TSOSCDiscovery>> TSOSCDiscovery::_retired;
+std::mutex TSOSCDiscovery::_setMutex;
+
+// Get the current provider (TSOSCLoopbackDiscovery unless another was set).
+TSOSCDiscovery* TSOSCDiscovery::Get()
+{
+	TSOSCDiscovery* provider = _provider.load(std::memory_order_acquire);
+	if (provider == NULL)
+	{
+		// First use, install the default. If someone beat us to it, use theirs.
+		TSOSCDiscovery* loopback = new TSOSCLoopbackDiscovery();
+		if (_provider.compare_exchange_strong(provider, loopback, std::memory_order_acq_rel))
+			provider = loopback;
+		else
+			delete loopback; // Never published
+	}
+	return provider;
+}
+// Set the provider (takes ownership, NULL to go back to the default).
+// The old provider is retired (it lives until exit) since Get() callers may still be using it.
+void TSOSCDiscovery::Set(TSOSCDiscovery* provider)
+{
+	std::lock_guard<std::mutex> lock(_setMutex);
+	TSOSCDiscovery* old = _provider.exchange(provider, std::memory_order_acq_rel);
+	if (old != NULL && old != provider)
+		_retired.push_back(std::unique_ptr<TSOSCDiscovery>(old));
+	return;
+}
+// Get the DNS-SD service type for the transport.
+const char* TSOSCDiscovery::ServiceType(TSOSCTransport transport)
+{
+	return (transport == TSOSCTransport::UdpTransport) ? "_osc._udp" : "_osc._tcp";
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// LocalHostFor()
+// @remoteHost : (IN) The host we send to (our controller).
+// Asks the OS which local interface would be used to reach remoteHost (no packets are sent).
+// @returns : Our address on that interface (127.0.0.1 if it can't be found).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+std::string TSOSCDiscovery::LocalHostFor(const std::string& remoteHost)
+{
+	std::string host = "127.0.0.1";
+	try
+	{
+		UdpSocket socket;
+		socket.Bind(IpEndpointName(IpEndpointName::ANY_ADDRESS, IpEndpointName::ANY_PORT));
+		IpEndpointName local = socket.LocalEndpointFor(IpEndpointName(remoteHost.c_str(), TSOSC_DISCOVERY_PORT));
+		if (local.address != 0 && local.address != IpEndpointName::ANY_ADDRESS)
+		{
+			char buffer[IpEndpointName::ADDRESS_STRING_LENGTH];
+			local.AddressAsString(buffer);
+			host = buffer;
+		}
+	}
+	catch (const std::exception& ex)
+	{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("TSOSCDiscovery::LocalHostFor(%s) - %s.", remoteHost.c_str(), ex.what());
+#endif
+	}
+	return host;
+} // end LocalHostFor()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// PortTaken()
+// @services : (IN) The services from browse().
+// @moduleId : (IN) Our module (our own service never collides).
+// @port : (IN) The port to check.
+// @forReceive : (IN) If we want to receive on it (receive ports may be shared, send ports may not).
+// Same rules as TSOSCConnector::RegisterPorts().
+// @returns : True if another service uses the port in a way that conflicts.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCDiscovery::PortTaken(const std::vector<TSOSCServiceInfo>& services, int moduleId, uint16_t port, bool forReceive)
+{
+	for (int i = 0; i < (int)services.size(); i++)
+	{
+		if (services[i].moduleId == moduleId)
+			continue;
+		if (services[i].txPort == port || (!forReceive && services[i].rxPort == port))
+			return true;
+	}
+	return false;
+} // end PortTaken()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// FreePort()
+// @services : (IN) The services from browse().
+// @moduleId : (IN) Our module.
+// @desiredPort : (IN) The port we want.
+// @forReceive : (IN) If we want to receive on it.
+// @returns : desiredPort if free, else the nearest free port with the same parity (above wins ties), 0 if none.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+uint16_t TSOSCDiscovery::FreePort(const std::vector<TSOSCServiceInfo>& services, int moduleId, uint16_t desiredPort, bool forReceive)
+{
+	if (!PortTaken(services, moduleId, desiredPort, forReceive))
+		return desiredPort;
+	// Only as many ports as there are services can be taken, so this ends quickly.
+	for (uint32_t d = 2; d <= 0xFFFF; d += 2)
+	{
+		uint32_t up = desiredPort + d;
+		if (up <= 0xFFFF && !PortTaken(services, moduleId, (uint16_t)up, forReceive))
+			return (uint16_t)up;
+		if (desiredPort >= TSOSC_DISCOVERY_MIN_PORT + d && !PortTaken(services, moduleId, (uint16_t)(desiredPort - d), forReceive))
+			return (uint16_t)(desiredPort - d);
+	}
+	return 0;
+} // end FreePort()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSOSCLoopbackDiscovery()
+// @announcePort : (IN) The loopback port to announce to.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+TSOSCLoopbackDiscovery::TSOSCLoopbackDiscovery(uint16_t announcePort)
+{
+	_announcePort = announcePort;
+	_socket = NULL;
+	_lastAnnounce = std::chrono::steady_clock::now();
+	return;
+}
+TSOSCLoopbackDiscovery::~TSOSCLoopbackDiscovery()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (int i = 0; i < (int)_services.size(); i++)
+		announce(_services[i], true);
+	_services.clear();
+	if (_socket != NULL)
+	{
+		delete _socket;
+		_socket = NULL;
+	}
+	return;
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// advertise()
+// @info : (IN) The service. Replaces any service for the same module.
+// @returns : True.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSOSCLoopbackDiscovery::advertise(const TSOSCServiceInfo& info)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	bool found = false;
+	for (int i = 0; i < (int)_services.size() && !found; i++)
+	{
+		if (_services[i].moduleId == info.moduleId)
+		{
+			_services[i] = info;
+			found = true;
+		}
+	}
+	if (!found)
+		_services.push_back(info);
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+	debug("TSOSCLoopbackDiscovery::advertise(%d) - %s %s %s:%d (rx %d).", info.moduleId, info.name.c_str(), info.serviceType.c_str(), info.host.c_str(), info.txPort, info.rxPort);
+#endif
+	announce(info, false);
+	return true;
+} // end advertise()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// withdraw()
+// @moduleId : (IN) The module.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSOSCLoopbackDiscovery::withdraw(int moduleId)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (int i = 0; i < (int)_services.size(); i++)
+	{
+		if (_services[i].moduleId == moduleId)
+		{
+			announce(_services[i], true);
+			_services.erase(_services.begin() + i);
+			break;
+		}
+	}
+	return;
+} // end withdraw()
+// Get the services currently known.
+std::vector<TSOSCServiceInfo> TSOSCLoopbackDiscovery::browse()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _services;
+}
+// Re-announce everything every TSOSC_DISCOVERY_ANNOUNCE_S.
+void TSOSCLoopbackDiscovery::poll()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now - _lastAnnounce < std::chrono::seconds(TSOSC_DISCOVERY_ANNOUNCE_S))
+		return;
+	std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+		return; // Someone is advertising, try next time.
+	_lastAnnounce = now;
+	for (int i = 0; i < (int)_services.size(); i++)
+		announce(_services[i], false);
+	return;
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// announce()
+// @info : (IN) The service.
+// @removed : (IN) If the service went away.
+// Sends the announcement to 127.0.0.1:_announcePort (caller must hold _mutex).
+// Nobody listening is fine.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSOSCLoopbackDiscovery::announce(const TSOSCServiceInfo& info, bool removed)
+{
+	char buffer[TSOSC_DISCOVERY_BUFFER_SIZE];
+	try
+	{
+		if (_socket == NULL)
+			_socket = new UdpTransmitSocket(IpEndpointName("127.0.0.1", _announcePort));
+		osc::OutboundPacketStream oscStream(buffer, TSOSC_DISCOVERY_BUFFER_SIZE);
+		if (removed)
+		{
+			oscStream << osc::BeginMessage(TSOSC_DISCOVERY_REMOVE_ADDR)
+				<< info.name.c_str() << info.moduleId
+				<< osc::EndMessage;
+		}
+		else
+		{
+			oscStream << osc::BeginMessage(TSOSC_DISCOVERY_ADD_ADDR)
+				<< info.name.c_str() << info.serviceType.c_str() << info.host.c_str()
+				<< (int)info.txPort << (int)info.rxPort << info.moduleId << (int)info.transport
+				<< osc::EndMessage;
+		}
+		_socket->Send(oscStream.Data(), oscStream.Size());
+	}
+	catch (const std::exception& ex)
+	{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("TSOSCLoopbackDiscovery::announce(%d) - %s.", info.moduleId, ex.what());
+#endif
+	}
+	return;
+} // end announce()
@@ -0,0 +1,117 @@
+#ifndef TSOSCDISCOVERY_HPP
+#define TSOSCDISCOVERY_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <stdint.h>
+#include "TSOSCCommon.hpp"
+
+class UdpTransmitSocket;
+
+// Loopback port the TSOSCLoopbackDiscovery announcements go to (controllers on this machine listen here).
+#define TSOSC_DISCOVERY_PORT			7099
+// Seconds between re-announcing all services (so late starting controllers still find us).
+#define TSOSC_DISCOVERY_ANNOUNCE_S		5
+// Announcement address for a service that was added or is still there: ,sssiiii name type host txPort rxPort id transport
+#define TSOSC_DISCOVERY_ADD_ADDR		"/trowaSoft/discovery/add"
+// Announcement address for a service that went away: ,si name id
+#define TSOSC_DISCOVERY_REMOVE_ADDR		"/trowaSoft/discovery/remove"
+// Buffer size for an announcement packet.
+#define TSOSC_DISCOVERY_BUFFER_SIZE		512
+// Lowest port FreePort() will hand out.
+#define TSOSC_DISCOVERY_MIN_PORT		1000
+
+//=== TSOSCServiceInfo ========================================
+// What a module advertises about its OSC endpoint.
+//=============================================================
+struct TSOSCServiceInfo
+{
+	// The module id (from TSOSCConnector).
+	int moduleId = 0;
+	// Service name (the module's OSC namespace).
+	std::string name;
+	// DNS-SD style service type (_osc._udp or _osc._tcp).
+	std::string serviceType;
+	// Our address (where controllers reach us, see LocalHostFor()).
+	std::string host;
+	// The port we send to.
+	uint16_t txPort = 0;
+	// The port we receive on (controllers send here).
+	uint16_t rxPort = 0;
+	// How we send.
+	TSOSCTransport transport = TSOSCTransport::UdpTransport;
+};
+
+//=== TSOSCDiscovery ==========================================
+// Pluggable discovery interface. Modules advertise their namespace and ports,
+// controllers (or the UI) browse them. The current provider is process wide.
+// Get() is one atomic load (called every UI step). Providers replaced by Set()
+// are retired, not deleted, so a pointer from Get() stays valid.
+//=============================================================
+class TSOSCDiscovery
+{
+public:
+	virtual ~TSOSCDiscovery() {}
+	// Advertise (or update) the service for info.moduleId.
+	virtual bool advertise(const TSOSCServiceInfo& info) = 0;
+	// Stop advertising the service for this module.
+	virtual void withdraw(int moduleId) = 0;
+	// Get the services currently known.
+	virtual std::vector<TSOSCServiceInfo> browse() = 0;
+	// Periodic work (re-announcing). Called from the UI thread, should be cheap.
+	virtual void poll() {}
+
+	// Get the current provider (TSOSCLoopbackDiscovery unless another was set).
+	static TSOSCDiscovery* Get();
+	// Set the provider (takes ownership, NULL to go back to the default). Advertise again after switching.
+	static void Set(TSOSCDiscovery* provider);
+	// Get the DNS-SD service type for the transport.
+	static const char* ServiceType(TSOSCTransport transport);
+	// Get our address as seen from remoteHost (the local interface we'd send from).
+	static std::string LocalHostFor(const std::string& remoteHost);
+	// See if another module's advertised service collides with the port.
+	static bool PortTaken(const std::vector<TSOSCServiceInfo>& services, int moduleId, uint16_t port, bool forReceive);
+	// Get the nearest port (same parity) that doesn't collide with the advertised services (0 if none).
+	static uint16_t FreePort(const std::vector<TSOSCServiceInfo>& services, int moduleId, uint16_t desiredPort, bool forReceive);
+private:
+	// The current provider.
+	static std::atomic<TSOSCDiscovery*> _provider;
+	// Providers that were replaced (kept alive since Get() callers may still hold them).
+	static std::vector<std::unique_ptr<TSOSCDiscovery>> _retired;
+	// Serializes Set().
+	static std::mutex _setMutex;
+};
+
+//=== TSOSCLoopbackDiscovery ==================================
+// Local stand-in for Zeroconf/DNS-SD. Keeps the services in process and announces
+// adds/removes as OSC messages to 127.0.0.1:TSOSC_DISCOVERY_PORT (re-announced
+// every TSOSC_DISCOVERY_ANNOUNCE_S). No receive thread, no network traffic off the machine.
+//=============================================================
+class TSOSCLoopbackDiscovery : public TSOSCDiscovery
+{
+public:
+	TSOSCLoopbackDiscovery(uint16_t announcePort = TSOSC_DISCOVERY_PORT);
+	~TSOSCLoopbackDiscovery();
+	bool advertise(const TSOSCServiceInfo& info) override;
+	void withdraw(int moduleId) override;
+	std::vector<TSOSCServiceInfo> browse() override;
+	void poll() override;
+private:
+	// Send an add (or remove) announcement for the service.
+	void announce(const TSOSCServiceInfo& info, bool removed);
+	// Services by module.
+	std::vector<TSOSCServiceInfo> _services;
+	std::mutex _mutex;
+	// Where announcements go.
+	uint16_t _announcePort;
+	// Announcement socket (created on first use).
+	UdpTransmitSocket* _socket;
+	// When we last announced everything.
+	std::chrono::steady_clock::time_point _lastAnnounce;
+};
+
+#endif // !TSOSCDISCOVERY_HPP
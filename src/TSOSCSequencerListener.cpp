@@ -1,7 +1,5 @@
 ﻿#include <string.h>
-#include <vector>
 #include <stdio.h>
-#include <exception>
 #include "util.hpp"
 #include "TSOSCSequencerListener.hpp"
 #include "TSSequencerModuleBase.hpp"
@@ -54,540 +52,491 @@ TSOSCSequencerListener::TSOSCSequencerListener()
 	return;
 }
 //--------------------------------------------------------------------------------------------------------------------------------------------
-// ProcessMessage()
-// @rxMsg : (IN) The received message from the OSC library.
-// @remoteEndPoint: (IN) The remove end point (sender).
-// Handler for receiving messages from the OSC library. Taken from their example listener.
-// Should create a generic TSExternalControlMessage for our trowaSoft sequencers and dump it in the module instance's queue.
+// queueMessage()
+// Stamp the message with the time tag and put it in the module's queue (the module schedules it).
 //--------------------------------------------------------------------------------------------------------------------------------------------
-void TSOSCSequencerListener::ProcessMessage(const osc::ReceivedMessage& rxMsg, const IpEndpointName& remoteEndpoint) 
+void TSOSCSequencerListener::queueMessage(uint64_t timeTag, TSExternalControlMessage msg)
 {
-	(void)remoteEndpoint; // suppress unused parameter warning
+	msg.timeTag = timeTag;
+	msg.rxTimeUs = TSOSCStatsNowUs();
+	TSOSCStats& stats = sequencerModule->oscStats;
+	stats.addMessageType(msg.messageType);
+	if (!sequencerModule->ctlMsgQueue.push(msg))
+	{
+		TSOSCStats::add(stats.drops, 1);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-	debug("[RECV] OSC Message: %s", rxMsg.AddressPattern());
+		debug("Control message queue is full. Message %d dropped.", msg.messageType);
 #endif
-	osc::int32 step = -1;
-	float stepVal = 0.0;
-	osc::int32 pattern = CURRENT_EDIT_PATTERN_IX;
-	osc::int32 channel = CURRENT_EDIT_CHANNEL_IX;
-	osc::int32 intVal = -1;
-	try {
-		const char* ns = this->oscNamespace.c_str();
-		std::string addr = rxMsg.AddressPattern();
-		int len = strlen(ns);
-		if (std::strcmp(addr.substr(0, len).c_str(), ns) != 0) // Message is not for us
-		{
+	}
+	else
+	{
+		TSOSCStats::setMax(stats.queueHighWater, (uint32_t)sequencerModule->ctlMsgQueue.size());
+	}
+	return;
+}
+// Count a bad packet/message on our receive port.
+void TSOSCSequencerListener::countParseError()
+{
+	TSOSCStats::add(sequencerModule->oscStats.parseErrors, 1);
+	return;
+}
+//--------------------------------------------------------------------------------------------------------------------------------------------
+// processMessage()
+// @rxMsg : (IN) The received (already validated) message.
+// @path : (IN) The address after our namespace (i.e. /edit/step).
+// @timeTag : (IN) Time tag of the enclosing bundle (when the module should apply the message).
+// Should create a generic TSExternalControlMessage for our trowaSoft sequencers and dump it in the module instance's queue.
+// Never throws; messages missing required arguments are dropped.
+//--------------------------------------------------------------------------------------------------------------------------------------------
+void TSOSCSequencerListener::processMessage(const TSOSCMessage& rxMsg, const char* path, uint64_t timeTag)
+{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-			debug("Message is not for our namespace (%s).", ns);
+	debug("[RECV] OSC Message: %s", rxMsg.address);
 #endif
-			return;
-		}
-		std::string subAddr = addr.substr(len);
-		const char* path = subAddr.c_str();
-
-		std::vector<std::string> parts = str_split(subAddr.substr(1), '/');
-		int numParts = parts.size();
+	int step = -1;
+	float stepVal = 0.0;
+	int pattern = CURRENT_EDIT_PATTERN_IX;
+	int channel = CURRENT_EDIT_CHANNEL_IX;
+	int intVal = -1;
+	int row = 0, col = 0;
+	TSOSCStats::add(sequencerModule->oscStats.messagesIn, 1);
+	TSOSCStats::add(sequencerModule->oscStats.bytesIn, rxMsg.size);
 
+	/// TODO: Try to order in order of frequency/commonality of the messages
+	/// TODO: Do better/more efficient parsing (tree)
+	if (std::strcmp(path, OSC_RANDOMIZE_EDIT_STEPVALUE) == 0)
+	{
+		// Set Randomize ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// No params
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-		debug("[RECV] %s - %d parts.", path, numParts);
-#endif
-
-
-		//int i = 0;
-		//if (parts[i].compare("edit") == 0)
-		//{
-		//	i++;
-		//	// Edit messages
-		//	if (parts[i].compare("step"))
-		//}
-		//else if (parts[i].compare("play") == 0)
-		//{
-		//	// Play messages
-		//	i++;
-		//}
-
-		int row = 0, col = 0;
-
-		/// TODO: Try to order in order of frequency/commonality of the messages
-		/// TODO: Do better/more efficient parsing (tree)
-		if (std::strcmp(path, OSC_RANDOMIZE_EDIT_STEPVALUE) == 0)
+		debug("Received %s message - Randomize Current Edit Channel.", path);
+#endif
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::RandomizeEditStepValue));
+	}
+	else if (std::strncmp(path, OSC_SET_EDIT_GRIDSTEP, strlen(OSC_SET_EDIT_GRIDSTEP)) == 0)
+	{
+		// For touchOSC, a multi control grid.
+		// /edit/stepgrid/<row>/<col>
+		if (!TSOSCParsePathInt(TSOSCPathSegment(path, 2), &row) || !TSOSCParsePathInt(TSOSCPathSegment(path, 3), &col)
+			|| rxMsg.getFloat(0, &stepVal) != TSOSC_PARSE_OK)
 		{
-			// Set Randomize ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			// No params
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Randomize Current Edit Channel.", rxMsg.AddressPattern());
+			debug("Error getting step or stepvalue: %s", path);
 #endif
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::RandomizeEditStepValue));
+			return;
 		}
-		else if (std::strncmp(path, OSC_SET_EDIT_GRIDSTEP, strlen(OSC_SET_EDIT_GRIDSTEP)) == 0)
-		{
-			// For touchOSC, a multi control grid.
-			// /edit/stepgrid/<row>/<col>
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			pattern = CURRENT_EDIT_PATTERN_IX;
-			channel = CURRENT_EDIT_CHANNEL_IX;
-			try
-			{
-				row = std::stoi(parts[2]);
-				col = std::stoi(parts[3]);
-				args >> stepVal >> osc::EndMessage;
-			}
-			catch (const std::exception& ex)
-			{
+		// --* touchOSC *--
+		// Grid control is addressed by /row/col (1-based) and starts from the bottom (to top) and goes left to right.
+		// Convert to our step #.
+		// ASSUMPTION: We assume that the touchOSC multi control has the same # of cols and # rows as the module (it is the shown page).
+		step = touchOSC::mcRowCol_to_stepIndex(row, col, sequencerModule->numRows, sequencerModule->numCols)
+			+ sequencerModule->currentPageIx * sequencerModule->numPageSteps;
+		step = clampi(step, 0, sequencerModule->maxSteps - 1);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-				debug("Error getting step or stepvalue: %s\n%s", path, ex.what());
-#endif
-			}
-			// --* touchOSC *--
-			// Grid control is addressed by /row/col (1-based) and starts from the bottom (to top) and goes left to right.
-			// Convert to our step #.
-			// ASSUMPTION: We assume that the touchOSC multi control has the same # of cols and # rows as the module.
-			step = touchOSC::mcRowCol_to_stepIndex(row, col, sequencerModule->numRows, sequencerModule->numCols);
-			step = clampi(step, 0, sequencerModule->maxSteps - 1);
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Row %d, Col %d => Ix %d. Value is %0.2f.", path, row, col, step, stepVal);
-#endif
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditStepValue, pattern, channel, step, stepVal));
-		}
-		else if (std::strcmp(path, OSC_TOGGLE_EDIT_STEPVALUE) == 0 || std::strncmp(path, OSC_SET_EDIT_STEPVALUE, strlen(OSC_SET_EDIT_STEPVALUE)) == 0)
+		debug("Received %s message - Row %d, Col %d => Ix %d. Value is %0.2f.", path, row, col, step, stepVal);
+#endif
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditStepValue, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_TOGGLE_EDIT_STEPVALUE) == 0 || std::strncmp(path, OSC_SET_EDIT_STEPVALUE, strlen(OSC_SET_EDIT_STEPVALUE)) == 0)
+	{
+		// Set Step Value ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// Normal:
+		// /edit/step int stepNumber, float value, int pattern, int channel
+		// or
+		// /edit/step/tog int stepNumber
+		// or
+		// /edit/step/<step> float value  (touchOSC)
+		stepVal = 1.0;
+		TSExternalControlMessage::MessageType messageType = TSExternalControlMessage::MessageType::SetEditStepValue;
+		const char* stepPart = TSOSCPathSegment(path, 2);
+		if (std::strcmp(path, OSC_TOGGLE_EDIT_STEPVALUE) == 0)
 		{
-			// Set Step Value ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			// Normal:
-			// /edit/step int stepNumber, float value, int pattern, int channel
-			// or
 			// /edit/step/tog int stepNumber
-			// or
-			// /edit/step/<step> float value  (touchOSC)
-			// or
-			// /edit/step/mtog/<row>/<col> (ignore any params) (touchOSC)
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			stepVal = 1.0;
-			TSExternalControlMessage::MessageType messageType = TSExternalControlMessage::MessageType::SetEditStepValue;
-			if (std::strcmp(path, OSC_TOGGLE_EDIT_STEPVALUE) == 0)
-			{
-				// /edit/step/tog int stepNumber
-				messageType = TSExternalControlMessage::MessageType::ToggleEditStepValue;
-			}
-			if (numParts > 2 && messageType == TSExternalControlMessage::MessageType::SetEditStepValue)
-			{
-				// /edit/step/<step> float value
-				// touchOSC will have to send the step number in the path because it can't send > 1 arg
-				pattern = CURRENT_EDIT_PATTERN_IX;
-				channel = CURRENT_EDIT_CHANNEL_IX;
-				try
-				{
-					step = std::stoi(parts[2]);
-					args >> stepVal >> osc::EndMessage;
-				}
-				catch (const std::exception& ex)
-				{
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-					debug("Error getting step or stepvalue: %s\n%s", path, ex.what());
-#endif
-				}
-			}
-			else
-			{
-				try
-				{
-					// We should always get step and stepVal, but we should allow pattern & channel to be optional
-					args >> step >> stepVal >> pattern >> channel >> osc::EndMessage;
-				}
-				catch (osc::MissingArgumentException& ex)
-				{
-					pattern = CURRENT_EDIT_PATTERN_IX;
-					channel = CURRENT_EDIT_CHANNEL_IX;
-				}
-			}
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Step %d, val %f (Pattern %d, Channel %d).", path, step, stepVal, pattern, channel);
-#endif
-			if (step > -1)
-			{
-				// If we at least have a step.
-				step = clampi(step, 1, sequencerModule->maxSteps) - 1;
-				if (pattern != CURRENT_EDIT_PATTERN_IX)
-					pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
-				if (channel != CURRENT_EDIT_CHANNEL_IX)
-					channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
-				// Queue up this message.
-				sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(messageType, pattern, channel, step, stepVal));
-			}
+			messageType = TSExternalControlMessage::MessageType::ToggleEditStepValue;
 		}
-		else if (std::strcmp(path, OSC_STORE_PLAY_PATTERN) == 0)
+		if (stepPart != NULL && messageType == TSExternalControlMessage::MessageType::SetEditStepValue)
 		{
-			// Store Playing Pattern :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int pattern : 1-64
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			try
-			{
-				// touchOSC is VERY limited and will just send floats
-				args >> pattern >> osc::EndMessage;
-			}
-			catch (osc::WrongArgumentTypeException touchOSCEx)
+			// /edit/step/<step> float value
+			// touchOSC will have to send the step number in the path because it can't send > 1 arg
+			if (!TSOSCParsePathInt(stepPart, &step) || rxMsg.getFloat(0, &stepVal) != TSOSC_PARSE_OK)
 			{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-				debug("Wrong argument type: Error %s message: ", path, touchOSCEx.what());
-				debug("We received %d.", pattern);
+				debug("Error getting step or stepvalue: %s", path);
 #endif
+				return;
 			}
-
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Pattern %d.", path, pattern);
-#endif
-			pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::StorePlayPattern, pattern, channel, step, stepVal));
 		}
-		else if (std::strcmp(path, OSC_SET_PLAY_PATTERN) == 0)
+		else
 		{
-			// Set Playing Pattern :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int pattern : 1-64
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			try
+			// We should always get step (and stepVal unless toggling), but we should allow pattern & channel to be optional
+			rxMsg.getInt(0, &step);
+			if (rxMsg.getFloat(1, &stepVal) == TSOSC_PARSE_OK
+				&& rxMsg.getInt(2, &pattern) == TSOSC_PARSE_OK)
 			{
-				// touchOSC is VERY limited and will just send floats
-				args >> pattern >> osc::EndMessage;
+				if (rxMsg.getInt(3, &channel) != TSOSC_PARSE_OK)
+					channel = CURRENT_EDIT_CHANNEL_IX;
 			}
-			catch (osc::WrongArgumentTypeException touchOSCEx)
+			else
 			{
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-				debug("Wrong argument type: Error %s message: ", path, touchOSCEx.what());
-				debug("We received %d.", pattern);
-#endif
+				pattern = CURRENT_EDIT_PATTERN_IX;
 			}
-
+		}
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Pattern %d.", path, pattern);
+		debug("Received %s message - Step %d, val %f (Pattern %d, Channel %d).", path, step, stepVal, pattern, channel);
 #endif
+		if (step > -1)
+		{
+			// If we at least have a step.
+			step = clampi(step, 1, sequencerModule->maxSteps) - 1;
 			if (pattern != CURRENT_EDIT_PATTERN_IX)
-			{
 				pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
-			}
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayPattern, pattern, channel, step, stepVal));
+			if (channel != CURRENT_EDIT_CHANNEL_IX)
+				channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
+			// Queue up this message.
+			queueMessage(timeTag, CreateOSCRecvMsg(messageType, pattern, channel, step, stepVal));
 		}
-		else if (std::strcmp(path, OSC_SET_PLAY_CURRENTSTEP) == 0)
-		{
-			// Set Playing Step/Jump :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int step : 1-16
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> step >> osc::EndMessage;
+	}
+	else if (std::strcmp(path, OSC_STORE_PLAY_PATTERN) == 0)
+	{
+		// Store Playing Pattern :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int pattern : 1-64 (touchOSC is VERY limited and will just send floats, getInt() converts)
+		if (rxMsg.getInt(0, &pattern) == TSOSC_PARSE_MISSING_ARGUMENT)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Step %d.", path, step);
-#endif
-			step = clampi(step, 1, sequencerModule->maxSteps) - 1;
-			/// TODO: Should we purge the queue so this guaranteed to happen immediately?
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayCurrentStep, pattern, channel, step, stepVal));
-		}
-		else if (std::strcmp(path, OSC_SET_EDIT_PATTERN) == 0)
-		{
-			// Set Editing Pattern :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int pattern : 1-16
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> pattern >> osc::EndMessage;
+		debug("Received %s message - Pattern %d.", path, pattern);
+#endif
+		pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::StorePlayPattern, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_SET_PLAY_PATTERN) == 0)
+	{
+		// Set Playing Pattern :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int pattern : 1-64 (touchOSC is VERY limited and will just send floats, getInt() converts)
+		if (rxMsg.getInt(0, &pattern) == TSOSC_PARSE_MISSING_ARGUMENT)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Pattern %d.", path, pattern);
+		debug("Received %s message - Pattern %d.", path, pattern);
 #endif
+		if (pattern != CURRENT_EDIT_PATTERN_IX)
+		{
 			pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditPattern, pattern, channel, step, stepVal));
 		}
-		else if (std::strcmp(path, OSC_SET_EDIT_CHANNEL) == 0)
-		{
-			// Set Editing Channel :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int channel : 1-16
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> channel >> osc::EndMessage;
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayPattern, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_SET_PLAY_CURRENTSTEP) == 0)
+	{
+		// Set Playing Step/Jump :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int step : 1-16
+		if (rxMsg.getInt(0, &step) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Channel %d.", path, channel);
-#endif
-			channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditChannel, pattern, channel, step, stepVal));
-		}
-		else if (std::strcmp(path, OSC_SET_PLAY_OUTPUTMODE) == 0)
-		{
-			// Set Output Mode (TRIG, RTRIG, GATE) or (VOLT, NOTE, PATT) :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> intVal >> osc::EndMessage;
+		debug("Received %s message - Step %d.", path, step);
+#endif
+		step = clampi(step, 1, sequencerModule->maxSteps) - 1;
+		/// TODO: Should we purge the queue so this guaranteed to happen immediately?
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayCurrentStep, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_SET_EDIT_PATTERN) == 0)
+	{
+		// Set Editing Pattern :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int pattern : 1-16
+		if (rxMsg.getInt(0, &pattern) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Output Mode %d.", path, intVal);
-#endif
-			intVal = clampi(intVal, TSSequencerModuleBase::ValueMode::MIN_VALUE_MODE, TSSequencerModuleBase::ValueMode::MAX_VALUE_MODE);
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayOutputMode, /*mode*/ intVal));
-		}
-		else if (std::strcmp(path, OSC_SET_PLAY_RESET) == 0)
-		{
-			// Reset :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		debug("Received %s message - Pattern %d.", path, pattern);
+#endif
+		pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditPattern, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_SET_EDIT_CHANNEL) == 0)
+	{
+		// Set Editing Channel :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int channel : 1-16
+		if (rxMsg.getInt(0, &channel) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message", path);
-#endif
-			stepVal = 1;
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayReset, pattern, channel, step, stepVal));
-		}
-		else if (std::strcmp(path, OSC_PASTE_EDIT_CLIPBOARD) == 0)
-		{
-			// Copy Edit Pattern ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		debug("Received %s message - Channel %d.", path, channel);
+#endif
+		channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditChannel, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_SET_PLAY_OUTPUTMODE) == 0)
+	{
+		// Set Output Mode (TRIG, RTRIG, GATE) or (VOLT, NOTE, PATT) :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		if (rxMsg.getInt(0, &intVal) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message.", path);
-#endif
-			// Queue up this message.
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::PasteEditClipboard, pattern, channel, step, stepVal));
-		}
-		else if (std::strcmp(path, OSC_SET_PLAY_LENGTH) == 0)
-		{
-			// Set Play Length :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int step
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> step >> osc::EndMessage;
+		debug("Received %s message - Output Mode %d.", path, intVal);
+#endif
+		intVal = clampi(intVal, TSSequencerModuleBase::ValueMode::MIN_VALUE_MODE, TSSequencerModuleBase::ValueMode::MAX_VALUE_MODE);
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayOutputMode, /*mode*/ intVal));
+	}
+	else if (std::strcmp(path, OSC_SET_PLAY_RESET) == 0)
+	{
+		// Reset :::::::::::::::::::::::::::::::::::::::::::::::::::::
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Step Length %d.", path, step);
-#endif
-			if (step != TROWA_INDEX_UNDEFINED)
-			{
-				step = clampi(step, 1, sequencerModule->maxSteps); // Must be 1 to 64 (not 0 to 63)
-			}
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayLength, pattern, channel, step, stepVal));
-		}
-		else if (std::strcmp(path, OSC_STORE_PLAY_LENGTH) == 0)
-		{
-			// Store Play Length :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int step
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> step >> osc::EndMessage;
+		debug("Received %s message", path);
+#endif
+		stepVal = 1;
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayReset, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_PASTE_EDIT_CLIPBOARD) == 0)
+	{
+		// Paste Clipboard ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Step Length %d.", path, step);
+		debug("Received %s message.", path);
+#endif
+		// Queue up this message.
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::PasteEditClipboard, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_SET_PLAY_LENGTH) == 0)
+	{
+		// Set Play Length :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int step
+		if (rxMsg.getInt(0, &step) != TSOSC_PARSE_OK)
+			return;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - Step Length %d.", path, step);
 #endif
+		if (step != TROWA_INDEX_UNDEFINED)
+		{
 			step = clampi(step, 1, sequencerModule->maxSteps); // Must be 1 to 64 (not 0 to 63)
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::StorePlayLength, pattern, channel, step, stepVal));
 		}
-		else if (std::strcmp(path, OSC_TOGGLE_PLAY_RUNNINGSTATE) == 0 || std::strcmp(path, OSC_SET_PLAY_RUNNINGSTATE) == 0)
-		{
-			// Set Playing State ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			try
-			{
-				// We may or not may not always get a value (we should really check on SET, but oh well).
-				args >> intVal >> osc::EndMessage;
-			}
-			catch (osc::MissingArgumentException& ex)
-			{
-				intVal = 1;
-			}
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayLength, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_STORE_PLAY_LENGTH) == 0)
+	{
+		// Store Play Length :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int step
+		if (rxMsg.getInt(0, &step) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Play Val %d.", path, intVal);
-#endif
-			if (intVal > -1)
-			{
-				TSExternalControlMessage::MessageType messageType = TSExternalControlMessage::MessageType::SetPlayRunningState;
-				if (std::strcmp(path, OSC_TOGGLE_PLAY_RUNNINGSTATE) == 0)
-					messageType = TSExternalControlMessage::MessageType::TogglePlayRunningState;
-				// Queue up this message.
-				sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(messageType, pattern, channel, step, intVal));
-			}
-		}
-		else if (std::strcmp(path, OSC_TOGGLE_PLAY_MODE) == 0 || std::strcmp(path, OSC_SET_PLAY_MODE) == 0)
-		{
-			// Set Control Mode ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			try
-			{
-				// We may or not may not always get a value (we should really check on SET, but oh well).
-				args >> intVal >> osc::EndMessage;
-			}
-			catch (osc::MissingArgumentException& ex)
-			{
-				intVal = 1;
-			}
+		debug("Received %s message - Step Length %d.", path, step);
+#endif
+		step = clampi(step, 1, sequencerModule->maxSteps); // Must be 1 to 64 (not 0 to 63)
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::StorePlayLength, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_TOGGLE_PLAY_RUNNINGSTATE) == 0 || std::strcmp(path, OSC_SET_PLAY_RUNNINGSTATE) == 0)
+	{
+		// Set Playing State ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// We may or not may not always get a value (we should really check on SET, but oh well).
+		if (rxMsg.getInt(0, &intVal) == TSOSC_PARSE_MISSING_ARGUMENT)
+			intVal = 1;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Control Mode Val %d.", rxMsg.AddressPattern(), intVal);
+		debug("Received %s message - Play Val %d.", path, intVal);
 #endif
-			if (intVal > -1)
-			{
-				TSExternalControlMessage::MessageType messageType = TSExternalControlMessage::MessageType::SetPlayMode;
-				if (std::strcmp(rxMsg.AddressPattern(), OSC_TOGGLE_PLAY_MODE) == 0)
-					messageType = TSExternalControlMessage::MessageType::TogglePlayMode;
-				// Queue up this message.
-				sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(messageType, pattern, channel, step, intVal, intVal));
-			}
-		}
-		else if (std::strcmp(path, OSC_STORE_PLAY_BPM) == 0)
+		if (intVal > -1)
 		{
-			// Store BPM/tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int bpm
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> intVal >> osc::EndMessage;
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - BPM %d.", path, intVal);
-#endif
-			intVal = clampi(intVal, 4, 5000); // Just make sure it's not 0 or negative or too crazy.
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::StorePlayBPM, pattern, channel, step, stepVal, /*mode*/ intVal));
+			TSExternalControlMessage::MessageType messageType = TSExternalControlMessage::MessageType::SetPlayRunningState;
+			if (std::strcmp(path, OSC_TOGGLE_PLAY_RUNNINGSTATE) == 0)
+				messageType = TSExternalControlMessage::MessageType::TogglePlayRunningState;
+			// Queue up this message.
+			queueMessage(timeTag, CreateOSCRecvMsg(messageType, pattern, channel, step, intVal));
 		}
-		else if (std::strcmp(path, OSC_SET_PLAY_BPM) == 0)
-		{
-			// Set BPM/tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int bpm - changed to BPM from tempo
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> intVal >> osc::EndMessage;
+	}
+	else if (std::strcmp(path, OSC_TOGGLE_PLAY_MODE) == 0 || std::strcmp(path, OSC_SET_PLAY_MODE) == 0)
+	{
+		// Set Control Mode ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// We may or not may not always get a value (we should really check on SET, but oh well).
+		if (rxMsg.getInt(0, &intVal) == TSOSC_PARSE_MISSING_ARGUMENT)
+			intVal = 1;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - BPM %d.", path, intVal);
+		debug("Received %s message - Control Mode Val %d.", path, intVal);
 #endif
-			if (intVal != TROWA_INDEX_UNDEFINED)
-				intVal = clampi(intVal, 4, 5000); // Just make sure it's not 0 or negative or too crazy.
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayBPM, pattern, channel, step, stepVal, /*mode*/ intVal));
-		} // end if BPM
-		else if (std::strcmp(path, OSC_ADD_PLAY_BPM) == 0)
+		if (intVal > -1)
 		{
-			// Add BPM :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int bpm - changed to BPM from tempo
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> intVal >> osc::EndMessage;
+			TSExternalControlMessage::MessageType messageType = TSExternalControlMessage::MessageType::SetPlayMode;
+			if (std::strcmp(path, OSC_TOGGLE_PLAY_MODE) == 0)
+				messageType = TSExternalControlMessage::MessageType::TogglePlayMode;
+			// Queue up this message.
+			queueMessage(timeTag, CreateOSCRecvMsg(messageType, pattern, channel, step, intVal, intVal));
+		}
+	}
+	else if (std::strcmp(path, OSC_STORE_PLAY_BPM) == 0)
+	{
+		// Store BPM/tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int bpm
+		if (rxMsg.getInt(0, &intVal) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - BPM Add %d.", path, intVal);
-#endif
-			intVal = clampi(intVal, -5000, 5000); // Just make sure it's not too crazy
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::AddPlayBPM, pattern, channel, step, stepVal, /*mode*/ intVal));
-		} // end if BPM Add
-		else if (std::strcmp(path, OSC_SET_PLAY_TEMPO) == 0)
-		{
-			// Set Tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//float tempo [0,1]
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> stepVal >> osc::EndMessage;
+		debug("Received %s message - BPM %d.", path, intVal);
+#endif
+		intVal = clampi(intVal, 4, 5000); // Just make sure it's not 0 or negative or too crazy.
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::StorePlayBPM, pattern, channel, step, stepVal, /*mode*/ intVal));
+	}
+	else if (std::strcmp(path, OSC_SET_PLAY_BPM) == 0)
+	{
+		// Set BPM/tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int bpm - changed to BPM from tempo
+		if (rxMsg.getInt(0, &intVal) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Tempo %.2f", path, stepVal);
+		debug("Received %s message - BPM %d.", path, intVal);
 #endif
-			stepVal = clampf(stepVal, 0, 1.0); // Must be 0 to 1
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayTempo, pattern, channel, step, stepVal));
-		} // end if Tempo
-		else if (std::strcmp(path, OSC_COPYCURRENT_EDIT_PATTERN) == 0 || std::strcmp(path, OSC_COPY_EDIT_PATTERN) == 0)
+		if (intVal != TROWA_INDEX_UNDEFINED)
+			intVal = clampi(intVal, 4, 5000); // Just make sure it's not 0 or negative or too crazy.
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayBPM, pattern, channel, step, stepVal, /*mode*/ intVal));
+	} // end if BPM
+	else if (std::strcmp(path, OSC_ADD_PLAY_BPM) == 0)
+	{
+		// Add BPM :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int bpm - changed to BPM from tempo
+		if (rxMsg.getInt(0, &intVal) != TSOSC_PARSE_OK)
+			return;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - BPM Add %d.", path, intVal);
+#endif
+		intVal = clampi(intVal, -5000, 5000); // Just make sure it's not too crazy
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::AddPlayBPM, pattern, channel, step, stepVal, /*mode*/ intVal));
+	} // end if BPM Add
+	else if (std::strcmp(path, OSC_SET_PLAY_TEMPO) == 0)
+	{
+		// Set Tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//float tempo [0,1]
+		if (rxMsg.getFloat(0, &stepVal) != TSOSC_PARSE_OK)
+			return;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - Tempo %.2f", path, stepVal);
+#endif
+		stepVal = clampf(stepVal, 0, 1.0); // Must be 0 to 1
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayTempo, pattern, channel, step, stepVal));
+	} // end if Tempo
+	else if (std::strcmp(path, OSC_COPYCURRENT_EDIT_PATTERN) == 0 || std::strcmp(path, OSC_COPY_EDIT_PATTERN) == 0)
+	{
+		// Copy Edit Pattern ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		channel = TROWA_SEQ_COPY_CHANNELIX_ALL;
+		if (std::strcmp(path, OSC_COPY_EDIT_PATTERN) == 0)
 		{
-			// Copy Edit Pattern ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			if (std::strcmp(path, OSC_COPYCURRENT_EDIT_PATTERN))
-			{
+			// We may or not may not always get a value
+			if (rxMsg.getInt(0, &pattern) != TSOSC_PARSE_OK || pattern < 1)
 				pattern = CURRENT_EDIT_PATTERN_IX;
-				channel = TROWA_SEQ_COPY_CHANNELIX_ALL;
-			}
-			else
-			{
-				osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-				try
-				{
-					// We may or not may not always get a value
-					args >> pattern >> osc::EndMessage;
-					if (pattern < 1)
-						pattern = CURRENT_EDIT_PATTERN_IX;
-
-				}
-				catch (osc::MissingArgumentException& ex)
-				{
-					pattern = CURRENT_EDIT_PATTERN_IX;
-				}
-				if (pattern != CURRENT_EDIT_PATTERN_IX)
-					pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
-			}
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Pattern %d.", path, pattern);
-#endif
-			// Queue up this message.
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::CopyEditPattern, pattern, channel, step, stepVal));
+			if (pattern != CURRENT_EDIT_PATTERN_IX)
+				pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
 		}
-		else if (std::strcmp(path, OSC_COPY_EDIT_CHANNEL) == 0 || std::strcmp(path, OSC_COPYCURRENT_EDIT_CHANNEL) == 0)
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - Pattern %d.", path, pattern);
+#endif
+		// Queue up this message.
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::CopyEditPattern, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_COPY_EDIT_CHANNEL) == 0 || std::strcmp(path, OSC_COPYCURRENT_EDIT_CHANNEL) == 0)
+	{
+		// Copy Edit Channel ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		if (std::strcmp(path, OSC_COPY_EDIT_CHANNEL) == 0)
 		{
-			// Copy Edit Channel ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			if (std::strcmp(path, OSC_COPYCURRENT_EDIT_CHANNEL) == 0)
-			{
-				pattern = CURRENT_EDIT_PATTERN_IX;
+			// We may or not may not always get a value or both values
+			if (rxMsg.getInt(0, &channel) != TSOSC_PARSE_OK || channel < 1)
 				channel = CURRENT_EDIT_CHANNEL_IX;
-			}
-			else 
-			{
-				osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-				try
-				{
-					// We may or not may not always get a value or both values
-					args >> channel;
-					if (channel < 1)
-						channel = CURRENT_EDIT_CHANNEL_IX;
-				}
-				catch (osc::MissingArgumentException& ex)
-				{
-					channel = CURRENT_EDIT_CHANNEL_IX;
-				}
-				try
-				{
-					// We may or not may not always get a value or both values
-					args >> pattern >> osc::EndMessage;
-					if (pattern < 1)
-						pattern = CURRENT_EDIT_PATTERN_IX;
-				}
-				catch (osc::MissingArgumentException& ex)
-				{
-					pattern = CURRENT_EDIT_PATTERN_IX;
-				}
-				if (pattern != CURRENT_EDIT_PATTERN_IX)
-					pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
-				if (channel != CURRENT_EDIT_CHANNEL_IX)
-					channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
-			}
-#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Pattern %d, Channel %d.", path, pattern, channel);
-#endif
-			// Queue up this message.
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::CopyEditChannel, pattern, channel, step, stepVal));
+			if (rxMsg.getInt(1, &pattern) != TSOSC_PARSE_OK || pattern < 1)
+				pattern = CURRENT_EDIT_PATTERN_IX;
+			if (pattern != CURRENT_EDIT_PATTERN_IX)
+				pattern = clampi(pattern, 1, TROWA_SEQ_NUM_PATTERNS) - 1;
+			if (channel != CURRENT_EDIT_CHANNEL_IX)
+				channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
 		}
-		else if (std::strcmp(path, OSC_ADD_PLAY_TEMPO) == 0)
-		{
-			// Add to Tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//float tempo [0,1]
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> stepVal >> osc::EndMessage;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Tempo %.2f", path, stepVal);
-#endif
-			stepVal = clampf(stepVal, 0, 1.0); // Must be 0 to 1
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::AddPlayTempo, pattern, channel, step, stepVal));
-		} // end if Tempo Add
-		else if (std::strcmp(path, OSC_ADD_PLAY_BPMNOTE) == 0)
-		{
-			// Set BPM Note Index :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int bpmIx
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> step >> osc::EndMessage;
+		debug("Received %s message - Pattern %d, Channel %d.", path, pattern, channel);
+#endif
+		// Queue up this message.
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::CopyEditChannel, pattern, channel, step, stepVal));
+	}
+	else if (std::strcmp(path, OSC_ADD_PLAY_TEMPO) == 0)
+	{
+		// Add to Tempo :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//float tempo [0,1]
+		if (rxMsg.getFloat(0, &stepVal) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Add to BPM Note Ix %d.", path, step);
-#endif
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::AddPlayBPMNote, pattern, channel, step, stepVal));
-		} // end if BPMIncr
-		else if (std::strcmp(path, OSC_SET_PLAY_BPMNOTE) == 0)
-		{
-			// Set BPM Note Index :::::::::::::::::::::::::::::::::::::::::::::::::::::
-			//int bpmIx
-			osc::ReceivedMessageArgumentStream args = rxMsg.ArgumentStream();
-			args >> step >> osc::EndMessage;
+		debug("Received %s message - Tempo %.2f", path, stepVal);
+#endif
+		stepVal = clampf(stepVal, 0, 1.0); // Must be 0 to 1
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::AddPlayTempo, pattern, channel, step, stepVal));
+	} // end if Tempo Add
+	else if (std::strcmp(path, OSC_ADD_PLAY_BPMNOTE) == 0)
+	{
+		// Add to BPM Note Index :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int bpmIx
+		if (rxMsg.getInt(0, &step) != TSOSC_PARSE_OK)
+			return;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - BPM Note Ix %d.", path, step);
-#endif
-			step = clampi(step, 0, TROWA_TEMP_BPM_NUM_OPTIONS - 1); // Must be 0 to TROWA_TEMP_BPM_NUM_OPTIONS - 1
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayBPMNote, pattern, channel, step, stepVal));
-		} // end if BPMNote
-		else if (std::strcmp(path, OSC_INITIALIZE_EDIT_MODULE) == 0)
+		debug("Received %s message - Add to BPM Note Ix %d.", path, step);
+#endif
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::AddPlayBPMNote, pattern, channel, step, stepVal));
+	} // end if BPMIncr
+	else if (std::strcmp(path, OSC_SET_PLAY_BPMNOTE) == 0)
+	{
+		// Set BPM Note Index :::::::::::::::::::::::::::::::::::::::::::::::::::::
+		//int bpmIx
+		if (rxMsg.getInt(0, &step) != TSOSC_PARSE_OK)
+			return;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - BPM Note Ix %d.", path, step);
+#endif
+		step = clampi(step, 0, TROWA_TEMP_BPM_NUM_OPTIONS - 1); // Must be 0 to TROWA_TEMP_BPM_NUM_OPTIONS - 1
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetPlayBPMNote, pattern, channel, step, stepVal));
+	} // end if BPMNote
+	else if (std::strcmp(path, OSC_INITIALIZE_EDIT_MODULE) == 0)
+	{
+		// Set Initialize ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// No params
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - Initialize module.", path);
+#endif
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::InitializeEditModule));
+	}
+	else if (std::strcmp(path, OSC_SYNC_STATE) == 0)
+	{
+		// Resync ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// (opt) int fromSeq : Replay from this sequence number instead of a snapshot.
+		int mode = (rxMsg.getInt(0, &intVal) == TSOSC_PARSE_OK) ? 1 : 0;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - From %d (%d).", path, intVal, mode);
+#endif
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SyncState, pattern, channel, intVal, stepVal, mode));
+	}
+	else if (std::strcmp(path, OSC_QUERY_STATS) == 0)
+	{
+		// Stats ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// (opt) int reset : Zero the counters after replying.
+		if (rxMsg.getInt(0, &intVal) != TSOSC_PARSE_OK)
+			intVal = 0;
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+		debug("Received %s message - Reset %d.", path, intVal);
+#endif
+		queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::QueryStats, intVal));
+	}
+	else if (std::strcmp(path, OSC_SET_EDIT_SCALE) == 0)
+	{
+		// Set Scale ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+		// int scale, (opt) int root, (opt) int channel
+		if (rxMsg.getInt(0, &intVal) == TSOSC_PARSE_OK)
 		{
-			// Set Initialize ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-			// No params
+			int root = 0;
+			if (rxMsg.getInt(1, &root) != TSOSC_PARSE_OK)
+				root = 0;
+			if (rxMsg.getInt(2, &channel) != TSOSC_PARSE_OK || channel < 1)
+				channel = CURRENT_EDIT_CHANNEL_IX;
+			if (channel != CURRENT_EDIT_CHANNEL_IX)
+				channel = clampi(channel, 1, TROWA_SEQ_NUM_CHNLS) - 1;
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Received %s message - Initialize module.", rxMsg.AddressPattern());
+			debug("Received %s message - Scale %d, Root %d (C:%d).", path, intVal, root, channel);
 #endif
-			sequencerModule->ctlMsgQueue.push(CreateOSCRecvMsg(TSExternalControlMessage::MessageType::InitializeEditModule));
+			queueMessage(timeTag, CreateOSCRecvMsg(TSExternalControlMessage::MessageType::SetEditScale, pattern, channel, intVal, stepVal, root));
 		}
 		else
 		{
+			TSOSCStats::add(sequencerModule->oscStats.parseErrors, 1);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-			debug("Unknown OSC message: %s received.", rxMsg.AddressPattern());
+			debug("Received %s message - Missing scale.", path);
 #endif
 		}
-	} // end try
-	catch (osc::Exception& e) {
+	}
+	else
+	{
+		TSOSCStats::add(sequencerModule->oscStats.unknownMessages, 1);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-		debug("Error parsing OSC message %s: %s", rxMsg.AddressPattern(), e.what());
+		debug("Unknown OSC message: %s received.", rxMsg.address);
 #endif
-	} // end catch
+	}
 	return;
-} // end ProcessMessage()
+} // end processMessage()
\ No newline at end of file
@@ -9,8 +9,7 @@ using namespace rack;
 #include "TSExternalControlMessage.hpp"
 #include "../lib/oscpack/osc/OscOutboundPacketStream.h"
 #include "../lib/oscpack/ip/UdpSocket.h"
-#include "../lib/oscpack/osc/OscReceivedElements.h"
-#include "../lib/oscpack/osc/OscPacketListener.h"
+#include "TSOSCCommon.hpp"
 
 struct TSSequencerModuleBase;
 
@@ -105,6 +104,16 @@ struct TSSequencerModuleBase;
 // Initialize the module (same as Context Menu -> Initialize)
 // Parameters: -NONE-
 #define OSC_INITIALIZE_EDIT_MODULE	"/edit/module/init"
+// Resync: with no parameter, reply with a full snapshot (/sync/snap). With a sequence number,
+// resend the state changes from that number on (or a snapshot if they are no longer kept).
+// Parameters: (opt) int fromSeq
+#define OSC_SYNC_STATE	"/sync"
+// Reply with our OSC traffic counters (/stats, /stats/types, /stats/latency).
+// Parameters: (opt) int reset (1 to zero the counters after replying)
+#define OSC_QUERY_STATS	"/stats"
+// Set the note scale (voltSeq NOTE mode). Scale is the index (0 = chromatic), root is the semitone above C (0-11).
+// Parameters: int scale, (opt) int root, (opt) int channel (1-16, or the current edit channel)
+#define OSC_SET_EDIT_SCALE	"/edit/scale"
 // Copy Current Channel [touchOSC]
 // Parameters: -NONE-
 #define OSC_COPYCURRENT_EDIT_CHANNEL	"/edit/ch/cpycurr"
@@ -117,11 +126,10 @@ struct TSSequencerModuleBase;
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // Listener for OSC incoming messages.
-// Currently each module must have its own listener object & slave thread since I'm not 100% sure about the threading in Rack (if we could keep
-// one thread alive throughout the deaths of other modules). This way, its easy to clean up (when module dies, it kills its slave listener thread)
-// instead of tracking how many modules are still alive and using OSC.
+// Each module has its own listener object, but they are all fed by the one receive thread in TSOSCConnector
+// (routed by port and namespace through TSOSCPortRouter). Messages go in the module's lock-free inbox.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-class TSOSCSequencerListener : public osc::OscPacketListener {
+class TSOSCSequencerListener {
 public:
 	// Pointer to our sequencer module (so we can dump messages in its queue).
 	TSSequencerModuleBase* sequencerModule;
@@ -129,14 +137,21 @@ public:
 	std::string oscNamespace;
 	// Instantiate a listener.
 	TSOSCSequencerListener();
+	// The router passes messages for our namespace to processMessage().
+	friend class TSOSCPortRouter;
 protected:
 	//--------------------------------------------------------------------------------------------------------------------------------------------
-	// ProcessMessage()
-	// @rxMsg : (IN) The received message from the OSC library.
-	// @remoteEndPoint: (IN) The remove end point (sender).
-	// Handler for receiving messages from the OSC library. Taken from their example listener.
+	// processMessage()
+	// @rxMsg : (IN) The received (already validated) message.
+	// @path : (IN) The address after our namespace (i.e. /edit/step).
+	// @timeTag : (IN) Time tag of the enclosing bundle (when the module should apply the message).
 	// Should create a generic TSExternalControlMessage for our trowaSoft sequencers and dump it in the module instance's queue.
+	// Never throws; messages missing required arguments are dropped.
 	//--------------------------------------------------------------------------------------------------------------------------------------------
-	virtual void ProcessMessage(const osc::ReceivedMessage& rxMsg, const IpEndpointName& remoteEndpoint) override;
+	void processMessage(const TSOSCMessage& rxMsg, const char* path, uint64_t timeTag);
+	// Stamp the message with the time tag and put it in the module's queue.
+	void queueMessage(uint64_t timeTag, TSExternalControlMessage msg);
+	// Count a bad packet/message on our receive port (we can't tell whose it was).
+	void countParseError();
 };
 #endif
\ No newline at end of file
@@ -104,6 +104,30 @@ enum SeqOSCOutputMsg {
 	// /edit/stepgrid/color
 	// Parameters: string color
 	EditStepGridColor,
+	// Full state snapshot (reply to /sync)
+	// /sync/snap
+	// Parameters: int version, int seq, ... (see OSC_SEND_SYNC_SNAPSHOT_FS)
+	SyncSnapshot,
+	// Steps of one channel of the edit pattern (follows /sync/snap)
+	// /sync/steps
+	// Parameters: int seq, int channel, blob steps
+	SyncSteps,
+	// Sequence number of a state change bundle (last message in the bundle)
+	// /sync/seq
+	// Parameters: int seq
+	SyncSeq,
+	// OSC traffic counters (reply to /stats)
+	// /stats
+	// Parameters: int packetsOut, int bytesOut, int messagesIn, int bytesIn, int queueHighWater, int drops, int parseErrors, int unknownMessages, int handleMaxUs
+	Stats,
+	// Messages received by type (reply to /stats)
+	// /stats/types
+	// Parameters: int count (one per message type)
+	StatsTypes,
+	// Receive to apply latency histogram (reply to /stats)
+	// /stats/latency
+	// Parameters: int count (one per bucket, bucket i is < 2^i us)
+	StatsLatency,
 	NUM_OSC_OUTPUT_MSGS
 };
 
@@ -189,6 +213,29 @@ enum SeqOSCOutputMsg {
 // Step Grid Color [touchOSC] (format string).
 // Parameters: string color
 #define OSC_SEND_EDIT_STEPGRID_COLOR_FS	"%s/edit/stepgrid/color"
+// Full state snapshot (reply to /sync) (format string).
+// Parameters: int version, int seq, int running, int playPattern, int length, float bpm, int bpmNoteIx, int outputMode,
+// int ctlMode, int editPattern, int editChannel, int storedPattern, int storedLength, int storedBPM,
+// int clipboardPattern, int clipboardChannel, int numSteps, int numChannels.
+// Patterns/channels are 1-based (0 = none) like the other messages. The steps follow as numChannels /sync/steps.
+#define OSC_SEND_SYNC_SNAPSHOT_FS	"%s/sync/snap"
+// Steps of one channel of the edit pattern (follows /sync/snap) (format string). Sent in their own
+// bundles (several channels to a bundle, each bundle under TROWA_SEQ_SYNC_MAX_PACKET_SIZE bytes).
+// Parameters: int seq (same as the /sync/snap), int channel (1-based), blob steps (numSteps float32 big-endian)
+#define OSC_SEND_SYNC_STEPS_FS	"%s/sync/steps"
+// Sequence number of a state change bundle (format string). Sent as the last message of every state change bundle;
+// a gap means something was lost (ask for it with /sync <seq>).
+// Parameters: int seq
+#define OSC_SEND_SYNC_SEQ_FS	"%s/sync/seq"
+// OSC traffic counters (reply to /stats) (format string).
+// Parameters: int packetsOut, int bytesOut, int messagesIn, int bytesIn, int queueHighWater, int drops, int parseErrors, int unknownMessages, int handleMaxUs
+#define OSC_SEND_STATS_FS	"%s/stats"
+// Messages received by type (reply to /stats) (format string).
+// Parameters: int count (one per message type)
+#define OSC_SEND_STATS_TYPES_FS	"%s/stats/types"
+// Receive to apply latency histogram (reply to /stats) (format string).
+// Parameters: int count (one per bucket, bucket i is < 2^i us)
+#define OSC_SEND_STATS_LATENCY_FS	"%s/stats/latency"
 
 
 // Format strings for our output OSC messages for our sequencers.
@@ -217,7 +264,13 @@ const char* const TSSeqOSCOutputFormats[] = {
 	OSC_SEND_PLAY_STEP_LED_FS,
 	OSC_SEND_PLAY_STEP_LEDCOLOR_FS,
 	OSC_SEND_EDIT_STEP_COLOR_FS,
-	OSC_SEND_EDIT_STEPGRID_COLOR_FS
+	OSC_SEND_EDIT_STEPGRID_COLOR_FS,
+	OSC_SEND_SYNC_SNAPSHOT_FS,
+	OSC_SEND_SYNC_STEPS_FS,
+	OSC_SEND_SYNC_SEQ_FS,
+	OSC_SEND_STATS_FS,
+	OSC_SEND_STATS_TYPES_FS,
+	OSC_SEND_STATS_LATENCY_FS
 };
 
 
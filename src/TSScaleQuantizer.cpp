@@ -0,0 +1,160 @@
+#include "TSScaleQuantizer.hpp"
+
+#include <string.h>
+
+const TSScale TSScales[TS_NUM_SCALES] = {
+	{ "Chromatic", 12, { 0, 100, 200, 300, 400, 500, 600, 700, 800, 900, 1000, 1100 } },
+	{ "Major", 7, { 0, 200, 400, 500, 700, 900, 1100 } },
+	{ "Natural Minor", 7, { 0, 200, 300, 500, 700, 800, 1000 } },
+	{ "Harmonic Minor", 7, { 0, 200, 300, 500, 700, 800, 1100 } },
+	{ "Melodic Minor", 7, { 0, 200, 300, 500, 700, 900, 1100 } },
+	{ "Dorian", 7, { 0, 200, 300, 500, 700, 900, 1000 } },
+	{ "Phrygian", 7, { 0, 100, 300, 500, 700, 800, 1000 } },
+	{ "Lydian", 7, { 0, 200, 400, 600, 700, 900, 1100 } },
+	{ "Mixolydian", 7, { 0, 200, 400, 500, 700, 900, 1000 } },
+	{ "Locrian", 7, { 0, 100, 300, 500, 600, 800, 1000 } },
+	{ "Major Pentatonic", 5, { 0, 200, 400, 700, 900 } },
+	{ "Minor Pentatonic", 5, { 0, 300, 500, 700, 1000 } },
+	{ "Blues", 6, { 0, 300, 500, 600, 700, 1000 } },
+	{ "Whole Tone", 6, { 0, 200, 400, 600, 800, 1000 } },
+	{ "User", 0, { 0 } }
+};
+
+TSScaleQuantizer::TSScaleQuantizer() : version(0)
+{
+	memset(_tables, 0, sizeof(_tables));
+	for (int c = 0; c < TS_QUANTIZER_NUM_CHANNELS; c++)
+	{
+		_active[c] = 0;
+		scaleIx[c] = TS_SCALE_CHROMATIC;
+		root[c] = 0;
+		buildTable(c);
+	}
+	return;
+}
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// setScale()
+// Set the scale & root for a channel and rebuild its table.
+// @channel : (IN) The channel (or < 0 for all channels).
+// @scaleIx : (IN) The scale (TSScaleId).
+// @root : (IN) The root (semitones above C, wrapped to 0-11).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSScaleQuantizer::setScale(int channel, int scaleIx, int root)
+{
+	if (scaleIx < 0 || scaleIx >= TS_NUM_SCALES)
+		scaleIx = TS_SCALE_CHROMATIC;
+	root = ((root % TS_QUANTIZER_NUM_ROOTS) + TS_QUANTIZER_NUM_ROOTS) % TS_QUANTIZER_NUM_ROOTS;
+	std::lock_guard<std::mutex> lock(_buildMutex);
+	int start = (channel < 0) ? 0 : channel;
+	int end = (channel < 0) ? TS_QUANTIZER_NUM_CHANNELS : channel + 1;
+	for (int c = start; c < end && c < TS_QUANTIZER_NUM_CHANNELS; c++)
+	{
+		this->scaleIx[c] = scaleIx;
+		this->root[c] = root;
+		buildTable(c);
+	}
+	return;
+} // end setScale()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// setUserScale()
+// Set the user scale. Rebuilds the channels that use it.
+// @cents : (IN) The degrees in cents (wrapped into [0, 1200)).
+// @numDegrees : (IN) The number of degrees (max TS_QUANTIZER_MAX_DEGREES).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSScaleQuantizer::setUserScale(const float* cents, int numDegrees)
+{
+	std::lock_guard<std::mutex> lock(_buildMutex);
+	userCents.clear();
+	for (int i = 0; i < numDegrees && i < TS_QUANTIZER_MAX_DEGREES; i++)
+	{
+		if (!std::isfinite(cents[i]))
+			continue;
+		float c = fmodf(cents[i], 1200.0f);
+		userCents.push_back((c < 0) ? c + 1200.0f : c);
+	}
+	for (int c = 0; c < TS_QUANTIZER_NUM_CHANNELS; c++)
+	{
+		if (scaleIx[c] == TS_SCALE_USER)
+			buildTable(c);
+	}
+	return;
+} // end setUserScale()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// findScale()
+// @name : (IN) The scale name.
+// @returns : The scale index or -1 if not found.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+int TSScaleQuantizer::findScale(const char* name)
+{
+	if (name == NULL)
+		return -1;
+	for (int i = 0; i < TS_NUM_SCALES; i++)
+	{
+		if (strcmp(TSScales[i].name, name) == 0)
+			return i;
+	}
+	return -1;
+} // end findScale()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// buildTable()
+// For each phase bin of the octave, find the nearest scale degree (transposed by
+// the root, ties go up) and store it relative to the octave's floor. It can be below 0
+// or at/above 1 if the nearest degree is in the octave below/above.
+// The table is built in the channel's spare table and then swapped in, so quantize() on
+// another thread never sees a half built table. Not swapped if nothing changed.
+// @channel : (IN) The channel.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSScaleQuantizer::buildTable(int channel)
+{
+	const float* cents = TSScales[TS_SCALE_CHROMATIC].cents;
+	int numDegrees = TSScales[TS_SCALE_CHROMATIC].numDegrees;
+	if (scaleIx[channel] == TS_SCALE_USER)
+	{
+		if (userCents.size() > 0)
+		{
+			cents = userCents.data();
+			numDegrees = (int)userCents.size();
+		}
+	}
+	else
+	{
+		cents = TSScales[scaleIx[channel]].cents;
+		numDegrees = TSScales[scaleIx[channel]].numDegrees;
+	}
+	// Degrees (with the root) as a fraction of the octave
+	float degrees[TS_QUANTIZER_MAX_DEGREES];
+	for (int j = 0; j < numDegrees; j++)
+	{
+		float d = (root[channel] * 100.0f + cents[j]) / 1200.0f;
+		degrees[j] = d - floorf(d);
+	}
+	int spare = 1 - _active[channel].load(std::memory_order_relaxed);
+	float* table = _tables[channel][spare];
+	for (int i = 0; i <= TS_QUANTIZER_BINS_PER_OCTAVE; i++)
+	{
+		float phase = (i + 0.5f) / TS_QUANTIZER_BINS_PER_OCTAVE;
+		float best = phase;
+		float bestDist = 2.0f;
+		for (int j = 0; j < numDegrees; j++)
+		{
+			// The degree in the octave below, this one and the two above
+			for (int k = -1; k <= 2; k++)
+			{
+				float candidate = degrees[j] + k;
+				float dist = fabsf(candidate - phase);
+				if (dist < bestDist || (dist == bestDist && candidate > best))
+				{
+					best = candidate;
+					bestDist = dist;
+				}
+			}
+		}
+		table[i] = best;
+	}
+	if (memcmp(table, _tables[channel][1 - spare], sizeof(_tables[channel][spare])) != 0)
+	{
+		_active[channel].store(spare, std::memory_order_release);
+		version++;
+	}
+	return;
+} // end buildTable()
@@ -0,0 +1,113 @@
+#ifndef TSSCALEQUANTIZER_HPP
+#define TSSCALEQUANTIZER_HPP
+
+#include <vector>
+#include <cmath>
+#include <math.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+// Quantizer lookup bins per octave (32 per semitone, so the 12-TET boundaries land on bin edges).
+#define TS_QUANTIZER_BINS_PER_OCTAVE	384
+// Max number of degrees in a (user) scale.
+#define TS_QUANTIZER_MAX_DEGREES		48
+// Number of channels (each has its own scale & root).
+#define TS_QUANTIZER_NUM_CHANNELS		16
+// Number of roots (semitones).
+#define TS_QUANTIZER_NUM_ROOTS			12
+
+// Scales. TS_SCALE_USER is the module's own (user-defined, microtonal) scale.
+enum TSScaleId {
+	TS_SCALE_CHROMATIC,
+	TS_SCALE_MAJOR,
+	TS_SCALE_NATURAL_MINOR,
+	TS_SCALE_HARMONIC_MINOR,
+	TS_SCALE_MELODIC_MINOR,
+	TS_SCALE_DORIAN,
+	TS_SCALE_PHRYGIAN,
+	TS_SCALE_LYDIAN,
+	TS_SCALE_MIXOLYDIAN,
+	TS_SCALE_LOCRIAN,
+	TS_SCALE_MAJOR_PENTATONIC,
+	TS_SCALE_MINOR_PENTATONIC,
+	TS_SCALE_BLUES,
+	TS_SCALE_WHOLE_TONE,
+	TS_SCALE_USER,
+	TS_NUM_SCALES
+};
+
+//=== TSScale =================================================
+// A scale: the degrees (in cents above the root) of one octave.
+//=============================================================
+struct TSScale
+{
+	// Display (and json) name.
+	const char* name;
+	// Number of degrees.
+	int numDegrees;
+	// Degrees in cents [0, 1200).
+	float cents[12];
+};
+// The built-in scales (by TSScaleId, TS_SCALE_USER is empty).
+extern const TSScale TSScales[TS_NUM_SCALES];
+
+//=== TSScaleQuantizer ========================================
+// Quantizes 1 V/octave voltages to a scale, per channel.
+// Whenever a channel's scale or root changes we build a dense lookup table over one
+// octave, so quantizing a sample is just a floor and one table index.
+// Scales may be changed from the UI thread while the engine thread quantizes: each
+// channel has two tables, the new one is built in the one not in use and then swapped in.
+//=============================================================
+struct TSScaleQuantizer
+{
+	// The scale for each channel (TSScaleId).
+	int scaleIx[TS_QUANTIZER_NUM_CHANNELS];
+	// The root for each channel (semitones above C, 0-11).
+	int root[TS_QUANTIZER_NUM_CHANNELS];
+	// The user scale degrees (cents). Empty is the same as chromatic.
+	std::vector<float> userCents;
+	// Bumped whenever any table changes.
+	std::atomic<uint32_t> version;
+
+	TSScaleQuantizer();
+	// Set the scale & root for a channel (or all channels if channel < 0).
+	void setScale(int channel, int scaleIx, int root);
+	// Set the user scale (cents, wrapped into [0, 1200)). Rebuilds the channels that use it.
+	void setUserScale(const float* cents, int numDegrees);
+	// Get the lookup table for a channel (for apply()).
+	const float* table(int channel) const {
+		return _tables[channel][_active[channel].load(std::memory_order_acquire)];
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// apply()
+	// Quantize a voltage with a lookup table.
+	// @table : (IN) The table (from table()).
+	// @v : (IN) The voltage (1 V/octave).
+	// @returns : The quantized voltage.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	static inline float apply(const float* table, float v) {
+		float octave = floorf(v);
+		// Table has one extra bin so a phase that rounds up to 1.0 is still in range
+		return octave + table[static_cast<int>((v - octave) * TS_QUANTIZER_BINS_PER_OCTAVE)];
+	}
+	// Quantize one value per channel (vals[0] is channel 0, etc.).
+	void quantize(float* vals, int n) const {
+		for (int i = 0; i < n; i++)
+			vals[i] = apply(table(i), vals[i]);
+		return;
+	}
+	// Get the scale index from its name (or -1).
+	static int findScale(const char* name);
+protected:
+	// Lookup tables (two per channel): for each phase bin in the octave, the quantized voltage above the octave's floor.
+	float _tables[TS_QUANTIZER_NUM_CHANNELS][2][TS_QUANTIZER_BINS_PER_OCTAVE + 1];
+	// Which of the channel's tables is in use.
+	std::atomic<int> _active[TS_QUANTIZER_NUM_CHANNELS];
+	// Serializes the writers (UI thread and OSC messages applied on the engine thread).
+	std::mutex _buildMutex;
+	// Build the lookup table for a channel (in the table not in use) and swap it in (caller holds _buildMutex).
+	void buildTable(int channel);
+}; // end TSScaleQuantizer
+
+#endif // !TSSCALEQUANTIZER_HPP
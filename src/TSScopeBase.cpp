@@ -19,16 +19,7 @@ const GlobalEffect* SCOPE_GLOBAL_EFFECTS[TROWA_NUM_GLOBAL_EFFECTS] = {
 // Gets where the point is.
 uint8_t GetPointLocationCode(Vec pt, float minX, float maxX, float minY, float maxY)
 {
-	uint8_t code = POINT_POS_INSIDE;
-	if (pt.x < minX)
-		code = code | POINT_POS_LEFT;
-	else if (pt.x > maxX)
-		code = code | POINT_POS_RIGHT;
-	if (pt.y < minY)
-		code = code | POINT_POS_BOTTOM;
-	else if (pt.y > maxY)
-		code = code | POINT_POS_TOP;
-	return code;
+	return TSScopePointLocationCode(pt.x, pt.y, minX, maxX, minY, maxY);
 }
 // Get where the point is.
 uint8_t GetPointLocationCode(Vec pt, Vec minBounds, Vec maxBounds)
@@ -43,4 +34,166 @@ uint8_t GetPointLocationCode(Vec pt, Vec minBounds, Vec maxBounds)
 	else if (pt.y > maxBounds.y)
 		code = code | POINT_POS_TOP;
 	return code;
-}
\ No newline at end of file
+}
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeCompositeOpNeedsTrim()
+// @compositeOp : (IN) The composite operation.
+// @returns : True if this composite operation needs the path trimmed to the draw box.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSScopeCompositeOpNeedsTrim(NVGcompositeOperation compositeOp)
+{
+	bool doTrim = false;
+	switch (compositeOp)
+	{
+	case NVG_DESTINATION_OVER:
+	case NVG_SOURCE_IN:
+	case NVG_SOURCE_OUT:
+	case NVG_DESTINATION_IN:
+	case NVG_DESTINATION_ATOP:
+	case NVG_COPY:
+		doTrim = true;
+		break;
+	case NVG_SOURCE_OVER:
+	case NVG_ATOP:
+	case NVG_DESTINATION_OUT:
+	case NVG_LIGHTER:
+	case NVG_XOR:
+	default:
+		break;
+	}
+	return doTrim;
+}
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// ClipLineSegment()
+// @p1 : (IN/OUT) First point.
+// @p2 : (IN/OUT) Second point.
+// Clip the line segment to the bounds (Cohen-Sutherland).
+// @returns: True if any of the segment is inside (p1 and p2 are now the clipped
+// end points), false if it is completely outside.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool ClipLineSegment(/*in/out*/ Vec* p1, /*in/out*/ Vec* p2, float minX, float maxX, float minY, float maxY)
+{
+	uint8_t outcode0 = GetPointLocationCode(*p1, minX, maxX, minY, maxY);
+	uint8_t outcode1 = GetPointLocationCode(*p2, minX, maxX, minY, maxY);
+	while (true)
+	{
+		if (LINE_IS_IN_BOUNDS(outcode0, outcode1))
+		{ // Bitwise OR is 0. Trivially accept and get out of loop
+			return true;
+		}
+		else if (LINE_OUT_OF_BOUNDS(outcode0, outcode1))
+		{ // Bitwise AND is not 0. (implies both end points are in the same region outside the window). Reject and get out of loop
+			return false;
+		}
+		// failed both tests, so calculate the line segment to clip
+		// from an outside point to an intersection with clip edge
+		double x = 0, y = 0;
+
+		// At least one endpoint is outside the clip rectangle; pick it.
+		uint8_t outcodeOut = outcode0 ? outcode0 : outcode1;
+
+		// Now find the intersection point;
+		// use formulas:
+		//   slope = (y1 - y0) / (x1 - x0)
+		//   x = x0 + (1 / slope) * (ym - y0), where ym is ymin or ymax
+		//   y = y0 + slope * (xm - x0), where xm is xmin or xmax
+		if (outcodeOut & POINT_POS_TOP) {           // point is above the clip rectangle
+			x = p1->x + (p2->x - p1->x) * (maxY - p1->y) / (p2->y - p1->y);
+			y = maxY;
+		}
+		else if (outcodeOut & POINT_POS_BOTTOM) { // point is below the clip rectangle
+			x = p1->x + (p2->x - p1->x) * (minY - p1->y) / (p2->y - p1->y);
+			y = minY;
+		}
+		else if (outcodeOut & POINT_POS_RIGHT) {  // point is to the right of clip rectangle
+			y = p1->y + (p2->y - p1->y) * (maxX - p1->x) / (p2->x - p1->x);
+			x = maxX;
+		}
+		else if (outcodeOut & POINT_POS_LEFT) {   // point is to the left of clip rectangle
+			y = p1->y + (p2->y - p1->y) * (minX - p1->x) / (p2->x - p1->x);
+			x = minX;
+		}
+
+		// Now we move outside point to intersection point to clip
+		// and get ready for next pass.
+		if (outcodeOut == outcode0) {
+			p1->x = x;
+			p1->y = y;
+			outcode0 = GetPointLocationCode(*p1, minX, maxX, minY, maxY);
+		}
+		else {
+			p2->x = x;
+			p2->y = y;
+			outcode1 = GetPointLocationCode(*p2, minX, maxX, minY, maxY);
+		}
+	} // end while
+	return false;
+} // end ClipLineSegment()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeProjection::update()
+// @yaw : (IN) Rotation about y [radians].
+// @pitch : (IN) Rotation about x [radians].
+// @returns : True if the matrix was recalculated.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSScopeProjection::update(float yaw, float pitch)
+{
+	if (valid && yaw == this->yaw && pitch == this->pitch)
+		return false;
+	this->yaw = yaw;
+	this->pitch = pitch;
+	float cy = cosf(yaw);
+	float sy = sinf(yaw);
+	float cp = cosf(pitch);
+	float sp = sinf(pitch);
+	// Rx(pitch) * Ry(yaw)
+	m[0] = cy;		m[1] = 0;	m[2] = sy;
+	m[3] = sp*sy;	m[4] = cp;	m[5] = -sp*cy;
+	m[6] = -cp*sy;	m[7] = sp;	m[8] = cp*cy;
+	valid = true;
+	return true;
+} // end TSScopeProjection::update()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeTransformBlock3D()
+// @valX/valY/valZ : (IN) Raw x, y, z values.
+// @n : (IN) Number of points in this block.
+// @gainX/gainY/gainZ: (IN) Gain (already divided by 10).
+// @offsetX/offsetY/offsetZ: (IN) Offsets.
+// @width/height: (IN) Size of the draw box.
+// @proj : (IN) The (already calculated) projection.
+// @flipX/flipY: (IN) Mirror about the center of the box.
+// @outX/outY : (OUT) Screen coordinates.
+// @outDepth : (OUT) Depth after rotation (half-box units, positive is toward the viewer).
+// Same as TSScopeTransformBlock() but rotates in 3D with the projection matrix and
+// applies perspective. Straight float loop (one divide per point) for vectorizing.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSScopeTransformBlock3D(/*in*/ const float* valX, /*in*/ const float* valY, /*in*/ const float* valZ, int n,
+	float gainX, float gainY, float gainZ, float offsetX, float offsetY, float offsetZ, float width, float height,
+	/*in*/ const TSScopeProjection* proj, bool flipX, bool flipY,
+	/*out*/ float* outX, /*out*/ float* outY, /*out*/ float* outDepth)
+{
+	const float ox = width / 2.0f; // Center of box
+	const float oy = height / 2.0f;
+	const float kx = ((flipX) ? -1.0f : 1.0f) * ox;
+	const float ky = ((flipY) ? 1.0f : -1.0f) * oy; // Screen y is flipped
+	const float* m = proj->m;
+	const float d = proj->cameraDist;
+	const float minDenom = 0.1f; // Don't let points behind the camera blow up
+	for (int i = 0; i < n; i++)
+	{
+		float u = (valX[i] + offsetX) * gainX;
+		float v = (valY[i] + offsetY) * gainY;
+		float w = (valZ[i] + offsetZ) * gainZ;
+		float a = m[0] * u + m[1] * v + m[2] * w;
+		float b = m[3] * u + m[4] * v + m[5] * w;
+		float depth = m[6] * u + m[7] * v + m[8] * w;
+		float p = d / fmaxf(d - depth, minDenom);
+		outX[i] = ox + a * p * kx;
+		outY[i] = oy + b * p * ky;
+		outDepth[i] = depth;
+	}
+	return;
+} // end TSScopeTransformBlock3D()
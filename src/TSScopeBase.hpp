@@ -7,6 +7,7 @@
 #include "trowaSoftUtilities.hpp"
 #include "math.hpp"
 #include "dsp/digital.hpp"
+#include "TSScopeTransform.hpp"
 
 #define BUFFER_SIZE 					512
 #define TROWA_SCOPE_USE_COLOR_LIGHTS	  0
@@ -75,11 +76,12 @@
 #define TROWA_SCOPE_THICKNESS_INPUT_MIN	 -5
 #define TROWA_SCOPE_THICKNESS_INPUT_MAX	  5
 
-#define POINT_POS_INSIDE	0 // Point is within bounds
-#define POINT_POS_LEFT		0b0001 // Point is below min X
-#define POINT_POS_RIGHT		0b0010 // Point is above max X
-#define POINT_POS_BOTTOM	0b0100 // Point is below min Y
-#define POINT_POS_TOP		0b1000 // Point is above max Y
+// 3D (Z input)
+#define TROWA_SCOPE_USE_Z_DIMENSION		1 // If we are using Z also (lissajous waveforms with Z plugged in are drawn in 3D)
+#define TROWA_SCOPE_3D_PITCH			0.35f	// Fixed tilt (about x) [radians] so depth is visible. Rotation knob is yaw (about y).
+#define TROWA_SCOPE_3D_CAMERA_DIST		3.0f	// Camera distance (in half-box units) for the perspective
+#define TROWA_SCOPE_3D_NUM_DEPTH_BANDS	4		// Number of depth bands for depth-cued opacity (one stroke each)
+#define TROWA_SCOPE_3D_MIN_DEPTH_ALPHA	0.25f	// Opacity multiplier of the farthest band
 
 #define POINT_IS_IN_BOUNDS(a)		(!a)	// The given point is inside our bounds.
 #define LINE_OUT_OF_BOUNDS(a,b)		(a&b)	// The line is completely outside of bounds (and would not cross our region).
@@ -89,6 +91,47 @@
 uint8_t GetPointLocationCode(Vec pt, float minX, float maxX, float minY, float maxY);
 // Gets where the point is.
 uint8_t GetPointLocationCode(Vec pt, Vec minBounds, Vec maxBounds);
+// If this composite operation needs the path trimmed to the draw box (otherwise it will paint outside the scissor).
+bool TSScopeCompositeOpNeedsTrim(NVGcompositeOperation compositeOp);
+// Clip the line segment to the bounds (Cohen-Sutherland). Returns true if any of the segment is inside (p1, p2 are moved to the clipped segment).
+bool ClipLineSegment(/*in/out*/ Vec* p1, /*in/out*/ Vec* p2, float minX, float maxX, float minY, float maxY);
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeProjection
+// Rotation matrix for the 3D view. Only recalculated when the angles change.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct TSScopeProjection
+{
+	// Rotation about y [radians].
+	float yaw = 0;
+	// Rotation about x [radians].
+	float pitch = 0;
+	// Camera distance (half-box units).
+	float cameraDist = TROWA_SCOPE_3D_CAMERA_DIST;
+	// Row-major 3x3 rotation (Rx(pitch) * Ry(yaw)).
+	float m[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+	// If m has been calculated.
+	bool valid = false;
+	// Recalculate the matrix if the angles changed. Returns true if it was recalculated.
+	bool update(float yaw, float pitch);
+};
+// Transform a block of raw x, y, z buffer values to projected screen coordinates (and depth).
+void TSScopeTransformBlock3D(/*in*/ const float* valX, /*in*/ const float* valY, /*in*/ const float* valZ, int n,
+	float gainX, float gainY, float gainZ, float offsetX, float offsetY, float offsetZ, float width, float height,
+	/*in*/ const TSScopeProjection* proj, bool flipX, bool flipY,
+	/*out*/ float* outX, /*out*/ float* outY, /*out*/ float* outDepth);
+// Get the depth band (0 is farthest) for depth-cued opacity.
+inline uint8_t TSScopeDepthBand(float depth)
+{
+	// Depth is in half-box units (-1 to 1 is the box at gain 1).
+	float t = clampf((depth + 1.0f) * 0.5f, 0.0f, 1.0f);
+	return (uint8_t)(t * (TROWA_SCOPE_3D_NUM_DEPTH_BANDS - 1) + 0.5f);
+}
+// Get the opacity multiplier for a depth band.
+inline float TSScopeDepthBandAlpha(int band)
+{
+	return TROWA_SCOPE_3D_MIN_DEPTH_ALPHA + (1.0f - TROWA_SCOPE_3D_MIN_DEPTH_ALPHA) * band / (float)(TROWA_SCOPE_3D_NUM_DEPTH_BANDS - 1);
+}
 
 // Global effects array
 extern const GlobalEffect* SCOPE_GLOBAL_EFFECTS[TROWA_NUM_GLOBAL_EFFECTS];
@@ -96,8 +139,6 @@ extern const GlobalEffect* SCOPE_GLOBAL_EFFECTS[TROWA_NUM_GLOBAL_EFFECTS];
 /// TODO: Waveform: Thickness control & port (1 knob, 1 port)
 /// TODO: Waveform: X&Y Size and position ports (4 ports)
 
-#define TROWA_SCOPE_USE_Z_DIMENSION		0 // If we are using Z also, this will require more transforms and crap
-
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // TSWaveform
 // Store data about a waveform.
@@ -107,9 +148,19 @@ struct TSWaveform
 	float bufferX[BUFFER_SIZE] = {};
 	float bufferY[BUFFER_SIZE] = {};
 	bool bufferPenOn[BUFFER_SIZE] = {};
+	// Buffer generation. Incremented whenever the buffer contents actually change so the display can skip re-transforming.
+	uint32_t bufferGeneration = 0;
 
 	int bufferIndex;
 	float frameIndex;
+	// Number of samples between captured frames (from time knob + input).
+	int frameCount = 0;
+	// Last time knob + input value (frameCount only recalculated when this changes).
+	float lastTimeValue = 0;
+	// Sample rate frameCount was calculated for.
+	float lastSampleRate = 0;
+	// If the pen on input is active.
+	bool penInputActive = false;
 	// Lissajous mode on
 	bool lissajous = true;
 	SchmittTrigger lissajousTrigger;
@@ -227,6 +278,46 @@ struct TSWaveform
 		return;
 	}
 
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// addFrame()
+	// @x : (IN) The x value.
+	// @y : (IN) The y value.
+	// @penOn : (IN) If the pen is on for this point.
+	// Store the values at the current buffer index and advance. Only bumps the
+	// generation if the slot changed (unplugged/static inputs won't dirty the display).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void addFrame(float x, float y, bool penOn)
+	{
+		if (bufferX[bufferIndex] != x || bufferY[bufferIndex] != y || bufferPenOn[bufferIndex] != penOn)
+		{
+			bufferX[bufferIndex] = x;
+			bufferY[bufferIndex] = y;
+			bufferPenOn[bufferIndex] = penOn;
+			bufferGeneration++;
+		}
+		bufferIndex++;
+		return;
+	}
+#if TROWA_SCOPE_USE_Z_DIMENSION
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// addFrame()
+	// @x : (IN) The x value.
+	// @y : (IN) The y value.
+	// @z : (IN) The z value.
+	// @penOn : (IN) If the pen is on for this point.
+	// Same as above, with z.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void addFrame(float x, float y, float z, bool penOn)
+	{
+		if (bufferZ[bufferIndex] != z)
+		{
+			bufferZ[bufferIndex] = z;
+			bufferGeneration++;
+		}
+		addFrame(x, y, penOn);
+		return;
+	}
+#endif
 	void setHue(float hue)
 	{
 		waveHue = hue;
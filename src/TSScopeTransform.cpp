@@ -0,0 +1,80 @@
+#include "TSScopeTransform.hpp"
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeTransformBlock()
+// @valX : (IN) Raw x values (or the plotted values if valY is NULL).
+// @valY : (IN) Raw y values (or NULL to plot valX vs time).
+// @n : (IN) Number of points in this block.
+// @drawIxStart : (IN) Draw index of the first point (for time-based x).
+// @drawCount : (IN) Number of points across the box (for time-based x).
+// @gainX/gainY: (IN) Gain (already divided by 10). If valY is NULL, gainX/offsetX apply to valX.
+// @offsetX/offsetY: (IN) Offsets.
+// @width/height: (IN) Size of the draw box.
+// @rotCos/rotSin: (IN) Cosine and sine of the rotation.
+// @flipX/flipY: (IN) Mirror about the center of the box.
+// @outX/outY : (OUT) Screen coordinates.
+// Applies gain, offset, flip and rotation (about the box center) to a whole block.
+// Kept as straight float loops with no branches inside so the compiler can vectorize them.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSScopeTransformBlock(/*in*/ const float* valX, /*in*/ const float* valY, int n, int drawIxStart, int drawCount,
+	float gainX, float gainY, float offsetX, float offsetY, float width, float height,
+	float rotCos, float rotSin, bool flipX, bool flipY,
+	/*out*/ float* outX, /*out*/ float* outY)
+{
+	const float ox = width / 2.0f; // Center of box
+	const float oy = height / 2.0f;
+	const float fx = (flipX) ? -1.0f : 1.0f;
+	const float fy = (flipY) ? -1.0f : 1.0f;
+	const float c = rotCos;
+	const float s = rotSin;
+	if (valY)
+	{
+		// Screen x = width * ((v + offset) * gain / 2 + 0.5), relative to center is just (v + offset) * gain * width / 2.
+		// Screen y is flipped (1 - y).
+		const float kx = fx * gainX * ox;
+		const float ky = -fy * gainY * oy;
+		for (int i = 0; i < n; i++)
+		{
+			float dx = (valX[i] + offsetX) * kx;
+			float dy = (valY[i] + offsetY) * ky;
+			outX[i] = ox + dx * c - dy * s;
+			outY[i] = oy + dx * s + dy * c;
+		}
+	}
+	else
+	{
+		// x is time (draw index), y is the value.
+		const float kt = fx * width / (drawCount - 1);
+		const float ky = -fy * gainX * oy;
+		const float dx0 = fx * -ox;
+		for (int i = 0; i < n; i++)
+		{
+			float dx = dx0 + (drawIxStart + i) * kt;
+			float dy = (valX[i] + offsetX) * ky;
+			outX[i] = ox + dx * c - dy * s;
+			outY[i] = oy + dx * s + dy * c;
+		}
+	}
+	return;
+} // end TSScopeTransformBlock()
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSScopeLocationCodeBlock()
+// @x : (IN) x coordinates.
+// @y : (IN) y coordinates.
+// @n : (IN) Number of points.
+// @codes : (OUT) Location codes (same as GetPointLocationCode()).
+// Branch-free version of GetPointLocationCode() for a whole block.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSScopeLocationCodeBlock(/*in*/ const float* x, /*in*/ const float* y, int n, float minX, float maxX, float minY, float maxY, /*out*/ uint8_t* codes)
+{
+	for (int i = 0; i < n; i++)
+	{
+		uint8_t left = (x[i] < minX);
+		uint8_t right = (x[i] > maxX) & !left;
+		uint8_t bottom = (y[i] < minY);
+		uint8_t top = (y[i] > maxY) & !bottom;
+		codes[i] = (left * POINT_POS_LEFT) | (right * POINT_POS_RIGHT) | (bottom * POINT_POS_BOTTOM) | (top * POINT_POS_TOP);
+	}
+	return;
+} // end TSScopeLocationCodeBlock()
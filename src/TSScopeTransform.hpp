@@ -0,0 +1,34 @@
+#ifndef TSSCOPETRANSFORM_HPP
+#define TSSCOPETRANSFORM_HPP
+
+#include <stdint.h>
+
+#define POINT_POS_INSIDE	0 // Point is within bounds
+#define POINT_POS_LEFT		0b0001 // Point is below min X
+#define POINT_POS_RIGHT		0b0010 // Point is above max X
+#define POINT_POS_BOTTOM	0b0100 // Point is below min Y
+#define POINT_POS_TOP		0b1000 // Point is above max Y
+
+// Gets where the point is.
+inline uint8_t TSScopePointLocationCode(float x, float y, float minX, float maxX, float minY, float maxY)
+{
+	uint8_t code = POINT_POS_INSIDE;
+	if (x < minX)
+		code = code | POINT_POS_LEFT;
+	else if (x > maxX)
+		code = code | POINT_POS_RIGHT;
+	if (y < minY)
+		code = code | POINT_POS_BOTTOM;
+	else if (y > maxY)
+		code = code | POINT_POS_TOP;
+	return code;
+}
+// Transform a block of raw buffer values to rotated screen coordinates.
+void TSScopeTransformBlock(/*in*/ const float* valX, /*in*/ const float* valY, int n, int drawIxStart, int drawCount,
+	float gainX, float gainY, float offsetX, float offsetY, float width, float height,
+	float rotCos, float rotSin, bool flipX, bool flipY,
+	/*out*/ float* outX, /*out*/ float* outY);
+// Get the location codes for a block of points.
+void TSScopeLocationCodeBlock(/*in*/ const float* x, /*in*/ const float* y, int n, float minX, float maxX, float minY, float maxY, /*out*/ uint8_t* codes);
+
+#endif // end if not defined
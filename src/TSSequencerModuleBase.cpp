@@ -9,6 +9,7 @@
 #include "TSOSCSequencerListener.hpp"
 #include "TSOSCSequencerOutputMessages.hpp"
 #include "TSOSCCommunicator.hpp"
+#include "TSOSCDiscovery.hpp"
 #include "TSSequencerWidgetBase.hpp"
 
 // Static Variables:
@@ -32,19 +33,20 @@ RandStructure TSSequencerModuleBase::RandomPatterns[TROWA_SEQ_NUM_RANDOM_PATTERN
 // @numSteps: (IN) Maximum number of steps
 // @numRows: (IN) The number of rows (for layout).
 // @numCols: (IN) The number of columns (for layout).
-// @numRows * @numCols = @numSteps
+// @numRows * @numCols = @numSteps, or if less, one page of steps is shown at a time.
 // @defStateVal : (IN) The default state value (i.e. 0/false for a boolean step sequencer or whatever float value you want).
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-TSSequencerModuleBase::TSSequencerModuleBase(/*in*/ int numSteps, /*in*/ int numRows, /*in*/ int numCols, /*in*/ float defStateVal) : Module(NUM_PARAMS + numSteps, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS + numSteps)
+TSSequencerModuleBase::TSSequencerModuleBase(/*in*/ int numSteps, /*in*/ int numRows, /*in*/ int numCols, /*in*/ float defStateVal) : 
+	Module(NUM_PARAMS + numRows * numCols + GetNumPageButtons(numSteps, numRows, numCols), NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS + numRows * numCols + GetNumPageButtons(numSteps, numRows, numCols))
 {
 	useOSC = false;
 	oscInitialized = false;
 	oscBuffer = NULL;
 	oscTxSocket = NULL;
 	oscListener = NULL;
-	oscRxSocket = NULL;
 	oscNamespace = OSC_DEFAULT_NS;
 	oscId = TSOSCConnector::GetId();
+	oscSendBatch.setStats(&oscStats);
 
 	for (int i = 0; i < SeqOSCOutputMsg::NUM_OSC_OUTPUT_MSGS; i++)
 	{
@@ -61,14 +63,25 @@ TSSequencerModuleBase::TSSequencerModuleBase(/*in*/ int numSteps, /*in*/ int num
 	currentChannelEditingIx = 0;
 	currentPatternEditingIx = 0;
 	currentPatternPlayingIx = 0;
+	for (int i = 0; i < KnobIx::NumKnobs; i++)
+		widgetSnapshot.knobValues[i] = 0.0f;
+	widgetSnapshot.padColor = voiceColors[0];
+	widgetSnapshot.pasteColor = COLOR_WHITE;
+	widgetSnapshot.copyChannelColor = COLOR_WHITE;
 	// Number of steps in not static at compile time anymore...
-	maxSteps = numSteps; // Num Steps may vary now up to 64
+	maxSteps = numSteps; // Num Steps may vary now up to TROWA_SEQ_MAX_NUM_STEPS
 	currentNumberSteps = maxSteps;
 	storedNumberSteps = maxSteps;
 	this->numRows = numRows;
 	this->numCols = numCols;
+	// Only one page (numRows x numCols) of steps has params & lights
+	numPageSteps = numRows * numCols;
+	numPages = (maxSteps + numPageSteps - 1) / numPageSteps;
+	currentPageIx = 0;
+	pageTriggers = (numPages > 1) ? new SchmittTrigger[numPages] : NULL;
 
 	stepLights = new float*[numRows];
+	stepLightFrames = new uint32_t[numPageSteps];
 	gateLights = new float*[numRows];
 	padLightPtrs = new ColorValueLight**[numRows];
 
@@ -83,6 +96,10 @@ TSSequencerModuleBase::TSSequencerModuleBase(/*in*/ int numSteps, /*in*/ int num
 			gateLights[r][c] = 0;
 		}
 	}
+	for (int s = 0; s < numPageSteps; s++)
+	{
+		stepLightFrames[s] = 0;
+	}
 	for (int g = 0; g < TROWA_SEQ_NUM_CHNLS; g++)
 	{
 		copyBuffer[g] = new float[maxSteps];
@@ -116,6 +133,7 @@ TSSequencerModuleBase::TSSequencerModuleBase(/*in*/ int numSteps, /*in*/ int num
 TSSequencerModuleBase::~TSSequencerModuleBase()
 {
 	initialized = false; // Stop doing stuff
+	TSOSCDiscovery::Get()->withdraw(oscId); // (UI thread, the widget won't get to it now)
 	cleanupOSC();
 	for (int r = 0; r < numRows; r++)
 	{
@@ -134,6 +152,14 @@ TSSequencerModuleBase::~TSSequencerModuleBase()
 	{
 		delete[] gateLights; gateLights = NULL;
 	}
+	if (stepLightFrames != NULL)
+	{
+		delete[] stepLightFrames; stepLightFrames = NULL;
+	}
+	if (pageTriggers != NULL)
+	{
+		delete[] pageTriggers; pageTriggers = NULL;
+	}
 	if (padLightPtrs != NULL)
 	{
 		delete[] padLightPtrs;	padLightPtrs = NULL;
@@ -183,6 +209,26 @@ void TSSequencerModuleBase::reset()
 	reloadEditMatrix = true;
 	return;
 }
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// setEditPage()
+// Show/edit a page of steps. The step lights of the old page are dropped and the
+// shown steps are reloaded.
+// @pageIx : (IN) The page (0 to numPages - 1).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSSequencerModuleBase::setEditPage(int pageIx)
+{
+	pageIx = clampi(pageIx, 0, numPages - 1);
+	if (pageIx == currentPageIx)
+		return;
+	currentPageIx = pageIx;
+	for (int r = 0; r < numRows; r++)
+	{
+		for (int c = 0; c < numCols; c++)
+			stepLights[r][c] = 0.0f;
+	}
+	reloadEditMatrix = true;
+	return;
+} // end setEditPage()
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // randomize()
@@ -278,8 +324,9 @@ void TSSequencerModuleBase::setOSCNamespace(const char* oscNs)
 // @ipAddress: (IN) The ip address.
 // @outputPort: (IN) The output port.
 // @inputPort: (IN) The input port.
+// @transport: (IN) The output transport (UDP or a SLIP framed stream).
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-void TSSequencerModuleBase::initOSC(const char* ipAddress, int outputPort, int inputPort)
+void TSSequencerModuleBase::initOSC(const char* ipAddress, int outputPort, int inputPort, TSOSCTransport transport)
 {
 	oscMutex.lock();
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
@@ -288,7 +335,9 @@ void TSSequencerModuleBase::initOSC(const char* ipAddress, int outputPort, int i
 	try
 	{
 		// Try to register these ports:
-		if (TSOSCConnector::RegisterPorts(oscId, outputPort, inputPort))
+		if (!oscPortsRegistered)
+			oscPortsRegistered = TSOSCConnector::RegisterPorts(oscId, outputPort, inputPort);
+		if (oscPortsRegistered)
 		{
 			oscError = false;
 			this->currentOSCSettings.oscTxIpAddress = ipAddress;
@@ -297,7 +346,21 @@ void TSSequencerModuleBase::initOSC(const char* ipAddress, int outputPort, int i
 			{
 				oscBuffer = (char*)malloc(OSC_OUTPUT_BUFFER_SIZE * sizeof(char));
 			}
-			if (oscTxSocket == NULL)
+			this->currentOSCSettings.oscTransport = transport;
+			if (transport != TSOSCTransport::UdpTransport)
+			{
+				if (oscTxStream == NULL)
+				{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+					debug("TSSequencerModuleBase::initOSC() - Create TRANS stream (%s) to %s, port %d.", TSOSCTransportStr[transport].c_str(), ipAddress, outputPort);
+#endif
+					// Connects in the background (and reconnects), so this doesn't fail.
+					oscTxStream = new TSOSCStreamTransmitter(transport, ipAddress, outputPort);
+					oscSendBatch.setStream(oscTxStream);
+					this->currentOSCSettings.oscTxPort = outputPort;
+				}
+			}
+			else if (oscTxSocket == NULL)
 			{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
 				debug("TSSequencerModuleBase::initOSC() - Create TRANS socket at %s, port %d.", ipAddress, outputPort);
@@ -305,25 +368,63 @@ void TSSequencerModuleBase::initOSC(const char* ipAddress, int outputPort, int i
 				oscTxSocket = new UdpTransmitSocket(IpEndpointName(ipAddress, outputPort));
 				this->currentOSCSettings.oscTxPort = outputPort;
 			}
-			if (oscRxSocket == NULL)
+			if (oscListener == NULL)
 			{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-				debug("TSSequencerModuleBase::initOSC() - Create RECV socket at any address, port %d.", inputPort);
+				debug("TSSequencerModuleBase::initOSC() - Add listener to shared RECV port %d (namespace %s).", inputPort, oscNamespace.c_str());
 #endif
 				oscListener = new TSOSCSequencerListener();
 				oscListener->sequencerModule = this;
 				oscListener->oscNamespace = this->oscNamespace;
-				oscRxSocket = new UdpListeningReceiveSocket(IpEndpointName(IpEndpointName::ANY_ADDRESS, inputPort), oscListener);
-				this->currentOSCSettings.oscRxPort = inputPort;
+				if (TSOSCConnector::AddListener(oscId, inputPort, oscListener))
+				{
+					this->currentOSCSettings.oscRxPort = inputPort;
+				}
+				else
+				{
+					// Port could not be opened or this namespace is already listening on the port.
+					oscError = true;
+					delete oscListener;
+					oscListener = NULL;
+				}
+			}
+			if (oscError)
+			{
+				TSOSCConnector::ClearPorts(oscId, outputPort, inputPort);
+				oscPortsRegistered = false;
+				if (oscTxSocket != NULL)
+				{
+					delete oscTxSocket;
+					oscTxSocket = NULL;
+				}
+				oscSendBatch.setStream(NULL);
+				if (oscTxStream != NULL)
+				{
+					delete oscTxStream;
+					oscTxStream = NULL;
+				}
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-				debug("TSSequencerModuleBase::initOSC() - Starting listener thread...");
+				debug("TSSequencerModuleBase::initOSC() - Could not listen on port %d.", inputPort);
 #endif
-				oscListenerThread = std::thread(&UdpListeningReceiveSocket::Run, oscRxSocket);
 			}
+			else
+			{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-			debug("TSSequencerModuleBase::initOSC() - OSC Initialized");
+				debug("TSSequencerModuleBase::initOSC() - OSC Initialized (%d mirrors).", (int)currentOSCSettings.oscMirrors.size());
 #endif
-			oscInitialized = true;
+				// Extra targets get a copy of every packet.
+				oscSendBatch.setMirrors(currentOSCSettings.oscMirrors);
+				// Let controllers find us (the widget advertises it, see oscService).
+				oscService.moduleId = oscId;
+				oscService.name = oscNamespace;
+				oscService.serviceType = TSOSCDiscovery::ServiceType(transport);
+				oscService.host.clear(); // Filled in by the widget (LocalHostFor() binds a socket)
+				oscService.txPort = currentOSCSettings.oscTxPort;
+				oscService.rxPort = currentOSCSettings.oscRxPort;
+				oscService.transport = transport;
+				oscServiceVersion++;
+				oscInitialized = true;
+			}
 		}
 		else
 		{
@@ -339,6 +440,12 @@ void TSSequencerModuleBase::initOSC(const char* ipAddress, int outputPort, int i
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
 		warn("TSSequencerModuleBase::initOSC() - Error initializing: %s.", ex.what());
 #endif
+		// Socket creation failed after we got the ports, give them back.
+		if (oscPortsRegistered && !oscInitialized)
+		{
+			TSOSCConnector::ClearPorts(oscId, outputPort, inputPort);
+			oscPortsRegistered = false;
+		}
 	}
 	oscMutex.unlock();
 	return;
@@ -354,19 +461,26 @@ void TSSequencerModuleBase::cleanupOSC()
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
 		debug("TSSequencerModuleBase::cleanupOSC() - Cleaning up OSC");
 #endif
+		// Only clear ports we registered (shared receive ports are reference counted).
+		if (oscPortsRegistered)
+		{
+			TSOSCConnector::ClearPorts(oscId, currentOSCSettings.oscTxPort, currentOSCSettings.oscRxPort);
+			oscPortsRegistered = false;
+		}
 		oscInitialized = false;
 		oscError = false;
-		TSOSCConnector::ClearPorts(oscId, currentOSCSettings.oscTxPort, currentOSCSettings.oscRxPort);
-		if (oscRxSocket != NULL)
+		if (oscListener != NULL)
 		{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
-			debug("TSSequencerModuleBase::cleanupOSC() - Cleaning up RECV socket.");
+			debug("TSSequencerModuleBase::cleanupOSC() - Removing listener from RECV port.");
 #endif
-			oscRxSocket->AsynchronousBreak();
-			oscListenerThread.join(); // Wait for him to finish
-			delete oscRxSocket;
-			oscRxSocket = NULL;
+			// Once this returns, the receive thread is no longer using our listener.
+			TSOSCConnector::RemoveListener(oscId, currentOSCSettings.oscRxPort, oscListener);
+			delete oscListener;
+			oscListener = NULL;
 		}
+		oscSendBatch.setStream(NULL);
+		oscSendBatch.setMirrors(std::vector<TSOSCEndpoint>());
 		if (oscTxSocket != NULL)
 		{
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
@@ -375,6 +489,14 @@ void TSSequencerModuleBase::cleanupOSC()
 			delete oscTxSocket;
 			oscTxSocket = NULL;
 		}
+		if (oscTxStream != NULL)
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
+			debug("TSSequencerModuleBase::cleanupOSC() - Cleanup TRANS stream.");
+#endif
+			delete oscTxStream;
+			oscTxStream = NULL;
+		}
 		//if (oscBuffer != NULL)
 		//{
 		//	free(oscBuffer);
@@ -393,6 +515,216 @@ void TSSequencerModuleBase::cleanupOSC()
 	oscMutex.unlock();
 	return;
 } // end cleanupOSC()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// flushOSC()
+// Send any OSC bundles queued during this step (in one go).
+// A stream transport is flushed every step (it may be holding data the reader wasn't ready for).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSSequencerModuleBase::flushOSC()
+{
+	if (oscSendBatch.count() < 1 && oscTxStream == NULL)
+		return;
+	oscMutex.lock();
+	if (oscInitialized)
+		oscSendBatch.flush(oscTxSocket);
+	else
+		oscSendBatch.clear();
+	oscMutex.unlock();
+	return;
+} // end flushOSC()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// endOSCDelta()
+// Finish a state change bundle: append /sync/seq with the next sequence number,
+// keep a copy for replays and queue it (caller must hold oscMutex).
+// @oscStream : (IN) The open bundle.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSSequencerModuleBase::endOSCDelta(osc::OutboundPacketStream& oscStream)
+{
+	if (oscSyncSeq == INT32_MAX)
+		oscSyncSeq = 0; // Wrap (clients should treat a smaller number after a snapshot as a restart)
+	oscSyncSeq++;
+	oscStream << osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::SyncSeq])
+		<< (osc::int32)(oscSyncSeq)
+		<< osc::EndMessage
+		<< osc::EndBundle;
+	int ix = oscSyncSeq % TROWA_SEQ_SYNC_HISTORY_SIZE;
+	oscSyncHistorySeq[ix] = oscSyncSeq;
+	if (oscStream.Size() <= TROWA_SEQ_SYNC_HISTORY_PACKET_SIZE)
+	{
+		memcpy(oscSyncHistory[ix], oscStream.Data(), oscStream.Size());
+		oscSyncHistorySize[ix] = (int)oscStream.Size();
+	}
+	else
+	{
+		oscSyncHistorySize[ix] = 0; // Too big to keep
+	}
+	oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
+	return;
+} // end endOSCDelta()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// replayOSCDeltas()
+// Queue the kept state change bundles from this sequence number on (caller must hold oscMutex).
+// @fromSeq : (IN) The first sequence number the client is missing.
+// @returns : False (nothing queued) if any of them are no longer kept.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSSequencerModuleBase::replayOSCDeltas(int32_t fromSeq)
+{
+	if (fromSeq > oscSyncSeq)
+		return true; // Nothing missed
+	if (fromSeq < 1 || oscSyncSeq - fromSeq >= TROWA_SEQ_SYNC_HISTORY_SIZE)
+		return false;
+	for (int32_t seq = fromSeq; seq <= oscSyncSeq; seq++)
+	{
+		int ix = seq % TROWA_SEQ_SYNC_HISTORY_SIZE;
+		if (oscSyncHistorySeq[ix] != seq || oscSyncHistorySize[ix] < 1)
+			return false;
+	}
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+	debug("replayOSCDeltas() - Resending %d to %d.", fromSeq, oscSyncSeq);
+#endif
+	for (int32_t seq = fromSeq; seq <= oscSyncSeq; seq++)
+	{
+		int ix = seq % TROWA_SEQ_SYNC_HISTORY_SIZE;
+		oscSendBatch.add(oscTxSocket, oscSyncHistory[ix], oscSyncHistorySize[ix]);
+	}
+	return true;
+} // end replayOSCDeltas()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// sendOSCSnapshot()
+// Queue a full snapshot of our play and edit state (caller must hold oscMutex): one /sync/snap
+// message, then the edit pattern's steps as one /sync/steps per channel. The steps are packed
+// into bundles of at most TROWA_SEQ_SYNC_MAX_PACKET_SIZE bytes (a trigSeq256 grid in one
+// datagram would be over the MTU and get dropped by many clients).
+// Carries the current sequence number; changes after it come as /sync/seq tagged bundles.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSSequencerModuleBase::sendOSCSnapshot()
+{
+	osc::OutboundPacketStream oscStream(oscBuffer, OSC_OUTPUT_BUFFER_SIZE);
+	oscStream << osc::BeginBundleImmediate
+		<< osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::SyncSnapshot])
+		<< TROWA_SEQ_SYNC_VERSION << (osc::int32)(oscSyncSeq)
+		<< (int)(running) << (currentPatternPlayingIx + 1) << currentNumberSteps
+		<< currentBPM << selectedBPMNoteIx << (int)(selectedOutputValueMode) << (int)(currentCtlMode)
+		<< (currentPatternEditingIx + 1) << (currentChannelEditingIx + 1)
+		<< ((storedPatternPlayingIx > -1) ? storedPatternPlayingIx + 1 : currentPatternPlayingIx + 1)
+		<< ((storedNumberSteps > 0) ? storedNumberSteps : currentNumberSteps)
+		<< ((storedBPM > 0) ? storedBPM : (int)(currentBPM))
+		<< ((copySourcePatternIx == TROWA_INDEX_UNDEFINED) ? 0 : copySourcePatternIx + 1)
+		<< ((copySourcePatternIx == TROWA_INDEX_UNDEFINED) ? 0 : copySourceChannelIx + 1)
+		<< maxSteps << TROWA_SEQ_NUM_CHNLS
+		<< osc::EndMessage
+		<< osc::EndBundle;
+	oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
+
+	// Steps. Size of one /sync/steps element: size + address (padded) + ",iib" + 2 ints + blob size + blob.
+	const int bundleHeaderSize = 16; // "#bundle" + time tag
+	const int blobSize = maxSteps * (int)sizeof(float);
+	const int elementSize = 4 + (((int)strlen(oscAddrBuffer[SeqOSCOutputMsg::SyncSteps]) + 4) & ~3) + 8 + 8 + 4 + ((blobSize + 3) & ~3);
+	int bundleSize = 0; // 0 if no bundle is open
+	oscStream.Clear();
+	for (int c = 0; c < TROWA_SEQ_NUM_CHNLS; c++)
+	{
+		if (bundleSize > 0 && bundleSize + elementSize > TROWA_SEQ_SYNC_MAX_PACKET_SIZE)
+		{
+			oscStream << osc::EndBundle;
+			oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
+			oscStream.Clear();
+			bundleSize = 0;
+		}
+		if (bundleSize == 0)
+		{
+			oscStream << osc::BeginBundleImmediate;
+			bundleSize = bundleHeaderSize;
+		}
+		int n = 0;
+		for (int s = 0; s < maxSteps; s++)
+		{
+			uint32_t bits;
+			memcpy(&bits, &(triggerState[currentPatternEditingIx][c][s]), sizeof(bits));
+			oscSyncStepsBlob[n++] = (char)(bits >> 24);
+			oscSyncStepsBlob[n++] = (char)(bits >> 16);
+			oscSyncStepsBlob[n++] = (char)(bits >> 8);
+			oscSyncStepsBlob[n++] = (char)(bits);
+		}
+		oscStream << osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::SyncSteps])
+			<< (osc::int32)(oscSyncSeq) << (c + 1)
+			<< osc::Blob(oscSyncStepsBlob, n)
+			<< osc::EndMessage;
+		bundleSize += elementSize;
+	}
+	if (bundleSize > 0)
+	{
+		oscStream << osc::EndBundle;
+		oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
+	}
+	return;
+} // end sendOSCSnapshot()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// sendOSCStats()
+// Queue our OSC traffic counters (/stats, /stats/types, /stats/latency) in one bundle
+// (caller must hold oscMutex).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSSequencerModuleBase::sendOSCStats()
+{
+	osc::OutboundPacketStream oscStream(oscBuffer, OSC_OUTPUT_BUFFER_SIZE);
+	oscStream << osc::BeginBundleImmediate
+		<< osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::Stats])
+		<< (osc::int32)(oscStats.packetsOut.load()) << (osc::int32)(oscStats.bytesOut.load())
+		<< (osc::int32)(oscStats.messagesIn.load()) << (osc::int32)(oscStats.bytesIn.load())
+		<< (osc::int32)(oscStats.queueHighWater.load()) << (osc::int32)(oscStats.drops.load())
+		<< (osc::int32)(oscStats.parseErrors.load()) << (osc::int32)(oscStats.unknownMessages.load())
+		<< (osc::int32)(oscStats.handleMaxUs.load())
+		<< osc::EndMessage;
+	oscStream << osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::StatsTypes]);
+	for (int i = 0; i < TSExternalControlMessage::MessageType::NUM_MESSAGE_TYPES; i++)
+		oscStream << (osc::int32)(oscStats.messageTypeCounts[i].load());
+	oscStream << osc::EndMessage;
+	oscStream << osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::StatsLatency]);
+	for (int i = 0; i < TSOSC_STATS_LATENCY_BUCKETS; i++)
+		oscStream << (osc::int32)(oscStats.latency[i].load());
+	oscStream << osc::EndMessage
+		<< osc::EndBundle;
+	oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
+	return;
+} // end sendOSCStats()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// getNextCtlMsg()
+// Get the next external message to apply on this sample.
+// Scheduled messages that are now due come first. New messages with a future time tag
+// are mapped onto our sample clock and held in scheduledMsgQueue until their sample.
+// @msg : (OUT) The message.
+// @returns : True if there is a message to apply.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSSequencerModuleBase::getNextCtlMsg(/*out*/ TSExternalControlMessage& msg)
+{
+	if (scheduledMsgQueue.popDue(sampleCounter, msg))
+		return true;
+	uint64_t now = 0;
+	while (ctlMsgQueue.pop(msg))
+	{
+		if (msg.timeTag <= TSOSC_TIMETAG_IMMEDIATE)
+		{
+			oscStats.addLatency((uint32_t)(TSOSCStatsNowUs() - msg.rxTimeUs));
+			return true;
+		}
+		if (now == 0)
+			now = TSOSCTimeTagNow();
+		double dt = TSOSCTimeTagDiffSeconds(now, msg.timeTag);
+		if (dt <= 0 || dt > TROWA_SEQ_MAX_SCHEDULE_AHEAD_S || scheduledMsgQueue.full())
+		{
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+			if (dt > 0)
+				debug("Can't schedule message %d (%.3f s ahead). Applying now.", msg.messageType, dt);
+#endif
+			return true; // Late (or can't hold it), apply now
+		}
+		int64_t dueSample = sampleCounter + (int64_t)(dt * engineGetSampleRate() + 0.5);
+		if (dueSample <= sampleCounter)
+			return true;
+		scheduledMsgQueue.push(dueSample, msg);
+	}
+	return false;
+} // end getNextCtlMsg()
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // copy()
@@ -475,25 +807,27 @@ void TSSequencerModuleBase::setStepValue(int step, float val, int channel, int p
 		pattern = currentPatternEditingIx;
 	}
 	triggerState[pattern][channel][step] = val;
-	r = step / this->numCols;
-	c = step % this->numCols;
-	if (pattern == currentPatternEditingIx && channel == currentChannelEditingIx)
+	int shownIx = getShownStepIx(step);
+	if (pattern == currentPatternEditingIx && channel == currentChannelEditingIx && shownIx > -1)
 	{
+		r = shownIx / this->numCols;
+		c = shownIx % this->numCols;
 		if (triggerState[pattern][channel][step])
 		{
 			gateLights[r][c] = 1.0f - stepLights[r][c];
 			if (gateTriggers != NULL)
-				gateTriggers[step].state = SchmittTrigger::HIGH;
+				gateTriggers[shownIx].state = SchmittTrigger::HIGH;
 		}
 		else
 		{
 			gateLights[r][c] = 0.0f; // Turn light off	
 			if (gateTriggers != NULL)
-				gateTriggers[step].state = SchmittTrigger::LOW;
+				gateTriggers[shownIx].state = SchmittTrigger::LOW;
 		}
 	}
 	oscMutex.lock();
-	if (useOSC && oscInitialized)
+	// touchOSC grids only have the shown page
+	if (useOSC && oscInitialized && (shownIx > -1 || this->oscCurrentClient != OSCClient::touchOSCClient))
 	{
 		try
 		{
@@ -502,7 +836,7 @@ void TSSequencerModuleBase::setStepValue(int step, float val, int channel, int p
 			if (this->oscCurrentClient == OSCClient::touchOSCClient)
 			{
 				int gridRow, gridCol;
-				touchOSC::stepIndex_to_mcRowCol(step, numRows, numCols, &gridRow, &gridCol);
+				touchOSC::stepIndex_to_mcRowCol(shownIx, numRows, numCols, &gridRow, &gridCol);
 				sprintf(addrBuff, oscAddrBuffer[SeqOSCOutputMsg::EditTOSC_GridStep], gridRow, gridCol); // Grid's /<row>/<col> to accomodate touchOSC's lack of multi-parameter support.
 			}
 			else
@@ -518,9 +852,8 @@ void TSSequencerModuleBase::setStepValue(int step, float val, int channel, int p
 			oscStream << osc::BeginBundleImmediate
 				<< osc::BeginMessage(addrBuff)
 				<< triggerState[pattern][channel][step]
-				<< osc::EndMessage
-				<< osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+				<< osc::EndMessage;
+			endOSCDelta(oscStream);
 
 		}
 		catch (const std::exception &e)
@@ -553,6 +886,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 	bool lastRunning = running;
 	int lastBPMNoteIx = this->selectedBPMNoteIx;
 	int lastStepIndex = index;
+	sampleCounter++;
 
 	// Run
 	if (runningTrigger.process(params[RUN_PARAM].value)) {
@@ -568,7 +902,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		break;
 	case OSCAction::Enable:
 		this->cleanupOSC(); // Try to clean up OSC if we already have something
-		this->initOSC(this->oscNewSettings.oscTxIpAddress.c_str(), this->oscNewSettings.oscTxPort, this->oscNewSettings.oscRxPort);
+		this->initOSC(this->oscNewSettings.oscTxIpAddress.c_str(), this->oscNewSettings.oscTxPort, this->oscNewSettings.oscRxPort, this->oscNewSettings.oscTransport);
 		this->useOSC = true;
 		oscStarted = this->useOSC && this->oscInitialized;
 		break;
@@ -594,6 +928,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		else
 			selectedBPMNoteIx = 0; // Wrap around
 		lights[SELECTED_BPM_MULT_IX_LIGHT].value = 1.0;
+		bpmNoteLightFrame = lightFrame;
 	}
 	float clockTime = 1.0;
 	float input = 1.0;
@@ -693,7 +1028,9 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		// Use the input if something is connected.
 		// Some seqeuencers go to 64 steps, we want the same voltage to mean the same step number no matter how many max steps this one takes.
 		// so voltage input is normalized to indicate step 1 to step 64, but we'll limit it to maxSteps.
-		currentNumberSteps = clampi(roundf(rescalef(inputs[STEPS_INPUT].value, TROWA_SEQ_STEPS_MIN_V, TROWA_SEQ_STEPS_MAX_V, 1, TROWA_SEQ_MAX_NUM_STEPS)), 1, maxSteps);
+		// (Sequencers with more than 64 steps stretch it to their maxSteps.)
+		int cvNumSteps = (maxSteps > TROWA_SEQ_STEPS_CV_NUM_STEPS) ? maxSteps : TROWA_SEQ_STEPS_CV_NUM_STEPS;
+		currentNumberSteps = clampi(roundf(rescalef(inputs[STEPS_INPUT].value, TROWA_SEQ_STEPS_MIN_V, TROWA_SEQ_STEPS_MAX_V, 1, cvNumSteps)), 1, maxSteps);
 	}
 	else
 	{
@@ -706,7 +1043,8 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 	// (i.e. from OSC)
 	//------------------------------------------------------------
 	/// TODO: Check performance hit from sending OSC in general
-	/// TODO: Some thread safety and make sure that this queue never gets unruly? such that we start getting out of time.
+	// The queue is a lock-free single producer (the OSC receive thread) / single consumer (us) ring.
+	// Time tagged messages (from OSC bundles) are held until their sample.
 	bool resetMsg = false;
 	bool doPaste = false;
 	int prevCopyPatternIx = copySourcePatternIx;
@@ -714,11 +1052,13 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 	bool storedPatternChanged = false;
 	bool storedLengthChanged = false;
 	bool storedBPMChanged = false;
-	while (ctlMsgQueue.size() > 0)
+	TSExternalControlMessage recvMsg;
+	int64_t handleStartUs = 0; // Only look at the clock if we have messages
+	while (getNextCtlMsg(recvMsg))
 	{
-		TSExternalControlMessage recvMsg = (TSExternalControlMessage)(ctlMsgQueue.front());
-		ctlMsgQueue.pop();
 		float tmp;
+		if (handleStartUs == 0)
+			handleStartUs = TSOSCStatsNowUs();
 		/// TODO: redorder switch for most common cases first.
 		switch (recvMsg.messageType)
 		{
@@ -752,9 +1092,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 				{
 					currentPatternPlayingIx = recvMsg.pattern; // Jump to this pattern if sent
 															   // Update our knob
-					controlKnobs[KnobIx::PlayPatternKnob]->value = currentPatternPlayingIx;
-					controlKnobs[KnobIx::PlayPatternKnob]->dirty = true;
-					params[ParamIds::SELECTED_PATTERN_PLAY_PARAM].value = currentPatternPlayingIx;
+					setControlKnob(KnobIx::PlayPatternKnob, ParamIds::SELECTED_PATTERN_PLAY_PARAM, currentPatternPlayingIx);
 				}
 				// Jump to this step:
 				if (nextStep)
@@ -809,9 +1147,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 				debug("Set Play Pattern: %d.", currentPatternPlayingIx);
 #endif
 				// Update our knob
-				controlKnobs[KnobIx::PlayPatternKnob]->value = currentPatternPlayingIx;
-				controlKnobs[KnobIx::PlayPatternKnob]->dirty = true;
-				params[ParamIds::SELECTED_PATTERN_PLAY_PARAM].value = currentPatternPlayingIx;
+				setControlKnob(KnobIx::PlayPatternKnob, ParamIds::SELECTED_PATTERN_PLAY_PARAM, currentPatternPlayingIx);
 			}
 			break;
 		case TSExternalControlMessage::MessageType::StorePlayPattern:
@@ -827,9 +1163,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
 			debug("Set Output Mode: %d (TRIG, RTRIG, GATE) or (VOLT, NOTE, PATT).", selectedOutputValueMode);
 #endif
-			controlKnobs[KnobIx::OutputModeKnob]->value = selectedOutputValueMode;
-			controlKnobs[KnobIx::OutputModeKnob]->dirty = true;
-			params[ParamIds::SELECTED_OUTPUT_VALUE_MODE_PARAM].value = selectedOutputValueMode;
+			setControlKnob(KnobIx::OutputModeKnob, ParamIds::SELECTED_OUTPUT_VALUE_MODE_PARAM, selectedOutputValueMode);
 			break;
 		case TSExternalControlMessage::MessageType::SetEditPattern:
 			currentPatternEditingIx = recvMsg.pattern;
@@ -838,9 +1172,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			debug("Set Edit Pattern: %d.", currentPatternEditingIx);
 #endif
 			// Update our knob
-			controlKnobs[KnobIx::EditPatternKnob]->value = currentPatternEditingIx;
-			controlKnobs[KnobIx::EditPatternKnob]->dirty = true;
-			params[ParamIds::SELECTED_PATTERN_EDIT_PARAM].value = currentPatternEditingIx;
+			setControlKnob(KnobIx::EditPatternKnob, ParamIds::SELECTED_PATTERN_EDIT_PARAM, currentPatternEditingIx);
 			break;
 		case TSExternalControlMessage::MessageType::SetEditChannel:
 			currentChannelEditingIx = recvMsg.channel;
@@ -849,9 +1181,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			debug("Set Edit Channel: %d.", currentChannelEditingIx);
 #endif
 			// Update our knob
-			controlKnobs[KnobIx::EditChannelKnob]->value = currentChannelEditingIx;
-			controlKnobs[KnobIx::EditChannelKnob]->dirty = true;
-			params[ParamIds::SELECTED_CHANNEL_PARAM].value = currentChannelEditingIx;
+			setControlKnob(KnobIx::EditChannelKnob, ParamIds::SELECTED_CHANNEL_PARAM, currentChannelEditingIx);
 			break;
 		case TSExternalControlMessage::MessageType::TogglePlayMode:
 			// -- Control Mode: Edit / Performance Mode --
@@ -887,40 +1217,32 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			if (recvMsg.mode == TROWA_INDEX_UNDEFINED)
 				recvMsg.mode = storedBPM;
 			tmp = clampf(std::log2f(recvMsg.mode / BPMOptions[selectedBPMNoteIx]->multiplier), TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX);
-			controlKnobs[KnobIx::BPMKnob]->value = tmp;
-			controlKnobs[KnobIx::BPMKnob]->dirty = true;
-			params[ParamIds::BPM_PARAM].value = tmp;
+			setControlKnob(KnobIx::BPMKnob, ParamIds::BPM_PARAM, tmp);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
 			debug("Set BPM (%d): %.2f.", recvMsg.mode, tmp);
 #endif
 			break;
 		case TSExternalControlMessage::MessageType::AddPlayBPM: // "BPM" is relative to the note
-			tmp = pow(2, controlKnobs[KnobIx::BPMKnob]->value) // Current BPM
+			tmp = pow(2, params[ParamIds::BPM_PARAM].value) // Current BPM
 				+ recvMsg.mode / BPMOptions[selectedBPMNoteIx]->multiplier;
 			tmp = std::log2f(tmp);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Add BPM (%d): Knob %.2f, End is %.2f", recvMsg.mode, controlKnobs[KnobIx::BPMKnob]->value, tmp);
+			debug("Add BPM (%d): Knob %.2f, End is %.2f", recvMsg.mode, params[ParamIds::BPM_PARAM].value, tmp);
 #endif
-			controlKnobs[KnobIx::BPMKnob]->value = clampf(tmp, TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX);
-			controlKnobs[KnobIx::BPMKnob]->dirty = true;
-			params[ParamIds::BPM_PARAM].value = tmp;
+			setControlKnob(KnobIx::BPMKnob, ParamIds::BPM_PARAM, clampf(tmp, TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX));
 			break;
 		case TSExternalControlMessage::MessageType::SetPlayTempo: // Tempo goes from 0 to 1
 			tmp = rescalef(recvMsg.val, 0.0, 1.0, TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX);
-			controlKnobs[KnobIx::BPMKnob]->value = tmp;
-			controlKnobs[KnobIx::BPMKnob]->dirty = true;
-			params[ParamIds::BPM_PARAM].value = tmp;
+			setControlKnob(KnobIx::BPMKnob, ParamIds::BPM_PARAM, tmp);
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
 			debug("Set Tempo (%.2f): Knob %.2f.", recvMsg.val, tmp);
 #endif
 			break;
 		case TSExternalControlMessage::MessageType::AddPlayTempo: // Tempo goes from 0 to 1
 			tmp = rescalef(recvMsg.val, 0.0, 1.0, TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX);
-			controlKnobs[KnobIx::BPMKnob]->value = clampf(tmp + controlKnobs[KnobIx::BPMKnob]->value, TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX);
-			controlKnobs[KnobIx::BPMKnob]->dirty = true;
-			params[ParamIds::BPM_PARAM].value = tmp;
+			setControlKnob(KnobIx::BPMKnob, ParamIds::BPM_PARAM, clampf(tmp + params[ParamIds::BPM_PARAM].value, TROWA_SEQ_BPM_KNOB_MIN, TROWA_SEQ_BPM_KNOB_MAX));
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
-			debug("Add Tempo (%.2f): Knob %.2f.", recvMsg.val, controlKnobs[KnobIx::BPMKnob]->value);
+			debug("Add Tempo (%.2f): Knob %.2f.", recvMsg.val, params[ParamIds::BPM_PARAM].value);
 #endif
 			break;
 		case TSExternalControlMessage::MessageType::AddPlayBPMNote:
@@ -952,9 +1274,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 				debug("Set Play Step Length: %d.", currentNumberSteps);
 #endif
 				// Update our knob
-				controlKnobs[KnobIx::StepLengthKnob]->value = currentNumberSteps;
-				controlKnobs[KnobIx::StepLengthKnob]->dirty = true;
-				params[ParamIds::STEPS_PARAM].value = currentNumberSteps;
+				setControlKnob(KnobIx::StepLengthKnob, ParamIds::STEPS_PARAM, currentNumberSteps);
 			}
 			break;
 		case TSExternalControlMessage::MessageType::PasteEditClipboard:
@@ -979,7 +1299,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 				//int c = (recvMsg.channel == CURRENT_EDIT_CHANNEL_IX) ? currentChannelEditingIx : recvMsg.channel;
 				copy(pat, TROWA_SEQ_COPY_CHANNELIX_ALL);
 				lights[PASTE_LIGHT].value = 1;	// Activate paste light to show there is something on the clipboard
-				pasteLight->setColor(COLOR_WHITE);
+				setClipboardColors(COLOR_WHITE, widgetSnapshot.copyChannelColor);
 				lights[COPY_PATTERN_LIGHT].value = 1; // Light up Pattern Copy as Active clipboard
 				lights[COPY_CHANNEL_LIGHT].value = 0;	  // Inactivate Gate Copy light
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
@@ -1004,9 +1324,9 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			{
 				copy(pat, ch);
 				lights[PASTE_LIGHT].value = 1;	// Activate paste light to show there is something on the clipboard
-				pasteLight->setColor(voiceColors[currentChannelEditingIx]);
+				// Paste & Channel Copy Light match the color with our Channel color
+				setClipboardColors(voiceColors[currentChannelEditingIx], voiceColors[currentChannelEditingIx]);
 				lights[COPY_CHANNEL_LIGHT].value = 1;		// Light up Channel Copy Light as Active clipboard
-				copyGateLight->setColor(voiceColors[currentChannelEditingIx]); // Match the color with our Channel color
 				lights[COPY_PATTERN_LIGHT].value = 0; // Inactivate Pattern Copy Light
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
 				debug("Copy Edit Channel: (P:%d, C:%d).", pat, ch);
@@ -1035,19 +1355,35 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		case TSExternalControlMessage::MessageType::RandomizeEditStepValue:
 			randomize();
 			break;
+		case TSExternalControlMessage::MessageType::SyncState:
+			// Answered when we send our changes (below).
+			oscSyncRequested = true;
+			oscSyncFromSeq = (recvMsg.mode) ? recvMsg.step : -1;
+			break;
 		case TSExternalControlMessage::MessageType::InitializeEditModule:
 			reset();
-			for (int i = 0; i < KnobIx::NumKnobs; i++)
-			{
-				controlKnobs[i]->value = controlKnobs[i]->defaultValue;
-				controlKnobs[i]->dirty = true;
-			}
+			// The widget knows the knob defaults
+			queueWidgetChange(KnobDefaultsChanged);
 			// We also need to make sure our controls reset....
 			//Module::reset(); // Base method reset should do the knobs
 			//_ParentWidget->reset();
 			/// TODO: We should also send our new values to OSC if OSC is enabled. We would have to re-read the vals though,
 			/// I think the values should trigger that they changed next step()... TODO: double check that this happens
 			break;
+		case TSExternalControlMessage::MessageType::QueryStats:
+			// Answered when we send our changes (below).
+			oscStatsRequested = true;
+			oscStatsReset = recvMsg.mode != 0;
+			break;
+		case TSExternalControlMessage::MessageType::SetEditScale:
+		{
+			int ch = (recvMsg.channel == CURRENT_EDIT_CHANNEL_IX) ? currentChannelEditingIx : recvMsg.channel;
+			setScale(ch, recvMsg.step, recvMsg.mode);
+#if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_MED
+			debug("Set Scale: %d, Root %d (C:%d).", recvMsg.step, recvMsg.mode, ch);
+#endif
+		}
+			break;
 		default:
 #if TROWA_DEBUG_MSGS >= TROWA_DEBUG_LVL_LOW
 			debug("Ooops - didn't handle this control message type yet %d.", recvMsg.messageType);
@@ -1055,6 +1391,8 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			break;
 		} // end switch
 	} // end loop through message queue	
+	if (handleStartUs != 0)
+		TSOSCStats::setMax(oscStats.handleMaxUs, (uint32_t)(TSOSCStatsNowUs() - handleStartUs));
 
 
 	//-- COPY / PASTE --
@@ -1077,7 +1415,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			{
 				copy(currentPatternEditingIx, TROWA_SEQ_COPY_CHANNELIX_ALL);
 				lights[PASTE_LIGHT].value = 1;	// Activate paste light to show there is something on the clipboard
-				pasteLight->setColor(COLOR_WHITE);
+				setClipboardColors(COLOR_WHITE, widgetSnapshot.copyChannelColor);
 				lights[COPY_PATTERN_LIGHT].value = 1; // Light up Pattern Copy as Active clipboard
 				lights[COPY_CHANNEL_LIGHT].value = 0;	  // Inactivate Gate Copy light				
 			}
@@ -1093,9 +1431,9 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			{
 				copy(currentPatternEditingIx, currentChannelEditingIx);
 				lights[PASTE_LIGHT].value = 1;	// Activate paste light to show there is something on the clipboard
-				pasteLight->setColor(voiceColors[currentChannelEditingIx]);
+				// Paste & Channel Copy Light match the color with our Channel color
+				setClipboardColors(voiceColors[currentChannelEditingIx], voiceColors[currentChannelEditingIx]);
 				lights[COPY_CHANNEL_LIGHT].value = 1;		// Light up Channel Copy Light as Active clipboard
-				copyGateLight->setColor(voiceColors[currentChannelEditingIx]); // Match the color with our Channel color
 				lights[COPY_PATTERN_LIGHT].value = 0; // Inactivate Pattern Copy Light				
 			}
 		} // end if copyGateTrigger()
@@ -1120,6 +1458,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		index = 999;
 		nextStep = true;
 		lights[RESET_LIGHT].value = 1.0;
+		resetLightFrame = lightFrame;
 		nextIndex = TROWA_INDEX_UNDEFINED; // Reset our jump to index
 		oscMutex.lock();
 		if (useOSC && oscInitialized)
@@ -1129,7 +1468,7 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 				<< osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::PlayReset])
 				<< "bang" << osc::EndMessage
 				<< osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
 		}
 		oscMutex.unlock();
 	}
@@ -1146,10 +1485,15 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		if (index >= currentNumberSteps || index < 0) {
 			index = 0; // Reset (artifical limit)
 		}
-		// Show which step we are on:
-		r = index / this->numCols;// TROWA_SEQ_STEP_NUM_COLS;
-		c = index % this->numCols; //TROWA_SEQ_STEP_NUM_COLS;
-		stepLights[r][c] = 1.0f;
+		// Show which step we are on (if it is on the shown page):
+		int shownIx = getShownStepIx(index);
+		if (shownIx > -1)
+		{
+			r = shownIx / this->numCols;// TROWA_SEQ_STEP_NUM_COLS;
+			c = shownIx % this->numCols; //TROWA_SEQ_STEP_NUM_COLS;
+			stepLights[r][c] = 1.0f;
+			stepLightFrames[shownIx] = lightFrame;
+		}
 		gatePulse.trigger(1e-3);
 
 		oscMutex.lock();
@@ -1157,11 +1501,12 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		{
 			// [01/06/2018] Changed to one-based for OSC (send index+1 instead of index)
 			osc::OutboundPacketStream oscStream(oscBuffer, OSC_OUTPUT_BUFFER_SIZE);
-			oscStream << osc::BeginBundleImmediate
+			// Stamp with the real time of the step so clients can compensate for network latency.
+			oscStream << osc::BeginBundle(TSOSCTimeTagNow())
 				<< osc::BeginMessage(oscAddrBuffer[SeqOSCOutputMsg::PlayClock])
 				<< index + 1 << osc::EndMessage
 				<< osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
 		}
 		oscMutex.unlock();
 	} // end if next step
@@ -1176,10 +1521,42 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 		resetPaused = false;
 	} // end if
 
-	// Reset light
-	lights[RESET_LIGHT].value -= lights[RESET_LIGHT].value / lightLambda / engineGetSampleRate();
-	// BPM Note Calc light:
-	lights[SELECTED_BPM_MULT_IX_LIGHT].value -= lights[SELECTED_BPM_MULT_IX_LIGHT].value / lightLambda / engineGetSampleRate();
+	// Page buttons
+	for (int p = 0; p < numPages && pageTriggers != NULL; p++)
+	{
+		if (pageTriggers[p].process(params[getPageParamId(p)].value))
+			setEditPage(p);
+	}
+
+	// Lights: We only note when they fired and work out the decay every TROWA_SEQ_LIGHT_UPDATE_FRAMES frames
+	// (the sub-modules update their pad lights when lightsUpdate is set).
+	lightFrame++;
+	lightsUpdate = --lightUpdateCounter <= 0;
+	if (lightsUpdate)
+	{
+		lightUpdateCounter = TROWA_SEQ_LIGHT_UPDATE_FRAMES;
+		lightDecayRate = 1.0f / (lightLambda * engineGetSampleRate());
+		for (int s = 0; s < numPageSteps; s++)
+		{
+			int lr = s / this->numCols;
+			int lc = s % this->numCols;
+			if (stepLights[lr][lc] > 0.0f)
+				stepLights[lr][lc] = getLightDecay(stepLightFrames[s]);
+		}
+		// Reset light
+		if (lights[RESET_LIGHT].value > 0.0f)
+			lights[RESET_LIGHT].value = getLightDecay(resetLightFrame);
+		// BPM Note Calc light:
+		if (lights[SELECTED_BPM_MULT_IX_LIGHT].value > 0.0f)
+			lights[SELECTED_BPM_MULT_IX_LIGHT].value = getLightDecay(bpmNoteLightFrame);
+		// Page lights: shown page is on, the playing page is dim
+		if (pageTriggers != NULL)
+		{
+			int playingPageIx = (index >= 0 && index < maxSteps) ? index / numPageSteps : 0;
+			for (int p = 0; p < numPages; p++)
+				lights[getPageLightId(p)].value = (p == currentPageIx) ? 1.0f : ((p == playingPageIx) ? 0.25f : 0.0f);
+		}
+	}
 	*pulse = gatePulse.process(1.0 / engineGetSampleRate());
 
 	editChannelChanged = currentChannelEditingIx != lastChannelIx;
@@ -1390,6 +1767,8 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 			}// end else
 		} // end if clipboard change
 
+		// Anything so far is a state change (the step LED alone is not).
+		bool isDelta = bundleOpened;
 #if OSC_UPDATE_CURRENT_STEP_LED
 		if (lastStepIndex != index)
 		{
@@ -1414,13 +1793,31 @@ void TSSequencerModuleBase::getStepInputs(/*out*/ bool* pulse, /*out*/ bool* rel
 #endif
 		
 		//--- FINISH BUNDLE ---
-		if (bundleOpened)
+		if (isDelta)
+		{
+			// Finish (tagged with the next sequence number) and send
+			endOSCDelta(oscStream);
+		}
+		else if (bundleOpened)
 		{
 			// Finish and send
 			oscStream << osc::EndBundle;
-			oscTxSocket->Send(oscStream.Data(), oscStream.Size());
+			oscSendBatch.add(oscTxSocket, oscStream.Data(), oscStream.Size());
+		}
+		// Resync: a snapshot, or just the changes the client missed if we still have them.
+		if (oscStarted || (oscSyncRequested && (oscSyncFromSeq < 0 || !replayOSCDeltas(oscSyncFromSeq))))
+		{
+			sendOSCSnapshot();
+		}
+		if (oscStatsRequested)
+		{
+			sendOSCStats();
+			if (oscStatsReset)
+				oscStats.reset();
 		}
 	} // end send osc
+	oscSyncRequested = false;
+	oscStatsRequested = false;
 	oscMutex.unlock();
 
 	firstLoad = false;
@@ -17,6 +17,7 @@
 #include "TSOSCCommon.hpp"
 #include "TSOSCSequencerListener.hpp"
 #include "TSOSCCommunicator.hpp"
+#include "TSOSCDiscovery.hpp"
 #include "TSOSCSequencerOutputMessages.hpp"
 #include "TSSequencerWidgetBase.hpp"
 
@@ -27,7 +28,15 @@
 
 #define TROWA_SEQ_NUM_CHNLS		16	// Num of channels/triggers/voices
 #define TROWA_SEQ_NUM_STEPS		16  // Num of steps per gate/voice
-#define TROWA_SEQ_MAX_NUM_STEPS	64  // Maximum number of steps
+#define TROWA_SEQ_MAX_NUM_STEPS	256 // Maximum number of steps
+// Number of steps at the max steps voltage (so the LNG input means the same for our 16 and 64 step modules).
+#define TROWA_SEQ_STEPS_CV_NUM_STEPS	64
+// Maximum number of pages of steps (if only one page of steps is shown at a time).
+#define TROWA_SEQ_MAX_NUM_PAGES		16
+// Number of frames between light updates (the lights decay at this control rate, not per sample).
+#define TROWA_SEQ_LIGHT_UPDATE_FRAMES	32
+// Decayed light values below this are just off (less than 1/255).
+#define TROWA_SEQ_LIGHT_OFF_VALUE		0.002f
 
 // Default OSC outgoing address (Tx). 127.0.0.1.
 #define OSC_ADDRESS_DEF		"127.0.0.1"
@@ -37,8 +46,22 @@
 #define OSC_INPORT_DEF		7001
 // Default namespace for OSC
 #define OSC_DEFAULT_NS				"/tsseq"
-#define OSC_OUTPUT_BUFFER_SIZE		(1024*TROWA_SEQ_MAX_NUM_STEPS)
+#define OSC_OUTPUT_BUFFER_SIZE		(256*TROWA_SEQ_MAX_NUM_STEPS)
 #define OSC_ADDRESS_BUFFER_SIZE		50
+// Size of the (lock-free) inbox for external control messages (power of 2). Messages past this per step are dropped.
+#define TROWA_SEQ_CTL_MSG_QUEUE_SIZE	1024
+// Max number of time tagged (scheduled) external messages waiting for their sample. Past this they are applied immediately.
+#define TROWA_SEQ_SCHEDULED_MSG_QUEUE_SIZE	256
+// Max seconds ahead we will schedule a time tagged message (anything later is applied immediately).
+#define TROWA_SEQ_MAX_SCHEDULE_AHEAD_S	60
+// Version of the /sync/snap layout (bump if the arguments change). 2: steps moved to /sync/steps.
+#define TROWA_SEQ_SYNC_VERSION		2
+// Max size of a snapshot packet (stays under a typical network MTU so clients get it in one datagram).
+#define TROWA_SEQ_SYNC_MAX_PACKET_SIZE	1400
+// Number of recent state change bundles kept so a client can ask for just what it missed (/sync <seq>).
+#define TROWA_SEQ_SYNC_HISTORY_SIZE	32
+// Largest state change bundle we keep for a replay (a gap over a bigger one gets a snapshot instead).
+#define TROWA_SEQ_SYNC_HISTORY_PACKET_SIZE	2048
 // If we should update the current step pointer to OSC (turn off prev step, highlight current step).
 // This gets slow though during testing.
 #define OSC_UPDATE_CURRENT_STEP_LED		1
@@ -96,7 +119,7 @@ struct TSSequencerModuleBase : Module {
 		OSC_SAVE_CONF_PARAM, // ENABLE and Save the configuration for OSC
 		OSC_DISABLE_PARAM,   // Disable OSC (ignore config values)
 		OSC_SHOW_CONF_PARAM, // Configure OSC toggle
-		CHANNEL_PARAM, // Edit Channel/Step Buttons/Knobs
+		CHANNEL_PARAM, // Edit Channel/Step Buttons/Knobs (one page of steps, then the page buttons if we have pages)
 		NUM_PARAMS = CHANNEL_PARAM // Add the number of steps separately...
 	};
 	enum InputIds {
@@ -125,7 +148,7 @@ struct TSSequencerModuleBase : Module {
 		OSC_CONFIGURE_LIGHT, // The light for configuring OSC.
 		OSC_ENABLED_LIGHT, // Light for OSC enabled and currently running/active.
 		CHANNEL_LIGHTS, // Channel output lights.		
-		PAD_LIGHTS = CHANNEL_LIGHTS + TROWA_SEQ_NUM_CHNLS, // Lights for the steps/pads for the currently editing Channel
+		PAD_LIGHTS = CHANNEL_LIGHTS + TROWA_SEQ_NUM_CHNLS, // Lights for the steps/pads for the currently editing Channel (one page, then the page button lights)
 		// Not the number of lights yet, add the # of steps (maxSteps)
 		NUM_LIGHTS = PAD_LIGHTS // Add the number of steps separately...
 	};
@@ -180,9 +203,18 @@ struct TSSequencerModuleBase : Module {
 	int numRows = 4;
 	// The number of columns for steps (for layout).
 	int numCols = 4;
-	// Step data for each pattern and channel.
+	// Number of steps shown at a time (numRows * numCols). Step params and lights only exist for one page.
+	int numPageSteps = 16;
+	// Number of pages of steps (1 if all steps are shown).
+	int numPages = 1;
+	// The page of steps shown/edited.
+	int currentPageIx = 0;
+	// Step data for each pattern and channel (all maxSteps, not just the shown page).
 	float * triggerState[TROWA_SEQ_NUM_PATTERNS][TROWA_SEQ_NUM_CHNLS];
+	// Triggers for the shown step pads (numPageSteps).
 	SchmittTrigger* gateTriggers;
+	// Page buttons (numPages, only if numPages > 1).
+	SchmittTrigger* pageTriggers;
 
 	// Knob indices for top control knobs.
 	enum KnobIx {
@@ -201,8 +233,41 @@ struct TSSequencerModuleBase : Module {
 		// Number of Control Knobs
 		NumKnobs
 	};
-	// References to input knobs (top row of knobs)
+	// References to input knobs (top row of knobs). UI thread only (see widgetChanges).
 	SVGKnob* controlKnobs[NumKnobs];
+	// Module -> widget change bits. The control knobs take the low bits (1 << KnobIx).
+	enum WidgetChangeBits : uint32_t {
+		// Control knobs go back to their default values
+		KnobDefaultsChanged = 1 << NumKnobs,
+		// Step (pad) light color changed (edit channel)
+		PadColorChanged = 1 << (NumKnobs + 1),
+		// Paste / copy channel light colors changed
+		ClipboardColorsChanged = 1 << (NumKnobs + 2),
+		// Step knobs should re-read their params (voltSeq)
+		StepValuesChanged = 1 << (NumKnobs + 3),
+		// Output value mode changed (voltSeq light arcs)
+		ValueModeChanged = 1 << (NumKnobs + 4)
+	};
+	// What the widget should show (written before the change bit is set).
+	struct WidgetSnapshot {
+		// Control knob values
+		float knobValues[NumKnobs];
+		// Step (pad) light color
+		NVGcolor padColor;
+		// Paste light color
+		NVGcolor pasteColor;
+		// Copy channel light color
+		NVGcolor copyChannelColor;
+	};
+	// Module -> widget change channel. We (engine thread) never touch widgets; we fill
+	// widgetSnapshot, then set the bits, and the widget's step() takes them (UI thread).
+	// The bits only say what changed: the widget copies the snapshot with readWidgetSnapshot()
+	// (seqlock on widgetSnapshotVersion) so it never sees a half written one.
+	std::atomic<uint32_t> widgetChanges = { 0 };
+	// Snapshot for widgetChanges. Engine thread writes it (between beginSnapshotWrite() and endSnapshotWrite()).
+	WidgetSnapshot widgetSnapshot;
+	// Seqlock version of widgetSnapshot (odd while it is being written).
+	std::atomic<uint32_t> widgetSnapshotVersion = { 0 };
 
 	// Another flag to reload the matrix.
 	bool reloadEditMatrix = false;
@@ -236,11 +301,25 @@ struct TSSequencerModuleBase : Module {
 	// Pad/Knob lights - Step On
 	float** stepLights; /// TODO: Just make linear
 	float** gateLights; /// TODO: Just make linear
+	// Frame counter for the lights (wraps, we only look at short differences).
+	uint32_t lightFrame = 0;
+	// Frames left until the next light update.
+	int lightUpdateCounter = 0;
+	// If the lights are being updated this frame (set in getStepInputs()).
+	bool lightsUpdate = false;
+	// Light decay per frame (1 / (lightLambda * sample rate)).
+	float lightDecayRate = 0.0f;
+	// The frame each step light fired on (by step index on the shown page).
+	uint32_t* stepLightFrames;
+	// The frame the reset light fired on.
+	uint32_t resetLightFrame = 0;
+	// The frame the BPM note light fired on.
+	uint32_t bpmNoteLightFrame = 0;
 
 	// Default values for our pads/knobs:
 	float defaultStateValue = 0.0;
 
-	// References to our pad lights
+	// References to our pad lights (UI thread only, see widgetChanges)
 	ColorValueLight*** padLightPtrs; /// TODO: Just make linear
 
 	// Output lights (for triggers/gate jacks)
@@ -269,8 +348,7 @@ struct TSSequencerModuleBase : Module {
 	SchmittTrigger copyPatternTrigger;
 	SchmittTrigger copyGateTrigger;
 	SchmittTrigger pasteTrigger;
-	/// TODO: Maybe eventually separate UI controls from module (UI changes in Widget not Module).
-	// Light for paste button
+	// Light for paste button (UI thread only, see widgetChanges)
 	TS_LightString* pasteLight;
 	// Light for copy pattern button
 	ColorValueLight* copyPatternLight;
@@ -283,8 +361,13 @@ struct TSSequencerModuleBase : Module {
 	SchmittTrigger selectedBPMNoteTrigger;
 
 	// External Messages ///////////////////////////////////////////////
-	// Message queue for external (to Rack) control messages
-	std::queue<TSExternalControlMessage> ctlMsgQueue;
+	// Message queue for external (to Rack) control messages.
+	// Filled by the shared OSC receive thread, emptied in step().
+	TSLockFreeQueue<TSExternalControlMessage, TROWA_SEQ_CTL_MSG_QUEUE_SIZE> ctlMsgQueue;
+	// Time tagged messages waiting for their sample (keyed by sampleCounter). Only touched in step().
+	TSTimeOrderedQueue<TSExternalControlMessage, TROWA_SEQ_SCHEDULED_MSG_QUEUE_SIZE> scheduledMsgQueue;
+	// Our sample clock (samples processed). Time tags are mapped onto this.
+	int64_t sampleCounter = 0;
 
 	enum ExternalControllerMode {
 		// Edit Mode : Send to control what we are editing.
@@ -315,20 +398,27 @@ struct TSSequencerModuleBase : Module {
 	bool oscShowConfigurationScreen = false;
 	// Flag if OSC objects have been initialized
 	bool oscInitialized = false;
+	// If we hold our ports in TSOSCConnector (registered in initOSC(), cleared in cleanupOSC() or on failure).
+	bool oscPortsRegistered = false;
 	// If there is an osc error.
 	bool oscError = false;
+	// Our service for discovery (set by initOSC(), host excepted). The widget advertises it from the UI thread
+	// (finding our address and announcing do socket work that doesn't belong on the engine thread). Guarded by oscMutex.
+	TSOSCServiceInfo oscService;
+	// Bumped by every successful initOSC() so the widget knows to advertise again. Guarded by oscMutex.
+	uint32_t oscServiceVersion = 0;
 	// OSC output buffer.
 	char* oscBuffer = NULL;
 	// OSC namespace to use
 	std::string oscNamespace = OSC_DEFAULT_NS;
 	// Sending OSC socket
 	UdpTransmitSocket* oscTxSocket = NULL;
-	// OSC message listener
+	// Sending OSC stream (if the transport is not UDP).
+	TSOSCStreamTransmitter* oscTxStream = NULL;
+	// Outgoing bundles for this step (sent together at the end of step()).
+	TSOSCSendBatch oscSendBatch;
+	// OSC message listener (registered with the shared receiver in TSOSCConnector).
 	TSOSCSequencerListener* oscListener = NULL;
-	// Receiving OSC socket
-	UdpListeningReceiveSocket* oscRxSocket = NULL;
-	// The OSC listener thread
-	std::thread oscListenerThread;
 	// Osc address buffer. 
 	char oscAddrBuffer[SeqOSCOutputMsg::NUM_OSC_OUTPUT_MSGS][OSC_ADDRESS_BUFFER_SIZE];
 	// Prev step that was last turned off (when going to a new step).
@@ -345,6 +435,28 @@ struct TSSequencerModuleBase : Module {
 	OSCAction oscCurrentAction = OSCAction::None;	
 	// The current osc client. Clients such as touchOSC and Lemur are limited and need special treatment.
 	OSCClient oscCurrentClient = OSCClient::GenericClient;
+	// Sequence number of the last state change bundle sent (/sync/seq).
+	int32_t oscSyncSeq = 0;
+	// If a client asked for a resync (/sync) this step.
+	bool oscSyncRequested = false;
+	// Sequence number the client wants the changes from (-1 for a snapshot).
+	int32_t oscSyncFromSeq = -1;
+	// Recent state change bundles (ring indexed by seq % TROWA_SEQ_SYNC_HISTORY_SIZE) for replays.
+	char oscSyncHistory[TROWA_SEQ_SYNC_HISTORY_SIZE][TROWA_SEQ_SYNC_HISTORY_PACKET_SIZE];
+	// OSC traffic counters (lock-free, always on).
+	TSOSCStats oscStats;
+	// If a client asked for our stats (/stats) this step.
+	bool oscStatsRequested = false;
+	// If we should zero the stats after replying.
+	bool oscStatsReset = false;
+	// Show the OSC stats on the display instead of the normal info (debug, not saved).
+	bool oscShowStats = false;
+	// Size of each kept bundle (0 if it was too big to keep).
+	int oscSyncHistorySize[TROWA_SEQ_SYNC_HISTORY_SIZE] = { 0 };
+	// Sequence number of each kept bundle.
+	int32_t oscSyncHistorySeq[TROWA_SEQ_SYNC_HISTORY_SIZE] = { 0 };
+	// One channel of steps for a /sync/steps blob (float32 big-endian).
+	char oscSyncStepsBlob[TROWA_SEQ_MAX_NUM_STEPS * sizeof(float)];
 
 	// Mode /////////////////////////	
 	// The mode string.
@@ -357,6 +469,17 @@ struct TSSequencerModuleBase : Module {
 	// If this was loaded from a save, what version
 	int saveVersion = -1;
 	const float lightLambda = 0.05;
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// getLightDecay()
+	// Get a light's value from when it fired (exp(-t / lightLambda)).
+	// @fireFrame : (IN) The frame (lightFrame) the light was set to 1 on.
+	// @returns : The light value (0 once it is too dim to see).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	float getLightDecay(uint32_t fireFrame)
+	{
+		float v = expf(-static_cast<float>(lightFrame - fireFrame) * lightDecayRate);
+		return (v < TROWA_SEQ_LIGHT_OFF_VALUE) ? 0.0f : v;
+	}
 
 	
 
@@ -371,6 +494,37 @@ struct TSSequencerModuleBase : Module {
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	TSSequencerModuleBase(/*in*/ int numSteps, /*in*/ int numRows, /*in*/ int numCols, /*in*/ float defStateVal);
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// GetNumPageButtons()
+	// @numSteps: (IN) Maximum number of steps
+	// @numRows: (IN) The number of rows (for layout).
+	// @numCols: (IN) The number of columns (for layout).
+	// @returns : The number of page buttons (params & lights after the shown steps), 0 if all steps fit.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	static int GetNumPageButtons(/*in*/ int numSteps, /*in*/ int numRows, /*in*/ int numCols)
+	{
+		int numPages = (numSteps + numRows * numCols - 1) / (numRows * numCols);
+		return (numPages > 1) ? numPages : 0;
+	}
+	// Get the param id of a page button.
+	int getPageParamId(int pageIx) {
+		return CHANNEL_PARAM + numPageSteps + pageIx;
+	}
+	// Get the light id of a page button.
+	int getPageLightId(int pageIx) {
+		return PAD_LIGHTS + numPageSteps + pageIx;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// getShownStepIx()
+	// @step : (IN) The step index (0 to maxSteps - 1).
+	// @returns : The index of the step on the shown page (pad/param/light), or -1 if it is on another page.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	int getShownStepIx(int step) {
+		int s = step - currentPageIx * numPageSteps;
+		return (s >= 0 && s < numPageSteps) ? s : -1;
+	}
+	// Show/edit a page of steps (reloads the shown steps).
+	void setEditPage(int pageIx);
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// Delete our goodies.
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-	
 	~TSSequencerModuleBase();
@@ -387,10 +541,22 @@ struct TSSequencerModuleBase : Module {
 	// Calculate a representation of all channels for this step
 	virtual float getPlayingStepValue(int step, int pattern) = 0;
 
-	// Initialize OSC on the given ip and ports.
-	void initOSC(const char* ipAddress, int outputPort, int inputPort);
+	// Initialize OSC on the given ip and ports (and output transport).
+	void initOSC(const char* ipAddress, int outputPort, int inputPort, TSOSCTransport transport = TSOSCTransport::UdpTransport);
 	// Clean up OSC.
 	void cleanupOSC();
+	// Send any OSC bundles queued during this step.
+	void flushOSC();
+	// Get the next external message to apply this sample (scheduled messages that are due, then new immediate ones).
+	bool getNextCtlMsg(/*out*/ TSExternalControlMessage& msg);
+	// Finish a state change bundle: tag it with the next sequence number, keep it for replays and queue it (caller must hold oscMutex).
+	void endOSCDelta(osc::OutboundPacketStream& oscStream);
+	// Queue a full snapshot of our play and edit state (caller must hold oscMutex).
+	void sendOSCSnapshot();
+	// Queue the kept state change bundles from this sequence number on (caller must hold oscMutex). False if some are gone.
+	bool replayOSCDeltas(int32_t fromSeq);
+	// Queue our OSC traffic counters (caller must hold oscMutex).
+	void sendOSCStats();
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// Set the OSC namespace.
 	// @oscNs: (IN) The namespace for OSC.
@@ -444,6 +610,98 @@ struct TSSequencerModuleBase : Module {
 		// DO nothing
 		return;
 	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// setScale()
+	// Set the note scale & root for a channel (voltSeq quantizes to it in NOTE mode).
+	// @channel : (IN) The channel (0 to TROWA_SEQ_NUM_CHNLS - 1, or < 0 for all).
+	// @scaleIx : (IN) The scale (TSScaleId).
+	// @root : (IN) The root (semitones above C).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	virtual void setScale(int channel, int scaleIx, int root) {
+		// Default: no scales
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// queueWidgetChange()
+	// Tell the widget something changed (it is picked up at the next UI step).
+	// Fill in widgetSnapshot first.
+	// @bits : (IN) The WidgetChangeBits (or 1 << KnobIx).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void queueWidgetChange(uint32_t bits) {
+		widgetChanges.fetch_or(bits, std::memory_order_release);
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// setControlKnob()
+	// Set a control knob's param and have the widget move the knob.
+	// @knobIx : (IN) The knob.
+	// @paramId : (IN) The knob's param.
+	// @val : (IN) The value.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void setControlKnob(KnobIx knobIx, int paramId, float val) {
+		params[paramId].value = val;
+		beginSnapshotWrite();
+		widgetSnapshot.knobValues[knobIx] = val;
+		endSnapshotWrite();
+		queueWidgetChange(1 << knobIx);
+		return;
+	}
+	// Set the step (pad) light color.
+	void setPadColor(NVGcolor color) {
+		beginSnapshotWrite();
+		widgetSnapshot.padColor = color;
+		endSnapshotWrite();
+		queueWidgetChange(PadColorChanged);
+		return;
+	}
+	// Set the paste and copy channel light colors.
+	void setClipboardColors(NVGcolor pasteColor, NVGcolor copyChannelColor) {
+		beginSnapshotWrite();
+		widgetSnapshot.pasteColor = pasteColor;
+		widgetSnapshot.copyChannelColor = copyChannelColor;
+		endSnapshotWrite();
+		queueWidgetChange(ClipboardColorsChanged);
+		return;
+	}
+	// Start writing widgetSnapshot (engine thread, the only writer). Version goes odd.
+	void beginSnapshotWrite() {
+		widgetSnapshotVersion.store(widgetSnapshotVersion.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		return;
+	}
+	// Done writing widgetSnapshot. Version goes even (call before queueWidgetChange()).
+	void endSnapshotWrite() {
+		widgetSnapshotVersion.store(widgetSnapshotVersion.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// readWidgetSnapshot()
+	// Copy widgetSnapshot without tearing (retries if the engine thread wrote it while
+	// we were copying). UI thread.
+	// @snapshot : (OUT) The copy.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void readWidgetSnapshot(/*out*/ WidgetSnapshot* snapshot) {
+		uint32_t v1, v2;
+		do {
+			v1 = widgetSnapshotVersion.load(std::memory_order_acquire);
+			if (v1 & 1)
+				continue; // Being written
+			*snapshot = widgetSnapshot;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			v2 = widgetSnapshotVersion.load(std::memory_order_relaxed);
+			if (v1 == v2)
+				break;
+		} while (true);
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// takeWidgetChanges()
+	// Get (and clear) the changes for the widget. UI thread.
+	// @returns : The WidgetChangeBits. Get the values with readWidgetSnapshot() after this.
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	uint32_t takeWidgetChanges() {
+		return widgetChanges.exchange(0, std::memory_order_acquire);
+	}
 
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// clearClipboard(void)
@@ -454,7 +712,7 @@ struct TSSequencerModuleBase : Module {
 		copySourcePatternIx = -1;
 		copySourceChannelIx = TROWA_SEQ_COPY_CHANNELIX_ALL; // Which trigger we are copying, -1 for all		
 		lights[COPY_CHANNEL_LIGHT].value = 0;		
-		pasteLight->setColor(COLOR_WHITE); // Return the paste light to white
+		setClipboardColors(COLOR_WHITE, widgetSnapshot.copyChannelColor); // Return the paste light to white
 		lights[COPY_PATTERN_LIGHT].value = 0;		
 		lights[PASTE_LIGHT].value = 0;			
 		return;
@@ -479,6 +737,9 @@ struct TSSequencerModuleBase : Module {
 		json_object_set_new(rootJ, "selectedOutputValueMode", json_integer((int) selectedOutputValueMode));
 		// Current BPM calculation note (i.e. 1/4, 1/8, 1/8T, 1/16)
 		json_object_set_new(rootJ, "selectedBPMNoteIx",  json_integer((int) selectedBPMNoteIx));
+		// The shown page of steps
+		if (numPages > 1)
+			json_object_set_new(rootJ, "currentPageIx", json_integer((int) currentPageIx));
 		
 		// triggers
 		json_t *triggersJ = json_array();
@@ -505,6 +766,16 @@ struct TSSequencerModuleBase : Module {
 		json_object_set_new(oscJ, "TxPort", json_integer(this->currentOSCSettings.oscTxPort));
 		json_object_set_new(oscJ, "RxPort", json_integer(this->currentOSCSettings.oscRxPort));
 		json_object_set_new(oscJ, "Client", json_integer(this->oscCurrentClient));
+		json_object_set_new(oscJ, "Transport", json_integer(this->currentOSCSettings.oscTransport));
+		json_t* mirrorsJ = json_array();
+		for (int i = 0; i < (int)this->currentOSCSettings.oscMirrors.size(); i++)
+		{
+			json_t* mirrorJ = json_object();
+			json_object_set_new(mirrorJ, "IpAddress", json_string(this->currentOSCSettings.oscMirrors[i].ipAddress.c_str()));
+			json_object_set_new(mirrorJ, "TxPort", json_integer(this->currentOSCSettings.oscMirrors[i].port));
+			json_array_append_new(mirrorsJ, mirrorJ);
+		}
+		json_object_set_new(oscJ, "Mirrors", mirrorsJ);
 		json_object_set_new(rootJ, "osc", oscJ);
 
 		return rootJ;
@@ -537,6 +808,9 @@ struct TSSequencerModuleBase : Module {
 		currJ = json_object_get(rootJ, "selectedBPMNoteIx");
 		if (currJ)
 			selectedBPMNoteIx = json_integer_value(currJ);
+		currJ = json_object_get(rootJ, "currentPageIx");
+		if (currJ)
+			currentPageIx = clampi((int)json_integer_value(currJ), 0, numPages - 1);
 		
 		// triggers
 		json_t *triggersJ = json_object_get(rootJ, "triggers");
@@ -576,6 +850,34 @@ struct TSSequencerModuleBase : Module {
 			currJ = json_object_get(oscJ, "Client");
 			if (currJ)
 				this->oscCurrentClient = static_cast<OSCClient>( (uint8_t)(json_integer_value(currJ)) );
+			currJ = json_object_get(oscJ, "Transport");
+			if (currJ)
+			{
+				int transport = (int)json_integer_value(currJ);
+				if (transport < 0 || transport >= TSOSCTransport::NUM_TSOSC_TRANSPORTS)
+					transport = TSOSCTransport::UdpTransport;
+				this->currentOSCSettings.oscTransport = static_cast<TSOSCTransport>(transport);
+				this->oscNewSettings.oscTransport = this->currentOSCSettings.oscTransport;
+			}
+			// Extra output targets (only set in the patch file): [ { "IpAddress" : "...", "TxPort" : n }, ... ]
+			json_t* mirrorsJ = json_object_get(oscJ, "Mirrors");
+			if (mirrorsJ && json_is_array(mirrorsJ))
+			{
+				this->currentOSCSettings.oscMirrors.clear();
+				for (int i = 0; i < (int)json_array_size(mirrorsJ); i++)
+				{
+					json_t* mirrorJ = json_array_get(mirrorsJ, i);
+					json_t* ipJ = json_object_get(mirrorJ, "IpAddress");
+					json_t* portJ = json_object_get(mirrorJ, "TxPort");
+					if (ipJ && portJ && json_is_string(ipJ))
+					{
+						TSOSCEndpoint mirror;
+						mirror.ipAddress = json_string_value(ipJ);
+						mirror.port = (uint16_t)(json_integer_value(portJ));
+						this->currentOSCSettings.oscMirrors.push_back(mirror);
+					}
+				}
+			}
 
 		}
 
@@ -597,30 +899,42 @@ struct TSSequencerModuleBase : Module {
 // A top digital display for trowaSoft sequencers.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 //===============================================================================
-struct TSSeqDisplay : TransparentWidget {
+struct TSSeqDisplay : TransparentWidget, TS_StaticLayerSource {
 	TSSequencerModuleBase *module;
 	std::shared_ptr<Font> font;
 	std::shared_ptr<Font> labelFont;
 	int fontSize;
 	char messageStr[TROWA_DISP_MSG_SIZE]; // tmp buffer for our strings.
 	bool showDisplay = true;
+	// Cached background, labels and group lines.
+	TS_StaticLayer* staticLayer;
+	// showDisplay when the static layer was drawn.
+	bool lastShowDisplay = true;
+	// BPM note index when the static layer was drawn.
+	int lastBPMNoteIx = -1;
+	// oscShowStats when the static layer was drawn.
+	bool lastShowStats = false;
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// TSSeqDisplay(void)
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	TSSeqDisplay() {
-		font = Font::load(assetPlugin(plugin, TROWA_DIGITAL_FONT));
-		labelFont = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_DIGITAL);
+		labelFont = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 12;
 		for (int i = 0; i < TROWA_DISP_MSG_SIZE; i++)
 			messageStr[i] = '\0';
 		showDisplay = true;
+		staticLayer = new TS_StaticLayer(this);
+		addChild(staticLayer);
 		return;
 	}
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-	// draw()
+	// drawStaticLayer()
+	// Background, labels and group lines. Only redrawn when our size, showDisplay
+	// or the BPM note changes.
 	// @vg : (IN) NVGcontext to draw on
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-	void draw(/*in*/ NVGcontext *vg) override {
+	void drawStaticLayer(/*in*/ NVGcontext *vg) override {
 		// Background Colors:
 		NVGcolor backgroundColor = nvgRGB(0x20, 0x20, 0x20);
 		NVGcolor borderColor = nvgRGB(0x10, 0x10, 0x10);
@@ -634,26 +948,17 @@ struct TSSeqDisplay : TransparentWidget {
 		nvgStrokeColor(vg, borderColor);
 		nvgStroke(vg);
 		
-		if (!showDisplay)
+		if (!showDisplay || module->oscShowStats)
 			return;
 
-		int currPlayPattern = module->currentPatternPlayingIx + 1;
-		int currEditPattern = module->currentPatternEditingIx + 1;
-		int currentGate = module->currentChannelEditingIx + 1;
-		int currentNSteps = module->currentNumberSteps;
-		float currentBPM = module->currentBPM;
-
 		// Default Font:
 		nvgFontSize(vg, fontSize);
-		nvgFontFaceId(vg, font->handle);
+		nvgFontFaceId(vg, labelFont->handle);
 		nvgTextLetterSpacing(vg, 2.5);
 
 		NVGcolor textColor = nvgRGB(0xee, 0xee, 0xee);
-		NVGcolor currColor = module->voiceColors[module->currentChannelEditingIx];
 		
 		int y1 = 42;
-		int y2 = 27;
-		int dx = 0;
 		int x = 0;
 		int spacing = 61;
 				
@@ -662,88 +967,26 @@ struct TSSeqDisplay : TransparentWidget {
 		// Current Playing Pattern
 		nvgFillColor(vg, textColor);
 		x = 5 + 21;
-		nvgFontSize(vg, fontSize); // Small font
-		nvgFontFaceId(vg, labelFont->handle);		
 		nvgText(vg, x, y1, "PATT", NULL);
-		sprintf(messageStr, "%02d", currPlayPattern);
-		nvgFontSize(vg, fontSize * 1.5);	// Large font
-		nvgFontFaceId(vg, font->handle);		
-		nvgText(vg, x + dx, y2, messageStr, NULL);
 		
 		// Current Playing Speed
-		nvgFillColor(vg, textColor);
 		x += spacing;
-		nvgFontSize(vg, fontSize); // Small font
-		nvgFontFaceId(vg, labelFont->handle);				
-		//nvgText(vg, x, y1, "BPM", NULL);		
 		sprintf(messageStr, "BPM/%s", BPMOptions[module->selectedBPMNoteIx]->label);		
 		nvgText(vg, x, y1, messageStr, NULL);		
-		// // BPM Note:
-		// nvgFontSize(vg, fontSize * 0.6); // Tiny font
-		// nvgTextLetterSpacing(vg, 1.0);
-		// nvgText(vg, x + 14, y1 - 1, BPMOptions[module->selectedBPMNoteIx]->label, NULL);						
-		// nvgTextLetterSpacing(vg, 2.5);						
-		if (module->lastStepWasExternalClock)
-		{
-			sprintf(messageStr, "%s", "CLK");
-		}
-		else
-		{
-			sprintf(messageStr, "%03.0f", currentBPM);
-		}
-		nvgFontFaceId(vg, font->handle);
-		nvgFontSize(vg, fontSize * 1.5); // Large font		
-		nvgText(vg, x + dx, y2, messageStr, NULL);
-		
 		
 		// Current Playing # Steps
-		nvgFillColor(vg, textColor);
 		x += spacing;
-		nvgFontSize(vg, fontSize); // Small font
-		nvgFontFaceId(vg, labelFont->handle);		
 		nvgText(vg, x, y1, "LENG", NULL);
-		sprintf(messageStr, "%02d", currentNSteps);
-		nvgFontSize(vg, fontSize * 1.5);	// Large font
-		nvgFontFaceId(vg, font->handle);				
-		nvgText(vg, x + dx, y2, messageStr, NULL);
 		
 		// Current Mode:
 		nvgFillColor(vg, nvgRGB(0xda, 0xda, 0xda));
 		x += spacing + 5;
-		nvgFontSize(vg, fontSize); // Small font
-		nvgFontFaceId(vg, labelFont->handle);						
 		nvgText(vg, x, y1, "MODE", NULL);
-		nvgFontSize(vg, fontSize);	// Small font
-		if (module->modeString != NULL)
-		{
-			nvgFontFaceId(vg, font->handle);					
-			//nvgText(vg, x + dx -6, y2, module->modeString, NULL);					
-			nvgText(vg, x + dx, y2, module->modeString, NULL);			
-		}
-
-		nvgTextAlign(vg, NVG_ALIGN_CENTER);
 
 		// Current Edit Pattern
 		nvgFillColor(vg, textColor);
 		x += spacing;
-		nvgFontSize(vg, fontSize); // Small font
-		nvgFontFaceId(vg, labelFont->handle);						
 		nvgText(vg, x, y1, "PATT", NULL);
-		sprintf(messageStr, "%02d", currEditPattern);
-		nvgFontSize(vg, fontSize * 1.5);	// Large font
-		nvgFontFaceId(vg, font->handle);		
-		nvgText(vg, x + dx, y2, messageStr, NULL);
-
-		// Current Edit Gate/Trigger
-		nvgFillColor(vg, currColor); // Match the Gate/Trigger color
-		x += spacing;
-		nvgFontSize(vg, fontSize); // Small font
-		nvgFontFaceId(vg, labelFont->handle);						
-		nvgText(vg, x, y1, "CHNL", NULL);
-		sprintf(messageStr, "%02d", currentGate);
-		nvgFontSize(vg, fontSize * 1.5);	// Large font
-		nvgFontFaceId(vg, font->handle);				
-		nvgText(vg, x + dx, y2, messageStr, NULL);
 		
 		// [[[[[[[[[[[[[[[[ EDIT Box Group ]]]]]]]]]]]]]]]]]]]]]]]]]]]]]
 		nvgTextAlign(vg, NVG_ALIGN_LEFT);		
@@ -752,7 +995,6 @@ struct TSSeqDisplay : TransparentWidget {
 		int labelX = 297;
 		x = labelX; // 289
 		nvgFontSize(vg, fontSize-5); // Small font
-		nvgFontFaceId(vg, labelFont->handle);				
 		nvgText(vg, x, 8, "EDIT", NULL);
 				
 		// Edit Label Line ---------------------------------------------------------------
@@ -799,33 +1041,212 @@ struct TSSeqDisplay : TransparentWidget {
 		nvgStrokeColor(vg, groupColor);
 		nvgStroke(vg);
 		return;
+	} // end drawStaticLayer()
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// step()
+	// Invalidate the static layer if anything it shows changed. Done before the
+	// children step since FramebufferWidget re-renders in step(), not draw().
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void step() override {
+		staticLayer->setSize(box.size);
+		if (showDisplay != lastShowDisplay || module->selectedBPMNoteIx != lastBPMNoteIx || module->oscShowStats != lastShowStats)
+		{
+			lastShowDisplay = showDisplay;
+			lastBPMNoteIx = module->selectedBPMNoteIx;
+			lastShowStats = module->oscShowStats;
+			staticLayer->dirty = true;
+		}
+		TransparentWidget::step();
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// draw()
+	// @vg : (IN) NVGcontext to draw on
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void draw(/*in*/ NVGcontext *vg) override {
+		// Static layer (cached):
+		Widget::draw(vg);
+		
+		if (!showDisplay)
+			return;
+		if (module->oscShowStats)
+		{
+			drawOSCStats(vg);
+			return;
+		}
+
+		int currPlayPattern = module->currentPatternPlayingIx + 1;
+		int currEditPattern = module->currentPatternEditingIx + 1;
+		int currentGate = module->currentChannelEditingIx + 1;
+		int currentNSteps = module->currentNumberSteps;
+		float currentBPM = module->currentBPM;
+
+		// Default Font:
+		nvgFontSize(vg, fontSize * 1.5);	// Large font
+		nvgFontFaceId(vg, font->handle);
+		nvgTextLetterSpacing(vg, 2.5);
+
+		NVGcolor textColor = nvgRGB(0xee, 0xee, 0xee);
+		NVGcolor currColor = module->voiceColors[module->currentChannelEditingIx];
+		
+		int y1 = 42;
+		int y2 = 27;
+		int dx = 0;
+		int x = 0;
+		int spacing = 61;
+				
+		nvgTextAlign(vg, NVG_ALIGN_CENTER);
+
+		// Current Playing Pattern
+		nvgFillColor(vg, textColor);
+		x = 5 + 21;
+		sprintf(messageStr, "%02d", currPlayPattern);
+		nvgText(vg, x + dx, y2, messageStr, NULL);
+		
+		// Current Playing Speed
+		x += spacing;
+		if (module->lastStepWasExternalClock)
+		{
+			sprintf(messageStr, "%s", "CLK");
+		}
+		else
+		{
+			sprintf(messageStr, "%03.0f", currentBPM);
+		}
+		nvgText(vg, x + dx, y2, messageStr, NULL);
+		
+		// Current Playing # Steps
+		x += spacing;
+		sprintf(messageStr, "%02d", currentNSteps);
+		nvgText(vg, x + dx, y2, messageStr, NULL);
+		
+		// Current Mode:
+		nvgFillColor(vg, nvgRGB(0xda, 0xda, 0xda));
+		x += spacing + 5;
+		if (module->modeString != NULL)
+		{
+			nvgFontSize(vg, fontSize);	// Small font
+			nvgText(vg, x + dx, y2, module->modeString, NULL);			
+			nvgFontSize(vg, fontSize * 1.5);	// Large font
+		}
+
+		// Current Edit Pattern
+		nvgFillColor(vg, textColor);
+		x += spacing;
+		sprintf(messageStr, "%02d", currEditPattern);
+		nvgText(vg, x + dx, y2, messageStr, NULL);
+
+		// Current Edit Gate/Trigger
+		nvgFillColor(vg, currColor); // Match the Gate/Trigger color
+		x += spacing;
+		sprintf(messageStr, "%02d", currentGate);
+		nvgText(vg, x + dx, y2, messageStr, NULL);
+		// Label is also in the Gate/Trigger color (so it is drawn here)
+		nvgFontSize(vg, fontSize); // Small font
+		nvgFontFaceId(vg, labelFont->handle);						
+		nvgText(vg, x, y1, "CHNL", NULL);
+		return;
 	} // end draw()
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// drawOSCStats()
+	// Debug panel: the module's OSC traffic counters instead of the normal info.
+	// @vg : (IN) NVGcontext to draw on
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void drawOSCStats(/*in*/ NVGcontext *vg)
+	{
+		TSOSCStats& stats = module->oscStats;
+		char buffer[80];
+		// Latency percentiles (upper bound of the bucket)
+		uint32_t total = 0;
+		for (int i = 0; i < TSOSC_STATS_LATENCY_BUCKETS; i++)
+			total += stats.latency[i].load(std::memory_order_relaxed);
+		int p50 = -1, p99 = -1;
+		uint32_t n = 0;
+		for (int i = 0; i < TSOSC_STATS_LATENCY_BUCKETS && total > 0; i++)
+		{
+			n += stats.latency[i].load(std::memory_order_relaxed);
+			if (p50 < 0 && n * 2 >= total)
+				p50 = i;
+			if (p99 < 0 && n * 100 >= total * 99)
+				p99 = i;
+		}
+		nvgFontSize(vg, fontSize * 0.9);
+		nvgFontFaceId(vg, labelFont->handle);
+		nvgTextLetterSpacing(vg, 1);
+		nvgTextAlign(vg, NVG_ALIGN_LEFT);
+		nvgFillColor(vg, nvgRGB(0xee, 0xee, 0xee));
+		int x = 8;
+		snprintf(buffer, sizeof(buffer), "OUT %u PKT %u KB   IN %u MSG %u KB", stats.packetsOut.load(), stats.bytesOut.load() / 1024,
+			stats.messagesIn.load(), stats.bytesIn.load() / 1024);
+		nvgText(vg, x, 16, buffer, NULL);
+		snprintf(buffer, sizeof(buffer), "QUEUE MAX %u   DROP %u   ERR %u   UNK %u", stats.queueHighWater.load(), stats.drops.load(),
+			stats.parseErrors.load(), stats.unknownMessages.load());
+		nvgText(vg, x, 30, buffer, NULL);
+		if (total > 0)
+			snprintf(buffer, sizeof(buffer), "LATENCY P50 <%uus  P99 <%uus   HANDLE MAX %uus", 1u << p50, 1u << p99, stats.handleMaxUs.load());
+		else
+			snprintf(buffer, sizeof(buffer), "LATENCY -   HANDLE MAX %uus", stats.handleMaxUs.load());
+		nvgText(vg, x, 44, buffer, NULL);
+		return;
+	} // end drawOSCStats()
 }; // end struct TSSeqDisplay
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // TSSeqLabelArea
 // Draw labels on our sequencer.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-struct TSSeqLabelArea : TransparentWidget {
+struct TSSeqLabelArea : TransparentWidget, TS_StaticLayerSource {
 	TSSequencerModuleBase *module;
 	std::shared_ptr<Font> font;
 	int fontSize;
 	bool drawGridLines = false;
 	char messageStr[TROWA_DISP_MSG_SIZE];
+	// Cached labels (everything we draw is static).
+	TS_StaticLayer* staticLayer;
+	// allowOSC when the static layer was drawn.
+	bool lastAllowOSC = false;
+	// drawGridLines when the static layer was drawn.
+	bool lastDrawGridLines = false;
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// TSSeqLabelArea()
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	TSSeqLabelArea() {
-		font = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 13;
 		for (int i = 0; i < TROWA_DISP_MSG_SIZE; i++)
 			messageStr[i] = '\0';		
+		staticLayer = new TS_StaticLayer(this);
+		addChild(staticLayer);
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// step()
+	// Invalidate the cached labels if something changed (before the layer steps and re-renders).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-	
+	void step() override {
+		staticLayer->setSize(box.size);
+		if (module->allowOSC != lastAllowOSC || drawGridLines != lastDrawGridLines)
+		{
+			lastAllowOSC = module->allowOSC;
+			lastDrawGridLines = drawGridLines;
+			staticLayer->dirty = true;
+		}
+		TransparentWidget::step();
+		return;
 	}
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 	// draw()
+	// Draws the cached labels.
 	// @vg : (IN) NVGcontext to draw on
 	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-	
-	void draw(NVGcontext *vg) override {		
+	void draw(NVGcontext *vg) override {
+		Widget::draw(vg);
+		return;
+	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// drawStaticLayer()
+	// @vg : (IN) NVGcontext to draw on
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-	
+	void drawStaticLayer(NVGcontext *vg) override {		
 		// Default Font:
 		nvgFontSize(vg, fontSize);
 		nvgFontFaceId(vg, font->handle);
@@ -914,7 +1335,7 @@ struct TSSeqLabelArea : TransparentWidget {
 		}
 		
 		return;
-	} // end draw()
+	} // end drawStaticLayer()
 }; // end struct TSSeqLabelArea
 
 #endif
\ No newline at end of file
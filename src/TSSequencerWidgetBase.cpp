@@ -9,6 +9,7 @@ using namespace rack;
 #include "TSSequencerModuleBase.hpp"
 //#include "TSTextField.hpp"
 #include "TSOSCConfigWidget.hpp"
+#include "TSOSCDiscovery.hpp"
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // Base constructor.
@@ -233,6 +234,35 @@ void TSSequencerWidgetBase::step()
 {
 	TSSequencerModuleBase* thisModule = dynamic_cast<TSSequencerModuleBase*>(module);
 
+	// Advertise (or withdraw) our OSC service when the module connects (or disconnects).
+	// Done here, not in initOSC()/cleanupOSC(), to keep the socket work off the engine thread.
+	{
+		std::unique_lock<std::mutex> oscLock(thisModule->oscMutex, std::try_to_lock);
+		if (oscLock.owns_lock()) // Else the module is busy with OSC, try next step.
+		{
+			uint32_t version = (thisModule->oscInitialized) ? thisModule->oscServiceVersion : 0;
+			if (version != oscAdvertisedVersion)
+			{
+				TSOSCServiceInfo service = thisModule->oscService;
+				std::string remoteHost = thisModule->currentOSCSettings.oscTxIpAddress;
+				oscLock.unlock();
+				if (version == 0)
+				{
+					TSOSCDiscovery::Get()->withdraw(thisModule->oscId);
+				}
+				else
+				{
+					service.host = TSOSCDiscovery::LocalHostFor(remoteHost);
+					TSOSCDiscovery::Get()->advertise(service);
+				}
+				oscAdvertisedVersion = version;
+			}
+		}
+	}
+	// Re-announce our OSC services now and then (rate limited by the provider).
+	if (oscAdvertisedVersion > 0)
+		TSOSCDiscovery::Get()->poll();
+
 	if (thisModule->oscConfigTrigger.process(thisModule->params[TSSequencerModuleBase::ParamIds::OSC_SHOW_CONF_PARAM].value))
 	{
 		thisModule->oscShowConfigurationScreen = !thisModule->oscShowConfigurationScreen;
@@ -243,13 +273,15 @@ void TSSequencerWidgetBase::step()
 		{
 			if (!thisModule->oscInitialized)
 			{
-				// Make sure the ports are available
-				int p = TSOSCConnector::PortInUse(thisModule->currentOSCSettings.oscTxPort);
-				if (p > 0 && p != thisModule->oscId)
-					thisModule->currentOSCSettings.oscTxPort = TSOSCConnector::GetAvailablePort(thisModule->oscId, thisModule->currentOSCSettings.oscTxPort);
-				p = TSOSCConnector::PortInUse(thisModule->currentOSCSettings.oscRxPort);
-				if (p > 0 && p != thisModule->oscId)
-					thisModule->currentOSCSettings.oscRxPort = TSOSCConnector::GetAvailablePort(thisModule->oscId, thisModule->currentOSCSettings.oscRxPort);
+				// Suggest ports that don't collide with what the other modules advertise
+				// (the port registry still has the final say when we connect).
+				std::vector<TSOSCServiceInfo> services = TSOSCDiscovery::Get()->browse();
+				uint16_t port = TSOSCDiscovery::FreePort(services, thisModule->oscId, thisModule->currentOSCSettings.oscTxPort, /*forReceive*/ false);
+				if (port > 0)
+					thisModule->currentOSCSettings.oscTxPort = port;
+				port = TSOSCDiscovery::FreePort(services, thisModule->oscId, thisModule->currentOSCSettings.oscRxPort, /*forReceive*/ true);
+				if (port > 0)
+					thisModule->currentOSCSettings.oscRxPort = port;
 
 			}
 			this->oscConfigurationScreen->setValues(thisModule->currentOSCSettings.oscTxIpAddress, thisModule->currentOSCSettings.oscTxPort, thisModule->currentOSCSettings.oscRxPort);
@@ -335,6 +367,11 @@ void TSSequencerWidgetBase::step()
 			this->oscConfigurationScreen->statusMsg = OSCClientAbbr[thisModule->oscCurrentClient] + " " + thisModule->currentOSCSettings.oscTxIpAddress;
 			this->oscConfigurationScreen->statusMsg2 = ":" + std::to_string(thisModule->currentOSCSettings.oscTxPort)
 				+ " :" + std::to_string(thisModule->currentOSCSettings.oscRxPort);
+			if (thisModule->currentOSCSettings.oscTransport != TSOSCTransport::UdpTransport)
+				this->oscConfigurationScreen->statusMsg2 = TSOSCTransportStr[thisModule->currentOSCSettings.oscTransport] + " " + this->oscConfigurationScreen->statusMsg2;
+			int nMirrors = thisModule->oscSendBatch.numMirrors();
+			if (nMirrors > 0)
+				this->oscConfigurationScreen->statusMsg2 += " +" + std::to_string(nMirrors) + " mirror(s)";
 			this->oscConfigurationScreen->btnActionEnable = false;
 		}
 		else
@@ -346,9 +383,54 @@ void TSSequencerWidgetBase::step()
 		}
 	} // end if show OSC config screen
 
+	// Module -> widget changes (the module never touches our widgets from the engine thread)
+	uint32_t changes = thisModule->takeWidgetChanges();
+	if (changes)
+		applyModuleChanges(thisModule, changes);
+
 	ModuleWidget::step();
 	return;
 } // end step()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// applyModuleChanges()
+// Apply the changes the module queued for us (control knobs, pad & clipboard light colors).
+// @thisModule : (IN) Our module.
+// @changes : (IN) The TSSequencerModuleBase::WidgetChangeBits (from takeWidgetChanges()).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+void TSSequencerWidgetBase::applyModuleChanges(TSSequencerModuleBase* thisModule, uint32_t changes)
+{
+	// Consistent copy (the engine thread may be writing the snapshot right now).
+	TSSequencerModuleBase::WidgetSnapshot snapshot;
+	thisModule->readWidgetSnapshot(&snapshot);
+	for (int i = 0; i < TSSequencerModuleBase::KnobIx::NumKnobs; i++)
+	{
+		SVGKnob* knob = thisModule->controlKnobs[i];
+		if (changes & TSSequencerModuleBase::WidgetChangeBits::KnobDefaultsChanged)
+		{
+			knob->value = knob->defaultValue;
+			knob->dirty = true;
+		}
+		else if (changes & (1 << i))
+		{
+			knob->value = snapshot.knobValues[i];
+			knob->dirty = true;
+		}
+	}
+	if (changes & TSSequencerModuleBase::WidgetChangeBits::PadColorChanged)
+	{
+		for (int r = 0; r < thisModule->numRows; r++)
+		{
+			for (int c = 0; c < thisModule->numCols; c++)
+				thisModule->padLightPtrs[r][c]->setColor(snapshot.padColor);
+		}
+	}
+	if (changes & TSSequencerModuleBase::WidgetChangeBits::ClipboardColorsChanged)
+	{
+		thisModule->pasteLight->setColor(snapshot.pasteColor);
+		thisModule->copyGateLight->setColor(snapshot.copyChannelColor);
+	}
+	return;
+} // end applyModuleChanges()
 
 struct seqRandomSubMenuItem : MenuItem {
 	TSSequencerModuleBase* sequencerModule;
@@ -429,10 +511,63 @@ struct seqRandomMenuItem : MenuItem {
 	}
 };
 
+// OSC output transport option (UDP or a SLIP framed stream).
+struct seqOSCTransportMenuItem : MenuItem {
+	TSSequencerModuleBase* sequencerModule;
+	TSOSCTransport transport;
+
+	seqOSCTransportMenuItem(TSOSCTransport transport, TSSequencerModuleBase* seqModule)
+	{
+		this->text = TSOSCTransportStr[transport];
+		this->transport = transport;
+		this->sequencerModule = seqModule;
+		return;
+	}
+	void onAction(EventAction &e) override {
+		sequencerModule->oscNewSettings.oscTransport = transport;
+		if (sequencerModule->oscInitialized && sequencerModule->currentOSCSettings.oscTransport != transport)
+		{
+			// Reconnect with the new transport.
+			sequencerModule->oscNewSettings.oscTxIpAddress = sequencerModule->currentOSCSettings.oscTxIpAddress;
+			sequencerModule->oscNewSettings.oscTxPort = sequencerModule->currentOSCSettings.oscTxPort;
+			sequencerModule->oscNewSettings.oscRxPort = sequencerModule->currentOSCSettings.oscRxPort;
+			sequencerModule->oscCurrentAction = TSSequencerModuleBase::OSCAction::Enable;
+		}
+		else
+		{
+			sequencerModule->currentOSCSettings.oscTransport = transport;
+		}
+		return;
+	}
+	void step() override {
+		rightText = (sequencerModule->oscNewSettings.oscTransport == transport) ? "✔" : "";
+		MenuItem::step();
+	}
+};
+
+// Show the OSC stats debug panel on the display.
+struct seqOSCStatsMenuItem : MenuItem {
+	TSSequencerModuleBase* sequencerModule;
+
+	seqOSCStatsMenuItem(TSSequencerModuleBase* seqModule)
+	{
+		this->text = "Show OSC Stats";
+		this->sequencerModule = seqModule;
+		return;
+	}
+	void onAction(EventAction &e) override {
+		sequencerModule->oscShowStats = !sequencerModule->oscShowStats;
+		return;
+	}
+	void step() override {
+		rightText = (sequencerModule->oscShowStats) ? "✔" : "";
+		MenuItem::step();
+	}
+};
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // createContextMenu()
-// Create context menu with more random options for sequencers.
+// Create context menu with more random options (and the OSC output transport) for sequencers.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 Menu *TSSequencerWidgetBase::createContextMenu()
 {
@@ -449,5 +584,20 @@ Menu *TSSequencerWidgetBase::createContextMenu()
 	menu->addChild(modeLabel); //menu->pushChild(modeLabel);
 	menu->addChild(new seqRandomMenuItem("> All Steps Random", false, sequencerModule));
 	menu->addChild(new seqRandomMenuItem("> Structured Random", true, sequencerModule));
+
+	//-------- OSC Transport ------- //
+	menu->addChild(new MenuLabel());
+	MenuLabel *transportLabel = new MenuLabel();
+	transportLabel->text = "OSC Output Transport";
+	menu->addChild(transportLabel);
+	for (int i = 0; i < TSOSCTransport::NUM_TSOSC_TRANSPORTS; i++)
+	{
+#if defined(_WIN32)
+		if (i == TSOSCTransport::UnixSlipTransport)
+			continue; // No local sockets
+#endif
+		menu->addChild(new seqOSCTransportMenuItem(static_cast<TSOSCTransport>(i), sequencerModule));
+	}
+	menu->addChild(new seqOSCStatsMenuItem(sequencerModule));
 	return menu;
 }
\ No newline at end of file
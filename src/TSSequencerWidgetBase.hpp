@@ -9,6 +9,7 @@ using namespace rack;
 #include "TSOSCConfigWidget.hpp"
 
 struct TSSeqDisplay;
+struct TSSequencerModuleBase;
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // TSSequencerWidgetBase
@@ -19,10 +20,14 @@ struct TSSequencerWidgetBase : TSSModuleWidgetBase {
 	TSSeqDisplay *display;
 	// OSC configuration widget.
 	TSOSCConfigWidget* oscConfigurationScreen;
+	// The module's oscServiceVersion we last advertised (0 if not advertised).
+	uint32_t oscAdvertisedVersion = 0;
 	// Instantiate a widget.
 	TSSequencerWidgetBase();
 	// Step
 	void step() override;
+	// Apply the changes the module queued for us (TSSequencerModuleBase::WidgetChangeBits).
+	virtual void applyModuleChanges(TSSequencerModuleBase* thisModule, uint32_t changes);
 	// Add base controls.
 	void addBaseControls() { addBaseControls(false); }
 	// Add base controls.
@@ -30,19 +30,35 @@ void TSTextField::requestFocus() {
 // Remove invalid chars from input.
 std::string TSTextField::cleanseString(std::string newText)
 {
-	if (allowedTextType == TextType::Any)
+	if (allowedCharClass == 0)
 	{
 		return newText.substr(0, maxLength);
 	}
 	else
 	{
 		// Remove invalid chars
-		std::stringstream cleansedStr;
-		// Issue: https://github.com/j4s0n-c/trowaSoft-VCV/issues/5. Changed from string constant (emtpy string "") to string object empty string ("") to older Linux compilers. Thx to @Chaircrusher.
-		std::regex_replace(std::ostream_iterator<char>(cleansedStr), newText.begin(), newText.end(), regexInvalidChar, std::string(""));
-		return cleansedStr.str().substr(0, maxLength);
+		return TSCharClass::cleanseString(newText, allowedCharClass, maxLength);
 	}
 } // end cleanseString()
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// isValidText()
+// @textType : (IN) The text type.
+// @text : (IN) The text.
+// @returns: True if the text is valid for the type (digits only may be empty).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+bool TSTextField::isValidText(TextType textType, const std::string& text)
+{
+	switch (textType)
+	{
+	case TextType::DigitsOnly:
+		return TSCharClass::isValidDigits(text);
+	case TextType::IpAddress:
+		return isValidIpAddress(text);
+	case TextType::Any:
+	default:
+		return true;
+	}
+} // end isValidText()
 
 // Remove invalid chars
 void TSTextField::insertText(std::string newText) {
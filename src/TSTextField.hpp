@@ -6,24 +6,9 @@
 
 using namespace rack;
 
-#include <iostream>
-#include <regex>
-#include <sstream>
 #include <string>
-
-// Integer/Digits: Entire string validation
-#define TROWA_REGEX_NUMERIC_STR_ONLY		"^[0-9]*$"
-// Integer/Digits: Single char validation
-#define TROWA_REGEX_NUMERIC_CHAR_ONLY		"^[0-9]$"
-// Integer/Digits: Not an digit
-#define TROWA_REGEX_NUMERIC_CHAR_NOT		"[^0-9]"
-
-// IP Address: Entire string validation
-#define TROWA_REGEX_IP_ADDRESS			 "^(?:(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\.){3}(?:25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)$" 
-// IP Address: Single char validation
-#define TROWA_REGEX_IP_CHAR				"^([0-9]|\\.)$"
-// IP Address: Not a valid character 
-#define TROWA_REGEX_IP_CHAR_NOT		"[^0-9\\.]"
+#include <stdint.h>
+#include "TSCharClass.hpp"
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // isPrintableKey()
@@ -36,7 +21,7 @@ bool isPrintableKey(int keyCode);
 // TSTextField - overload rack TextField
 // trowaSoft text field with some basic validation and character limiting enforced.
 // 1. Consume invalid characters and throw away.
-// 2. Validate (regex) input (can be checked with IsValid()).
+// 2. Validate input (can be checked with IsValid()).
 // 3. Limit input length (with maxLength).
 /// TODO: Implement scrolling and cropping so that characters can't break out of the field box.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
@@ -64,7 +49,7 @@ struct TSTextField : TextField {
 
 	// Text type for validation of input.
 	enum TextType {
-		// Any text allowed (i.e. no regex check).
+		// Any text allowed (i.e. no check).
 		Any,
 		// Digits only (no decimals even).
 		DigitsOnly,
@@ -73,12 +58,8 @@ struct TSTextField : TextField {
 	};
 	// Text type for validation of input.
 	TextType allowedTextType = TextType::Any;
-	// Regex for a single char.
-	std::regex regexChar;
-	// Regex for the entire string.
-	std::regex regexStr;
-	// Regex for invalid characters (to match on invalid and remove).
-	std::regex regexInvalidChar;
+	// Character class bit (TROWA_CHARCLASS_*) of allowed characters (0 for any).
+	uint8_t allowedCharClass = 0;
 
 	TSTextField(TextType textType) : TextField() {
 		setTextType(textType);
@@ -104,8 +85,7 @@ struct TSTextField : TextField {
 
 	// If the text is valid.
 	bool isValid() {
-		return (allowedTextType == TextType::Any
-			|| std::regex_match(text, regexStr));
+		return isValidText(allowedTextType, text);
 	}
 	// Set the text type/validation
 	void setTextType(TextType validationType)
@@ -114,21 +94,28 @@ struct TSTextField : TextField {
 		switch (allowedTextType)
 		{
 		case TextType::DigitsOnly:
-			regexChar = std::regex(TROWA_REGEX_NUMERIC_CHAR_ONLY);
-			regexStr = std::regex(TROWA_REGEX_NUMERIC_STR_ONLY);
-			regexInvalidChar = std::regex(TROWA_REGEX_NUMERIC_CHAR_NOT);
+			allowedCharClass = TROWA_CHARCLASS_DIGIT;
 			break;
 		case TextType::IpAddress:
-			regexChar = std::regex(TROWA_REGEX_IP_CHAR);
-			regexStr = std::regex(TROWA_REGEX_IP_ADDRESS);
-			regexInvalidChar = std::regex(TROWA_REGEX_IP_CHAR_NOT);
+			allowedCharClass = TROWA_CHARCLASS_IP;
 			break;
 		case TextType::Any:
 		default:
+			allowedCharClass = 0;
 			break;
 		}
 		return;
 	}
+	// If the text is valid for the text type.
+	static bool isValidText(TextType textType, const std::string& text);
+	// If the text is a valid IPv4 address (dotted quad, i.e. 127.0.0.1).
+	static bool isValidIpAddress(const std::string& text) {
+		return TSCharClass::isValidIpAddress(text);
+	}
+	// If the text is a valid port number (0-65535).
+	static bool isValidPort(const std::string& text) {
+		return TSCharClass::isValidPort(text);
+	}
 	// Remove invalid chars.
 	std::string cleanseString(std::string newText);
 	void draw(NVGcontext *vg) override;
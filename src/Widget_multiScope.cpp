@@ -10,7 +10,6 @@ using namespace trowaSoft;
 
 #define SCREW_DIAMETER						 15
 #define TROWA_WIDGET_TOP_BAR_HEIGHT	 		 15
-#define	TROWA_SCOPE_INPUT_AREA_WIDTH		365  // 295 265
 #define TROWA_SCOPE_MIN_SCOPE_AREA_WIDTH	(240 - RACK_GRID_WIDTH) // 240-RACK_GRID_WIDTH
 #define TROWA_SCOPE_DISPLAY_AREA_WIDTH		400 
 #define KNOB_X	0
@@ -26,11 +25,15 @@ using namespace trowaSoft;
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // multiScopeWidget(void)
 // Instantiate a multiScope widget.
+// @numWaveforms : (IN) Number of waveforms / shapes.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-multiScopeWidget::multiScopeWidget()
+multiScopeWidget::multiScopeWidget(int numWaveforms)
 {
+	numWaveforms = clampi(numWaveforms, 1, TROWA_SCOPE_MAX_NUM_WAVEFORMS);
+	this->numWaveforms = numWaveforms;
 	// Calculate Sizes:	
-	this->inputAreaWidth = TROWA_SCOPE_INPUT_AREA_WIDTH;
+	int numColumns = (numWaveforms + TROWA_SCOPE_WAVEFORMS_PER_COLUMN - 1) / TROWA_SCOPE_WAVEFORMS_PER_COLUMN;
+	this->inputAreaWidth = TROWA_SCOPE_INPUT_AREA_WIDTH * numColumns;
 	int borderSize = TROWA_WIDGET_TOP_BAR_HEIGHT; // Size of the top and bottom borders
 
 	// Minimum widget width:
@@ -46,7 +49,7 @@ multiScopeWidget::multiScopeWidget()
 	box.size = Vec(RACK_GRID_WIDTH*w, RACK_GRID_HEIGHT);
 
 	// Create module:
-	multiScope *module = new multiScope();
+	multiScope *module = new multiScope(numWaveforms);
 	setModule(module);	
 	
 	// Border color for panels
@@ -56,15 +59,18 @@ multiScopeWidget::multiScopeWidget()
 	////////////////////////////////////
 	// LHS Panel (with controls)
 	////////////////////////////////////
+	for (int c = 0; c < numColumns; c++)
 	{
-		TS_SVGPanel *svgpanel = new TS_SVGPanel(/*top*/ borderWidth, /*right*/ 0, /*bottom*/ borderWidth, /*left*/ borderWidth);
+		// One panel per column of controls
+		TS_SVGPanel *svgpanel = new TS_SVGPanel(/*top*/ borderWidth, /*right*/ 0, /*bottom*/ borderWidth, /*left*/ (c == 0) ? borderWidth : 0);
 		svgpanel->borderColor = borderColor;
-		svgpanel->box.size = Vec(inputAreaWidth, RACK_GRID_HEIGHT);
-		svgpanel->setBackground(SVG::load(assetPlugin(plugin, "res/multiScope.svg")));
+		svgpanel->box.pos = Vec(c * TROWA_SCOPE_INPUT_AREA_WIDTH, 0);
+		svgpanel->box.size = Vec(TROWA_SCOPE_INPUT_AREA_WIDTH, RACK_GRID_HEIGHT);
+		svgpanel->setBackground(TSAssets::svg(TS_SVG_PANEL_MULTISCOPE));
 		addChild(svgpanel);
 	}
 
-	int controlDisplayHeight = 64; // 56
+	int controlDisplayHeight = 16 * (numWaveforms + 1); // 64 for 3 waveforms
 	int controlDisplayY = 24;
 	////////////////////////////////////
 	// Labels
@@ -108,20 +114,20 @@ multiScopeWidget::multiScopeWidget()
 		TS_SVGPanel *svgpanel = new TS_SVGPanel(/*top*/ borderWidth, /*right*/ borderWidth, /*bottom*/ borderWidth, /*left*/ 0);
 		svgpanel->box.size = Vec(RACK_GRID_WIDTH, RACK_GRID_HEIGHT);
 		svgpanel->borderColor = borderColor;
-		svgpanel->setBackground(SVG::load(assetPlugin(plugin, "res/multiScope.svg")));
+		svgpanel->setBackground(TSAssets::svg(TS_SVG_PANEL_MULTISCOPE));
 
 		//========== Single Controls ================
 		// Turn Display On/Off (Default is On)
-		TS_PadSwitch* displayToggleBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(20, 20), module, multiScope::INFO_DISPLAY_TOGGLE_PARAM, 0, 1, 1));
+		TS_PadSwitch* displayToggleBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(20, 20), module, module->paramId(multiScope::INFO_DISPLAY_TOGGLE_PARAM), 0, 1, 1));
 		displayToggleBtn->box.size = tinyBtnSize;
 		displayToggleBtn->value = 1.0;
-		ColorValueLight* displayLED = TS_createColorValueLight<ColorValueLight>(displayToggleBtn->box.pos, module, multiScope::INFO_DISPLAY_TOGGLE_LED, tinyBtnSize, TROWA_SCOPE_INFO_DISPLAY_ON_COLOR);
+		ColorValueLight* displayLED = TS_createColorValueLight<ColorValueLight>(displayToggleBtn->box.pos, module, module->lightId(multiScope::INFO_DISPLAY_TOGGLE_LED), tinyBtnSize, TROWA_SCOPE_INFO_DISPLAY_ON_COLOR);
 
 		// Background Color
-		TS_PadSwitch* colorDisplayToggleBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(20, 65), module, multiScope::BGCOLOR_DISPLAY_PARAM, 0, 1, 1));
+		TS_PadSwitch* colorDisplayToggleBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(20, 65), module, module->paramId(multiScope::BGCOLOR_DISPLAY_PARAM), 0, 1, 1));
 		colorDisplayToggleBtn->box.size = tinyBtnSize;
 		colorDisplayToggleBtn->value = 1.0;
-		ColorValueLight* colorDisplayLED = TS_createColorValueLight<ColorValueLight>(colorDisplayToggleBtn->box.pos, module, multiScope::BGCOLOR_DISPLAY_LED, tinyBtnSize, TROWA_SCOPE_INFO_DISPLAY_ON_COLOR);
+		ColorValueLight* colorDisplayLED = TS_createColorValueLight<ColorValueLight>(colorDisplayToggleBtn->box.pos, module, module->lightId(multiScope::BGCOLOR_DISPLAY_LED), tinyBtnSize, TROWA_SCOPE_INFO_DISPLAY_ON_COLOR);
 
 		TSScopeModuleResizeHandle* rightHandle = new TSScopeModuleResizeHandle(minimumWidgetWidth, svgpanel, displayToggleBtn, displayLED);
 		rightHandle->colorDisplayToggleBtn = colorDisplayToggleBtn;
@@ -143,7 +149,7 @@ multiScopeWidget::multiScopeWidget()
 		addParam(colorDisplayToggleBtn);
 		addChild(colorDisplayLED);
 #endif
-		module->lights[multiScope::INFO_DISPLAY_TOGGLE_LED].value = 1.0;
+		module->lights[module->lightId(multiScope::INFO_DISPLAY_TOGGLE_LED)].value = 1.0;
 		module->infoDisplayOnTrigger.state = SchmittTrigger::HIGH;
 	}
 
@@ -152,23 +158,22 @@ multiScopeWidget::multiScopeWidget()
 	////////////////////////////////////		
 	int wIx = 0;
 	int scopeGraphWidth = box.size.x - inputAreaWidth - this->rightHandle->box.size.x;
-	for (wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
 	{
-		//info("Adding scope area %d.", wIx);
+		// One display draws all the waveforms
 		multiScopeDisplay* scopeArea = new multiScopeDisplay();
-		scopeArea->wIx = wIx;
 		scopeArea->module = module;
+		scopeArea->setNumWaveforms(numWaveforms);
 		scopeArea->box.pos = Vec(inputAreaWidth - 1, borderSize);
 		scopeArea->box.size = Vec(scopeGraphWidth, scopeGraphHeight);
 		addChild(scopeArea);
-		this->display[wIx] = scopeArea;
+		this->display = scopeArea;
 	}
 
 	// Single Controls:
 	// Color sliders
 	const int sliderHeight = 20;
 	const int margin = 10;
-	int yslider = this->display[0]->box.pos.y + this->display[0]->box.size.y - 3 * (sliderHeight + margin) - margin;
+	int yslider = this->display->box.pos.y + this->display->box.size.y - 3 * (sliderHeight + margin) - margin;
 
 	//info("Adding color sliders");
 	for (int i = 0; i < 3; i++)
@@ -220,43 +225,47 @@ multiScopeWidget::multiScopeWidget()
 	int knobOffset = 5;
 	int tinyOffset = 5;
 	int x, y = yStart;
-	for (wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+	for (wIx = 0; wIx < numWaveforms; wIx++)
 	{
-		x = xStart;
+		// More waveforms than fit go in another column
+		int colX = (wIx / TROWA_SCOPE_WAVEFORMS_PER_COLUMN) * TROWA_SCOPE_INPUT_AREA_WIDTH;
+		if (wIx % TROWA_SCOPE_WAVEFORMS_PER_COLUMN == 0)
+			y = yStart;
+		x = xStart + colX;
 		int y2 = y + dy + knobOffset;
 		int y3 = y2 + dy;
 
 		// X Controls:
-		inputPorts[multiScope::X_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::X_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::X_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::X_POS_PARAM + wIx, TROWA_SCOPE_POS_KNOB_MIN, TROWA_SCOPE_POS_KNOB_MAX, TROWA_SCOPE_POS_X_KNOB_DEF));
+		inputPorts[module->inputId(multiScope::X_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::X_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::X_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::X_POS_PARAM, wIx), TROWA_SCOPE_POS_KNOB_MIN, TROWA_SCOPE_POS_KNOB_MAX, TROWA_SCOPE_POS_X_KNOB_DEF));
 		// Keep reference to the scale knobs for synching
-		scaleKnobs[wIx][KNOB_X] = dynamic_cast<TS_TinyBlackKnob*>(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y3), module, multiScope::X_SCALE_PARAM + wIx, TROWA_SCOPE_SCALE_KNOB_MIN, TROWA_SCOPE_SCALE_KNOB_MAX, 1.0));
+		scaleKnobs[wIx][KNOB_X] = dynamic_cast<TS_TinyBlackKnob*>(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y3), module, module->paramId(multiScope::X_SCALE_PARAM, wIx), TROWA_SCOPE_SCALE_KNOB_MIN, TROWA_SCOPE_SCALE_KNOB_MAX, 1.0));
 		addParam(scaleKnobs[wIx][KNOB_X]);
 
 		// X-Y Scale Synchronization:
-		TS_PadSwitch* linkXYScalesBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + 23, y3 + tinyOffset), module, multiScope::LINK_XY_SCALE_PARAM + wIx, 0, 1, 0));
+		TS_PadSwitch* linkXYScalesBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + 23, y3 + tinyOffset), module, module->paramId(multiScope::LINK_XY_SCALE_PARAM, wIx), 0, 1, 0));
 		linkXYScalesBtn->box.size = tinyBtnSize;
 		addParam(linkXYScalesBtn);
-		addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + 23, y3 + tinyOffset), module, multiScope::LINK_XY_SCALE_LED + wIx, tinyBtnSize, TROWA_SCOPE_LINK_XY_SCALE_ON_COLOR));
+		addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + 23, y3 + tinyOffset), module, module->lightId(multiScope::LINK_XY_SCALE_LED, wIx), tinyBtnSize, TROWA_SCOPE_LINK_XY_SCALE_ON_COLOR));
 		module->waveForms[wIx]->lastXYScaleValue = 1.0;
 
 		// Y Controls:
 		x += dx;
-		inputPorts[multiScope::Y_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::Y_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::Y_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::Y_POS_PARAM + wIx, TROWA_SCOPE_POS_KNOB_MIN, TROWA_SCOPE_POS_KNOB_MAX, TROWA_SCOPE_POS_Y_KNOB_DEF));
+		inputPorts[module->inputId(multiScope::Y_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::Y_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::Y_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::Y_POS_PARAM, wIx), TROWA_SCOPE_POS_KNOB_MIN, TROWA_SCOPE_POS_KNOB_MAX, TROWA_SCOPE_POS_Y_KNOB_DEF));
 		// Keep reference to the scale knobs for synching
-		scaleKnobs[wIx][KNOB_Y] = dynamic_cast<TS_TinyBlackKnob*>(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y3), module, multiScope::Y_SCALE_PARAM + wIx, TROWA_SCOPE_SCALE_KNOB_MIN, TROWA_SCOPE_SCALE_KNOB_MAX, 1.0));
+		scaleKnobs[wIx][KNOB_Y] = dynamic_cast<TS_TinyBlackKnob*>(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y3), module, module->paramId(multiScope::Y_SCALE_PARAM, wIx), TROWA_SCOPE_SCALE_KNOB_MIN, TROWA_SCOPE_SCALE_KNOB_MAX, 1.0));
 		addParam(scaleKnobs[wIx][KNOB_Y]);
 
 		// Color Controls:
 		x += dx;
-		inputPorts[multiScope::COLOR_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::COLOR_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::COLOR_INPUT + wIx]);
+		inputPorts[module->inputId(multiScope::COLOR_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::COLOR_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::COLOR_INPUT, wIx)]);
 		float knobHueVal = rescalef(module->waveForms[wIx]->waveHue, 0, 1.0, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2 + TROWA_SCOPE_COLOR_KNOB_Y_OFFSET), module, multiScope::COLOR_PARAM + wIx, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, knobHueVal));
-		module->params[multiScope::COLOR_PARAM + wIx].value = knobHueVal;
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2 + TROWA_SCOPE_COLOR_KNOB_Y_OFFSET), module, module->paramId(multiScope::COLOR_PARAM, wIx), TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, knobHueVal));
+		module->params[module->paramId(multiScope::COLOR_PARAM, wIx)].value = knobHueVal;
 		//// Highlights toggle (close to knob)
 		//TS_PadSwitch* highlightsBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 - 7), module, multiScope::HIGHLIGHT_PARAM + wIx, 0, 1, 0));
 		//highlightsBtn->box.size = tinyBtnSize;
@@ -264,81 +273,86 @@ multiScopeWidget::multiScopeWidget()
 		//addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 - 7), module, multiScope::HIGHLIGHT_LED + wIx, tinyBtnSize, TROWA_SCOPE_HIGHLIGHT_ON_COLOR));
 
 #if TROWA_SCOPE_USE_COLOR_LIGHTS
-		//module->waveForms[wIx]->waveLight = TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset, y3), module, multiScope::COLOR_LED + wIx, ledSize, module->waveForms[wIx]->waveColor, backColor);
-		module->waveForms[wIx]->waveLight = TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, multiScope::COLOR_LED + wIx, tinyBtnSize, module->waveForms[wIx]->waveColor, backColor);
+		//module->waveForms[wIx]->waveLight = TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset, y3), module, module->lightId(multiScope::COLOR_LED, wIx), ledSize, module->waveForms[wIx]->waveColor, backColor);
+		module->waveForms[wIx]->waveLight = TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, module->lightId(multiScope::COLOR_LED, wIx), tinyBtnSize, module->waveForms[wIx]->waveColor, backColor);
 		addChild(module->waveForms[wIx]->waveLight);
 #endif
+#if TROWA_SCOPE_USE_Z_DIMENSION
+		// Z (depth) input under the color knob:
+		inputPorts[module->inputId(multiScope::Z_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y3 - knobOffset), module, module->inputId(multiScope::Z_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::Z_INPUT, wIx)]);
+#endif
 
 		// Opacity:
 		x += dx;
-		inputPorts[multiScope::OPACITY_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::OPACITY_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::OPACITY_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::OPACITY_PARAM + wIx, TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY, TROWA_SCOPE_MAX_OPACITY));
+		inputPorts[module->inputId(multiScope::OPACITY_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::OPACITY_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::OPACITY_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::OPACITY_PARAM, wIx), TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY, TROWA_SCOPE_MAX_OPACITY));
 		// Pen On:
-		inputPorts[multiScope::PEN_ON_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y3 - knobOffset), module, multiScope::PEN_ON_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::PEN_ON_INPUT + wIx]);
+		inputPorts[module->inputId(multiScope::PEN_ON_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y3 - knobOffset), module, module->inputId(multiScope::PEN_ON_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::PEN_ON_INPUT, wIx)]);
 
 		// Fill Color Controls:
 		x += dx;
-		inputPorts[multiScope::FILL_COLOR_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::FILL_COLOR_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->fillColor));
-		addInput(inputPorts[multiScope::FILL_COLOR_INPUT + wIx]);
+		inputPorts[module->inputId(multiScope::FILL_COLOR_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::FILL_COLOR_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->fillColor));
+		addInput(inputPorts[module->inputId(multiScope::FILL_COLOR_INPUT, wIx)]);
 		knobHueVal = rescalef(module->waveForms[wIx]->fillHue, 0, 1.0, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2 + TROWA_SCOPE_COLOR_KNOB_Y_OFFSET), module, multiScope::FILL_COLOR_PARAM + wIx, TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, knobHueVal));
-		module->params[multiScope::FILL_COLOR_PARAM + wIx].value = knobHueVal;
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2 + TROWA_SCOPE_COLOR_KNOB_Y_OFFSET), module, module->paramId(multiScope::FILL_COLOR_PARAM, wIx), TROWA_SCOPE_HUE_KNOB_MIN, TROWA_SCOPE_HUE_KNOB_MAX, knobHueVal));
+		module->params[module->paramId(multiScope::FILL_COLOR_PARAM, wIx)].value = knobHueVal;
 		// Fill On toggle
 		// close to knob: Vec(x + knobOffset + tinyOffset, y3 - 7)
-		TS_PadSwitch* fillBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 - 7), module, multiScope::FILL_ON_PARAM + wIx, 0, 1, 0));
+		TS_PadSwitch* fillBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 - 7), module, module->paramId(multiScope::FILL_ON_PARAM, wIx), 0, 1, 0));
 		fillBtn->box.size = tinyBtnSize;
 		addParam(fillBtn);
-		this->fillColorLEDs[wIx] = TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 - 7), module, multiScope::FILL_ON_LED + wIx, tinyBtnSize, module->waveForms[wIx]->fillColor);
+		this->fillColorLEDs[wIx] = TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 - 7), module, module->lightId(multiScope::FILL_ON_LED, wIx), tinyBtnSize, module->waveForms[wIx]->fillColor);
 		addChild(fillColorLEDs[wIx]);
 
 		// Fill Opacity:
 		x += dx;
-		inputPorts[multiScope::FILL_OPACITY_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::FILL_OPACITY_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->fillColor));
-		addInput(inputPorts[multiScope::FILL_OPACITY_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::FILL_OPACITY_PARAM + wIx, TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY, TROWA_SCOPE_MAX_OPACITY));
+		inputPorts[module->inputId(multiScope::FILL_OPACITY_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::FILL_OPACITY_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->fillColor));
+		addInput(inputPorts[module->inputId(multiScope::FILL_OPACITY_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::FILL_OPACITY_PARAM, wIx), TROWA_SCOPE_MIN_OPACITY, TROWA_SCOPE_MAX_OPACITY, TROWA_SCOPE_MAX_OPACITY));
 
 
 		// Rotation Controls:
 		x += dx;
-		inputPorts[multiScope::ROTATION_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::ROTATION_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::ROTATION_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::ROTATION_PARAM + wIx, TROWA_SCOPE_ROT_KNOB_MIN, TROWA_SCOPE_ROT_KNOB_MAX, 0));
-		TS_PadSwitch* rotModeBtn = dynamic_cast<TS_PadSwitch*>( createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, multiScope::ROTATION_MODE_PARAM + wIx, 0, 1, 0) );
+		inputPorts[module->inputId(multiScope::ROTATION_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::ROTATION_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::ROTATION_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::ROTATION_PARAM, wIx), TROWA_SCOPE_ROT_KNOB_MIN, TROWA_SCOPE_ROT_KNOB_MAX, 0));
+		TS_PadSwitch* rotModeBtn = dynamic_cast<TS_PadSwitch*>( createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, module->paramId(multiScope::ROTATION_MODE_PARAM, wIx), 0, 1, 0) );
 		rotModeBtn->box.size = tinyBtnSize;
 		addParam(rotModeBtn);
-		addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, multiScope::ROT_LED + wIx, tinyBtnSize, TROWA_SCOPE_ABS_ROT_ON_COLOR));
+		addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, module->lightId(multiScope::ROT_LED, wIx), tinyBtnSize, TROWA_SCOPE_ABS_ROT_ON_COLOR));
 		if (module->waveForms[wIx]->rotMode)
 		{
 			rotModeBtn->value = 1.0;
-			module->params[multiScope::ROTATION_MODE_PARAM + wIx].value = 1.0;
+			module->params[module->paramId(multiScope::ROTATION_MODE_PARAM, wIx)].value = 1.0;
 			module->waveForms[wIx]->rotModeTrigger.state = SchmittTrigger::HIGH;
-			module->lights[multiScope::ROT_LED + wIx].value = 1.0;
+			module->lights[module->lightId(multiScope::ROT_LED, wIx)].value = 1.0;
 		}
 
 		// Time Controls:
 		x += dx;
-		inputPorts[multiScope::TIME_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::TIME_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::TIME_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::TIME_PARAM + wIx, TROWA_SCOPE_TIME_KNOB_MIN, TROWA_SCOPE_TIME_KNOB_MAX, TROWA_SCOPE_TIME_KNOB_DEF));
-		TS_PadSwitch* lissajousBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, multiScope::LISSAJOUS_PARAM + wIx, 0, 1, 1));
+		inputPorts[module->inputId(multiScope::TIME_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::TIME_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::TIME_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::TIME_PARAM, wIx), TROWA_SCOPE_TIME_KNOB_MIN, TROWA_SCOPE_TIME_KNOB_MAX, TROWA_SCOPE_TIME_KNOB_DEF));
+		TS_PadSwitch* lissajousBtn = dynamic_cast<TS_PadSwitch*>(createParam<TS_PadSwitch>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, module->paramId(multiScope::LISSAJOUS_PARAM, wIx), 0, 1, 1));
 		lissajousBtn->box.size = tinyBtnSize;
 		lissajousBtn->value = 1.0;
 		addParam(lissajousBtn);
-		addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, multiScope::LISSAJOUS_LED + wIx, tinyBtnSize, TROWA_SCOPE_LISSAJOUS_ON_COLOR));
-		module->params[multiScope::LISSAJOUS_PARAM + wIx].value = 1.0;
+		addChild(TS_createColorValueLight<ColorValueLight>(Vec(x + knobOffset + tinyOffset, y3 + tinyOffset), module, module->lightId(multiScope::LISSAJOUS_LED, wIx), tinyBtnSize, TROWA_SCOPE_LISSAJOUS_ON_COLOR));
+		module->params[module->paramId(multiScope::LISSAJOUS_PARAM, wIx)].value = 1.0;
 		module->waveForms[wIx]->lissajousTrigger.state = SchmittTrigger::HIGH;
-		module->lights[multiScope::LISSAJOUS_LED + wIx].value = 1.0;
+		module->lights[module->lightId(multiScope::LISSAJOUS_LED, wIx)].value = 1.0;
 
 		// Thickness:
 		x += dx;
-		inputPorts[multiScope::THICKNESS_INPUT + wIx] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, multiScope::THICKNESS_INPUT + wIx, plugLightsEnabled, module->waveForms[wIx]->waveColor));
-		addInput(inputPorts[multiScope::THICKNESS_INPUT + wIx]);
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, multiScope::THICKNESS_PARAM + wIx, TROWA_SCOPE_THICKNESS_MIN, TROWA_SCOPE_THICKNESS_MAX, TROWA_SCOPE_THICKNESS_DEF));
+		inputPorts[module->inputId(multiScope::THICKNESS_INPUT, wIx)] = dynamic_cast<TS_Port*>(TS_createInput<TS_Port>(Vec(x, y), module, module->inputId(multiScope::THICKNESS_INPUT, wIx), plugLightsEnabled, module->waveForms[wIx]->waveColor));
+		addInput(inputPorts[module->inputId(multiScope::THICKNESS_INPUT, wIx)]);
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y2), module, module->paramId(multiScope::THICKNESS_PARAM, wIx), TROWA_SCOPE_THICKNESS_MIN, TROWA_SCOPE_THICKNESS_MAX, TROWA_SCOPE_THICKNESS_DEF));
 		// Effect Controls:
 		//x += dx;
-		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y3), module, multiScope::EFFECT_PARAM + wIx, TROWA_SCOPE_EFFECT_KNOB_MIN, TROWA_SCOPE_EFFECT_KNOB_MAX, TROWA_SCOPE_EFFECT_KNOB_DEF));
+		addParam(createParam<TS_TinyBlackKnob>(Vec(x + knobOffset, y3), module, module->paramId(multiScope::EFFECT_PARAM, wIx), TROWA_SCOPE_EFFECT_KNOB_MIN, TROWA_SCOPE_EFFECT_KNOB_MAX, TROWA_SCOPE_EFFECT_KNOB_DEF));
 
 
 		y = y3 + dy + shapeSpacingY; // Extra space between shapes / waveforms		
@@ -369,10 +383,10 @@ void multiScopeWidget::step() {
 	if (scopeModule->initialized)
 	{
 		// Display toggle
-		if (scopeModule->infoDisplayOnTrigger.process(scopeModule->params[multiScope::INFO_DISPLAY_TOGGLE_PARAM].value)) {
+		if (scopeModule->infoDisplayOnTrigger.process(scopeModule->params[scopeModule->paramId(multiScope::INFO_DISPLAY_TOGGLE_PARAM)].value)) {
 			scopeInfoDisplay->visible = !scopeInfoDisplay->visible;
 		}
-		scopeModule->lights[multiScope::INFO_DISPLAY_TOGGLE_LED].value = (scopeInfoDisplay->visible) ? 1.0 : 0.0;
+		scopeModule->lights[scopeModule->lightId(multiScope::INFO_DISPLAY_TOGGLE_LED)].value = (scopeInfoDisplay->visible) ? 1.0 : 0.0;
 
 #if ENABLE_BG_COLOR_PICKER
 		// Color Picker (On-Screen)
@@ -452,25 +466,28 @@ void multiScopeWidget::step() {
 			scopeInfoDisplay->box.size.x = (width - 15 > scopeInfoDisplay->originalWidth) ? scopeInfoDisplay->originalWidth : width - 15;
 		}
 		//float height = box.size.y - TROWA_WIDGET_TOP_BAR_HEIGHT * 2;
-		for (int wIx = 0; wIx < TROWA_SCOPE_NUM_WAVEFORMS; wIx++)
+		display->box.size.x = width;
+		for (int wIx = 0; wIx < scopeModule->numWaveforms; wIx++)
 		{
-			display[wIx]->box.size.x = width;
 			// Change light colors on plugs
 			if (plugLightsEnabled)
 			{
 				//if (scopeModule->waveForms[wIx]->colorChanged) // When reloading from save, this doesn't work :(
 				{
-					inputPorts[multiScope::PEN_ON_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::OPACITY_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::COLOR_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::ROTATION_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::TIME_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::X_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::Y_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-					inputPorts[multiScope::THICKNESS_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
-
-					inputPorts[multiScope::FILL_COLOR_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->fillColor);
-					inputPorts[multiScope::FILL_OPACITY_INPUT + wIx]->setLightColor(scopeModule->waveForms[wIx]->fillColor);
+					inputPorts[scopeModule->inputId(multiScope::PEN_ON_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::OPACITY_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::COLOR_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::ROTATION_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::TIME_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::X_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::Y_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+					inputPorts[scopeModule->inputId(multiScope::THICKNESS_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+#if TROWA_SCOPE_USE_Z_DIMENSION
+					inputPorts[scopeModule->inputId(multiScope::Z_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->waveColor);
+#endif
+
+					inputPorts[scopeModule->inputId(multiScope::FILL_COLOR_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->fillColor);
+					inputPorts[scopeModule->inputId(multiScope::FILL_OPACITY_INPUT, wIx)]->setLightColor(scopeModule->waveForms[wIx]->fillColor);
 					if (scopeModule->waveForms[wIx]->doFill)
 					{
 						fillColorLEDs[wIx]->setColor(scopeModule->waveForms[wIx]->fillColor);
@@ -480,7 +497,7 @@ void multiScopeWidget::step() {
 			// Adjusting Knobs ///////////////////////////////////////////////
 			// Link X, Y scales
 			int srcIx = -1;
-			if (scopeModule->waveForms[wIx]->linkXYScalesTrigger.process(scopeModule->params[multiScope::LINK_XY_SCALE_PARAM + wIx].value))
+			if (scopeModule->waveForms[wIx]->linkXYScalesTrigger.process(scopeModule->params[scopeModule->paramId(multiScope::LINK_XY_SCALE_PARAM, wIx)].value))
 			{
 				scopeModule->waveForms[wIx]->linkXYScales = !scopeModule->waveForms[wIx]->linkXYScales;
 				if (scopeModule->waveForms[wIx]->linkXYScales)
@@ -492,9 +509,9 @@ void multiScopeWidget::step() {
 			else if (scopeModule->waveForms[wIx]->linkXYScales)
 			{
 				// Check if any one changed.
-				if (scopeModule->params[multiScope::X_SCALE_PARAM + wIx].value != scopeModule->waveForms[wIx]->lastXYScaleValue)
+				if (scopeModule->params[scopeModule->paramId(multiScope::X_SCALE_PARAM, wIx)].value != scopeModule->waveForms[wIx]->lastXYScaleValue)
 					srcIx = KNOB_X;
-				else if (scopeModule->params[multiScope::Y_SCALE_PARAM + wIx].value != scopeModule->waveForms[wIx]->lastXYScaleValue)
+				else if (scopeModule->params[scopeModule->paramId(multiScope::Y_SCALE_PARAM, wIx)].value != scopeModule->waveForms[wIx]->lastXYScaleValue)
 					srcIx = KNOB_Y;
 			}
 			if (srcIx > -1)
@@ -506,11 +523,11 @@ void multiScopeWidget::step() {
 				scaleKnobs[wIx][destIx]->value = val;
 				scaleKnobs[wIx][destIx]->dirty = true; // Set to dirty.
 				// Change the value on thhe module param too?
-				scopeModule->params[multiScope::X_SCALE_PARAM + wIx].value = val;
-				scopeModule->params[multiScope::Y_SCALE_PARAM + wIx].value = val;
+				scopeModule->params[scopeModule->paramId(multiScope::X_SCALE_PARAM, wIx)].value = val;
+				scopeModule->params[scopeModule->paramId(multiScope::Y_SCALE_PARAM, wIx)].value = val;
 				scopeModule->waveForms[wIx]->lastXYScaleValue = val;
 			}
-			scopeModule->lights[multiScope::LINK_XY_SCALE_LED + wIx].value = (scopeModule->waveForms[wIx]->linkXYScales) ? 1.0 : 0;
+			scopeModule->lights[scopeModule->lightId(multiScope::LINK_XY_SCALE_LED, wIx)].value = (scopeModule->waveForms[wIx]->linkXYScales) ? 1.0 : 0;
 			// end adjust Knobs for XY Scale Link //////////////////////////
 		}
 		for (int i = 0; i < 2; i++)
@@ -117,7 +117,10 @@ struct TSScopeModuleResizeHandle : Widget {
 struct multiScopeWidget : ModuleWidget {
 	Panel* panel;
 	TSScopeModuleResizeHandle* rightHandle;
-	TransparentWidget* display[TROWA_SCOPE_NUM_WAVEFORMS];
+	// Number of waveforms / shapes.
+	int numWaveforms = TROWA_SCOPE_NUM_WAVEFORMS;
+	// Draws all the waveforms.
+	multiScopeDisplay* display;
 	TS_Panel* screenContainer;
 	TS_ColorSlider* colorSliders[3];
 	TSScopeDisplay* scopeInfoDisplay;
@@ -126,15 +129,24 @@ struct multiScopeWidget : ModuleWidget {
 	int inputAreaWidth;
 	bool plugLightsEnabled = true;
 	// Keep references to our ports to disable lights or change the colors.
-	TS_Port* inputPorts[multiScope::NUM_INPUTS];
+	TS_Port* inputPorts[multiScope::NUM_INPUTS * TROWA_SCOPE_MAX_NUM_WAVEFORMS];
 	// Keep references to our scale knobs [0: x, 1: y]
-	TS_TinyBlackKnob* scaleKnobs[TROWA_SCOPE_NUM_WAVEFORMS][2];
-	ColorValueLight* fillColorLEDs[TROWA_SCOPE_NUM_WAVEFORMS];
+	TS_TinyBlackKnob* scaleKnobs[TROWA_SCOPE_MAX_NUM_WAVEFORMS][2];
+	ColorValueLight* fillColorLEDs[TROWA_SCOPE_MAX_NUM_WAVEFORMS];
 	
-	multiScopeWidget();
+	multiScopeWidget() : multiScopeWidget(TROWA_SCOPE_NUM_WAVEFORMS) { }
+	multiScopeWidget(int numWaveforms);
 	void step() override;
 	json_t *toJson() override;
 	void fromJson(json_t *rootJ) override;
 	//Menu *createContextMenu() override;
 };
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// multiScope8Widget
+// Widget for the scope with more waveforms (TROWA_SCOPE_NUM_WAVEFORMS_LARGE).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct multiScope8Widget : multiScopeWidget {
+	multiScope8Widget() : multiScopeWidget(TROWA_SCOPE_NUM_WAVEFORMS_LARGE) { }
+};
 #endif // end if not defined
\ No newline at end of file
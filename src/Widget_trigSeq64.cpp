@@ -5,21 +5,26 @@
 #include "trowaSoftComponents.hpp"
 #include "trowaSoftUtilities.hpp"
 #include "TSSequencerModuleBase.hpp"
+#include "TSLightGrid.hpp"
 #include "Module_trigSeq.hpp"
 
 #define N64_NUM_STEPS	64
 #define N64_NUM_ROWS	 8
 #define N64_NUM_COLS	 (N64_NUM_STEPS/N64_NUM_ROWS)
 
-
+// Page button labels.
+static const char* N64_PAGE_LABELS[TROWA_SEQ_MAX_NUM_PAGES] = {
+	"1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13", "14", "15", "16"
+};
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // 64SeqWidget
 // Widget for the trowaSoft 64-step sequencer.
+// @numSteps : (IN) The number of steps (more than 64 shows one page of 64 at a time).
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
-trigSeq64Widget::trigSeq64Widget() : TSSequencerWidgetBase()
+trigSeq64Widget::trigSeq64Widget(int numSteps) : TSSequencerWidgetBase()
 {
-	trigSeq *module = new trigSeq(N64_NUM_STEPS, N64_NUM_ROWS, N64_NUM_COLS);
+	trigSeq *module = new trigSeq(numSteps, N64_NUM_ROWS, N64_NUM_COLS);
 	setModule(module);
 	
 	//////////////////////////////////////////////
@@ -28,7 +33,7 @@ trigSeq64Widget::trigSeq64Widget() : TSSequencerWidgetBase()
 	{
 		SVGPanel *panel = new SVGPanel();
 		panel->box.size = box.size;
-		panel->setBackground(SVG::load(assetPlugin(plugin, "res/trigSeq.svg")));
+		panel->setBackground(TSAssets::svg(TS_SVG_PANEL_TRIGSEQ));
 		addChild(panel);
 	}
 	
@@ -41,6 +46,9 @@ trigSeq64Widget::trigSeq64Widget() : TSSequencerWidgetBase()
 	Vec padSize = Vec(24, 24);
 	Vec lSize = Vec(padSize.x - 2*dx, padSize.y - 2*dx);
 	int spacing = padSize.x + 5;
+	// All pad lights are drawn together by the grid
+	TS_LightSquareGrid* lightGrid = new TS_LightSquareGrid(/*pitch*/ Vec(spacing, spacing));
+	lightGrid->box.size = box.size;
 	
 	for (int r = 0; r < module->numRows; r++) //---------THE PADS
 	{
@@ -63,7 +71,7 @@ trigSeq64Widget::trigSeq64Widget() : TSSequencerWidgetBase()
 				/*module*/ module, 
 				/*lightId*/ TSSequencerModuleBase::PAD_LIGHTS + r*module->numCols + c,
 				/* size */ lSize, /* color */ module->voiceColors[module->currentChannelEditingIx]));
-			addChild( module->padLightPtrs[r][c] );
+			lightGrid->addLight( module->padLightPtrs[r][c] );
 			
 			module->lights[TSSequencerModuleBase::PAD_LIGHTS + r*module->numCols + c].value = 0;
 
@@ -72,6 +80,36 @@ trigSeq64Widget::trigSeq64Widget() : TSSequencerWidgetBase()
 		y += spacing; // Next row
 		x = 79;
 	} // end loop through NxN grid
+	addChild(lightGrid);
+
+	// Page buttons (under the pads) ======================================
+	if (module->numPages > 1)
+	{
+		int pageSpacing = 4;
+		int gridWidth = module->numCols * spacing - 5;
+		Vec pageBtnSize = Vec((gridWidth - pageSpacing * (module->numPages - 1)) / module->numPages, 14);
+		x = 79;
+		y += 2;
+		for (int p = 0; p < module->numPages && p < TROWA_SEQ_MAX_NUM_PAGES; p++)
+		{
+			TS_PadSwitch* pageBtn = new TS_PadSwitch(pageBtnSize);
+			pageBtn->box.pos = Vec(x, y);
+			pageBtn->module = module;
+			pageBtn->paramId = module->getPageParamId(p);
+			pageBtn->setLimits(0, 1);
+			pageBtn->setDefaultValue(0);
+			pageBtn->value = 0;
+			addParam(pageBtn);
+			TS_LightString* pageLight = dynamic_cast<TS_LightString*>(TS_createColorValueLight<TS_LightString>(/*pos */ Vec(x, y),
+				/*module*/ module,
+				/*lightId*/ module->getPageLightId(p),
+				/* size */ pageBtnSize, /* color */ COLOR_WHITE));
+			pageLight->lightString = N64_PAGE_LABELS[p];
+			pageLight->fontSize = 10;
+			addChild(pageLight);
+			x += pageBtnSize.x + pageSpacing;
+		}
+	}
 	
 	module->modeString = module->modeStrings[module->selectedOutputValueMode];
 	module->initialized = true;
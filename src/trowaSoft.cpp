@@ -14,10 +14,12 @@ void init(rack::Plugin *p) {
 	// Add EXTERNAL_TAG for osc
 	p->addModel(createModel<trigSeqWidget>(TROWA_PLUGIN_NAME, "trigSeq", "trigSeq", SEQUENCER_TAG, EXTERNAL_TAG));
 	p->addModel(createModel<trigSeq64Widget>(TROWA_PLUGIN_NAME, "trigSeq64", "trigSeq64", SEQUENCER_TAG, EXTERNAL_TAG));
+	p->addModel(createModel<trigSeq256Widget>(TROWA_PLUGIN_NAME, "trigSeq256", "trigSeq256", SEQUENCER_TAG, EXTERNAL_TAG));
     p->addModel(createModel<voltSeqWidget>(TROWA_PLUGIN_NAME, "voltSeq", "voltSeq", SEQUENCER_TAG, EXTERNAL_TAG));
 	
 	// Scope Modules:
 	p->addModel(createModel<multiScopeWidget>(TROWA_PLUGIN_NAME, "multiScope", "multiScope", VISUAL_TAG, EFFECT_TAG, UTILITY_TAG));
+	p->addModel(createModel<multiScope8Widget>(TROWA_PLUGIN_NAME, "multiScope8", "multiScope8", VISUAL_TAG, EFFECT_TAG, UTILITY_TAG));
 	
 	// Any other plugin initialization may go here.
 	// As an alternative, consider lazy-loading assets and lookup tables within this file or the individual module files to reduce startup times of Rack.	
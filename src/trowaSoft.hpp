@@ -33,6 +33,8 @@ struct trigSeqWidget : TSSequencerWidgetBase {
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 struct voltSeqWidget : TSSequencerWidgetBase {
 	voltSeqWidget();
+	// Also move the step knobs and change the light arcs' value mode.
+	void applyModuleChanges(TSSequencerModuleBase* thisModule, uint32_t changes) override;
 	// Create context menu with shifting.
 	Menu *createContextMenu() override;
 };
@@ -42,7 +44,17 @@ struct voltSeqWidget : TSSequencerWidgetBase {
 // Widget for the trowaSoft 64-step sequencer.
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 struct trigSeq64Widget : TSSequencerWidgetBase {
-	trigSeq64Widget();
+	trigSeq64Widget() : trigSeq64Widget(64) { }
+	// 8x8 pads. If numSteps is more than 64, one page of 64 is shown at a time.
+	trigSeq64Widget(int numSteps);
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// trigSeq256Widget
+// Widget for the trowaSoft 256-step sequencer (4 pages of 64).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+struct trigSeq256Widget : trigSeq64Widget {
+	trigSeq256Widget() : trigSeq64Widget(256) { }
 };
 
 #endif
\ No newline at end of file
@@ -90,11 +90,43 @@ extern Plugin* plugin;
 //--------------------------------------------------------------
 struct ColorValueLight : ModuleLightWidget {
 	NVGcolor baseColor;
+	// Change signature of what we draw (quantized color & base color plus whatever subclasses add).
+	uint32_t signature = 0;
+	// If the signature changed in the last step().
+	bool changed = true;
 	ColorValueLight()
 	{
 		return;
 	};
 	virtual ~ColorValueLight(){};
+	// Mix a value into a signature (FNV-1a style).
+	static uint32_t hashMix(uint32_t h, uint32_t v)
+	{
+		return (h ^ v) * 16777619u;
+	}
+	// Mix a color (8 bits per channel) into a signature.
+	static uint32_t hashColor(uint32_t h, NVGcolor c)
+	{
+		uint32_t v = ((uint32_t)(clampf(c.r, 0, 1) * 255 + 0.5f) << 24)
+			| ((uint32_t)(clampf(c.g, 0, 1) * 255 + 0.5f) << 16)
+			| ((uint32_t)(clampf(c.b, 0, 1) * 255 + 0.5f) << 8)
+			| (uint32_t)(clampf(c.a, 0, 1) * 255 + 0.5f);
+		return hashMix(h, v);
+	}
+	// Compute the change signature. Override to add anything else that changes the drawing.
+	virtual uint32_t computeSignature()
+	{
+		return hashColor(hashColor(2166136261u, color), baseColor);
+	}
+	// Update the color from the module lights, then the signature.
+	void step() override
+	{
+		ModuleLightWidget::step();
+		uint32_t sig = computeSignature();
+		changed = (sig != signature);
+		signature = sig;
+		return;
+	}
 	// Set a single color
 	void setColor(NVGcolor bColor)
 	{
@@ -154,13 +186,13 @@ struct TS_PadSwitch : MomentarySwitch {
 struct TS_PadSquare : SVGSwitch, TS_PadSwitch {
 	TS_PadSquare() 
 	{
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_0.svg")));
+		addFrame(TSAssets::svg(TS_SVG_PAD));
 		sw->wrap();
 		box.size = sw->box.size;
 	}
 	TS_PadSquare(Vec size)
 	{
-		addFrame(SVG::load(assetPlugin(plugin, "res/ComponentLibrary/TS_pad_0.svg")));
+		addFrame(TSAssets::svg(TS_SVG_PAD));
 		sw->box.size = size;
 		box.size = size;
 	}
@@ -173,8 +205,8 @@ struct TS_PadBtn : SVGSwitch, MomentarySwitch {
 	
 	TS_PadBtn() 
 	{
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_btn_0.svg")));
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_btn_1.svg")));
+		addFrame(TSAssets::svg(TS_SVG_PAD_BTN_0));
+		addFrame(TSAssets::svg(TS_SVG_PAD_BTN_1));
 		sw->wrap();
 		box.size = sw->box.size;
 	}	
@@ -187,8 +219,8 @@ struct TS_Pad_Run : SVGSwitch, MomentarySwitch {
 	
 	TS_Pad_Run() 
 	{
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_run_0.svg")));
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_run_1.svg")));
+		addFrame(TSAssets::svg(TS_SVG_PAD_RUN_0));
+		addFrame(TSAssets::svg(TS_SVG_PAD_RUN_1));
 		sw->wrap();
 		box.size = sw->box.size;
 	}	
@@ -201,8 +233,8 @@ struct TS_Pad_Reset : SVGSwitch, MomentarySwitch {
 	
 	TS_Pad_Reset() 
 	{
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_reset_0.svg")));
-		addFrame(SVG::load(assetPlugin(plugin,"res/ComponentLibrary/TS_pad_reset_1.svg")));
+		addFrame(TSAssets::svg(TS_SVG_PAD_RESET_0));
+		addFrame(TSAssets::svg(TS_SVG_PAD_RESET_1));
 		sw->wrap();
 		box.size = sw->box.size;
 	}	
@@ -215,28 +247,61 @@ struct TS_LightArc : ColorValueLight {
 	// The inner radius 
 	float innerRadius = 22;	
 	// Pointer to current angle in radians. This is the differential like from a knob.
-	float* currentAngle_radians;
+	float* currentAngle_radians = NULL;
 	// Font size for our display numbers
 	int fontSize;
 	// Font face
 	std::shared_ptr<Font> font;
 	// Numeric value to print out
-	float* numericValue;
+	float* numericValue = NULL;
 	// Buffer for our light string.
 	char lightString[10];
 	// The point where the angle is considered 0 degrees / radians.
 	float zeroAnglePoint;
 	// Pointer to the Sequencer Value mode information.
-	ValueSequencerMode* valueMode;
+	ValueSequencerMode* valueMode = NULL;
+	// The value & mode (and mode output version) lightString was last formatted for.
+	float lastNumericValue = 0;
+	ValueSequencerMode* lastValueMode = NULL;
+	uint32_t lastOutputVersion = 0;
 	
 	TS_LightArc()
 	{
-		font = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 10;
 		bgColor = nvgRGBAf(0.0, 0, 0, /*alpha */ 1.0);
 		baseColor = COLOR_WHITE;
 		zeroAnglePoint = TROWA_ANGLE_STRAIGHT_UP_RADIANS;
-	}	
+	}
+	// Signature also covers the knob angle (to 1 mrad), the value and the mode.
+	uint32_t computeSignature() override
+	{
+		uint32_t h = ColorValueLight::computeSignature();
+		if (currentAngle_radians != NULL)
+			h = hashMix(h, (uint32_t)(int32_t)(*currentAngle_radians * 1000));
+		if (numericValue != NULL)
+		{
+			uint32_t bits;
+			memcpy(&bits, numericValue, sizeof(bits));
+			h = hashMix(h, bits);
+		}
+		h = hashMix(h, (uint32_t)(uintptr_t)valueMode);
+		if (valueMode != NULL)
+			h = hashMix(h, valueMode->outputVersion);
+		return h;
+	}
+	// Get the display string. Only formatted (sprintf) when the value or mode changed.
+	const char* getDisplayString()
+	{
+		if (valueMode != lastValueMode || *numericValue != lastNumericValue || valueMode->outputVersion != lastOutputVersion)
+		{
+			lastValueMode = valueMode;
+			lastNumericValue = *numericValue;
+			lastOutputVersion = valueMode->outputVersion;
+			valueMode->GetDisplayString(valueMode->GetOutputValue(lastNumericValue), lightString);
+		}
+		return lightString;
+	}
 	void draw(NVGcontext *vg) override
 	{
 		float oradius = box.size.x / 2.0; // 25
@@ -306,10 +371,8 @@ struct TS_LightArc : ColorValueLight {
 			NVGcolor textColor = COLOR_WHITE;
 			nvgFontSize(vg, fontSize); 	
 			nvgTextAlign(vg, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
-			float v = valueMode->GetOutputValue(*numericValue);
-			valueMode->GetDisplayString(v, lightString);
 			nvgFillColor(vg, textColor);
-			nvgText(vg, oradius, oradius, lightString, NULL);
+			nvgText(vg, oradius, oradius, getDisplayString(), NULL);
 		}
 		return;
 	}
@@ -371,7 +434,7 @@ struct TS_LightString : ColorValueLight
 	int fontSize;
 	TS_LightString()
 	{
-		font = Font::load(assetPlugin(plugin, TROWA_LABEL_FONT));
+		font = TSAssets::font(TS_FONT_LABEL);
 		fontSize = 14;
 		bgColor = nvgRGBAf(0.2, 0.2, 0.2, /*alpha */ 1);
 		baseColor = COLOR_WHITE;		
@@ -394,26 +457,30 @@ struct TS_LightString : ColorValueLight
 		nvgStrokeColor(vg, borderColor);
 		nvgStroke(vg);
 		
-		// Inner glow
-		nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
-		nvgFillColor(vg, color);
-		nvgFill(vg);
+		// Off lights would add nothing
+		if (color.a > 0)
+		{
+			// Inner glow
+			nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
+			nvgFillColor(vg, color);
+			nvgFill(vg);
 
-		// Outer glow
-		nvgBeginPath(vg);
-		nvgRoundedRect(vg, /*x*/ radius - oradius, /*y*/ radiusY - oradiusY, /*w*/ 3*oradius, /*h*/ 2*oradiusY, cornerRadius);
-		NVGpaint paint;
-		NVGcolor icol = outerColor;// color;
-		icol.a *= 0.5;
-		NVGcolor ocol = outerColor;// color;
-		ocol.a = 0.0;
-		float feather = 3;
-		// Feather defines how blurry the border of the rectangle is.
-		paint = nvgBoxGradient(vg, /*x*/ 0, /*y*/ 0, /*w*/ box.size.x, /*h*/ oradiusY - 10, 
-			/*r: corner radius*/ cornerRadius, /*f: feather*/ feather, 
-			/*inner color*/ icol, /*outer color */ ocol);
-		nvgFillPaint(vg, paint);
-		nvgFill(vg);
+			// Outer glow
+			nvgBeginPath(vg);
+			nvgRoundedRect(vg, /*x*/ radius - oradius, /*y*/ radiusY - oradiusY, /*w*/ 3*oradius, /*h*/ 2*oradiusY, cornerRadius);
+			NVGpaint paint;
+			NVGcolor icol = outerColor;// color;
+			icol.a *= 0.5;
+			NVGcolor ocol = outerColor;// color;
+			ocol.a = 0.0;
+			float feather = 3;
+			// Feather defines how blurry the border of the rectangle is.
+			paint = nvgBoxGradient(vg, /*x*/ 0, /*y*/ 0, /*w*/ box.size.x, /*h*/ oradiusY - 10, 
+				/*r: corner radius*/ cornerRadius, /*f: feather*/ feather, 
+				/*inner color*/ icol, /*outer color */ ocol);
+			nvgFillPaint(vg, paint);
+			nvgFill(vg);
+		}
 		
 		nvgBeginPath(vg);
 		nvgGlobalCompositeOperation(vg, NVG_SOURCE_OVER);//Restore to default.
@@ -459,6 +526,8 @@ struct TS_LightSquare : ColorValueLight
 		nvgStrokeColor(vg, borderColor);
 		nvgStroke(vg);
 
+		if (color.a <= 0)
+			return; // Off, the glows would add nothing
 		// Inner glow
 		nvgGlobalCompositeOperation(vg, NVG_LIGHTER);
 		nvgFillColor(vg, color);
@@ -551,7 +620,7 @@ struct TS_Port : SVGPort {
 	NVGcolor posColor;
 	
 	TS_Port() : SVGPort() {
-		background->svg = SVG::load(assetPlugin(plugin, "res/ComponentLibrary/TS_Port.svg"));
+		background->svg = TSAssets::svg(TS_SVG_PORT);
 		background->wrap();
 		box.size = background->box.size;
 		if (plugLight)
@@ -711,6 +780,56 @@ struct TS_Panel : Panel
 	} // end draw()
 }; // end TS_Panel
 
+//--------------------------------------------------------------
+// TS_StaticLayerSource - Widget with a static (rarely changing) layer.
+//--------------------------------------------------------------
+struct TS_StaticLayerSource
+{
+	virtual ~TS_StaticLayerSource() {}
+	// Draw the parts that do not change. Only called when the cached layer is dirty.
+	virtual void drawStaticLayer(NVGcontext *vg) = 0;
+};
+
+//--------------------------------------------------------------
+// TS_StaticLayer - Caches the static layer of a TS_StaticLayerSource in a framebuffer.
+// Add as the first child of the source widget and set dirty when the static parts change.
+//--------------------------------------------------------------
+struct TS_StaticLayer : FramebufferWidget
+{
+	// Child that actually draws (into the framebuffer).
+	struct LayerDrawer : TransparentWidget
+	{
+		TS_StaticLayerSource* source = NULL;
+		void draw(NVGcontext *vg) override
+		{
+			if (source)
+				source->drawStaticLayer(vg);
+			return;
+		}
+	};
+	LayerDrawer* drawer;
+
+	TS_StaticLayer(TS_StaticLayerSource* source)
+	{
+		drawer = new LayerDrawer();
+		drawer->source = source;
+		addChild(drawer);
+		dirty = true;
+		return;
+	}
+	// Match the size of our owner. Sets dirty if the size changed.
+	void setSize(Vec size)
+	{
+		if (size.x != box.size.x || size.y != box.size.y)
+		{
+			box.size = size;
+			drawer->box.size = size;
+			dirty = true;
+		}
+		return;
+	}
+}; // end TS_StaticLayer
+
 //--------------------------------------------------------------
 // TS_SVGPanel - SVG Panel without mandatory border on LHS
 //--------------------------------------------------------------
@@ -1,7 +1,5 @@
 #include "trowaSoftUtilities.hpp"
 
-const char * TROWA_NOTES[TROWA_SEQ_NUM_NOTES] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
-
 // Split a string
 std::vector<std::string> str_split(const std::string& s, char delimiter)
 {
@@ -15,7 +13,6 @@ std::vector<std::string> str_split(const std::string& s, char delimiter)
 	return tokens;
 }
 
-
 namespace trowaSoft
 {
 	void TSColorToHSL(NVGcolor color, TSColorHSL* hsv)
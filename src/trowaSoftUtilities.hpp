@@ -7,8 +7,15 @@ using namespace rack;
 #include <string.h>
 #include <vector>
 #include <sstream> // std::istringstream
+#include <atomic>
+#include <algorithm>
+#include <stdint.h>
+#include <cmath>
 
 #include "math.hpp"
+#include "TSScaleQuantizer.hpp"
+#include "TSDisplayFormat.hpp"
+#include "TSAssets.hpp"
 
 #define TROWA_DEBUG_LVL_HIGH		100
 #define TROWA_DEBUG_LVL_MED			 50
@@ -19,25 +26,15 @@ using namespace rack;
 
 // Index not defined value.
 #define TROWA_INDEX_UNDEFINED		-1 // Value for undefined index.
-#define TROWA_DISP_MSG_SIZE			30 // For local buffers of strings
 #define TROWA_SEQ_NUM_PATTERNS		64 // Number of patterns for sequencers.
 #define TROWA_SEQ_PATTERN_MIN_V		-10 // Min voltage input / output for controlling pattern index and BPM
 #define TROWA_SEQ_PATTERN_MAX_V	 	 10 // Max voltage input / output for controlling pattern index and BPM
-#define TROWA_SEQ_NUM_NOTES			12 // Num notes per octave (1 V per octave)
-#define TROWA_SEQ_ZERO_OCTAVE		4  // Octave for voltage 0 -- Was 5, now 4
-#define TROWA_SEQ_NUM_OCTAVES	   10  // Number of total octaves
 
 #define TROWA_NUM_GLOBAL_EFFECTS	11
 
 #define TROWA_ANGLE_STRAIGHT_UP_RADIANS			(1.5*NVG_PI) // Angle for straight up (svg angles start from positive x and go clockwise)
 #define TROWA_ANGLE_STRAIGHT_DOWN_RADIANS		(0.5*NVG_PI) // Angle for straight down
 
-// Fonts:
-#define TROWA_DIGITAL_FONT		"res/Fonts/Digital dream Fat.ttf"
-#define TROWA_LABEL_FONT		"res/Fonts/ZeroesThree-Regular.ttf"
-
-extern const char * TROWA_NOTES[TROWA_SEQ_NUM_NOTES]; // Our note labels.
-
 // Given some input voltage, convert to our Pattern index [0-63].
 inline int VoltsToPattern(float voltsInput)
 {	
@@ -48,20 +45,6 @@ inline float PatternToVolts(int patternIx)
 {
 	return rescalef(patternIx + 1, 1, TROWA_SEQ_NUM_PATTERNS, TROWA_SEQ_PATTERN_MIN_V, TROWA_SEQ_PATTERN_MAX_V);
 }
-// Voltage [-5 to 5] to Octave 0 to 10
-inline int VoltsToOctave(float v)
-{
-	return (int)(v + TROWA_SEQ_ZERO_OCTAVE);
-}
-// Note index 0 to 11 (to TROWA_NOTES array).
-inline int VoltsToNoteIx(float v)
-{
-	// This doesn't work all the time.
-	//(v - floorf(v))*TROWA_SEQ_NUM_NOTES
-	// (-4.9 - -5) * 12 = 0.1*12 = int(1.2) = 1 [C#]
-	// (-0.33 - -1) * 12 = 0.67*12 = int(8.04) = 8 [G#]
-	return (int)(round((v + TROWA_SEQ_ZERO_OCTAVE)*TROWA_SEQ_NUM_NOTES)) % TROWA_SEQ_NUM_NOTES;
-}
 // Floating point hue [0-1.0] to color.
 NVGcolor inline HueToColor(float hue)
 {
@@ -112,6 +95,120 @@ struct GlobalEffect {
 	}
 };
 
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSLockFreeQueue
+// Fixed size single producer / single consumer ring buffer.
+// One thread may push() while another thread pop()s without any locks.
+// SIZE must be a power of 2 (one slot is always left empty).
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+template <typename T, int SIZE>
+struct TSLockFreeQueue
+{
+	static_assert(SIZE > 1 && (SIZE & (SIZE - 1)) == 0, "TSLockFreeQueue SIZE must be a power of 2.");
+	// The items.
+	T items[SIZE];
+	// Next slot to read (only written by the consumer).
+	std::atomic<int> head;
+	// Next slot to write (only written by the producer).
+	std::atomic<int> tail;
+	TSLockFreeQueue() : head(0), tail(0)
+	{
+		return;
+	}
+	// [Producer] Add an item. Returns false if the queue is full (item is dropped).
+	bool push(const T& item)
+	{
+		int t = tail.load(std::memory_order_relaxed);
+		int next = (t + 1) & (SIZE - 1);
+		if (next == head.load(std::memory_order_acquire))
+			return false;
+		items[t] = item;
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+	// [Consumer] Get the next item. Returns false if the queue is empty.
+	bool pop(T& item)
+	{
+		int h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire))
+			return false;
+		item = items[h];
+		head.store((h + 1) & (SIZE - 1), std::memory_order_release);
+		return true;
+	}
+	// [Consumer] If there is nothing to read.
+	bool empty()
+	{
+		return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+	}
+	// Number of items waiting (a snapshot, may be stale by the time it is used).
+	int size()
+	{
+		return (tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)) & (SIZE - 1);
+	}
+};
+
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+// TSTimeOrderedQueue
+// Fixed size (no allocation) min-heap of items keyed by time (i.e. sample #).
+// Items with the same time come out in the order they were pushed. Single thread only.
+//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+template <typename T, int SIZE>
+struct TSTimeOrderedQueue
+{
+	struct Entry {
+		// When the item is due.
+		int64_t time;
+		// Push order (to keep same-time items in order).
+		uint32_t seq;
+		// The item.
+		T item;
+		// Heap order: later (or pushed later) is 'less' so the earliest is on top.
+		bool operator<(const Entry& other) const
+		{
+			return (time != other.time) ? time > other.time : (int32_t)(seq - other.seq) > 0;
+		}
+	};
+	// The heap.
+	Entry entries[SIZE];
+	// Number of items.
+	int count = 0;
+	// Next push sequence #.
+	uint32_t nextSeq = 0;
+	// Add an item due at the given time. Returns false if the queue is full.
+	bool push(int64_t time, const T& item)
+	{
+		if (count >= SIZE)
+			return false;
+		entries[count].time = time;
+		entries[count].seq = nextSeq++;
+		entries[count].item = item;
+		count++;
+		std::push_heap(entries, entries + count);
+		return true;
+	}
+	// Get the earliest item if it is due (time <= now).
+	bool popDue(int64_t now, T& item)
+	{
+		if (count < 1 || entries[0].time > now)
+			return false;
+		std::pop_heap(entries, entries + count);
+		count--;
+		item = entries[count].item;
+		return true;
+	}
+	// If the queue is full.
+	bool full() const
+	{
+		return count >= SIZE;
+	}
+	// Remove everything.
+	void clear()
+	{
+		count = 0;
+	}
+};
+
 
 
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
@@ -145,12 +242,24 @@ struct ValueSequencerMode
 	float roundNearestDisplay = 0;
 	float roundNearestOutput = 0;
 	// Format string for the display value
-	const char * displayFormatString;
+	const char * displayFormatString = NULL;
 	// The display name.
 	const char * displayName;
 	
 	float zeroValue;
 	
+	// displayFormatString with its lookup table / fixed point formatting.
+	TSDisplayFormat displayFormat;
+	
+	// Output translation precomputed as a multiply-add (out = val * outputScale + outputOffset).
+	float outputScale = 1.0f;
+	float outputOffset = 0.0f;
+	// Output quantize step (0 for none) and its inverse.
+	float outputQuantize = 0.0f;
+	float outputQuantizeInv = 0.0f;
+	// Changed whenever the output for a given value changes (i.e. a new note scale), so cached display strings are redone.
+	uint32_t outputVersion = 0;
+	
 	ValueSequencerMode()
 	{
 		return;
@@ -177,9 +286,40 @@ struct ValueSequencerMode
 		
 		needsTranslationDisplay = minDisplayValue != voltageMin || maxDisplayValue != voltageMax;
 		needsTranslationOutput = outputVoltageMin != voltageMin || outputVoltageMax != voltageMax;
+		initOutputKernel();
+		initDisplayLookup();
 		return;
 	}
-
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// initOutputKernel()
+	// Precompute the output scale/offset/quantize (call after the voltage ranges are set).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void initOutputKernel()
+	{
+		if (needsTranslationOutput)
+		{
+			outputScale = (outputVoltageMax - outputVoltageMin) / (voltageMax - voltageMin);
+			outputOffset = outputVoltageMin - voltageMin * outputScale;
+		}
+		else
+		{
+			outputScale = 1.0f;
+			outputOffset = 0.0f;
+		}
+		outputQuantize = (roundNearestOutput > 0) ? roundNearestOutput : 0.0f;
+		outputQuantizeInv = (roundNearestOutput > 0) ? 1.0f / roundNearestOutput : 0.0f;
+		return;
+	} // end initOutputKernel()
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// initDisplayLookup()
+	// Parse the display format and, if it has no decimals, make all the display
+	// strings now (the display range is small and finite).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void initDisplayLookup()
+	{
+		displayFormat.init(displayFormatString, minDisplayValue, maxDisplayValue);
+		return;
+	} // end initDisplayLookup()
 	
 	virtual void GetDisplayString(/*in*/ float val, /*out*/ char* buffer)
 	{
@@ -192,24 +332,46 @@ struct ValueSequencerMode
 		{
 			dVal = static_cast<int>(dVal  / roundNearestDisplay) * roundNearestDisplay;
 		}
-		sprintf(buffer, displayFormatString, dVal);	
+		displayFormat.format(dVal, buffer);
 		return;
 	}
 
 	
 	virtual float GetOutputValue(float val)
 	{
-		float oVal = val;
-		if (needsTranslationOutput)
-		{
-			oVal = rescalef(val, voltageMin, voltageMax, outputVoltageMin, outputVoltageMax);
-		}
-		if (roundNearestOutput > 0)
+		float oVal = val * outputScale + outputOffset;
+		if (outputQuantize > 0)
 		{ // Round this
-			oVal = static_cast<int>(round(oVal  / roundNearestOutput)) * roundNearestOutput;
+			oVal = roundf(oVal * outputQuantizeInv) * outputQuantize;
 		}
 		return oVal;
 	}
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	// GetOutputValues()
+	// Translate a block of values (i.e. all channels for a sample). The quantize check is
+	// made once for the block so each loop is just a multiply-add (and a round).
+	// @vals : (IN/OUT) The values (translated in place).
+	// @n : (IN) The number of values.
+	// @quantize : (IN) Apply the quantize step (false if the caller quantizes itself).
+	//-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
+	void GetOutputValues(/*in/out*/ float* vals, /*in*/ int n, /*in*/ bool quantize = true)
+	{
+		const float scale = outputScale;
+		const float offset = outputOffset;
+		if (quantize && outputQuantize > 0)
+		{
+			const float q = outputQuantize;
+			const float qInv = outputQuantizeInv;
+			for (int i = 0; i < n; i++)
+				vals[i] = roundf((vals[i] * scale + offset) * qInv) * q;
+		}
+		else
+		{
+			for (int i = 0; i < n; i++)
+				vals[i] = vals[i] * scale + offset;
+		}
+		return;
+	} // end GetOutputValues()
 };
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 // NoteValueSequencerMode
@@ -217,6 +379,12 @@ struct ValueSequencerMode
 //-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-*-
 struct NoteValueSequencerMode : ValueSequencerMode
 {
+	// Precomputed note labels by octave and note index (i.e. "C#4").
+	TSNoteLabels noteLabels;
+	// Scale quantizer table to use instead of rounding to the semitone (NULL for none).
+	// The module points this at the current edit channel's table (for display).
+	const float* quantizeTable = NULL;
+	
 	NoteValueSequencerMode(const char* displayName,
 		float min_V, float max_V)
 	{
@@ -246,18 +414,20 @@ struct NoteValueSequencerMode : ValueSequencerMode
 		
 		needsTranslationDisplay = minDisplayValue != voltageMin || maxDisplayValue != voltageMax;
 		needsTranslationOutput = outputVoltageMin != voltageMin || outputVoltageMax != voltageMax;
+		initOutputKernel();
 		return;
 	}
+	// Quantize to the scale if we have one.
+	float GetOutputValue(float val) override
+	{
+		if (quantizeTable == NULL)
+			return ValueSequencerMode::GetOutputValue(val);
+		return TSScaleQuantizer::apply(quantizeTable, val * outputScale + outputOffset);
+	}
 	// Overriden display string to show notes instead of output voltage values.
 	void GetDisplayString(/*in*/ float val, /*out*/ char* buffer) override
 	{
-		int octave = VoltsToOctave(val);
-		int noteIx = VoltsToNoteIx(val);
-		if (noteIx > TROWA_SEQ_NUM_NOTES - 1)
-			noteIx = TROWA_SEQ_NUM_NOTES - 1;
-		else if (noteIx < 0)
-			noteIx = 0;
-		sprintf(buffer, "%s%d", TROWA_NOTES[noteIx], octave);
+		noteLabels.format(val, buffer);
 		return;
 	}
 };